@@ -18,6 +18,24 @@ namespace winrt::WinUI3MVVMSample1::ViewModels
         return s_myEntityViewModel;
     }
 
+    WinUI3MVVMSample1::MyEntityViewModel Locator::AcquireMyEntity()
+    {
+        return MyEntityPool().Acquire();
+    }
+
+    void Locator::ReleaseMyEntity(WinUI3MVVMSample1::MyEntityViewModel const& viewModel)
+    {
+        // 单例 VM 不进入对象池
+        if (!viewModel || viewModel == s_myEntityViewModel) return;
+        MyEntityPool().Release(viewModel);
+    }
+
+    Locator::MyEntityViewModelPool& Locator::MyEntityPool()
+    {
+        static MyEntityViewModelPool s_pool{ s_myEntityPoolCapacity };
+        return s_pool;
+    }
+
     void Locator::ResetViewModel(winrt::Windows::Foundation::IInspectable const& viewModel)
     {
         // 如果需要丢弃缓存、重建 VM，可在此实现
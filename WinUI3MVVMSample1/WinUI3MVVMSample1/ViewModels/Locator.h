@@ -1,17 +1,30 @@
 ﻿#pragma once
 #include "ViewModels/MyEntityViewModel.h"
+#include "mvvm_framework/view_model_pool.h"
 
 namespace winrt::WinUI3MVVMSample1::ViewModels
 {
     struct Locator
     {
+        using MyEntityViewModelPool = ::mvvm::ViewModelPool<
+            WinUI3MVVMSample1::MyEntityViewModel,
+            WinUI3MVVMSample1::implementation::MyEntityViewModel>;
+
         // 提供给 View 的投影类型
         static WinUI3MVVMSample1::MyEntityViewModel MyEntity();
 
+        // 列表-详情等频繁创建/销毁的场景：从对象池取出/归还 VM
+        static WinUI3MVVMSample1::MyEntityViewModel AcquireMyEntity();
+        static void ReleaseMyEntity(WinUI3MVVMSample1::MyEntityViewModel const& viewModel);
+
+        // 对象池（容量、命中率等）
+        static MyEntityViewModelPool& MyEntityPool();
+
         // 重置 ViewModel
         static void ResetViewModel(winrt::Windows::Foundation::IInspectable const& viewModel);
 
     private:
+        static constexpr size_t s_myEntityPoolCapacity = 16;
         static winrt::WinUI3MVVMSample1::MyEntityViewModel s_myEntityViewModel;
     };
 }
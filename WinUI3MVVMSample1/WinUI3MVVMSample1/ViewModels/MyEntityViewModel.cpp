@@ -15,6 +15,12 @@ namespace winrt::WinUI3MVVMSample1::implementation
 {
     MyEntityViewModel::MyEntityViewModel()
     {
+#ifdef MVVM_VIEWMODEL_METRICS
+        // 启用热路径计数，需在命令构建前调用。
+        // 可用 ::mvvm::ViewModelMetricsRegistry::Instance().StartPeriodicDump(...) 定期写入诊断日志
+        EnableMetrics(L"MyEntityViewModel");
+#endif
+
         // 初始化命令对象
         // 有多种方法可以初始化命令对象，比如这里的 4 种方法。
 
@@ -61,126 +67,83 @@ namespace winrt::WinUI3MVVMSample1::implementation
 
         // 方法4：使用 DelegateCommandBuilder 来简化命令对象创建和初始化
         // ---- 命令注册 ----
-        m_resetCommand = ::mvvm::DelegateCommandBuilder<winrt::Windows::Foundation::IInspectable>(*this)
-            .Execute([this](auto&&) { MyProperty(0); })
-            .CanExecute([this](auto&&) { return MyProperty() > 0; })
-            .DependsOn(L"MyProperty",
-                [this](auto&&, auto&&) { return MyProperty() == 0 || MyProperty() == 1; },
-                [this](auto&&) { return MyProperty() >= 10; })
-            .Build();
-
-        m_asyncCommand = ::mvvm::AsyncCommandBuilder<void>(*this)
-            .ExecuteAsync([this]() -> IAsyncAction { co_await DoSaveAsync(); })
-            .CanExecute([this]() { return IsValid() && !IsBusy(); })
-            .DependsOn(L"IsValid")
-            .DependsOn(L"IsBusy")
-            .Build();
-
-        m_cancelAsyncOpCommand = ::mvvm::DelegateCommandBuilder<winrt::Windows::Foundation::IInspectable>(*this)
-            .Execute([this](auto&&) { CancelSave(); })
-            .CanExecute([this](auto&&)
-                {
-                    auto cmd = m_asyncCommand.try_as< ::mvvm::AsyncDelegateCommand<> >();
-                    return IsBusy() && cmd && cmd->IsRunning();
-                })
-            .DependsOn(L"IsBusy")
-            .Build();
-
-        // TODO: vm 的注册绑定解除写的不太好，目前需要我们手动调用注册清理的方法。
-        // 当然这个AutoCleanup并非是指我不调用框架就不会在析构时自动释放对象了。
-        // 而是指当请求解绑定一个 VM 时，需要提交释放的对象。
-        RegisterForAutoCleanup(m_resetCommand);
-        RegisterForAutoCleanup(m_asyncCommand);
-        RegisterForAutoCleanup(m_cancelAsyncOpCommand);
-
-        // 注册基于属性依赖的多属性更改通知：FullName 依赖 First/Last。当 First/Last 变化时，FullName 也会变化。
-        RegisterDependency(L"FirstName", { L"FullName" });
-        RegisterDependency(L"LastName", { L"FullName" });
-
-        // 校验器：由 Model Service 完成实际的校验验证逻辑。VM 仅负责状态和命令的编排（即，数据转换）
-        AddValidator<int>(L"Age", [this](int v)->std::optional<hstring>
+        // 通过 DefineLazyCommand 延迟构建：Build()、依赖挂接与事件订阅都推迟到视图第一次读取命令属性时，
+        // 构建后自动以给定名称 RegisterForAutoCleanup。视图未绑定的命令不产生任何开销。
+        DefineLazyCommand(m_resetCommand, L"ResetCommand", [this]() -> ICommand
             {
-                if (!m_service->ValidateAge(v))
-                    return hstring{ L"Age must be in [0, 130]." };
-                return std::nullopt;
+                return ::mvvm::DelegateCommandBuilder<winrt::Windows::Foundation::IInspectable>(*this)
+                    .Execute([this](auto&&) { MyProperty(0); })
+                    .CanExecute([this](auto&&) { return MyProperty() > 0; })
+                    .DependsOn(L"MyProperty",
+                        [this](auto&&, auto&&) { return MyProperty() == 0 || MyProperty() == 1; },
+                        [this](auto&&) { return MyProperty() >= 10; })
+                    .Build();
             });
 
-        // 订阅事件
-        auto dc = winrt::get_self< ::mvvm::DelegateCommand<winrt::Windows::Foundation::IInspectable> >(m_resetCommand);
-
-        dc->CanExecuteRequested(
-            [](auto&& sender, auto&& args)
+        DefineLazyCommand(m_asyncCommand, L"AsyncCommand", [this]() -> ICommand
             {
-                OutputDebugString(L"[Test] CanExecuteRequested fired\n");
-                if (auto param = args.Parameter())
+                auto cmd = ::mvvm::AsyncCommandBuilder<void>(*this)
+                    .ExecuteAsync([this]() -> IAsyncAction { co_await DoSaveAsync(); })
+                    .CanExecute([this]() { return IsValid() && !IsBusy(); })
+                    .DependsOn(L"IsValid")
+                    .DependsOn(L"IsBusy")
+                    .Build();
+
+                if (auto ac = cmd.try_as< ::mvvm::AsyncDelegateCommand<> >())
                 {
-                    OutputDebugString((L"    Parameter: " + param.as<winrt::hstring>() + L"\n").c_str());
+                    auto weak = get_weak();
+                    ac->ExecuteCompleted([weak](auto&&, winrt::Mvvm::Framework::Core::ExecuteCompletedEventArgs const& args)
+                        {
+                            // 调试器截获取消异常时 DoSaveAsync 中的收尾可能来不及更新界面，取消在这里再处理一次
+                            if (args.Error() != mvvm::HResultHelper::hresult_error_fCanceled())
+                                return;
+
+                            if (auto self = weak.get(); self)
+                            {
+                                winrt::Microsoft::UI::Dispatching::DispatcherQueue ui = self->m_ui;
+                                if (!ui) return;
+
+                                ::mvvm::ProfiledEnqueue(ui, MVVM_DISPATCH_SITE("MyEntityViewModel::SaveCancelled"), [weak]()
+                                    {
+                                        if (auto s = weak.get())
+                                        {
+                                            s->StatusText(L"Save cancelled.");
+                                            s->IsBusy(false);
+                                        }
+                                    });
+                            }
+                        });
                 }
-
-                // 我们可以通过设置 handled 为 true 来禁用命令
-                // args.Handled(true);
+                return cmd;
             });
 
-        dc->CanExecuteCompleted(
-            [](auto&&, auto&& args)
+        DefineLazyCommand(m_cancelAsyncOpCommand, L"CancelAsyncOpCommand", [this]() -> ICommand
             {
-                std::wstring msg = L"[Test] CanExecuteCompleted fired, result = "
-                    + std::to_wstring(args.Result()) + L"\n";
-                OutputDebugString(msg.c_str());
+                return ::mvvm::DelegateCommandBuilder<winrt::Windows::Foundation::IInspectable>(*this)
+                    .Execute([this](auto&&) { CancelSave(); })
+                    .CanExecute([this](auto&&)
+                        {
+                            // 只查看不构建：AsyncCommand 尚未被绑定则必然没有在运行
+                            auto cmd = m_asyncCommand.PeekAs< ::mvvm::AsyncDelegateCommand<> >();
+                            return IsBusy() && cmd && cmd->IsRunning();
+                        })
+                    .DependsOn(L"IsBusy")
+                    .Build();
             });
 
-        dc->ExecuteRequested(
-            [](auto&&, auto&& args)
-            {
-                OutputDebugString(L"[Test] ExecuteRequested fired\n");
-                if (auto param = args.Parameter())
-                {
-                    OutputDebugString((L"    Parameter: " + param.as<winrt::hstring>() + L"\n").c_str());
-                }
-            });
+        // 解绑 VM 时由 AutoCleanup 释放已登记的对象：延迟命令在构建时自动登记，其它对象手动调用 RegisterForAutoCleanup。
 
-        dc->ExecuteCompleted(
-            [](auto&&, auto&& args)
-            {
-                std::wstring msg = L"[Test] ExecuteCompleted fired, succeeded = "
-                    + std::to_wstring(args.Succeeded()) + L"\n";
-                OutputDebugString(msg.c_str());
+        // 注册基于属性依赖的多属性更改通知：FullName 依赖 First/Last。当 First/Last 变化时，FullName 也会变化。
+        RegisterDependency(L"FirstName", { L"FullName" });
+        RegisterDependency(L"LastName", { L"FullName" });
 
-                if (!args.Succeeded())
-                {
-                    std::wstring err = L"    Error: " + std::to_wstring(args.Error()) + L"\n";
-                    OutputDebugString(err.c_str());
-                }
+        // 校验器：由 Model Service 完成实际的校验验证逻辑。VM 仅负责状态和命令的编排（即，数据转换）
+        AddValidator<int>(L"Age", [this](int v)->std::optional<hstring>
+            {
+                if (!m_service->ValidateAge(v))
+                    return hstring{ L"Age must be in [0, 130]." };
+                return std::nullopt;
             });
-
-        if (auto ac = m_asyncCommand.try_as< ::mvvm::AsyncDelegateCommand<> >())
-        {
-            auto weak = get_weak();
-            ac->ExecuteCompleted([weak](auto&&, winrt::Mvvm::Framework::Core::ExecuteCompletedEventArgs const& args)
-                {
-                    // TODO: 存在小问题，调试模式下为了防止异常被VS捕获后，UI 不能及时更新 Save cancelled.
-                    // 故我们需要在事件中再次处理，这有点麻烦，
-                    // 其实我们建议单独为 AsyncCommand 的取消操作提供一个事件，然后在那个事件的回调中统一地进行用户端点处理
-                    // DoSaveAsync() 的处理完全可以通过事件来完成，而且也不需要一个额外的命令（m_cancelAsyncOpCommand）来绑定啦
-                    if (args.Error() != mvvm::HResultHelper::hresult_error_fCanceled())
-                        return;
-
-                    if (auto self = weak.get(); self)
-                    {
-                        winrt::Microsoft::UI::Dispatching::DispatcherQueue ui = self->m_ui;
-                        if (!ui) return;
-
-                        ui.TryEnqueue([weak]()
-                            {
-                                if (auto s = weak.get())
-                                {
-                                    s->StatusText(L"Save cancelled.");
-                                    s->IsBusy(false);
-                                }
-                            });
-                    }
-                });
-        }
     }
 
     // ------------ 简单属性 ------------
@@ -261,14 +224,14 @@ namespace winrt::WinUI3MVVMSample1::implementation
     }
 
     // ------------ 命令属性 ------------
-    Microsoft::UI::Xaml::Input::ICommand MyEntityViewModel::ResetCommand() { return m_resetCommand; }
-    void MyEntityViewModel::ResetCommand(Microsoft::UI::Xaml::Input::ICommand const& v) { m_resetCommand = v; }
-    Microsoft::UI::Xaml::Input::ICommand MyEntityViewModel::AsyncCommand() { return m_asyncCommand; }
-    void MyEntityViewModel::AsyncCommand(Microsoft::UI::Xaml::Input::ICommand const& v) { m_asyncCommand = v; }
-    Microsoft::UI::Xaml::Input::ICommand MyEntityViewModel::CancelAsyncOpCommand() { return m_cancelAsyncOpCommand; }
+    Microsoft::UI::Xaml::Input::ICommand MyEntityViewModel::ResetCommand() { return m_resetCommand.Get(); }
+    void MyEntityViewModel::ResetCommand(Microsoft::UI::Xaml::Input::ICommand const& v) { m_resetCommand.Set(v); }
+    Microsoft::UI::Xaml::Input::ICommand MyEntityViewModel::AsyncCommand() { return m_asyncCommand.Get(); }
+    void MyEntityViewModel::AsyncCommand(Microsoft::UI::Xaml::Input::ICommand const& v) { m_asyncCommand.Set(v); }
+    Microsoft::UI::Xaml::Input::ICommand MyEntityViewModel::CancelAsyncOpCommand() { return m_cancelAsyncOpCommand.Get(); }
     void MyEntityViewModel::CancelAsyncOpCommand(Microsoft::UI::Xaml::Input::ICommand const& v)
     {
-        m_cancelAsyncOpCommand = v;
+        m_cancelAsyncOpCommand.Set(v);
     }
 
     bool MyEntityViewModel::IsValid() { return GetProperty(m_isValid); }
@@ -284,15 +247,17 @@ namespace winrt::WinUI3MVVMSample1::implementation
     // ------------ 异步保存：交由 Model 执行，VM 仅做状态编排 ------------
     IAsyncAction MyEntityViewModel::DoSaveAsync()
     {
-        m_cancelRequested->store(false, std::memory_order_relaxed);
+        // 在第一次挂起前取得本次保存的取消标志；Reset 可能替换成员，之后只访问这份本地引用
+        auto cancelRequested = m_cancelRequested;
+        cancelRequested->store(false, std::memory_order_relaxed);
 
         if (m_ui) co_await wil::resume_foreground(m_ui);
         IsBusy(true);
         StatusText(L"Saving...");
 
-        co_await m_service->SaveAsync(m_cancelRequested);
+        co_await m_service->SaveAsync(cancelRequested);
 
-        if (m_cancelRequested->load(std::memory_order_relaxed))
+        if (cancelRequested->load(std::memory_order_relaxed))
         {
             if (m_ui) co_await wil::resume_foreground(m_ui);
             StatusText(L"Save cancelled.");
@@ -307,20 +272,66 @@ namespace winrt::WinUI3MVVMSample1::implementation
 
     void MyEntityViewModel::CancelSave()
     {
-        auto cmd = m_asyncCommand.try_as< ::mvvm::AsyncDelegateCommand<> >();
+        auto cmd = m_asyncCommand.PeekAs< ::mvvm::AsyncDelegateCommand<> >();
         if (!cmd) return;
 
         const bool running = cmd->IsRunning();
         if (!(running || IsBusy())) return;
 
         m_cancelRequested->store(true, std::memory_order_relaxed);
-        if (m_ui) m_ui.TryEnqueue([weak = get_weak()]()
+        if (m_ui) ::mvvm::ProfiledEnqueue(m_ui, MVVM_DISPATCH_SITE("MyEntityViewModel::CancelSave"), [weak = get_weak()]()
             {
                 if (auto self = weak.get()) self->StatusText(L"Cancelling...");
             });
         cmd->Cancel();
     }
 
+    // 回收前的排空：由 Locator 的对象池在 Release 时先于 Reset 调用。
+    // 取消进行中的保存并等待命令空闲（含 ExecuteCompleted 回调），最后回到 UI 线程：
+    // 回调投递到 UI 队列的“Save cancelled.”会排在本延续之前执行，不会覆盖 Reset 之后的新状态。
+    IAsyncOperation<bool> MyEntityViewModel::QuiesceAsync(TimeSpan timeout)
+    {
+        auto strong = get_strong();
+        m_cancelRequested->store(true, std::memory_order_relaxed);
+
+        bool idle = true;
+        if (auto cmd = m_asyncCommand.PeekAs< ::mvvm::AsyncDelegateCommand<> >())
+        {
+            cmd->Cancel();
+            idle = co_await cmd->WhenIdleAsync(timeout);
+        }
+
+        if (m_ui) co_await wil::resume_foreground(m_ui);
+        co_return idle;
+    }
+
+    // 回收复用：由 Locator 的对象池在排空后调用。
+    // 命令对象、属性依赖表与校验器保持不变，只把数据恢复为新实例的初始状态。
+    void MyEntityViewModel::Reset()
+    {
+        // 兜底终止进行中的保存；运行中的 DoSaveAsync 持有自己的那份取消标志，换一个新的给下一次使用
+        m_cancelRequested->store(true, std::memory_order_relaxed);
+        if (auto cmd = m_asyncCommand.PeekAs< ::mvvm::AsyncDelegateCommand<> >())
+        {
+            cmd->Cancel();
+        }
+        m_cancelRequested = std::make_shared<std::atomic_bool>(false);
+
+        m_entity = {};
+        ClearValidateErrors();
+
+        // 通过 SetProperty 通知，保证重新绑定的视图拿到新值
+        MyProperty(0);
+        FirstName(m_entity.FirstName);
+        LastName(m_entity.LastName);
+        SetProperty(m_age, m_entity.Age, NAME_OF(MyEntityViewModel, Age));
+        SetProperty(m_ageText, hstring{ std::to_wstring(m_entity.Age) }, NAME_OF(MyEntityViewModel, AgeText));
+        AgeErrorsText(L"");
+        IsValid(true);
+        IsBusy(false);
+        StatusText(L"");
+    }
+
     // 我们已经通过框架内置了处理流程，只需要少量的代码即可使用，而不需要再定义下述内容。
     // 参见：Locator::ResetViewModel 方法
     // 
@@ -368,6 +379,16 @@ namespace winrt::WinUI3MVVMSample1::implementation
         this->ViewModel<MyEntityViewModel>::FrameworkCleanup();
     }
 
+    // IViewModelCleanup.DisposeAsync
+    IAsyncAction MyEntityViewModel::DisposeAsync()
+    {
+        // 先通知 Model 层取消，使 SaveAsync 能尽快退出
+        m_cancelRequested->store(true, std::memory_order_relaxed);
+
+        // 调用基类：取消 -> 排空进行中的命令 -> 解除订阅
+        return this->ViewModel<MyEntityViewModel>::DisposeAsync();
+    }
+
     // IAutoCleanupRegistrar.RegisterForAutoCleanup
     void MyEntityViewModel::RegisterForAutoCleanup(winrt::Windows::Foundation::IInspectable const& obj)
     {
@@ -4,6 +4,7 @@
 #include "mvvm_framework/delegate_command.h"
 #include "mvvm_framework/delegate_command_builder.h"
 #include "mvvm_framework/async_command_builder.h"
+#include "mvvm_framework/lazy_command.h"
 
 #include <atomic>
 #include <memory>
@@ -67,16 +68,22 @@ namespace winrt::WinUI3MVVMSample1::implementation
         winrt::Windows::Foundation::IAsyncAction DoSaveAsync();
         void                                    CancelSave();
 
+        // 对象池回收约定：先终止并排空进行中的保存，再重置数据字段（保留命令、依赖广播与校验器）
+        winrt::Windows::Foundation::IAsyncOperation<bool> QuiesceAsync(winrt::Windows::Foundation::TimeSpan timeout);
+        void                                    Reset();
+
 
         void            FrameworkCleanup();
+        winrt::Windows::Foundation::IAsyncAction DisposeAsync();
         void            RegisterForAutoCleanup(winrt::Windows::Foundation::IInspectable const& obj);
+        using ::mvvm::ViewModel<MyEntityViewModel>::RegisterForAutoCleanup; // 带名称的重载
     private:
         // 业务服务
         std::shared_ptr<WinUI3MVVMSample1::Models::IMyEntityService> m_service{ std::make_shared<WinUI3MVVMSample1::Models::MyEntityService>() };
         WinUI3MVVMSample1::Models::MyEntity m_entity{}; // 持有实体
 
         int32_t m_myProperty{};
-        winrt::Microsoft::UI::Xaml::Input::ICommand m_resetCommand{ nullptr };
+        ::mvvm::LazyCommand m_resetCommand;
 
         winrt::hstring m_firstName{ L"John" };
         winrt::hstring m_lastName{ L"Doe" };
@@ -85,8 +92,9 @@ namespace winrt::WinUI3MVVMSample1::implementation
         winrt::hstring m_ageText{ L"18" };
         winrt::hstring m_ageErrorsText{};
 
-        Microsoft::UI::Xaml::Input::ICommand m_asyncCommand{ nullptr };
-        Microsoft::UI::Xaml::Input::ICommand m_cancelAsyncOpCommand{ nullptr };
+        // 命令在首次绑定时才构建，见构造函数中的 DefineLazyCommand
+        ::mvvm::LazyCommand m_asyncCommand;
+        ::mvvm::LazyCommand m_cancelAsyncOpCommand;
         bool          m_isValid{ true };
         bool          m_isBusy{ false };
         winrt::hstring m_statusText{};
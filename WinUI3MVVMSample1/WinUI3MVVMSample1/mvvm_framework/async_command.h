@@ -2,16 +2,19 @@
 #ifndef __MVVM_CPPWINRT_ASYNC_DELEGATE_COMMAND_H_INCLUDED
 #define __MVVM_CPPWINRT_ASYNC_DELEGATE_COMMAND_H_INCLUDED
 
+#include <atomic>
 #include <functional>
 #include <type_traits>
 #include <vector>
 
+#include <wil/resource.h>
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Microsoft.UI.Xaml.Input.h>
 #include <winrt/Microsoft.UI.Xaml.Data.h>
 
 #include <mvvm_framework/mvvm_framework_events.h>  // Can/Execute EventArgs (same as sync)
 #include <mvvm_framework/mvvm_diagnostics.h>     // optional
+#include <mvvm_framework/view_model_metrics.h>
 #include "mvvm_framework/mvvm_hresult_helper.h"
 
 namespace mvvm
@@ -59,7 +62,8 @@ namespace mvvm
     struct AsyncDelegateCommand
         : winrt::implements<AsyncDelegateCommand<Parameter>
             , winrt::Microsoft::UI::Xaml::Input::ICommand
-            , winrt::Mvvm::Framework::Core::ICommandCleanup>
+            , winrt::Mvvm::Framework::Core::ICommandCleanup
+            , winrt::Mvvm::Framework::Core::ICommandDrain>
     {
         using ExecuteAsyncHandler = std::function<winrt::Windows::Foundation::IAsyncAction(
             std::add_lvalue_reference_t<std::conditional_t<std::is_same_v<Parameter, void>, void,
@@ -163,6 +167,9 @@ namespace mvvm
 
         bool CanExecute(winrt::Windows::Foundation::IInspectable const& parameter)
         {
+            MVVM_TRACE_SCOPE(traceScope, CanExecute, "AsyncDelegateCommand");
+            if (auto metrics = m_ownerMetrics.lock()) metrics->Add(MetricCounter::CanExecuteEvals);
+
             // Requested
             if (m_evtCanReq)
                 m_evtCanReq(*this, winrt::Mvvm::Framework::Core::CanExecuteRequestedEventArgs(parameter));
@@ -181,18 +188,21 @@ namespace mvvm
             if (m_evtCanCpl)
                 m_evtCanCpl(*this, winrt::Mvvm::Framework::Core::CanExecuteCompletedEventArgs(parameter, ok));
 
+            MVVM_TRACE_ARG(traceScope, ok);
             return ok;
         }
 
         void Execute(winrt::Windows::Foundation::IInspectable const& parameter)
         {
             if (!m_executeAsync) return;
+            MVVM_TRACE_SCOPE(traceScope, Execute, "AsyncDelegateCommand"); // 只覆盖同步启动部分
 
             if (m_evtExecReq)
                 m_evtExecReq(*this, winrt::Mvvm::Framework::Core::ExecuteRequestedEventArgs(parameter));
 
             // 进入运行状态，通知可执行状态变化
             m_isRunning = true;
+            EnterInFlight();
             RaiseCanExecuteChangedEvent();
 
             winrt::hresult hr = S_OK;
@@ -208,6 +218,9 @@ namespace mvvm
                     {
                         if (auto self = weak.get())
                         {
+                            // 完成回调全部执行完毕（或其中之一抛出）后才视为空闲，供 WhenIdleAsync 等待
+                            auto leave = wil::scope_exit([&self]() noexcept { self->LeaveInFlight(); });
+
                             // 结束运行，通知可执行状态变化
                             self->m_isRunning = false;
                             self->RaiseCanExecuteChangedEvent();
@@ -244,6 +257,7 @@ namespace mvvm
 
             if (FAILED(hr))
             {
+                auto leave = wil::scope_exit([this]() noexcept { LeaveInFlight(); });
                 m_isRunning = false;
                 RaiseCanExecuteChangedEvent();
                 if (m_evtExecCpl)
@@ -273,6 +287,13 @@ namespace mvvm
 
         bool IsRunning() const noexcept { return m_isRunning; }
 
+        // 等待所有进行中的执行（包括 ExecuteCompleted 回调）结束；超时返回 false
+        winrt::Windows::Foundation::IAsyncOperation<bool> WhenIdleAsync(winrt::Windows::Foundation::TimeSpan timeout)
+        {
+            auto strong = this->get_strong();
+            co_return co_await winrt::resume_on_signal(m_idleEvent.get(), timeout);
+        }
+
         // ------------------------------------------------------------
         //  Dependencies & Auto-exec (same behavior as sync)
         // ------------------------------------------------------------
@@ -350,6 +371,7 @@ namespace mvvm
             winrt::Windows::Foundation::IInspectable const& notifier,
             std::vector<DependencyRegistration> const& dependencies)
         {
+            m_ownerMetrics = ViewModelMetricsRegistry::Instance().Find(notifier);
             if (auto inpc = notifier.try_as<winrt::Microsoft::UI::Xaml::Data::INotifyPropertyChanged>())
             {
                 for (auto const& dep : dependencies)
@@ -502,6 +524,19 @@ namespace mvvm
             construct_at(std::addressof(e)); // 默认构造一个全新的 event 对象
         }
 
+        // 进行中的执行计数（允许重入时可能 > 1），归零时置位空闲事件
+        void EnterInFlight() noexcept
+        {
+            if (m_inFlight.fetch_add(1, std::memory_order_acq_rel) == 0)
+                ::ResetEvent(m_idleEvent.get());
+        }
+
+        void LeaveInFlight() noexcept
+        {
+            if (m_inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ::SetEvent(m_idleEvent.get());
+        }
+
         ExecuteAsyncHandler  m_executeAsync;
         CanExecuteHandler    m_canExecute;
 
@@ -510,6 +545,12 @@ namespace mvvm
 
         winrt::Windows::Foundation::IAsyncAction m_runningAction{ nullptr };
 
+        // 手动重置事件，初始为已置位（空闲）
+        winrt::handle m_idleEvent{ ::CreateEventW(nullptr, TRUE, TRUE, nullptr) };
+        std::atomic<uint32_t> m_inFlight{ 0 };
+
+        std::weak_ptr<ViewModelMetrics> m_ownerMetrics;   // notifier 启用统计时才非空；不延长 VM 计数器的生命周期
+
         // events
         winrt::event< winrt::Windows::Foundation::EventHandler<winrt::Windows::Foundation::IInspectable> > m_canExecuteChanged;
 
@@ -536,7 +577,8 @@ namespace mvvm
     struct AsyncDelegateCommandResult
         : winrt::implements<AsyncDelegateCommandResult<Parameter, TResult>
             , winrt::Microsoft::UI::Xaml::Input::ICommand
-            , winrt::Mvvm::Framework::Core::ICommandCleanup>
+            , winrt::Mvvm::Framework::Core::ICommandCleanup
+            , winrt::Mvvm::Framework::Core::ICommandDrain>
     {
         using ExecuteAsyncHandler = std::function<winrt::Windows::Foundation::IAsyncOperation<TResult>(
             std::add_lvalue_reference_t<std::conditional_t<std::is_same_v<Parameter, void>, void,
@@ -594,6 +636,8 @@ namespace mvvm
 
         bool CanExecute(winrt::Windows::Foundation::IInspectable const& parameter)
         {
+            MVVM_TRACE_SCOPE(traceScope, CanExecute, "AsyncDelegateCommandResult");
+            if (auto metrics = m_ownerMetrics.lock()) metrics->Add(MetricCounter::CanExecuteEvals);
             if (m_evtCanReq)
                 m_evtCanReq(*this, winrt::Mvvm::Framework::Core::CanExecuteRequestedEventArgs(parameter));
 
@@ -603,17 +647,20 @@ namespace mvvm
 
             if (m_evtCanCpl)
                 m_evtCanCpl(*this, winrt::Mvvm::Framework::Core::CanExecuteCompletedEventArgs(parameter, ok));
+            MVVM_TRACE_ARG(traceScope, ok);
             return ok;
         }
 
         void Execute(winrt::Windows::Foundation::IInspectable const& parameter)
         {
             if (!m_executeAsync) return;
+            MVVM_TRACE_SCOPE(traceScope, Execute, "AsyncDelegateCommandResult"); // 只覆盖同步启动部分
 
             if (m_evtExecReq)
                 m_evtExecReq(*this, winrt::Mvvm::Framework::Core::ExecuteRequestedEventArgs(parameter));
 
             m_isRunning = true;
+            EnterInFlight();
             RaiseCanExecuteChangedEvent();
 
             winrt::hresult hr = S_OK;
@@ -628,6 +675,7 @@ namespace mvvm
                     {
                         if (auto self = weak.get())
                         {
+                            auto leave = wil::scope_exit([&self]() noexcept { self->LeaveInFlight(); });
                             self->m_isRunning = false;
                             self->RaiseCanExecuteChangedEvent();
 
@@ -654,6 +702,7 @@ namespace mvvm
 
             if (FAILED(hr))
             {
+                auto leave = wil::scope_exit([this]() noexcept { LeaveInFlight(); });
                 m_isRunning = false;
                 RaiseCanExecuteChangedEvent();
                 if (m_evtExecCpl)
@@ -677,6 +726,12 @@ namespace mvvm
 
         bool IsRunning() const noexcept { return m_isRunning; }
 
+        winrt::Windows::Foundation::IAsyncOperation<bool> WhenIdleAsync(winrt::Windows::Foundation::TimeSpan timeout)
+        {
+            auto strong = this->get_strong();
+            co_return co_await winrt::resume_on_signal(m_idleEvent.get(), timeout);
+        }
+
         // Dependencies & Auto-exec (same as above)
         void OnAttachPropertyChanged(
             winrt::hstring const& prop, RelayDependencyCondition const& cond,
@@ -741,6 +796,7 @@ namespace mvvm
             winrt::Windows::Foundation::IInspectable const& notifier,
             std::vector<DependencyRegistration> const& dependencies)
         {
+            m_ownerMetrics = ViewModelMetricsRegistry::Instance().Find(notifier);
             if (auto inpc = notifier.try_as<winrt::Microsoft::UI::Xaml::Data::INotifyPropertyChanged>())
             {
                 for (auto const& dep : dependencies)
@@ -893,6 +949,19 @@ namespace mvvm
             construct_at(std::addressof(e)); // 默认构造一个全新的 event 对象
         }
 
+        // 进行中的执行计数（允许重入时可能 > 1），归零时置位空闲事件
+        void EnterInFlight() noexcept
+        {
+            if (m_inFlight.fetch_add(1, std::memory_order_acq_rel) == 0)
+                ::ResetEvent(m_idleEvent.get());
+        }
+
+        void LeaveInFlight() noexcept
+        {
+            if (m_inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ::SetEvent(m_idleEvent.get());
+        }
+
         ExecuteAsyncHandler  m_executeAsync;
         CanExecuteHandler    m_canExecute;
         bool m_isRunning{ false };
@@ -900,6 +969,11 @@ namespace mvvm
 
         winrt::Windows::Foundation::IAsyncOperation<TResult> m_runningOp{ nullptr };
 
+        winrt::handle m_idleEvent{ ::CreateEventW(nullptr, TRUE, TRUE, nullptr) };
+        std::atomic<uint32_t> m_inFlight{ 0 };
+
+        std::weak_ptr<ViewModelMetrics> m_ownerMetrics;   // notifier 启用统计时才非空；不延长 VM 计数器的生命周期
+
         // events
         winrt::event< winrt::Windows::Foundation::EventHandler<winrt::Windows::Foundation::IInspectable> > m_canExecuteChanged;
         winrt::event< winrt::Windows::Foundation::TypedEventHandler<
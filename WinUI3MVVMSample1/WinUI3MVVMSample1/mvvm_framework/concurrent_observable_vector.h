@@ -0,0 +1,345 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_CONCURRENT_OBSERVABLE_VECTOR_H_INCLUDED
+#define __MVVM_CPPWINRT_CONCURRENT_OBSERVABLE_VECTOR_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Microsoft.UI.Dispatching.h>
+#endif
+
+#include "dispatch_profiler.h"
+
+// 多线程写入、UI 线程投影的可观察集合。
+// 任意线程调用 EnqueueAdd / EnqueueAddRange / EnqueueRemove / EnqueueClear 只把操作追加到分片日志
+// （每个线程固定落在一个分片，分片各自加锁）；第一次由空闲变为待处理时经 ProfiledEnqueue 向 UI 调度器投递一次 Flush，
+// Flush 在 UI 线程按全局序号合并所有分片中截止序号之前的操作并一次性应用到投影，之后再合并发出 VectorChanged。
+// 投影只在 UI 线程修改，UI 线程上的读取始终看到一致的快照。
+namespace mvvm
+{
+    enum class ConcurrentVectorOp : uint8_t
+    {
+        Add,
+        Remove,     // 删除第一个相等的元素
+        Clear,
+    };
+
+    enum class ProjectionChange : uint8_t
+    {
+        Inserted,
+        Removed,
+        Reset,
+    };
+
+    namespace details
+    {
+        // Clear 操作不携带值；WinRT 投影类型的 T{} 会激活新实例，须以 nullptr 构造
+        template <typename T>
+        T EmptyOpValue()
+        {
+#ifdef _WIN32
+            if constexpr (std::is_base_of_v<winrt::Windows::Foundation::IUnknown, T>)
+                return T{ nullptr };
+            else
+#endif
+                return T{};
+        }
+    }
+
+    template <typename T, size_t ShardCount = 8>
+    class ConcurrentVectorStore
+    {
+        static_assert(ShardCount > 0, "ShardCount must be positive");
+
+    public:
+        struct Op
+        {
+            uint64_t           seq;
+            ConcurrentVectorOp kind;
+            T                  value;
+        };
+
+        // 返回 true 表示本次写入使存储由空闲变为待处理，调用方需安排一次 Drain
+        bool Add(T value)
+        {
+            return Push(ConcurrentVectorOp::Add, std::move(value));
+        }
+
+        template <typename Range>
+        bool AddRange(Range&& values)
+        {
+            auto& shard = CurrentShard();
+            {
+                std::scoped_lock lock{ shard.mutex };
+                for (auto&& value : values)
+                    shard.ops.push_back({ m_seq.fetch_add(1, std::memory_order_seq_cst), ConcurrentVectorOp::Add, value });
+            }
+            return MarkPending();
+        }
+
+        bool Remove(T value)
+        {
+            return Push(ConcurrentVectorOp::Remove, std::move(value));
+        }
+
+        bool Clear()
+        {
+            return Push(ConcurrentVectorOp::Clear, details::EmptyOpValue<T>());
+        }
+
+        // 取走截止序号之前的全部操作并按写入顺序排列。
+        // 分片是逐个加锁的，若直接整片取走，可能漏掉已处理分片中较早的写入、却取到后处理分片中较晚的写入
+        // （例如先取分片 0，随后 Add(x) 以序号 8 写入分片 0、Remove(x) 以序号 9 写入分片 1，
+        // 只取到 Remove 会使其先于 Add 生效）。因此先清除待处理标记，再读取截止序号：
+        //   - 序号小于截止值的操作在本分片加锁时必然已经入列（序号在分片锁内分配）；
+        //   - 序号不小于截止值的操作留在分片中，它们的写入方在清除标记之后置位，会重新触发调度。
+        std::vector<Op> Drain()
+        {
+            m_pending.store(false, std::memory_order_seq_cst);
+            uint64_t const limit = m_seq.load(std::memory_order_seq_cst);
+
+            std::vector<Op> merged;
+            std::array<std::vector<Op>, ShardCount> taken;
+            size_t total = 0;
+            for (size_t i = 0; i < ShardCount; ++i)
+            {
+                std::scoped_lock lock{ m_shards[i].mutex };
+                auto& ops = m_shards[i].ops;
+                auto end = std::partition_point(ops.begin(), ops.end(), [limit](Op const& op) { return op.seq < limit; });
+                if (end == ops.end())
+                {
+                    taken[i].swap(ops);
+                }
+                else
+                {
+                    taken[i].assign(std::make_move_iterator(ops.begin()), std::make_move_iterator(end));
+                    ops.erase(ops.begin(), end);
+                }
+                total += taken[i].size();
+            }
+
+            merged.reserve(total);
+            for (auto& ops : taken)
+            {
+                // 同一分片内序号在锁内分配，天然有序；逐段归并即可
+                auto middle = merged.size();
+                merged.insert(merged.end(), std::make_move_iterator(ops.begin()), std::make_move_iterator(ops.end()));
+                std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end(),
+                    [](Op const& a, Op const& b) { return a.seq < b.seq; });
+            }
+            return merged;
+        }
+
+        bool HasPending() const noexcept
+        {
+            return m_pending.load(std::memory_order_acquire);
+        }
+
+    private:
+        struct alignas(64) Shard
+        {
+            std::mutex      mutex;
+            std::vector<Op> ops;
+        };
+
+        Shard& CurrentShard() noexcept
+        {
+            static std::atomic<size_t> s_nextShard{ 0 };
+            thread_local size_t const index = s_nextShard.fetch_add(1, std::memory_order_relaxed) % ShardCount;
+            return m_shards[index];
+        }
+
+        bool Push(ConcurrentVectorOp kind, T&& value)
+        {
+            auto& shard = CurrentShard();
+            {
+                std::scoped_lock lock{ shard.mutex };
+                shard.ops.push_back({ m_seq.fetch_add(1, std::memory_order_seq_cst), kind, std::move(value) });
+            }
+            return MarkPending();
+        }
+
+        bool MarkPending() noexcept
+        {
+            return !m_pending.exchange(true, std::memory_order_seq_cst);
+        }
+
+        std::array<Shard, ShardCount> m_shards;
+        std::atomic<uint64_t>         m_seq{ 0 };
+        std::atomic<bool>             m_pending{ false };
+    };
+
+    // 把一批操作应用到投影。操作数不超过 resetThreshold 时逐项修改并回调 raise(change, index)，
+    // 每次回调时 values 已处于与该通知一致的状态；否则整体应用后只回调一次 Reset。
+    template <typename T, typename Ops, typename Raise>
+    void ApplyProjectionOps(std::vector<T>& values, Ops&& ops, uint32_t resetThreshold, Raise&& raise)
+    {
+        if (ops.empty())
+            return;
+
+        bool const reset = ops.size() > resetThreshold;
+        bool changed = false;
+        for (auto& op : ops)
+        {
+            switch (op.kind)
+            {
+            case ConcurrentVectorOp::Add:
+                values.push_back(std::move(op.value));
+                changed = true;
+                if (!reset)
+                    raise(ProjectionChange::Inserted, static_cast<uint32_t>(values.size() - 1));
+                break;
+            case ConcurrentVectorOp::Remove:
+                if (auto it = std::find(values.begin(), values.end(), op.value); it != values.end())
+                {
+                    auto index = static_cast<uint32_t>(it - values.begin());
+                    values.erase(it);
+                    changed = true;
+                    if (!reset)
+                        raise(ProjectionChange::Removed, index);
+                }
+                break;
+            case ConcurrentVectorOp::Clear:
+                if (!values.empty())
+                {
+                    values.clear();
+                    changed = true;
+                    if (!reset)
+                        raise(ProjectionChange::Reset, 0u);
+                }
+                break;
+            }
+        }
+        if (reset && changed)
+            raise(ProjectionChange::Reset, 0u);
+    }
+
+#ifdef _WIN32
+    // UI 线程投影。IVector 的修改方法（Append / RemoveAt / Clear 等）仍可在 UI 线程直接使用并立即生效；
+    // 其他线程通过 EnqueueAdd / EnqueueAddRange / EnqueueRemove / EnqueueClear 写入，在下一次 Flush 时按写入顺序应用。
+    // 两者交错时，直接修改先于尚未 Flush 的排队操作生效；需要以排队操作为准时先调用 Flush()。
+    //
+    //   auto items = mvvm::make_concurrent_observable_vector<winrt::Windows::Foundation::IInspectable>(DispatcherQueue());
+    //   std::thread([items] { items->EnqueueAdd(winrt::box_value(L"from worker")); }).detach();
+    //   list.ItemsSource(items.as<winrt::Windows::Foundation::IInspectable>());
+    template <typename T>
+    struct ConcurrentObservableVector :
+        winrt::implements<ConcurrentObservableVector<T>,
+            winrt::Windows::Foundation::Collections::IObservableVector<T>,
+            winrt::Windows::Foundation::Collections::IVector<T>,
+            winrt::Windows::Foundation::Collections::IVectorView<T>,
+            winrt::Windows::Foundation::Collections::IIterable<T>>,
+        winrt::observable_vector_base<ConcurrentObservableVector<T>, T>
+    {
+        using CollectionChange = winrt::Windows::Foundation::Collections::CollectionChange;
+
+        static constexpr uint32_t DefaultResetThreshold = 64;
+
+        explicit ConcurrentObservableVector(winrt::Microsoft::UI::Dispatching::DispatcherQueue const& dispatcher)
+            : m_dispatcher(dispatcher)
+        {
+        }
+
+        auto& get_container() noexcept { return m_values; }
+        auto const& get_container() const noexcept { return m_values; }
+
+        // —— 任意线程 ——（命名与 IVector 的方法区分开，避免隐藏 observable_vector_base::Clear 等）
+        void EnqueueAdd(T value)
+        {
+            if (m_store.Add(std::move(value)))
+                ScheduleFlush();
+        }
+
+        template <typename Range>
+        void EnqueueAddRange(Range&& values)
+        {
+            if (m_store.AddRange(std::forward<Range>(values)))
+                ScheduleFlush();
+        }
+
+        void EnqueueRemove(T value)
+        {
+            if (m_store.Remove(std::move(value)))
+                ScheduleFlush();
+        }
+
+        void EnqueueClear()
+        {
+            if (m_store.Clear())
+                ScheduleFlush();
+        }
+
+        // 一帧内操作数超过该值时只发出一次 Reset
+        uint32_t ResetThreshold() const noexcept { return m_resetThreshold.load(std::memory_order_relaxed); }
+        void ResetThreshold(uint32_t value) noexcept { m_resetThreshold.store(value, std::memory_order_relaxed); }
+
+        // —— UI 线程 ——
+        // 立即应用所有待处理写入（例如在读取前需要最新内容时）
+        void Flush()
+        {
+            if (!m_dispatcher.HasThreadAccess())
+                throw winrt::hresult_wrong_thread();
+
+            auto ops = m_store.Drain();
+            if (ops.empty())
+                return;
+
+            this->increment_version();
+            ApplyProjectionOps(m_values, ops, ResetThreshold(), [this](ProjectionChange change, uint32_t index)
+                {
+                    switch (change)
+                    {
+                    case ProjectionChange::Inserted: this->call_changed(CollectionChange::ItemInserted, index); break;
+                    case ProjectionChange::Removed:  this->call_changed(CollectionChange::ItemRemoved, index); break;
+                    case ProjectionChange::Reset:    this->call_changed(CollectionChange::Reset, 0); break;
+                    }
+                });
+        }
+
+    private:
+        void ScheduleFlush()
+        {
+            ::mvvm::ProfiledEnqueue(m_dispatcher, MVVM_DISPATCH_SITE("ConcurrentObservableVector::Flush"),
+                [weak = this->get_weak()]()
+                {
+                    if (auto self = weak.get())
+                        self->Flush();
+                });
+        }
+
+        winrt::Microsoft::UI::Dispatching::DispatcherQueue m_dispatcher{ nullptr };
+        ConcurrentVectorStore<T>                           m_store;
+        std::vector<T>                                     m_values;
+        std::atomic<uint32_t>                              m_resetThreshold{ DefaultResetThreshold };
+    };
+
+    template <typename T>
+    winrt::com_ptr<ConcurrentObservableVector<T>> make_concurrent_observable_vector(
+        winrt::Microsoft::UI::Dispatching::DispatcherQueue const& dispatcher)
+    {
+        return winrt::make_self<ConcurrentObservableVector<T>>(dispatcher);
+    }
+#endif
+}
+
+#endif // __MVVM_CPPWINRT_CONCURRENT_OBSERVABLE_VECTOR_H_INCLUDED
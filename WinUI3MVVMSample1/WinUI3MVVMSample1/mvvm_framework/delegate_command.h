@@ -35,6 +35,7 @@
 
 #include <mvvm_framework/mvvm_diagnostics.h>
 #include <mvvm_framework/mvvm_framework_events.h>
+#include <mvvm_framework/view_model_metrics.h>
 
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Microsoft.UI.Xaml.Input.h>
@@ -186,6 +187,8 @@ namespace mvvm
         // ICommand required methods
         bool CanExecute(winrt::Windows::Foundation::IInspectable const& parameter)
         {
+            MVVM_TRACE_SCOPE(traceScope, CanExecute, "DelegateCommand");
+            if (auto metrics = m_ownerMetrics.lock()) metrics->Add(MetricCounter::CanExecuteEvals);
             winrt::Mvvm::Framework::Core::CanExecuteRequestedEventArgs reqArgs(parameter);
             if (m_eventCanExecuteRequested) m_eventCanExecuteRequested(*this, reqArgs);
 
@@ -210,11 +213,13 @@ namespace mvvm
             if (m_eventCanExecuteCompleted)
                 m_eventCanExecuteCompleted(*this, winrt::Mvvm::Framework::Core::CanExecuteCompletedEventArgs(parameter, state));
 
+            MVVM_TRACE_ARG(traceScope, state);
             return state;
         }
 
         void Execute(winrt::Windows::Foundation::IInspectable const& parameter)
         {
+            MVVM_TRACE_SCOPE(traceScope, Execute, "DelegateCommand");
             if (m_eventExecuteRequested)
                 m_eventExecuteRequested(*this, winrt::Mvvm::Framework::Core::ExecuteRequestedEventArgs(parameter));
 
@@ -232,6 +237,7 @@ namespace mvvm
             }
             catch (winrt::hresult_error const& e) { error = e.code(); }
             catch (...) { error = E_FAIL; }
+            MVVM_TRACE_ARG(traceScope, error.value);
 
             if (m_eventExecuteCompleted)
                 m_eventExecuteCompleted(*this, winrt::Mvvm::Framework::Core::ExecuteCompletedEventArgs(parameter, error));
@@ -323,6 +329,7 @@ namespace mvvm
             winrt::Windows::Foundation::IInspectable const& notifier,
             std::vector<DependencyRegistration> const& dependencies)
         {
+            m_ownerMetrics = ViewModelMetricsRegistry::Instance().Find(notifier);
             if (auto inpc = notifier.try_as<winrt::Microsoft::UI::Xaml::Data::INotifyPropertyChanged>())
             {
                 for (auto const& dep : dependencies)
@@ -377,7 +384,7 @@ namespace mvvm
             static_assert(std::is_invocable_r_v<bool, CanExecuteHandler, Parameter>);
 
             if (!notifier)
-                MVVM_THROW(invalid_object, L"Invalid parameter `Notifier` is null.");
+                MVVM_THROWS(Commands, invalid_object, L"Invalid parameter `Notifier` is null.");
 
             auto inpc = notifier.try_as<winrt::Microsoft::UI::Xaml::Data::INotifyPropertyChanged>();
             if (!inpc) return;
@@ -591,6 +598,8 @@ namespace mvvm
         std::vector< winrt::event_token > m_dependencyTokens;
         std::vector< winrt::weak_ref<winrt::Microsoft::UI::Xaml::Data::INotifyPropertyChanged> > m_autoExecuteNotifiers;
         std::vector< winrt::event_token > m_autoExecuteTokens;
+
+        std::weak_ptr<ViewModelMetrics> m_ownerMetrics;   // notifier 启用统计时才非空；不延长 VM 计数器的生命周期
     #pragma endregion
     };
 }
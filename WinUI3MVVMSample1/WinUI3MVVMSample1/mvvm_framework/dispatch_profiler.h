@@ -0,0 +1,425 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_DISPATCH_PROFILER_H_INCLUDED
+#define __MVVM_CPPWINRT_DISPATCH_PROFILER_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winrt/Microsoft.UI.Xaml.Media.h>
+#endif
+
+// 经框架投递到 UI 线程的工作项的延迟剖析：
+//   入队 -> 开始 记为排队等待时间，开始 -> 结束 记为执行时间，按调用点分别记入 HDR 直方图；
+//   每帧累计框架工作耗时，超出预算（默认 4 ms）的帧单独记录。
+// 队列类型只需提供 TryEnqueue(callable)，DispatcherQueue 与 PortableEventLoop 均可使用。
+// 默认关闭，关闭时 ProfiledEnqueue 直接转发给队列。
+namespace mvvm
+{
+    // 对数-线性分桶的直方图（HDR Histogram 的简化实现）：
+    // 每个 2 的幂区间再等分为 64 个子桶，相对误差约 1.5%；记录为无锁 relaxed 原子操作。
+    class HdrHistogram
+    {
+    public:
+        static constexpr unsigned SubBucketBits = 7;
+        static constexpr uint64_t SubBucketCount = uint64_t{ 1 } << SubBucketBits;  // 128
+        static constexpr uint64_t SubBucketHalf = SubBucketCount / 2;               // 64
+        static constexpr unsigned MaxValueBits = 40;                                // ~18 分钟（纳秒）
+        static constexpr uint64_t MaxValue = (uint64_t{ 1 } << MaxValueBits) - 1;
+        static constexpr size_t   BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBucketHalf + SubBucketHalf;
+
+        void Record(uint64_t value) noexcept
+        {
+            value = (std::min)(value, MaxValue);
+            m_counts[IndexOf(value)].fetch_add(1, std::memory_order_relaxed);
+            m_total.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+
+            auto max = m_max.load(std::memory_order_relaxed);
+            while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+        }
+
+        uint64_t Count() const noexcept { return m_total.load(std::memory_order_relaxed); }
+        uint64_t Max() const noexcept { return m_max.load(std::memory_order_relaxed); }
+
+        double Mean() const noexcept
+        {
+            auto count = Count();
+            return count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+        }
+
+        // 返回所在子桶的上界，percentile 取 0~100
+        uint64_t ValueAtPercentile(double percentile) const noexcept
+        {
+            auto count = Count();
+            if (!count) return 0;
+
+            percentile = (std::clamp)(percentile, 0.0, 100.0);
+            auto target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+            target = (std::max)(target, uint64_t{ 1 });
+
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BucketCount; ++i)
+            {
+                seen += m_counts[i].load(std::memory_order_relaxed);
+                if (seen >= target)
+                    return (std::min)(HighestEquivalentValue(i), Max());
+            }
+            return Max();
+        }
+
+        void Reset() noexcept
+        {
+            for (auto& c : m_counts)
+                c.store(0, std::memory_order_relaxed);
+            m_total.store(0, std::memory_order_relaxed);
+            m_sum.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+        static constexpr size_t IndexOf(uint64_t value) noexcept
+        {
+            if (value < SubBucketCount)
+                return static_cast<size_t>(value);
+
+            unsigned shift = static_cast<unsigned>(std::bit_width(value)) - SubBucketBits;
+            return static_cast<size_t>(shift * SubBucketHalf + (value >> shift));
+        }
+
+        static constexpr uint64_t LowestEquivalentValue(size_t index) noexcept
+        {
+            if (index < SubBucketCount)
+                return index;
+
+            uint64_t shift = index / SubBucketHalf - 1;
+            return (index - shift * SubBucketHalf) << shift;
+        }
+
+        static constexpr uint64_t HighestEquivalentValue(size_t index) noexcept
+        {
+            if (index < SubBucketCount)
+                return index;
+
+            uint64_t shift = index / SubBucketHalf - 1;
+            return LowestEquivalentValue(index) + (uint64_t{ 1 } << shift) - 1;
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, BucketCount> m_counts{};
+        std::atomic<uint64_t> m_total{ 0 };
+        std::atomic<uint64_t> m_sum{ 0 };
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+
+    // 调用点：由 MVVM_DISPATCH_SITE 生成函数内静态对象，统计对象在首次使用时绑定
+    struct DispatchSite
+    {
+        const char* name;
+        const char* file;
+        int         line;
+        mutable std::atomic<void*> stats{ nullptr };
+    };
+
+#define MVVM_DISPATCH_SITE(name) \
+    ([]() -> ::mvvm::DispatchSite const& { \
+        static ::mvvm::DispatchSite site{ name, __FILE__, __LINE__ }; \
+        return site; \
+    }())
+
+    struct DispatchSiteReport
+    {
+        std::string name;
+        std::string file;
+        int         line{ 0 };
+        uint64_t    count{ 0 };
+        uint64_t    waitP50Ns{ 0 }, waitP90Ns{ 0 }, waitP99Ns{ 0 }, waitMaxNs{ 0 };
+        uint64_t    execP50Ns{ 0 }, execP90Ns{ 0 }, execP99Ns{ 0 }, execMaxNs{ 0 };
+        double      execMeanNs{ 0 };
+    };
+
+    struct OverBudgetFrame
+    {
+        uint64_t    frameIndex{ 0 };
+        uint64_t    frameEndNs{ 0 };        // steady_clock 纳秒
+        uint64_t    workNs{ 0 };            // 该帧内框架工作耗时（采样时已按采样间隔放大）
+        uint32_t    items{ 0 };
+        std::string slowestSite;
+        uint64_t    slowestItemNs{ 0 };
+    };
+
+    struct DispatchReport
+    {
+        std::vector<DispatchSiteReport> sites;  // 按 P99 执行时间降序
+        uint64_t frames{ 0 };
+        uint64_t overBudgetFrames{ 0 };
+        std::chrono::nanoseconds budget{ 0 };
+        std::vector<OverBudgetFrame> recentOverBudget;  // 最近的超预算帧，旧的在前
+    };
+
+    class DispatchProfiler
+    {
+    public:
+        static constexpr size_t MaxRecentFrames = 64;
+
+        static DispatchProfiler& Instance()
+        {
+            static DispatchProfiler profiler;
+            return profiler;
+        }
+
+        DispatchProfiler(DispatchProfiler const&) = delete;
+        DispatchProfiler& operator=(DispatchProfiler const&) = delete;
+
+        bool Enabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+        void Enable(bool enabled = true) noexcept { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+        // 每 interval 个工作项剖析一个（按投递线程计数），1 为全部剖析
+        void SetSampleInterval(uint32_t interval) noexcept { m_sampleInterval.store((std::max)(interval, 1u), std::memory_order_relaxed); }
+        uint32_t SampleInterval() const noexcept { return m_sampleInterval.load(std::memory_order_relaxed); }
+
+        void SetFrameBudget(std::chrono::nanoseconds budget) noexcept { m_budgetNs.store(static_cast<uint64_t>(budget.count()), std::memory_order_relaxed); }
+        std::chrono::nanoseconds FrameBudget() const noexcept { return std::chrono::nanoseconds{ m_budgetNs.load(std::memory_order_relaxed) }; }
+
+        static uint64_t NowNs() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // 投递线程调用：是否剖析本次投递
+        bool ShouldSample() const noexcept
+        {
+            if (!Enabled()) return false;
+            auto interval = SampleInterval();
+            if (interval == 1) return true;
+
+            thread_local uint32_t counter = 0;
+            return ++counter % interval == 0;
+        }
+
+        // UI 线程调用：工作项执行完毕
+        void OnItemCompleted(DispatchSite const& site, uint64_t enqueueNs, uint64_t startNs, uint64_t endNs)
+        {
+            auto& stats = StatsOf(site);
+            uint64_t exec = endNs - startNs;
+            stats.wait.Record(startNs - enqueueNs);
+            stats.exec.Record(exec);
+
+            std::scoped_lock lock{ m_frameMutex };
+            auto scaled = exec * SampleInterval();
+            m_frameWorkNs += scaled;
+            ++m_frameItems;
+            if (exec > m_frameSlowestNs)
+            {
+                m_frameSlowestNs = exec;
+                m_frameSlowestSite = &site;
+            }
+        }
+
+        // 帧边界：WinUI 下由 AttachRenderingFrameClock 驱动，其他事件循环由调用方在每轮结束时调用
+        void MarkFrame()
+        {
+            std::scoped_lock lock{ m_frameMutex };
+            ++m_frames;
+            if (m_frameWorkNs > m_budgetNs.load(std::memory_order_relaxed))
+            {
+                ++m_overBudgetFrames;
+                OverBudgetFrame frame;
+                frame.frameIndex = m_frames;
+                frame.frameEndNs = NowNs();
+                frame.workNs = m_frameWorkNs;
+                frame.items = m_frameItems;
+                frame.slowestItemNs = m_frameSlowestNs;
+                if (m_frameSlowestSite)
+                    frame.slowestSite = m_frameSlowestSite->name;
+
+                m_recentFrames.push_back(std::move(frame));
+                if (m_recentFrames.size() > MaxRecentFrames)
+                    m_recentFrames.pop_front();
+            }
+            m_frameWorkNs = 0;
+            m_frameItems = 0;
+            m_frameSlowestNs = 0;
+            m_frameSlowestSite = nullptr;
+        }
+
+        DispatchReport Report() const
+        {
+            DispatchReport report;
+            {
+                std::scoped_lock lock{ m_sitesMutex };
+                report.sites.reserve(m_sites.size());
+                for (auto const& [site, stats] : m_sites)
+                {
+                    DispatchSiteReport r;
+                    r.name = site->name;
+                    r.file = site->file;
+                    r.line = site->line;
+                    r.count = stats->exec.Count();
+                    r.waitP50Ns = stats->wait.ValueAtPercentile(50);
+                    r.waitP90Ns = stats->wait.ValueAtPercentile(90);
+                    r.waitP99Ns = stats->wait.ValueAtPercentile(99);
+                    r.waitMaxNs = stats->wait.Max();
+                    r.execP50Ns = stats->exec.ValueAtPercentile(50);
+                    r.execP90Ns = stats->exec.ValueAtPercentile(90);
+                    r.execP99Ns = stats->exec.ValueAtPercentile(99);
+                    r.execMaxNs = stats->exec.Max();
+                    r.execMeanNs = stats->exec.Mean();
+                    report.sites.push_back(std::move(r));
+                }
+            }
+            std::sort(report.sites.begin(), report.sites.end(),
+                [](auto const& a, auto const& b) { return a.execP99Ns > b.execP99Ns; });
+
+            std::scoped_lock lock{ m_frameMutex };
+            report.frames = m_frames;
+            report.overBudgetFrames = m_overBudgetFrames;
+            report.budget = FrameBudget();
+            report.recentOverBudget.assign(m_recentFrames.begin(), m_recentFrames.end());
+            return report;
+        }
+
+        std::wstring FormatReport() const
+        {
+            auto report = Report();
+            auto us = [](uint64_t ns) { return std::to_wstring(ns / 1000); };
+            auto wide = [](std::string const& s) { return std::wstring(s.begin(), s.end()); };
+
+            std::wstring text = L"[DISPATCH] frames=" + std::to_wstring(report.frames)
+                + L" overBudget=" + std::to_wstring(report.overBudgetFrames)
+                + L" budget=" + us(static_cast<uint64_t>(report.budget.count())) + L"us\n";
+
+            for (auto const& s : report.sites)
+            {
+                text += L"|-> " + wide(s.name) + L" (" + wide(s.file) + L":" + std::to_wstring(s.line) + L")"
+                    + L" n=" + std::to_wstring(s.count)
+                    + L" wait p50/p90/p99/max=" + us(s.waitP50Ns) + L"/" + us(s.waitP90Ns) + L"/" + us(s.waitP99Ns) + L"/" + us(s.waitMaxNs) + L"us"
+                    + L" exec p50/p90/p99/max=" + us(s.execP50Ns) + L"/" + us(s.execP90Ns) + L"/" + us(s.execP99Ns) + L"/" + us(s.execMaxNs) + L"us\n";
+            }
+
+            for (auto const& f : report.recentOverBudget)
+            {
+                text += L"  |-> frame #" + std::to_wstring(f.frameIndex)
+                    + L" work=" + us(f.workNs) + L"us items=" + std::to_wstring(f.items)
+                    + L" slowest=" + wide(f.slowestSite) + L" (" + us(f.slowestItemNs) + L"us)\n";
+            }
+            return text;
+        }
+
+        void Reset()
+        {
+            {
+                std::scoped_lock lock{ m_sitesMutex };
+                for (auto& [site, stats] : m_sites)
+                {
+                    stats->wait.Reset();
+                    stats->exec.Reset();
+                }
+            }
+
+            std::scoped_lock lock{ m_frameMutex };
+            m_frames = m_overBudgetFrames = 0;
+            m_frameWorkNs = 0;
+            m_frameItems = 0;
+            m_frameSlowestNs = 0;
+            m_frameSlowestSite = nullptr;
+            m_recentFrames.clear();
+        }
+
+    private:
+        struct SiteStats
+        {
+            HdrHistogram wait;
+            HdrHistogram exec;
+        };
+
+        DispatchProfiler() = default;
+
+        SiteStats& StatsOf(DispatchSite const& site)
+        {
+            if (auto cached = site.stats.load(std::memory_order_acquire))
+                return *static_cast<SiteStats*>(cached);
+
+            std::scoped_lock lock{ m_sitesMutex };
+            auto& slot = m_sites[&site];
+            if (!slot)
+                slot = std::make_unique<SiteStats>();
+            site.stats.store(slot.get(), std::memory_order_release);
+            return *slot;
+        }
+
+        std::atomic<bool>     m_enabled{ false };
+        std::atomic<uint32_t> m_sampleInterval{ 1 };
+        std::atomic<uint64_t> m_budgetNs{ 4'000'000 };
+
+        mutable std::mutex m_sitesMutex;
+        std::unordered_map<DispatchSite const*, std::unique_ptr<SiteStats>> m_sites;
+
+        mutable std::mutex          m_frameMutex;
+        uint64_t                    m_frames{ 0 };
+        uint64_t                    m_overBudgetFrames{ 0 };
+        uint64_t                    m_frameWorkNs{ 0 };
+        uint32_t                    m_frameItems{ 0 };
+        uint64_t                    m_frameSlowestNs{ 0 };
+        DispatchSite const*         m_frameSlowestSite{ nullptr };
+        std::deque<OverBudgetFrame> m_recentFrames;
+    };
+
+    // 经剖析器投递工作项。Queue 需提供 TryEnqueue(callable) -> bool
+    template <typename Queue, typename F>
+    bool ProfiledEnqueue(Queue const& queue, DispatchSite const& site, F&& work)
+    {
+        auto& profiler = DispatchProfiler::Instance();
+        if (!profiler.ShouldSample())
+            return queue.TryEnqueue(std::forward<F>(work));
+
+        return queue.TryEnqueue([&site, enqueueNs = DispatchProfiler::NowNs(), work = std::forward<F>(work)]() mutable
+            {
+                auto startNs = DispatchProfiler::NowNs();
+                struct Completion
+                {
+                    DispatchSite const& site;
+                    uint64_t enqueueNs, startNs;
+                    ~Completion() { DispatchProfiler::Instance().OnItemCompleted(site, enqueueNs, startNs, DispatchProfiler::NowNs()); }
+                } completion{ site, enqueueNs, startNs };
+                work();
+            });
+    }
+
+#ifdef _WIN32
+    // 以 CompositionTarget::Rendering 作为帧边界，须在 UI 线程调用；返回的 token 用于 DetachRenderingFrameClock
+    inline winrt::event_token AttachRenderingFrameClock()
+    {
+        return winrt::Microsoft::UI::Xaml::Media::CompositionTarget::Rendering(
+            [](auto&&, auto&&) { DispatchProfiler::Instance().MarkFrame(); });
+    }
+
+    inline void DetachRenderingFrameClock(winrt::event_token const& token)
+    {
+        winrt::Microsoft::UI::Xaml::Media::CompositionTarget::Rendering(token);
+    }
+#endif
+}
+
+#endif // __MVVM_CPPWINRT_DISPATCH_PROFILER_H_INCLUDED
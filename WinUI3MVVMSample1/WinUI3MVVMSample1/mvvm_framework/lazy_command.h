@@ -0,0 +1,41 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_LAZY_COMMAND_H_INCLUDED
+#define __MVVM_CPPWINRT_LAZY_COMMAND_H_INCLUDED
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Microsoft.UI.Xaml.Input.h>
+
+#include "lazy_slot.h"
+
+namespace mvvm
+{
+    // 延迟命令槽：构造 VM 时只保存工厂函数，首次通过 Get() 访问（通常是 XAML 绑定
+    // 读取 XxxCommand 属性）时才执行 Build() 和依赖挂接，并回调 onBuilt（登记自动清理、订阅事件等）。
+    // 视图从不绑定的命令不会产生任何 COM 对象和 PropertyChanged 订阅。
+    // 构建、发布与重定义的规则见 LazySlot（与平台无关，可单独测试与测量）。
+    class LazyCommand : public LazySlot<winrt::Microsoft::UI::Xaml::Input::ICommand>
+    {
+    public:
+        using LazySlot::LazySlot;
+
+        // 便于在 CanExecute 等处直接取实现类型：未构建时返回 nullptr
+        template <typename TCommand>
+        winrt::com_ptr<TCommand> PeekAs() const
+        {
+            auto cmd = Peek();
+            return cmd ? cmd.try_as<TCommand>() : nullptr;
+        }
+    };
+}
+
+#endif // __MVVM_CPPWINRT_LAZY_COMMAND_H_INCLUDED
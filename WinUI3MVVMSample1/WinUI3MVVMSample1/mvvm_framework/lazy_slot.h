@@ -0,0 +1,120 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_LAZY_SLOT_H_INCLUDED
+#define __MVVM_CPPWINRT_LAZY_SLOT_H_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace mvvm
+{
+    // 延迟构建槽：只保存工厂函数，首次 Get() 时才构建并回调 onBuilt。
+    // 与平台无关，T 只需可复制、可默认构造为空值并可按 bool 判断是否为空
+    // （WinRT 接口、std::shared_ptr 等）。LazyCommand 即 LazySlot<ICommand>。
+    template <typename T>
+    class LazySlot
+    {
+    public:
+        using Factory = std::function<T()>;
+        using BuiltCallback = std::function<void(T const&)>;
+
+        LazySlot() = default;
+
+        explicit LazySlot(Factory factory, BuiltCallback onBuilt = nullptr)
+            : m_factory(std::move(factory)), m_onBuilt(std::move(onBuilt))
+        {
+        }
+
+        LazySlot(LazySlot const&) = delete;
+        LazySlot& operator=(LazySlot const&) = delete;
+
+        // 重新定义工厂；已构建的值会被丢弃（不做清理，清理由 VM 的 AutoCleanup 负责）
+        void Define(Factory factory, BuiltCallback onBuilt = nullptr)
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_factory = std::move(factory);
+            m_onBuilt = std::move(onBuilt);
+            m_value = T{};
+            ++m_generation;
+        }
+
+        // 取得值，必要时构建。
+        // 工厂和 onBuilt 都在锁外执行：onBuilt 通常是 RegisterForAutoCleanup，会获取 VM 的清理锁，
+        // 持锁回调会与“持清理锁再访问命令”的路径形成锁顺序反转。
+        // 并发首次访问时各线程可能各自构建，只有先发布的那个生效并回调 onBuilt，其余的直接丢弃，
+        // 因此工厂的副作用应只落在构建出的对象自身上（依赖订阅、命令事件随命令析构解除），对外登记放在 onBuilt 里。
+        T Get()
+        {
+            Factory factory;
+            BuiltCallback onBuilt;
+            uint64_t generation;
+            {
+                std::scoped_lock lock{ m_mutex };
+                if (m_value || !m_factory)
+                    return m_value;
+                factory = m_factory;
+                onBuilt = m_onBuilt;
+                generation = m_generation;
+            }
+
+            auto built = factory();
+
+            T current{};
+            bool published = false;
+            {
+                std::scoped_lock lock{ m_mutex };
+                // 期间被 Set() 赋值或被其他线程抢先发布时沿用现有值；被 Define() 重定义时丢弃旧工厂的产物
+                if (!m_value && m_generation == generation)
+                {
+                    m_value = built;
+                    published = static_cast<bool>(built);
+                }
+                current = m_value;
+            }
+
+            if (published && onBuilt)
+                onBuilt(built);
+            return current;
+        }
+
+        // 只读取，不触发构建（未构建时返回空值）
+        T Peek() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return m_value;
+        }
+
+        // 外部直接替换（对应 IDL 属性的 setter）
+        void Set(T const& value)
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_value = value;
+        }
+
+        bool IsBuilt() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return static_cast<bool>(m_value);
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        Factory       m_factory;
+        BuiltCallback m_onBuilt;
+        T             m_value{};
+        uint64_t      m_generation{ 0 };    // Define() 递增，用于识别锁外构建期间工厂已被替换
+    };
+}
+
+#endif // __MVVM_CPPWINRT_LAZY_SLOT_H_INCLUDED
@@ -1,14 +1,33 @@
 ﻿#pragma once
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <sstream>
 #include <format>
 #include <Windows.h>
-#include <DbgHelp.h>
+#include <algorithm>
 #include <vector>
 #include <fstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "mvvm_log_filter.h"
+#include "mvvm_log_queue.h"
+#include "mvvm_stack_trace.h"
 
-#pragma comment(lib, "Dbghelp.lib")
 
 namespace mvvm::exceptions
 {
@@ -35,26 +54,6 @@ namespace mvvm::exceptions
 
 namespace mvvm::diagnostics
 {
-    enum class LogLevel
-    {
-        Info,
-        Warning,
-        Error,
-        Fatal
-    };
-
-    inline const wchar_t* ToString(LogLevel level)
-    {
-        switch (level)
-        {
-        case LogLevel::Info: return L"INFO";
-        case LogLevel::Warning: return L"WARNING";
-        case LogLevel::Error: return L"ERROR";
-        case LogLevel::Fatal: return L"FATAL";
-        default: return L"UNKNOWN";
-        }
-    }
-
     inline std::wstring widen(const char* narrow)
     {
         if (!narrow) return L"(null)";
@@ -77,10 +76,21 @@ namespace mvvm::diagnostics
         return result;
     }
 
-    inline std::wstring CurrentTimestamp()
+    // UTC FILETIME（100ns 刻度），读取开销极低，供日志记录在调用线程上打时间戳
+    inline uint64_t NowFileTime() noexcept
     {
-        SYSTEMTIME st;
-        GetLocalTime(&st);
+        FILETIME ft;
+        GetSystemTimePreciseAsFileTime(&ft);
+        return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    }
+
+    inline std::wstring FormatTimestamp(uint64_t fileTime)
+    {
+        FILETIME ft{ static_cast<DWORD>(fileTime), static_cast<DWORD>(fileTime >> 32) };
+        FILETIME local{};
+        SYSTEMTIME st{};
+        FileTimeToLocalFileTime(&ft, &local);
+        FileTimeToSystemTime(&local, &st);
         wchar_t buf[64];
         swprintf_s(buf, L"%04d-%02d-%02d %02d:%02d:%02d.%03d",
             st.wYear, st.wMonth, st.wDay,
@@ -88,240 +98,481 @@ namespace mvvm::diagnostics
         return buf;
     }
 
-#include <Psapi.h>
-#pragma comment(lib, "Psapi.lib")
+    inline std::wstring CurrentTimestamp()
+    {
+        return FormatTimestamp(NowFileTime());
+    }
 
+    // 同步采集并符号化当前调用栈（符号处理器与缓存见 mvvm_stack_trace.h）。
+    // 日志路径只采集原始地址，由后台线程符号化，见 LogMessage。
     inline std::wstring CaptureStackTrace()
     {
-        constexpr int MAX_FRAMES = 30;
-        constexpr std::wstring_view systemModules[] = { L"kernel32.dll", L"kernelbase.dll", L"ntdll.dll" };
+        return FormatStackTrace(CaptureStack(1));
+    }
 
-        void* stack[MAX_FRAMES];
-        USHORT frames = RtlCaptureStackBackTrace(0, MAX_FRAMES, stack, nullptr);
+    // ---------------------------------------------------------------------
+    // 异步日志后端
+    // 调用线程只填充一条紧凑的 LogRecord 并无锁入队；时间格式化、文件名/函数名宽化、
+    // 写文件（长期持有的文件句柄 + 按大小滚动）全部在后台线程批量完成。
+    // ---------------------------------------------------------------------
 
-        HANDLE process = GetCurrentProcess();
-        SymInitialize(process, nullptr, TRUE);
+#ifndef MVVM_LOG_FILE
+#define MVVM_LOG_FILE L"mvvm_log.txt"
+#endif
+#ifndef MVVM_LOG_MAX_BYTES
+#define MVVM_LOG_MAX_BYTES (4u * 1024u * 1024u)
+#endif
+#ifndef MVVM_LOG_MAX_BACKUPS
+#define MVVM_LOG_MAX_BACKUPS 3
+#endif
+#ifndef MVVM_LOG_QUEUE_CAPACITY
+#define MVVM_LOG_QUEUE_CAPACITY 4096
+#endif
 
-        std::wstringstream ss;
-        ss << L"Stack Trace:\n";
+    // 定长记录，入队不分配内存：
+    //   参数全部是算术类型时，调用线程只把参数按值拷入内联缓冲区（每个参数一个 8 字节槽），
+    //   连同格式串和对应的格式化函数入队，由后台线程格式化；
+    //   其他参数（字符串等）在调用线程格式化进内联缓冲区，捕获它们本身就要在调用线程上分配。
+    // 只有超出缓冲区的长消息（如指标报告）才溢出到堆上；调用栈仅在请求时单独分配。
+    struct LogRecord
+    {
+        static constexpr size_t InlineChars = 192;
+        static constexpr size_t ArgSlot = 8;
+
+        template <typename... Args>
+        static constexpr bool CanDeferFormat =
+            ((std::is_arithmetic_v<std::remove_cvref_t<Args>> && sizeof(std::remove_cvref_t<Args>) <= ArgSlot) && ...)
+            && sizeof...(Args) * ArgSlot <= InlineChars * sizeof(wchar_t);
+
+        LogLevel     level{ LogLevel::Info };
+        int          line{ 0 };
+        uint64_t     fileTime{ 0 };         // NowFileTime()
+        const char*  file{ nullptr };       // 静态字符串（__FILE__ / __FUNCTION__），为空表示正文已是完整输出
+        const char*  function{ nullptr };
+        std::unique_ptr<StackCapture> stack;    // 仅原始返回地址，格式化时才符号化
+        std::unique_ptr<wchar_t[]>    overflow; // 正文超出 InlineChars 时使用
+        std::wstring_view format;           // 延迟格式化的格式串（编译期常量，静态存储）
+        void (*deferred)(LogRecord const&, std::wstring&) { nullptr };    // 非空表示 text 中存放的是参数
+        uint32_t     length{ 0 };
+        wchar_t      text[InlineChars];     // 不做零初始化，只有前 length 个字符有效
+
+        LogRecord() noexcept {}
+        LogRecord(LogRecord&& other) noexcept { *this = std::move(other); }
+
+        // 只拷贝有效字符，队列槽位的移入移出不会搬动整个缓冲区
+        LogRecord& operator=(LogRecord&& other) noexcept
+        {
+            level = other.level;
+            line = other.line;
+            fileTime = other.fileTime;
+            file = other.file;
+            function = other.function;
+            stack = std::move(other.stack);
+            overflow = std::move(other.overflow);
+            format = other.format;
+            deferred = std::exchange(other.deferred, nullptr);
+            length = std::exchange(other.length, 0);
+            if (!overflow)
+                std::copy_n(other.text, length, text);
+            return *this;
+        }
 
-        bool inSystemBlock = false;
-        std::wstring collapsedModule;
-        DWORD collapsedCount = 0;
-        DWORD64 firstSystemAddr = 0;
-        MODULEINFO modInfo = {};
+        // 已格式化的正文；延迟格式化的记录须用 AppendPayload
+        std::wstring_view Payload() const noexcept
+        {
+            return { overflow ? overflow.get() : text, length };
+        }
 
-        for (USHORT i = 2; i < frames; ++i)
+        void AppendPayload(std::wstring& out) const
         {
-            DWORD64 address = (DWORD64)(stack[i]);
+            if (deferred)
+                deferred(*this, out);
+            else
+                out += Payload();
+        }
 
-            // Get module info
-            HMODULE hMod = nullptr;
-            WCHAR moduleName[MAX_PATH] = {};
+        void SetPayload(std::wstring_view message)
+        {
+            std::copy_n(message.data(), message.size(), Reserve(message.size()));
+        }
 
-            if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(address), &hMod) &&
-                GetModuleInformation(process, hMod, &modInfo, sizeof(modInfo)) &&
-                GetModuleFileNameW(hMod, moduleName, MAX_PATH))
+        // 可延迟时只拷贝参数；否则先尝试直接格式化进内联缓冲区，放不下时按实际长度溢出到堆上再格式化一次
+        template <typename... Args>
+        void FormatPayload(std::wformat_string<Args...> fmt, Args&&... args)
+        {
+            if constexpr (CanDeferFormat<Args...>)
             {
-                std::wstring modName = moduleName;
-                size_t pos = modName.find_last_of(L"\\/");
-                if (pos != std::wstring::npos)
-                    modName = modName.substr(pos + 1);
+                DeferFormat<std::remove_cvref_t<Args>...>(fmt.get(), args...);
+            }
+            else
+            {
+                deferred = nullptr;
+                auto result = std::format_to_n(text, InlineChars, fmt, std::forward<Args>(args)...);
+                auto size = static_cast<size_t>(result.size);
+                if (size <= InlineChars)
+                {
+                    overflow.reset();
+                    length = static_cast<uint32_t>(size);
+                    return;
+                }
+                // 格式化只按引用读取参数，上面的转发不会移走它们
+                std::vformat_to(Reserve(size), fmt.get(), std::make_wformat_args(args...));
+            }
+        }
 
-                DWORD64 rva = address - (DWORD64)(modInfo.lpBaseOfDll);
+    private:
+        template <typename... Values>
+        void DeferFormat(std::wstring_view fmt, Values const&... values) noexcept
+        {
+            auto* bytes = reinterpret_cast<std::byte*>(text);
+            size_t slot = 0;
+            (std::memcpy(bytes + ArgSlot * slot++, &values, sizeof(Values)), ...);
+            overflow.reset();
+            length = static_cast<uint32_t>(sizeof...(Values) * ArgSlot / sizeof(wchar_t));
+            format = fmt;
+            deferred = &FormatDeferred<Values...>;
+        }
 
-                bool isSystem = false;
-                for (auto& sys : systemModules)
+        // 后台线程：从槽中取回参数后格式化
+        template <typename... Values>
+        static void FormatDeferred(LogRecord const& record, std::wstring& out)
+        {
+            auto const* bytes = reinterpret_cast<std::byte const*>(record.text);
+            std::tuple<Values...> values;
+            std::apply([&](Values&... v)
                 {
-                    if (_wcsicmp(sys.data(), modName.c_str()) == 0)
-                    {
-                        isSystem = true;
-                        break;
-                    }
+                    size_t slot = 0;
+                    (std::memcpy(&v, bytes + ArgSlot * slot++, sizeof(Values)), ...);
+                    std::vformat_to(std::back_inserter(out), record.format, std::make_wformat_args(v...));
+                }, values);
+        }
+
+        wchar_t* Reserve(size_t size)
+        {
+            deferred = nullptr;
+            length = static_cast<uint32_t>(size);
+            if (size <= InlineChars)
+            {
+                overflow.reset();
+                return text;
+            }
+            overflow = std::make_unique_for_overwrite<wchar_t[]>(size);
+            return overflow.get();
+        }
+    };
+
+    inline std::wstring FormatRecord(LogRecord const& r)
+    {
+        std::wstring s;
+        if (!r.file)
+        {
+            r.AppendPayload(s);
+            return s;
+        }
+
+        s.reserve(96 + r.length);
+        s += L"[";
+        s += ToString(r.level);
+        s += L"] ";
+        s += FormatTimestamp(r.fileTime);
+        s += L" | ";
+        s += widen(r.file);
+        s += L":";
+        s += std::to_wstring(r.line);
+        s += L" (";
+        s += widen(r.function);
+        s += L")\n|-> ";
+        r.AppendPayload(s);
+        s += L"\n";
+        if (r.stack && !r.stack->empty())
+            s += FormatStackTrace(*r.stack);
+        s += L"\n";
+        return s;
+    }
+
+    class AsyncLogger
+    {
+    public:
+        static AsyncLogger& Instance()
+        {
+            static AsyncLogger logger;
+            return logger;
+        }
+
+        AsyncLogger(AsyncLogger const&) = delete;
+        AsyncLogger& operator=(AsyncLogger const&) = delete;
+
+        ~AsyncLogger()
+        {
+            {
+                std::scoped_lock lock{ m_mutex };
+                m_stop = true;
+            }
+            m_wake.notify_one();
+            if (m_thread.joinable())
+                m_thread.join();
+        }
+
+        // 生产者：无锁、无阻塞。队列满时丢弃记录并计数，后台线程会输出一条丢弃提示。
+        bool Enqueue(LogRecord&& record) noexcept
+        {
+            if (!m_queue.TryPush(std::move(record)))
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            m_enqueued.fetch_add(1, std::memory_order_release);
+
+            // 仅在后台线程空闲等待时唤醒；漏掉的唤醒最多延迟 IdleWait
+            if (m_consumerIdle.load(std::memory_order_acquire))
+                m_wake.notify_one();
+            return true;
+        }
+
+        // 等待此刻之前入队的记录全部写出（Fatal 日志、进程退出前使用）
+        void Flush(std::chrono::milliseconds timeout = std::chrono::milliseconds{ 1000 })
+        {
+            if (std::this_thread::get_id() == m_thread.get_id())
+                return;
+
+            auto target = m_enqueued.load(std::memory_order_acquire);
+            std::unique_lock lock{ m_mutex };
+            m_flushRequested = true;
+            m_wake.notify_one();
+            m_flushed.wait_for(lock, timeout,
+                [&] { return m_written.load(std::memory_order_acquire) >= target; });
+        }
+
+        uint64_t DroppedCount() const noexcept { return m_totalDropped.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t MaxBatch = 256;
+        static constexpr std::chrono::milliseconds IdleWait{ 100 };
+
+        AsyncLogger()
+        {
+            m_thread = std::thread([this] { Run(); });
+        }
+
+        void Run()
+        {
+            SetThreadDescription(GetCurrentThread(), L"mvvm log writer");
+
+            LogRecord record;
+            std::wstring batch;
+            for (;;)
+            {
+                size_t count = 0;
+                while (count < MaxBatch && m_queue.TryPop(record))
+                {
+                    batch += FormatRecord(record);
+                    ++count;
                 }
 
-                if (isSystem)
+                if (auto dropped = m_dropped.exchange(0, std::memory_order_relaxed))
                 {
-                    if (!inSystemBlock)
-                    {
-                        inSystemBlock = true;
-                        collapsedModule = modName;
-                        firstSystemAddr = address;
-                        collapsedCount = 1;
-                    }
-                    else
-                    {
-                        collapsedCount++;
-                    }
-                    continue; // don't output yet
+                    m_totalDropped.fetch_add(dropped, std::memory_order_relaxed);
+                    batch += L"[" + std::wstring{ ToString(LogLevel::Warning) } + L"] " + CurrentTimestamp()
+                        + L" | " + std::to_wstring(dropped) + L" log record(s) dropped: queue full.\n\n";
                 }
-                else
+
+                if (!batch.empty())
                 {
-                    if (inSystemBlock)
-                    {
-                        // Output folded block
-                        DWORD64 sysRva = firstSystemAddr - (DWORD64)(modInfo.lpBaseOfDll);
-                        ss << L"  |->> [Folded] " << collapsedCount
-                            << L" system frame(s) from " << collapsedModule
-                            << L" + 0x" << std::hex << sysRva << std::dec << L"\n";
-                        inSystemBlock = false;
-                        collapsedCount = 0;
-                    }
-
-                    // Try get symbol name
-                    BYTE symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)]{};
-                    PSYMBOL_INFO pSymbol = reinterpret_cast<PSYMBOL_INFO>(symbolBuffer);
-                    pSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
-                    pSymbol->MaxNameLen = MAX_SYM_NAME;
-
-                    DWORD64 displacement = 0;
-                    if (SymFromAddr(process, address, &displacement, pSymbol))
-                    {
-                        // get source file path and line number information
-                        IMAGEHLP_LINEW64 line{};
-                        line.SizeOfStruct = sizeof(IMAGEHLP_LINEW64);
-                        DWORD lineDisplacement = 0;
-
-                        ss << L"[" << i << L"] " << modName
-                            << L" + 0x" << std::hex << rva
-                            << L" (" << pSymbol->Name << L")" << std::dec;
-
-                        #ifdef MVVM_TRACE_WITH_SOURCE
-                        bool hasLine = SymGetLineFromAddrW64(process, address, &lineDisplacement, &line);
-                        if (hasLine)
-                        {
-                            ss << L" [" << line.FileName << L":" << line.LineNumber << L"]";
-                        }
-                        #endif
-
-                        ss << L"\n";
-
-                    }
+                    Write(batch);
+                    batch.clear();
                 }
+
+                if (count)
+                {
+                    m_written.fetch_add(count, std::memory_order_release);
+                    std::scoped_lock lock{ m_mutex };
+                    m_flushed.notify_all();
+                }
+
+                if (count == MaxBatch)
+                    continue;
+
+                std::unique_lock lock{ m_mutex };
+                if (m_stop && count == 0)
+                    break;
+
+                m_consumerIdle.store(true, std::memory_order_release);
+                m_wake.wait_for(lock, IdleWait, [&] { return m_stop || m_flushRequested; });
+                m_consumerIdle.store(false, std::memory_order_relaxed);
+                m_flushRequested = false;
             }
+
+            m_file.close();
         }
 
-        // Flush final folded block if still active
-        if (inSystemBlock)
+        void Write(std::wstring const& text)
         {
-            ss << L"  |->> [Folded] " << collapsedCount
-                << L" system frame(s) from " << collapsedModule
-                << L" + 0x" << std::hex << (firstSystemAddr - (DWORD64)modInfo.lpBaseOfDll) << std::dec << L"\n";
+#ifdef _DEBUG
+            OutputDebugStringW(text.c_str());
+#else
+            auto bytes = narrow(text);
+            // 先打开：m_fileBytes 由 Open() 取自已有文件的大小，滚动判断才能覆盖进程启动前写入的内容
+            if (!m_file.is_open())
+                Open();
+            if (m_fileBytes > 0 && m_fileBytes + bytes.size() > MVVM_LOG_MAX_BYTES)
+                Rotate();
+
+            m_file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            m_file.flush();
+            m_fileBytes += bytes.size();
+#endif
         }
 
-        SymCleanup(process);
-        return ss.str();
+        void Open()
+        {
+            std::filesystem::path path{ MVVM_LOG_FILE };
+            m_file.open(path, std::ios::binary | std::ios::app);
+
+            std::error_code ec;
+            auto size = std::filesystem::file_size(path, ec);
+            m_fileBytes = ec ? 0 : static_cast<size_t>(size);
+        }
+
+        // mvvm_log.txt -> mvvm_log.1.txt -> ... -> mvvm_log.N.txt（最旧的被删除）
+        void Rotate()
+        {
+            m_file.close();
+
+            std::error_code ec;
+            std::filesystem::path base{ MVVM_LOG_FILE };
+            auto backup = [&](int i)
+                {
+                    auto p = base;
+                    p.replace_extension(L"." + std::to_wstring(i) + base.extension().wstring());
+                    return p;
+                };
+
+            if constexpr (MVVM_LOG_MAX_BACKUPS > 0)
+            {
+                std::filesystem::remove(backup(MVVM_LOG_MAX_BACKUPS), ec);
+                for (int i = MVVM_LOG_MAX_BACKUPS - 1; i > 0; --i)
+                    std::filesystem::rename(backup(i), backup(i + 1), ec);
+                std::filesystem::rename(base, backup(1), ec);
+            }
+            else
+            {
+                std::filesystem::remove(base, ec);
+            }
+
+            Open();
+        }
+
+        MpscRingBuffer<LogRecord> m_queue{ MVVM_LOG_QUEUE_CAPACITY };
+        std::atomic<uint64_t>     m_enqueued{ 0 };
+        std::atomic<uint64_t>     m_written{ 0 };
+        std::atomic<uint64_t>     m_dropped{ 0 };
+        std::atomic<uint64_t>     m_totalDropped{ 0 };
+        std::atomic<bool>         m_consumerIdle{ false };
+
+        std::mutex                m_mutex;
+        std::condition_variable   m_wake;
+        std::condition_variable   m_flushed;
+        bool                      m_stop{ false };
+        bool                      m_flushRequested{ false };
+
+        // 仅后台线程访问
+        std::ofstream             m_file;
+        size_t                    m_fileBytes{ 0 };
+
+        std::thread               m_thread;
+    };
+
+    // 写出一段已格式化的文本
+    inline void OutputLog(std::wstring_view text)
+    {
+        LogRecord record;
+        record.SetPayload(text);
+        AsyncLogger::Instance().Enqueue(std::move(record));
     }
 
-    inline void OutputLog(std::wstring const& text)
+    inline void SubmitLogRecord(LogRecord&& record)
     {
-#ifdef _DEBUG
-        OutputDebugStringW(text.c_str());
-#else
-        std::wofstream file(L"mvvm_log.txt", std::ios::app);
-        file << text;
-#endif
+        auto level = record.level;
+        auto& logger = AsyncLogger::Instance();
+        logger.Enqueue(std::move(record));
+
+        if (level == LogLevel::Fatal)
+        {
+            logger.Flush();
+            if (IsDebuggerPresent())
+            {
+                __debugbreak();
+            }
+        }
     }
 
+    // file/function 须为静态字符串（宏传入 __FILE__ / __FUNCTION__），在后台线程才宽化
     inline void LogMessage(
         LogLevel level,
         std::wstring_view message,
-        std::wstring_view file,
-        std::wstring_view function,
+        const char* file,
+        const char* function,
         int line,
         bool includeStack = false)
     {
-        std::wstringstream ss;
-        ss << L"[" << ToString(level) << L"] "
-            << CurrentTimestamp() << L" | "
-            << file << L":" << line << L" (" << function << L")\n"
-            << L"|-> " << message << L"\n";
+        LogRecord record;
+        record.level = level;
+        record.line = line;
+        record.fileTime = NowFileTime();
+        record.file = file;
+        record.function = function;
+        record.SetPayload(message);
 
         if (includeStack)
         {
-            ss << CaptureStackTrace();
+            record.stack = std::make_unique<StackCapture>(CaptureStack(1));
         }
 
-        ss << L"\n";
-
-        OutputLog(ss.str());
-
-        if (level == LogLevel::Fatal && IsDebuggerPresent())
-        {
-            __debugbreak();
-        }
+        SubmitLogRecord(std::move(record));
     }
 
-    // Convenience Macros
-
-    template <size_t N>
-    constexpr const char* FilenameFromPath(const char(&path)[N])
+    // 只有一个参数时视为完整消息，不做格式化
+    inline void LogFormat(LogLevel level, const char* file, const char* function, int line, bool includeStack,
+        std::wstring_view message)
     {
-        static_assert(N > 1, "FilenameFromPath requires non-empty path");
-        const char* last = path;
-        for (size_t i = 0; i < N; ++i)
-        {
-            if (path[i] == '/' || path[i] == '\\')
-                last = &path[i + 1];
-            if (path[i] == '\0') break;
-        }
-        return last;
+        LogMessage(level, message, file, function, line, includeStack);
     }
 
-#define __MVVM_FILENAME__ ::mvvm::diagnostics::FilenameFromPath(__FILE__)
-
-#ifdef MVVM_LOG_VERBOSE
-
-#define MVVM_LOG(level, msg) \
-    do { \
-        ::mvvm::diagnostics::LogMessage(level, msg, \
-            ::mvvm::diagnostics::widen(__MVVM_FILENAME__), \
-            ::mvvm::diagnostics::widen(__FUNCTION__), __LINE__); \
-    } while(false)
+    template <typename... Args>
+        requires (sizeof...(Args) > 0)
+    inline void LogFormat(LogLevel level, const char* file, const char* function, int line, bool includeStack,
+        std::wformat_string<Args...> format, Args&&... args)
+    {
+        LogRecord record;
+        record.level = level;
+        record.line = line;
+        record.fileTime = NowFileTime();
+        record.file = file;
+        record.function = function;
 
-#define MVVM_LOG_STACK(level, msg) \
-    do { \
-        ::mvvm::diagnostics::LogMessage(level, msg, \
-            ::mvvm::diagnostics::widen(__MVVM_FILENAME__), \
-            ::mvvm::diagnostics::widen(__FUNCTION__), __LINE__, true); \
-    } while(false)
+        record.FormatPayload(format, std::forward<Args>(args)...);
 
-#else
+        if (includeStack)
+        {
+            record.stack = std::make_unique<StackCapture>(CaptureStack(1));
+        }
 
-#define MVVM_LOG(level, msg) \
-    do { \
-        if constexpr (level != ::mvvm::diagnostics::LogLevel::Info) { \
-            ::mvvm::diagnostics::LogMessage(level, msg, \
-                ::mvvm::diagnostics::widen(__MVVM_FILENAME__), \
-                ::mvvm::diagnostics::widen(__FUNCTION__), __LINE__); \
-        } \
-    } while(false)
+        SubmitLogRecord(std::move(record));
+    }
 
-#define MVVM_LOG_STACK(level, msg) \
+// msg 只求值一次：先绑定到局部引用，日志与异常共用（临时对象的生存期随引用延长）
+#define MVVM_THROW_AT(subsystem, ex_type, msg) \
     do { \
-        if constexpr (level != ::mvvm::diagnostics::LogLevel::Info) { \
-            ::mvvm::diagnostics::LogMessage(level, msg, \
-                ::mvvm::diagnostics::widen(__MVVM_FILENAME__), \
-                ::mvvm::diagnostics::widen(__FUNCTION__), __LINE__, true); \
-        } \
+        auto const& mvvm_throw_message_ = (msg); \
+        MVVM_LOG_AT(subsystem, ::mvvm::diagnostics::LogLevel::Fatal, true, mvvm_throw_message_); \
+        throw ::mvvm::exceptions::ex_type{ ::mvvm::diagnostics::narrow(mvvm_throw_message_) };  \
     } while(false)
 
-#endif
-
-#define MVVM_WARN(msg)    MVVM_LOG(::mvvm::diagnostics::LogLevel::Warning, msg)
-#define MVVM_ERROR(msg)   MVVM_LOG(::mvvm::diagnostics::LogLevel::Error, msg)
-#define MVVM_FATAL(msg)   MVVM_LOG(::mvvm::diagnostics::LogLevel::Fatal, msg)
-
-#ifndef MVVM_LOG_VERBOSE
-#define MVVM_INFO(msg)    ((void)0)
-#else
-#define MVVM_INFO(msg)    MVVM_LOG(::mvvm::diagnostics::LogLevel::Info, msg)
-#endif
-    
 #define MVVM_THROW(ex_type, msg) \
-    do { \
-        MVVM_LOG_STACK(::mvvm::diagnostics::LogLevel::Fatal, msg); \
-        throw ::mvvm::exceptions::ex_type{ ::mvvm::diagnostics::narrow(msg) };  \
-    } while(false)
+    MVVM_THROW_AT(::mvvm::diagnostics::LogSubsystem::General, ex_type, msg)
+
+// 指定子系统：MVVM_THROWS(Commands, invalid_object, L"...")
+#define MVVM_THROWS(subsystem, ex_type, msg) \
+    MVVM_THROW_AT(::mvvm::diagnostics::LogSubsystem::subsystem, ex_type, msg)
 
 } // namespace mvvm::diagnostics
@@ -0,0 +1,187 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 日志级别、子系统与两层阈值，以及日志点宏。
+// 本文件不依赖平台 API，可脱离 Windows 单独编译；宏展开处调用的 ::mvvm::diagnostics::LogFormat
+// 由 mvvm_diagnostics.h 提供。
+
+namespace mvvm::diagnostics
+{
+    enum class LogLevel
+    {
+        Info,
+        Warning,
+        Error,
+        Fatal,
+        Off         // 仅用作阈值：关闭全部日志
+    };
+
+    inline const wchar_t* ToString(LogLevel level)
+    {
+        switch (level)
+        {
+        case LogLevel::Info: return L"INFO";
+        case LogLevel::Warning: return L"WARNING";
+        case LogLevel::Error: return L"ERROR";
+        case LogLevel::Fatal: return L"FATAL";
+        case LogLevel::Off: return L"OFF";
+        default: return L"UNKNOWN";
+        }
+    }
+
+    // 日志按子系统分级过滤，分两层：
+    //   编译期阈值  MVVM_LOG_LEVEL / MVVM_LOG_LEVEL_<子系统>（0=Info 1=Warning 2=Error 3=Fatal 4=Off），
+    //              低于阈值的日志点不生成任何代码，参数表达式也不会被求值；
+    //   运行期阈值  SetLogThreshold()，在求值参数和格式化之前检查，关闭时只有一次 relaxed 读取和一次分支。
+    // 运行期阈值只能在编译期阈值之上进一步收紧。
+    enum class LogSubsystem : uint8_t
+    {
+        General,
+        Commands,
+        Properties,
+        Validation,
+        GraphPanel,
+        WindowHooks,
+        Count
+    };
+
+    inline const wchar_t* ToString(LogSubsystem subsystem)
+    {
+        switch (subsystem)
+        {
+        case LogSubsystem::General: return L"General";
+        case LogSubsystem::Commands: return L"Commands";
+        case LogSubsystem::Properties: return L"Properties";
+        case LogSubsystem::Validation: return L"Validation";
+        case LogSubsystem::GraphPanel: return L"GraphPanel";
+        case LogSubsystem::WindowHooks: return L"WindowHooks";
+        default: return L"UNKNOWN";
+        }
+    }
+
+#ifndef MVVM_LOG_LEVEL
+#ifdef MVVM_LOG_VERBOSE
+#define MVVM_LOG_LEVEL 0
+#else
+#define MVVM_LOG_LEVEL 1
+#endif
+#endif
+#ifndef MVVM_LOG_LEVEL_COMMANDS
+#define MVVM_LOG_LEVEL_COMMANDS MVVM_LOG_LEVEL
+#endif
+#ifndef MVVM_LOG_LEVEL_PROPERTIES
+#define MVVM_LOG_LEVEL_PROPERTIES MVVM_LOG_LEVEL
+#endif
+#ifndef MVVM_LOG_LEVEL_VALIDATION
+#define MVVM_LOG_LEVEL_VALIDATION MVVM_LOG_LEVEL
+#endif
+#ifndef MVVM_LOG_LEVEL_GRAPH_PANEL
+#define MVVM_LOG_LEVEL_GRAPH_PANEL MVVM_LOG_LEVEL
+#endif
+#ifndef MVVM_LOG_LEVEL_WINDOW_HOOKS
+#define MVVM_LOG_LEVEL_WINDOW_HOOKS MVVM_LOG_LEVEL
+#endif
+
+    constexpr LogLevel CompiledLogThreshold(LogSubsystem subsystem) noexcept
+    {
+        int level = MVVM_LOG_LEVEL;
+        switch (subsystem)
+        {
+        case LogSubsystem::Commands: level = MVVM_LOG_LEVEL_COMMANDS; break;
+        case LogSubsystem::Properties: level = MVVM_LOG_LEVEL_PROPERTIES; break;
+        case LogSubsystem::Validation: level = MVVM_LOG_LEVEL_VALIDATION; break;
+        case LogSubsystem::GraphPanel: level = MVVM_LOG_LEVEL_GRAPH_PANEL; break;
+        case LogSubsystem::WindowHooks: level = MVVM_LOG_LEVEL_WINDOW_HOOKS; break;
+        default: break;
+        }
+        return level < 0 ? LogLevel::Info : level > 4 ? LogLevel::Off : static_cast<LogLevel>(level);
+    }
+
+    constexpr bool IsLogCompiledIn(LogSubsystem subsystem, LogLevel level) noexcept
+    {
+        return level != LogLevel::Off && level >= CompiledLogThreshold(subsystem);
+    }
+
+    namespace details
+    {
+        // 常量初始化，访问时没有静态局部变量的初始化检查
+        inline std::atomic<uint8_t> g_logThresholds[static_cast<size_t>(LogSubsystem::Count)] = {
+            static_cast<uint8_t>(CompiledLogThreshold(LogSubsystem::General)),
+            static_cast<uint8_t>(CompiledLogThreshold(LogSubsystem::Commands)),
+            static_cast<uint8_t>(CompiledLogThreshold(LogSubsystem::Properties)),
+            static_cast<uint8_t>(CompiledLogThreshold(LogSubsystem::Validation)),
+            static_cast<uint8_t>(CompiledLogThreshold(LogSubsystem::GraphPanel)),
+            static_cast<uint8_t>(CompiledLogThreshold(LogSubsystem::WindowHooks)),
+        };
+    }
+
+    inline bool IsLogEnabled(LogSubsystem subsystem, LogLevel level) noexcept
+    {
+        return static_cast<uint8_t>(level)
+            >= details::g_logThresholds[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed);
+    }
+
+    inline LogLevel GetLogThreshold(LogSubsystem subsystem) noexcept
+    {
+        return static_cast<LogLevel>(details::g_logThresholds[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed));
+    }
+
+    inline void SetLogThreshold(LogSubsystem subsystem, LogLevel level) noexcept
+    {
+        details::g_logThresholds[static_cast<size_t>(subsystem)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    inline void SetLogThreshold(LogLevel level) noexcept
+    {
+        for (auto& threshold : details::g_logThresholds)
+            threshold.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    // Convenience Macros
+
+    template <size_t N>
+    constexpr const char* FilenameFromPath(const char(&path)[N])
+    {
+        static_assert(N > 1, "FilenameFromPath requires non-empty path");
+        const char* last = path;
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (path[i] == '/' || path[i] == '\\')
+                last = &path[i + 1];
+            if (path[i] == '\0') break;
+        }
+        return last;
+    }
+
+#define __MVVM_FILENAME__ ::mvvm::diagnostics::FilenameFromPath(__FILE__)
+
+// 禁用的日志点：编译期丢弃，或运行期一次分支跳过；参数只在启用时求值。
+// 用法：MVVM_WARN(L"message") 或 MVVM_WARN(L"value {} of {}", value, name)
+#define MVVM_LOG_AT(subsystem, level, includeStack, ...) \
+    do { \
+        if constexpr (::mvvm::diagnostics::IsLogCompiledIn(subsystem, level)) { \
+            if (::mvvm::diagnostics::IsLogEnabled(subsystem, level)) [[unlikely]] { \
+                ::mvvm::diagnostics::LogFormat(level, \
+                    __MVVM_FILENAME__, __FUNCTION__, __LINE__, includeStack, __VA_ARGS__); \
+            } \
+        } \
+    } while(false)
+
+#define MVVM_LOG(level, ...) \
+    MVVM_LOG_AT(::mvvm::diagnostics::LogSubsystem::General, level, false, __VA_ARGS__)
+
+#define MVVM_LOG_STACK(level, ...) \
+    MVVM_LOG_AT(::mvvm::diagnostics::LogSubsystem::General, level, true, __VA_ARGS__)
+
+// 指定子系统：MVVM_LOGS(Commands, Warning, L"...", ...)
+#define MVVM_LOGS(subsystem, level, ...) \
+    MVVM_LOG_AT(::mvvm::diagnostics::LogSubsystem::subsystem, ::mvvm::diagnostics::LogLevel::level, false, __VA_ARGS__)
+
+#define MVVM_INFO(...)    MVVM_LOG(::mvvm::diagnostics::LogLevel::Info, __VA_ARGS__)
+#define MVVM_WARN(...)    MVVM_LOG(::mvvm::diagnostics::LogLevel::Warning, __VA_ARGS__)
+#define MVVM_ERROR(...)   MVVM_LOG(::mvvm::diagnostics::LogLevel::Error, __VA_ARGS__)
+#define MVVM_FATAL(...)   MVVM_LOG(::mvvm::diagnostics::LogLevel::Fatal, __VA_ARGS__)
+
+} // namespace mvvm::diagnostics
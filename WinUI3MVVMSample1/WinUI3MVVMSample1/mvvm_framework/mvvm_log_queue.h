@@ -0,0 +1,94 @@
+﻿#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace mvvm::diagnostics
+{
+    // 有界无锁 MPSC 环形队列（基于 Vyukov bounded queue）。
+    // 生产者：TryPush 不加锁、不分配内存、不阻塞；队列满时立即返回 false，由调用方计数丢弃。
+    //         CAS 重试次数只受同时入队的生产者数量约束，因此调用线程（通常是 UI 线程）的开销有上界。
+    // 消费者：TryPop 只允许单线程调用（日志后台线程）。
+    // 本文件不依赖平台 API，可脱离 Windows 单独编译。
+    template <typename T>
+    class MpscRingBuffer
+    {
+    public:
+        // capacity 向上取整为 2 的幂
+        explicit MpscRingBuffer(size_t capacity)
+            : m_mask(std::bit_ceil(capacity < 2 ? size_t{ 2 } : capacity) - 1),
+              m_cells(std::make_unique<Cell[]>(m_mask + 1))
+        {
+            for (size_t i = 0; i <= m_mask; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscRingBuffer(MpscRingBuffer const&) = delete;
+        MpscRingBuffer& operator=(MpscRingBuffer const&) = delete;
+
+        size_t Capacity() const noexcept { return m_mask + 1; }
+
+        bool TryPush(T&& value) noexcept
+        {
+            Cell* cell;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // 满
+                }
+                else
+                {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 仅限消费者线程
+        bool TryPop(T& out) noexcept
+        {
+            Cell& cell = m_cells[m_dequeuePos & m_mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(m_dequeuePos + 1) < 0)
+                return false; // 空，或生产者尚未写完
+
+            out = std::move(cell.value);
+            cell.value = T{};
+            cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+            ++m_dequeuePos;
+            return true;
+        }
+
+    private:
+        static constexpr size_t CacheLine = 64;
+
+        struct alignas(CacheLine) Cell
+        {
+            std::atomic<size_t> sequence{ 0 };
+            T value{};
+        };
+
+        size_t const m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+
+        alignas(CacheLine) std::atomic<size_t> m_enqueuePos{ 0 };
+        alignas(CacheLine) size_t m_dequeuePos{ 0 };
+    };
+}
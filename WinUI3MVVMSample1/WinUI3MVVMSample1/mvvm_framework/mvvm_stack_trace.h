@@ -0,0 +1,374 @@
+﻿#pragma once
+#include <cstdint>
+#include <cwctype>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <DbgHelp.h>
+#pragma comment(lib, "Dbghelp.lib")
+#else
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <cstdlib>
+#endif
+
+// 调用栈的采集与符号化分离：
+//   CaptureStack()      只记录返回地址和所在模块基址，开销为微秒级，可在任何线程调用；
+//   FormatStackTrace()  延迟符号化（通常在日志后台线程），使用进程生命周期内只初始化一次的符号处理器，
+//                       并以 地址 -> 符号 的 LRU 缓存避免重复解析。
+// 非 Windows 平台使用 backtrace/dladdr，便于脱离 Windows 验证缓存层。
+namespace mvvm::diagnostics
+{
+    // 非线程安全，由调用方加锁
+    template <typename Key, typename Value>
+    class LruCache
+    {
+    public:
+        explicit LruCache(size_t capacity) : m_capacity(capacity ? capacity : 1) {}
+
+        Value const* Find(Key const& key)
+        {
+            auto it = m_index.find(key);
+            if (it == m_index.end())
+                return nullptr;
+
+            m_items.splice(m_items.begin(), m_items, it->second);
+            return &it->second->second;
+        }
+
+        void Insert(Key const& key, Value value)
+        {
+            if (auto it = m_index.find(key); it != m_index.end())
+            {
+                it->second->second = std::move(value);
+                m_items.splice(m_items.begin(), m_items, it->second);
+                return;
+            }
+
+            if (m_items.size() >= m_capacity)
+            {
+                m_index.erase(m_items.back().first);
+                m_items.pop_back();
+            }
+            m_items.emplace_front(key, std::move(value));
+            m_index.emplace(key, m_items.begin());
+        }
+
+        size_t Size() const noexcept { return m_items.size(); }
+        size_t Capacity() const noexcept { return m_capacity; }
+
+    private:
+        size_t m_capacity;
+        std::list<std::pair<Key, Value>> m_items;
+        std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator> m_index;
+    };
+
+    struct StackFrame
+    {
+        uintptr_t pc{ 0 };
+        uintptr_t moduleBase{ 0 };   // 0 表示采集时未解析，符号化时再补
+    };
+
+    struct StackCapture
+    {
+        static constexpr size_t MaxFrames = 30;
+
+        std::vector<StackFrame> frames;
+
+        bool empty() const noexcept { return frames.empty(); }
+    };
+
+    // skip 为需要跳过的调用者帧数（不含 CaptureStack 自身）
+    inline StackCapture CaptureStack(unsigned skip = 0)
+    {
+        StackCapture capture;
+
+#ifdef _WIN32
+        void* stack[StackCapture::MaxFrames];
+        USHORT count = RtlCaptureStackBackTrace(static_cast<DWORD>(skip + 1),
+            static_cast<DWORD>(StackCapture::MaxFrames), stack, nullptr);
+
+        capture.frames.reserve(count);
+        for (USHORT i = 0; i < count; ++i)
+        {
+            void* base = nullptr;
+            RtlPcToFileHeader(stack[i], &base);
+            capture.frames.push_back({ reinterpret_cast<uintptr_t>(stack[i]), reinterpret_cast<uintptr_t>(base) });
+        }
+#else
+        void* raw[StackCapture::MaxFrames + 8];
+        int count = backtrace(raw, static_cast<int>(std::size(raw)));
+        int first = static_cast<int>(skip) + 1;
+
+        capture.frames.reserve(count > first ? count - first : 0);
+        for (int i = first; i < count && capture.frames.size() < StackCapture::MaxFrames; ++i)
+        {
+            capture.frames.push_back({ reinterpret_cast<uintptr_t>(raw[i]), 0 });
+        }
+#endif
+        return capture;
+    }
+
+    struct ResolvedFrame
+    {
+        std::wstring module;
+        uintptr_t    rva{ 0 };
+        std::wstring symbol;        // 为空表示未能解析
+        std::wstring sourceFile;
+        uint32_t     sourceLine{ 0 };
+        bool         isSystem{ false };
+    };
+
+    class Symbolizer
+    {
+    public:
+        static constexpr size_t DefaultCacheCapacity = 2048;
+
+        static Symbolizer& Instance()
+        {
+            static Symbolizer symbolizer;
+            return symbolizer;
+        }
+
+        Symbolizer(Symbolizer const&) = delete;
+        Symbolizer& operator=(Symbolizer const&) = delete;
+
+        ResolvedFrame Resolve(StackFrame const& frame)
+        {
+            std::scoped_lock lock{ m_mutex }; // DbgHelp 不是线程安全的
+            if (auto hit = m_cache.Find(frame.pc))
+            {
+                ++m_hits;
+                return *hit;
+            }
+
+            ++m_misses;
+            auto resolved = ResolveUncached(frame);
+            m_cache.Insert(frame.pc, resolved);
+            return resolved;
+        }
+
+        uint64_t CacheHits() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return m_hits;
+        }
+
+        uint64_t CacheMisses() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return m_misses;
+        }
+
+    private:
+        Symbolizer()
+        {
+#ifdef _WIN32
+            m_process = GetCurrentProcess();
+            SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+            m_initialized = SymInitialize(m_process, nullptr, TRUE) != FALSE;
+#endif
+        }
+
+        ~Symbolizer()
+        {
+#ifdef _WIN32
+            if (m_initialized)
+                SymCleanup(m_process);
+#endif
+        }
+
+        static bool IsSystemModule(std::wstring_view name)
+        {
+#ifdef _WIN32
+            constexpr std::wstring_view systemModules[] = { L"kernel32.dll", L"kernelbase.dll", L"ntdll.dll" };
+#else
+            constexpr std::wstring_view systemModules[] = { L"libc.so.6", L"libstdc++.so.6", L"ld-linux-x86-64.so.2" };
+#endif
+            for (auto sys : systemModules)
+            {
+                if (sys.size() != name.size())
+                    continue;
+
+                bool equal = true;
+                for (size_t i = 0; i < sys.size() && equal; ++i)
+                    equal = std::towlower(sys[i]) == std::towlower(name[i]);
+                if (equal)
+                    return true;
+            }
+            return false;
+        }
+
+        static std::wstring FileNameOf(std::wstring path)
+        {
+            auto pos = path.find_last_of(L"\\/");
+            return pos == std::wstring::npos ? path : path.substr(pos + 1);
+        }
+
+#ifdef _WIN32
+        std::wstring const& ModuleName(uintptr_t base)
+        {
+            auto it = m_modules.find(base);
+            if (it != m_modules.end())
+                return it->second;
+
+            WCHAR path[MAX_PATH] = {};
+            std::wstring name;
+            if (base && GetModuleFileNameW(reinterpret_cast<HMODULE>(base), path, MAX_PATH))
+                name = FileNameOf(path);
+            return m_modules.emplace(base, std::move(name)).first->second;
+        }
+
+        ResolvedFrame ResolveUncached(StackFrame const& frame)
+        {
+            ResolvedFrame out;
+            uintptr_t base = frame.moduleBase;
+            if (!base)
+            {
+                void* b = nullptr;
+                RtlPcToFileHeader(reinterpret_cast<void*>(frame.pc), &b);
+                base = reinterpret_cast<uintptr_t>(b);
+            }
+
+            out.module = ModuleName(base);
+            out.rva = base ? frame.pc - base : frame.pc;
+            out.isSystem = IsSystemModule(out.module);
+            if (out.isSystem || !m_initialized)
+                return out;
+
+            BYTE buffer[sizeof(SYMBOL_INFOW) + MAX_SYM_NAME * sizeof(WCHAR)]{};
+            auto symbol = reinterpret_cast<PSYMBOL_INFOW>(buffer);
+            symbol->SizeOfStruct = sizeof(SYMBOL_INFOW);
+            symbol->MaxNameLen = MAX_SYM_NAME;
+
+            DWORD64 displacement = 0;
+            BOOL found = SymFromAddrW(m_process, frame.pc, &displacement, symbol);
+            if (!found && !m_refreshedModules)
+            {
+                // 初始化之后才加载的模块需要刷新一次模块列表
+                m_refreshedModules = true;
+                SymRefreshModuleList(m_process);
+                found = SymFromAddrW(m_process, frame.pc, &displacement, symbol);
+            }
+            if (found)
+                out.symbol.assign(symbol->Name, symbol->NameLen);
+
+#ifdef MVVM_TRACE_WITH_SOURCE
+            IMAGEHLP_LINEW64 line{};
+            line.SizeOfStruct = sizeof(IMAGEHLP_LINEW64);
+            DWORD lineDisplacement = 0;
+            if (SymGetLineFromAddrW64(m_process, frame.pc, &lineDisplacement, &line))
+            {
+                out.sourceFile = line.FileName;
+                out.sourceLine = line.LineNumber;
+            }
+#endif
+            return out;
+        }
+#else
+        static std::wstring Widen(char const* s)
+        {
+            std::wstring out;
+            if (s)
+                for (; *s; ++s) out.push_back(static_cast<wchar_t>(static_cast<unsigned char>(*s)));
+            return out;
+        }
+
+        ResolvedFrame ResolveUncached(StackFrame const& frame)
+        {
+            ResolvedFrame out;
+            Dl_info info{};
+            if (!dladdr(reinterpret_cast<void*>(frame.pc), &info))
+            {
+                out.rva = frame.pc;
+                return out;
+            }
+
+            auto base = reinterpret_cast<uintptr_t>(info.dli_fbase);
+            out.module = FileNameOf(Widen(info.dli_fname));
+            out.rva = frame.pc - base;
+            out.isSystem = IsSystemModule(out.module);
+            if (out.isSystem || !info.dli_sname)
+                return out;
+
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            out.symbol = Widen(status == 0 && demangled ? demangled : info.dli_sname);
+            std::free(demangled);
+            return out;
+        }
+#endif
+
+        mutable std::mutex m_mutex;
+        LruCache<uintptr_t, ResolvedFrame> m_cache{ DefaultCacheCapacity };
+        uint64_t m_hits{ 0 };
+        uint64_t m_misses{ 0 };
+
+#ifdef _WIN32
+        HANDLE m_process{ nullptr };
+        bool   m_initialized{ false };
+        bool   m_refreshedModules{ false };
+        std::unordered_map<uintptr_t, std::wstring> m_modules;
+#endif
+    };
+
+    // 连续的系统模块帧折叠为一行
+    inline std::wstring FormatStackTrace(StackCapture const& capture)
+    {
+        std::wstringstream ss;
+        ss << L"Stack Trace:\n";
+
+        auto& symbolizer = Symbolizer::Instance();
+
+        std::optional<ResolvedFrame> folded;
+        size_t foldedCount = 0;
+        auto flushFolded = [&]
+            {
+                if (!folded) return;
+                ss << L"  |->> [Folded] " << foldedCount
+                    << L" system frame(s) from " << folded->module
+                    << L" + 0x" << std::hex << folded->rva << std::dec << L"\n";
+                folded.reset();
+                foldedCount = 0;
+            };
+
+        for (size_t i = 0; i < capture.frames.size(); ++i)
+        {
+            auto frame = symbolizer.Resolve(capture.frames[i]);
+            if (frame.module.empty())
+                continue;
+
+            if (frame.isSystem)
+            {
+                if (!folded)
+                    folded = std::move(frame);
+                ++foldedCount;
+                continue;
+            }
+
+            flushFolded();
+
+            ss << L"[" << i << L"] " << frame.module
+                << L" + 0x" << std::hex << frame.rva << std::dec;
+            if (!frame.symbol.empty())
+                ss << L" (" << frame.symbol << L")";
+            if (!frame.sourceFile.empty())
+                ss << L" [" << frame.sourceFile << L":" << frame.sourceLine << L"]";
+            ss << L"\n";
+        }
+
+        flushFolded();
+        return ss.str();
+    }
+}
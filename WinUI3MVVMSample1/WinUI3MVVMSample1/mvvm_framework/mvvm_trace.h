@@ -0,0 +1,597 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// 结构化二进制跟踪（MVVM_TRACE 定义时启用，未定义时所有 MVVM_TRACE_* 宏展开为空）。
+//
+// 记录属性设置、依赖广播、命令 CanExecute/Execute、校验与调度器切换。
+// 每条事件为 32 字节定长记录，名称以驻留字符串 ID 引用；文件按固定大小分块，
+// 通过内存映射逐块写入。离线转换见 mvvm_trace_reader.h（Chrome trace JSON / Perfetto）。
+//
+// 文件布局：
+//   块 0 : TraceFileHeader | TraceChunkHeader | 载荷
+//   块 n : TraceChunkHeader | 载荷
+//   事件块载荷为连续的 TraceEvent；字符串块载荷为 { uint32 id; uint32 length; char utf8[length]; } 按 4 字节对齐。
+//   事件块与字符串块各自同时映射一个，写满后在文件末尾另起一块，两种块在文件中交错出现。
+//   驻留字符串在首次引用时、写出引用它的事件之前写入字符串块，进程崩溃后事件与名称都可读出。
+// 本文件不依赖 WinRT，可在 Linux 上编译。
+namespace mvvm::trace
+{
+    enum class EventKind : uint8_t
+    {
+        PropertySet   = 1,
+        Broadcast     = 2,
+        CanExecute    = 3,
+        Execute       = 4,
+        Validate      = 5,
+        DispatcherHop = 6,
+        Marker        = 7,
+    };
+
+    enum class Phase : uint8_t
+    {
+        Complete = 'X',   // 带持续时间
+        Instant  = 'i',
+        FlowOut  = 's',   // 调度器入队
+        FlowIn   = 'f',   // 调度器执行
+    };
+
+    inline constexpr const char* ToString(EventKind kind) noexcept
+    {
+        switch (kind)
+        {
+        case EventKind::PropertySet:   return "PropertySet";
+        case EventKind::Broadcast:     return "Broadcast";
+        case EventKind::CanExecute:    return "CanExecute";
+        case EventKind::Execute:       return "Execute";
+        case EventKind::Validate:      return "Validate";
+        case EventKind::DispatcherHop: return "DispatcherHop";
+        case EventKind::Marker:        return "Marker";
+        default:                       return "Unknown";
+        }
+    }
+
+    struct TraceEvent
+    {
+        uint64_t  timestampNs{ 0 };     // 相对 Start() 的时间
+        uint64_t  durationNs{ 0 };      // 仅 Complete
+        uint32_t  threadId{ 0 };
+        uint32_t  nameId{ 0 };          // 驻留字符串 ID（0 保留为空名称）
+        uint32_t  arg{ 0 };             // 按事件类型：是否变化 / 广播扇出 / 错误数 / 结果 / 流 ID
+        EventKind kind{ EventKind::Marker };
+        Phase     phase{ Phase::Instant };
+        uint16_t  reserved{ 0 };
+    };
+    static_assert(sizeof(TraceEvent) == 32, "TraceEvent must stay 32 bytes");
+
+    inline constexpr char     TraceFileMagic[8]   = { 'M', 'V', 'V', 'M', 'T', 'R', 'C', '1' };
+    inline constexpr uint32_t TraceFileVersion    = 1;
+    inline constexpr uint32_t TraceChunkMagic     = 0x4B4E4843; // "CHNK"
+    inline constexpr size_t   TraceChunkAlignment = 64 * 1024;  // Windows 映射粒度
+    inline constexpr size_t   DefaultTraceChunkSize = 1024 * 1024;
+
+    enum class ChunkType : uint32_t
+    {
+        Events  = 1,
+        Strings = 2,
+    };
+
+    struct TraceFileHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t chunkSize;
+        uint64_t startUnixNs;           // Start() 时的系统时间
+        uint64_t reserved;
+    };
+    static_assert(sizeof(TraceFileHeader) == 32);
+
+    struct TraceChunkHeader
+    {
+        uint32_t  magic;
+        ChunkType type;
+        uint32_t  usedBytes;            // 载荷中已写入的字节数（每次写入后更新，进程崩溃时已写事件仍可读）
+        uint32_t  reserved;
+    };
+    static_assert(sizeof(TraceChunkHeader) == 16);
+
+    inline void AppendUtf8(std::string& out, std::wstring_view text)
+    {
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            uint32_t cp = static_cast<uint32_t>(text[i]);
+            if constexpr (sizeof(wchar_t) == 2)
+            {
+                if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < text.size())
+                {
+                    uint32_t lo = static_cast<uint32_t>(text[i + 1]);
+                    if (lo >= 0xDC00 && lo <= 0xDFFF)
+                    {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        ++i;
+                    }
+                }
+            }
+
+            if (cp < 0x80) out.push_back(static_cast<char>(cp));
+            else if (cp < 0x800)
+            {
+                out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            else if (cp < 0x10000)
+            {
+                out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+        }
+    }
+
+    inline uint32_t CurrentThreadId() noexcept
+    {
+#ifdef _WIN32
+        return static_cast<uint32_t>(GetCurrentThreadId());
+#else
+        static std::atomic<uint32_t> next{ 1 };
+        thread_local uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+        return id;
+#endif
+    }
+
+    // 分块的内存映射文件；每个块单独映射（区域只会向文件末尾追加）
+    class MappedChunkFile
+    {
+    public:
+        MappedChunkFile() = default;
+        MappedChunkFile(MappedChunkFile const&) = delete;
+        MappedChunkFile& operator=(MappedChunkFile const&) = delete;
+        ~MappedChunkFile() { Close(); }
+
+        bool Open(std::filesystem::path const& path)
+        {
+            Close();
+#ifdef _WIN32
+            m_file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                m_file = nullptr;
+                return false;
+            }
+#else
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (m_fd < 0) return false;
+#endif
+            return true;
+        }
+
+        bool IsOpen() const noexcept
+        {
+#ifdef _WIN32
+            return m_file != nullptr;
+#else
+            return m_fd >= 0;
+#endif
+        }
+
+        // 将文件扩展到 offset + size 并映射该区域（offset 必须按 TraceChunkAlignment 对齐）
+        std::byte* Map(uint64_t offset, size_t size)
+        {
+            uint64_t end = offset + size;
+#ifdef _WIN32
+            HANDLE mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE,
+                static_cast<DWORD>(end >> 32), static_cast<DWORD>(end), nullptr);
+            if (!mapping) return nullptr;
+            void* view = MapViewOfFile(mapping, FILE_MAP_WRITE,
+                static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), size);
+            CloseHandle(mapping); // 视图持有映射对象
+            return static_cast<std::byte*>(view);
+#else
+            if (::ftruncate(m_fd, static_cast<off_t>(end)) != 0) return nullptr;
+            void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(offset));
+            return view == MAP_FAILED ? nullptr : static_cast<std::byte*>(view);
+#endif
+        }
+
+        static void Unmap(std::byte* view, size_t size) noexcept
+        {
+            if (!view) return;
+#ifdef _WIN32
+            (void)size;
+            UnmapViewOfFile(view);
+#else
+            ::munmap(view, size);
+#endif
+        }
+
+        void Close() noexcept
+        {
+#ifdef _WIN32
+            if (m_file) CloseHandle(m_file);
+            m_file = nullptr;
+#else
+            if (m_fd >= 0) ::close(m_fd);
+            m_fd = -1;
+#endif
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE m_file{ nullptr };
+#else
+        int m_fd{ -1 };
+#endif
+    };
+
+    class TraceWriter
+    {
+    public:
+        TraceWriter() = default;
+        TraceWriter(TraceWriter const&) = delete;
+        TraceWriter& operator=(TraceWriter const&) = delete;
+        ~TraceWriter() { Close(); }
+
+        bool Open(std::filesystem::path const& path, size_t chunkSize = DefaultTraceChunkSize)
+        {
+            std::scoped_lock lock{ m_mutex };
+            CloseLocked();
+
+            m_chunkSize = (std::max)(TraceChunkAlignment,
+                (chunkSize + TraceChunkAlignment - 1) / TraceChunkAlignment * TraceChunkAlignment);
+            if (!m_file.Open(path))
+                return false;
+
+            m_nextRegion = 0;
+            m_strings.clear();
+            m_wideStrings.clear();
+            m_nextStringId = 1;
+
+            if (!BeginEventsChunk())
+            {
+                m_file.Close();
+                return false;
+            }
+
+            TraceFileHeader header{};
+            std::memcpy(header.magic, TraceFileMagic, sizeof(header.magic));
+            header.version = TraceFileVersion;
+            header.chunkSize = static_cast<uint32_t>(m_chunkSize);
+            header.startUnixNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            std::memcpy(m_view, &header, sizeof(header));
+            return true;
+        }
+
+        void Close()
+        {
+            std::scoped_lock lock{ m_mutex };
+            CloseLocked();
+        }
+
+        bool IsOpen() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return m_view != nullptr;
+        }
+
+        template <typename Name>
+        void Write(TraceEvent e, Name name)
+        {
+            std::scoped_lock lock{ m_mutex };
+            if (!m_view) return;
+
+            e.nameId = InternLocked(name);
+            if (m_chunk->usedBytes + sizeof(TraceEvent) > m_payloadCapacity)
+            {
+                SealEventsChunk();
+                if (!BeginEventsChunk()) return;
+            }
+
+            std::memcpy(m_payload + m_chunk->usedBytes, &e, sizeof(e));
+            m_chunk->usedBytes += sizeof(TraceEvent);
+        }
+
+    private:
+        struct TransparentHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+            size_t operator()(std::wstring_view s) const noexcept { return std::hash<std::wstring_view>{}(s); }
+        };
+
+        uint32_t InternLocked(std::string_view name)
+        {
+            if (name.empty()) return 0;
+            if (auto it = m_strings.find(name); it != m_strings.end())
+                return it->second;
+            auto id = AddString(name);
+            m_strings.emplace(std::string{ name }, id);
+            return id;
+        }
+
+        uint32_t InternLocked(std::wstring_view name)
+        {
+            if (name.empty()) return 0;
+            if (auto it = m_wideStrings.find(name); it != m_wideStrings.end())
+                return it->second;
+
+            std::string utf8;
+            AppendUtf8(utf8, name);
+            uint32_t id;
+            if (auto it = m_strings.find(std::string_view{ utf8 }); it != m_strings.end())
+                id = it->second;
+            else
+            {
+                id = AddString(utf8);
+                m_strings.emplace(utf8, id);
+            }
+            m_wideStrings.emplace(std::wstring{ name }, id);
+            return id;
+        }
+
+        // 立即写入当前字符串块；块映射失败时仍返回 ID，读取端会把该名称显示为 #id
+        uint32_t AddString(std::string_view text)
+        {
+            size_t maxLength = m_chunkSize - sizeof(TraceChunkHeader) - 2 * sizeof(uint32_t);
+            if (text.size() > maxLength) text = text.substr(0, maxLength);
+
+            uint32_t id = m_nextStringId++;
+            uint32_t length = static_cast<uint32_t>(text.size());
+            size_t recordBytes = 2 * sizeof(uint32_t) + ((length + 3) & ~3u);
+            if (!m_stringView || m_stringChunk->usedBytes + recordBytes > m_stringCapacity)
+            {
+                SealStringsChunk();
+                if (!BeginStringsChunk()) return id;
+            }
+
+            auto at = m_stringPayload + m_stringChunk->usedBytes;
+            std::memcpy(at, &id, sizeof(id));
+            std::memcpy(at + sizeof(id), &length, sizeof(length));
+            std::memcpy(at + 2 * sizeof(uint32_t), text.data(), length);
+            m_stringChunk->usedBytes += static_cast<uint32_t>(recordBytes); // 记录写完后再计入
+            return id;
+        }
+
+        bool BeginStringsChunk()
+        {
+            auto region = m_nextRegion++;
+            m_stringView = m_file.Map(static_cast<uint64_t>(region) * m_chunkSize, m_chunkSize);
+            if (!m_stringView) return false;
+
+            m_stringChunk = reinterpret_cast<TraceChunkHeader*>(m_stringView);
+            *m_stringChunk = { TraceChunkMagic, ChunkType::Strings, 0, 0 };
+            m_stringPayload = reinterpret_cast<std::byte*>(m_stringChunk + 1);
+            m_stringCapacity = m_chunkSize - sizeof(TraceChunkHeader);
+            return true;
+        }
+
+        void SealStringsChunk()
+        {
+            MappedChunkFile::Unmap(m_stringView, m_chunkSize);
+            m_stringView = nullptr;
+            m_stringChunk = nullptr;
+            m_stringPayload = nullptr;
+        }
+
+        bool BeginEventsChunk()
+        {
+            auto region = m_nextRegion++;
+            m_view = m_file.Map(static_cast<uint64_t>(region) * m_chunkSize, m_chunkSize);
+            if (!m_view) return false;
+
+            size_t headerBytes = region == 0 ? sizeof(TraceFileHeader) : 0;
+            m_chunk = reinterpret_cast<TraceChunkHeader*>(m_view + headerBytes);
+            *m_chunk = { TraceChunkMagic, ChunkType::Events, 0, 0 };
+            m_payload = reinterpret_cast<std::byte*>(m_chunk + 1);
+            m_payloadCapacity = m_chunkSize - headerBytes - sizeof(TraceChunkHeader);
+            return true;
+        }
+
+        void SealEventsChunk()
+        {
+            MappedChunkFile::Unmap(m_view, m_chunkSize);
+            m_view = nullptr;
+            m_chunk = nullptr;
+            m_payload = nullptr;
+        }
+
+        void CloseLocked()
+        {
+            if (!m_file.IsOpen()) return;
+            if (m_view) SealEventsChunk();
+            if (m_stringView) SealStringsChunk();
+            m_file.Close();
+        }
+
+        mutable std::mutex m_mutex;
+        MappedChunkFile    m_file;
+        size_t             m_chunkSize{ DefaultTraceChunkSize };
+        uint32_t           m_nextRegion{ 0 };
+
+        std::byte*         m_view{ nullptr };
+        TraceChunkHeader*  m_chunk{ nullptr };
+        std::byte*         m_payload{ nullptr };
+        size_t             m_payloadCapacity{ 0 };
+
+        std::byte*         m_stringView{ nullptr };
+        TraceChunkHeader*  m_stringChunk{ nullptr };
+        std::byte*         m_stringPayload{ nullptr };
+        size_t             m_stringCapacity{ 0 };
+
+        std::unordered_map<std::string, uint32_t, TransparentHash, std::equal_to<>>  m_strings;
+        std::unordered_map<std::wstring, uint32_t, TransparentHash, std::equal_to<>> m_wideStrings;
+        uint32_t               m_nextStringId{ 1 };
+    };
+
+    // 进程级跟踪器：Start/Stop 控制是否记录，未启动时每个跟踪点只有一次原子读取
+    class Tracer
+    {
+    public:
+        static Tracer& Instance()
+        {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        bool Start(std::filesystem::path const& path, size_t chunkSize = DefaultTraceChunkSize)
+        {
+            Stop();
+            // 其他线程可能仍在 NowNs() 中读取起点（例如跨越 Stop/Start 的 TraceScope），故为原子量
+            m_originNs.store(SteadyNowNs(), std::memory_order_relaxed);
+            if (!m_writer.Open(path, chunkSize))
+                return false;
+            m_enabled.store(true, std::memory_order_release);
+            return true;
+        }
+
+        void Stop()
+        {
+            m_enabled.store(false, std::memory_order_release);
+            m_writer.Close();
+        }
+
+        bool Enabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+        uint64_t NowNs() const noexcept
+        {
+            return static_cast<uint64_t>(SteadyNowNs() - m_originNs.load(std::memory_order_relaxed));
+        }
+
+        uint32_t NextFlowId() noexcept { return m_nextFlowId.fetch_add(1, std::memory_order_relaxed); }
+
+        template <typename Name>
+        void Emit(EventKind kind, Phase phase, Name name, uint64_t timestampNs, uint64_t durationNs, uint32_t arg)
+        {
+            if (!Enabled()) return;
+
+            TraceEvent e{};
+            e.timestampNs = timestampNs;
+            e.durationNs = durationNs;
+            e.threadId = CurrentThreadId();
+            e.arg = arg;
+            e.kind = kind;
+            e.phase = phase;
+            m_writer.Write(e, name);
+        }
+
+        template <typename Name>
+        void Instant(EventKind kind, Name name, uint32_t arg = 0, Phase phase = Phase::Instant)
+        {
+            if (!Enabled()) return;
+            Emit(kind, phase, name, NowNs(), 0, arg);
+        }
+
+    private:
+        Tracer() = default;
+
+        static int64_t SteadyNowNs() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        std::atomic<bool>     m_enabled{ false };
+        std::atomic<uint32_t> m_nextFlowId{ 1 };
+        std::atomic<int64_t>  m_originNs{ SteadyNowNs() };
+        TraceWriter           m_writer;
+    };
+
+    // 作用域事件：析构时写出一条 Complete 事件；name 须在作用域内保持有效
+    class TraceScope
+    {
+    public:
+        TraceScope(EventKind kind, std::wstring_view name) noexcept
+            : m_kind(kind), m_wideName(name)
+        {
+            Begin();
+        }
+
+        TraceScope(EventKind kind, std::string_view name) noexcept
+            : m_kind(kind), m_name(name)
+        {
+            Begin();
+        }
+
+        TraceScope(TraceScope const&) = delete;
+        TraceScope& operator=(TraceScope const&) = delete;
+
+        ~TraceScope()
+        {
+            if (!m_active) return;
+            try
+            {
+                auto& tracer = Tracer::Instance();
+                auto duration = tracer.NowNs() - m_start;
+                if (!m_wideName.empty())
+                    tracer.Emit(m_kind, Phase::Complete, m_wideName, m_start, duration, m_arg);
+                else
+                    tracer.Emit(m_kind, Phase::Complete, m_name, m_start, duration, m_arg);
+            }
+            catch (...) {}
+        }
+
+        void Arg(uint32_t value) noexcept { m_arg = value; }
+
+    private:
+        void Begin() noexcept
+        {
+            auto& tracer = Tracer::Instance();
+            m_active = tracer.Enabled();
+            if (m_active) m_start = tracer.NowNs();
+        }
+
+        EventKind         m_kind;
+        std::wstring_view m_wideName;
+        std::string_view  m_name;
+        uint64_t          m_start{ 0 };
+        uint32_t          m_arg{ 0 };
+        bool              m_active{ false };
+    };
+}
+
+#ifdef MVVM_TRACE
+#define MVVM_TRACE_SCOPE(var, kind, name) \
+    ::mvvm::trace::TraceScope var{ ::mvvm::trace::EventKind::kind, name }
+#define MVVM_TRACE_ARG(var, value) \
+    var.Arg(static_cast<uint32_t>(value))
+#define MVVM_TRACE_INSTANT(kind, name, arg) \
+    ::mvvm::trace::Tracer::Instance().Instant(::mvvm::trace::EventKind::kind, name, static_cast<uint32_t>(arg))
+#define MVVM_TRACE_FLOW_ID(var) \
+    [[maybe_unused]] uint32_t const var = ::mvvm::trace::Tracer::Instance().NextFlowId()
+#define MVVM_TRACE_FLOW_OUT(kind, name, id) \
+    ::mvvm::trace::Tracer::Instance().Instant(::mvvm::trace::EventKind::kind, name, id, ::mvvm::trace::Phase::FlowOut)
+#define MVVM_TRACE_FLOW_IN(kind, name, id) \
+    ::mvvm::trace::Tracer::Instance().Instant(::mvvm::trace::EventKind::kind, name, id, ::mvvm::trace::Phase::FlowIn)
+#else
+#define MVVM_TRACE_SCOPE(var, kind, name)   ((void)0)
+#define MVVM_TRACE_ARG(var, value)          ((void)0)
+#define MVVM_TRACE_INSTANT(kind, name, arg) ((void)0)
+#define MVVM_TRACE_FLOW_ID(var)             ((void)0)
+#define MVVM_TRACE_FLOW_OUT(kind, name, id) ((void)0)
+#define MVVM_TRACE_FLOW_IN(kind, name, id)  ((void)0)
+#endif
@@ -0,0 +1,187 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mvvm_trace.h"
+
+// mvvm_trace.h 所写跟踪文件的读取与离线转换（Chrome trace JSON，可直接导入 chrome://tracing 或 Perfetto）。
+// 不依赖平台 API。
+namespace mvvm::trace
+{
+    struct TraceFile
+    {
+        TraceFileHeader                           header{};
+        std::unordered_map<uint32_t, std::string> strings;
+        std::vector<TraceEvent>                   events;     // 按时间戳排序
+
+        std::string NameOf(uint32_t id) const
+        {
+            if (id == 0) return {};
+            auto it = strings.find(id);
+            // 不写成 "#" + std::to_string(id)：GCC 12 在 -O2 下对这种拼接误报 -Wrestrict
+            return it != strings.end() ? it->second : std::string("#").append(std::to_string(id));
+        }
+    };
+
+    inline TraceFile ReadTraceFile(std::filesystem::path const& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("cannot open trace file");
+
+        std::vector<char> data{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+        TraceFile file;
+        if (data.size() < sizeof(TraceFileHeader))
+            throw std::runtime_error("trace file is truncated");
+
+        std::memcpy(&file.header, data.data(), sizeof(TraceFileHeader));
+        if (std::memcmp(file.header.magic, TraceFileMagic, sizeof(TraceFileMagic)) != 0)
+            throw std::runtime_error("not an mvvm trace file");
+        if (file.header.version != TraceFileVersion)
+            throw std::runtime_error("unsupported trace file version");
+        if (file.header.chunkSize < sizeof(TraceFileHeader) + sizeof(TraceChunkHeader))
+            throw std::runtime_error("invalid trace chunk size");
+
+        size_t const chunkSize = file.header.chunkSize;
+        for (size_t region = 0; region * chunkSize < data.size(); ++region)
+        {
+            size_t begin = region * chunkSize + (region == 0 ? sizeof(TraceFileHeader) : 0);
+            size_t limit = (std::min)(data.size(), (region + 1) * chunkSize);
+            if (begin + sizeof(TraceChunkHeader) > limit)
+                break;
+
+            TraceChunkHeader chunk;
+            std::memcpy(&chunk, data.data() + begin, sizeof(chunk));
+            if (chunk.magic != TraceChunkMagic)
+                continue; // 未写完的块
+
+            size_t payload = begin + sizeof(TraceChunkHeader);
+            size_t used = (std::min)(static_cast<size_t>(chunk.usedBytes), limit - payload);
+
+            if (chunk.type == ChunkType::Events)
+            {
+                for (size_t at = payload; at + sizeof(TraceEvent) <= payload + used; at += sizeof(TraceEvent))
+                {
+                    TraceEvent e;
+                    std::memcpy(&e, data.data() + at, sizeof(e));
+                    file.events.push_back(e);
+                }
+            }
+            else if (chunk.type == ChunkType::Strings)
+            {
+                size_t at = payload;
+                while (at + 2 * sizeof(uint32_t) <= payload + used)
+                {
+                    uint32_t id, length;
+                    std::memcpy(&id, data.data() + at, sizeof(id));
+                    std::memcpy(&length, data.data() + at + sizeof(id), sizeof(length));
+                    at += 2 * sizeof(uint32_t);
+                    if (at + length > payload + used) break;
+
+                    file.strings.emplace(id, std::string{ data.data() + at, length });
+                    at += (length + 3) & ~size_t{ 3 };
+                }
+            }
+        }
+
+        std::stable_sort(file.events.begin(), file.events.end(),
+            [](TraceEvent const& a, TraceEvent const& b) { return a.timestampNs < b.timestampNs; });
+        return file;
+    }
+
+    inline void WriteJsonString(std::ostream& out, std::string_view text)
+    {
+        out << '"';
+        for (unsigned char c : text)
+        {
+            switch (c)
+            {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20)
+                {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                }
+                else out << static_cast<char>(c);
+            }
+        }
+        out << '"';
+    }
+
+    // Chrome trace 的时间单位为微秒：写成整数微秒加三位小数，保留纳秒精度（默认的 double 输出只有 6 位有效数字）
+    inline void WriteMicros(std::ostream& out, uint64_t ns)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%llu.%03u",
+            static_cast<unsigned long long>(ns / 1000), static_cast<unsigned>(ns % 1000));
+        out << buf;
+    }
+
+    // 事件名为驻留名称（属性名/命令类型），分类为事件类型；调度器切换以 flow 事件连接入队与执行
+    inline void WriteChromeTraceJson(TraceFile const& file, std::ostream& out)
+    {
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        bool first = true;
+        for (auto const& e : file.events)
+        {
+            if (!first) out << ",\n";
+            first = false;
+
+            auto name = file.NameOf(e.nameId);
+            if (name.empty()) name = ToString(e.kind);
+
+            out << "{\"name\":";
+            WriteJsonString(out, name);
+            out << ",\"cat\":\"" << ToString(e.kind) << "\""
+                << ",\"ph\":\"" << static_cast<char>(e.phase) << "\""
+                << ",\"ts\":";
+            WriteMicros(out, e.timestampNs);
+            out << ",\"pid\":1,\"tid\":" << e.threadId;
+
+            switch (e.phase)
+            {
+            case Phase::Complete:
+                out << ",\"dur\":";
+                WriteMicros(out, e.durationNs);
+                break;
+            case Phase::Instant:
+                out << ",\"s\":\"t\"";
+                break;
+            case Phase::FlowOut:
+                out << ",\"id\":" << e.arg;
+                break;
+            case Phase::FlowIn:
+                out << ",\"id\":" << e.arg << ",\"bp\":\"e\"";
+                break;
+            }
+
+            out << ",\"args\":{\"arg\":" << e.arg << "}}";
+        }
+        out << "\n]}\n";
+    }
+
+    inline void ConvertTraceToChromeJson(std::filesystem::path const& tracePath, std::filesystem::path const& jsonPath)
+    {
+        auto file = ReadTraceFile(tracePath);
+        std::ofstream out(jsonPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("cannot create json file");
+        WriteChromeTraceJson(file, out);
+    }
+}
@@ -20,6 +20,8 @@
 #include <functional>
 
 #include "name_of.h"
+#include "mvvm_trace.h"
+#include "view_model_metrics.h"
 #include <mvvm_framework/mvvm_framework_events.h>
 
 #include <winrt/Microsoft.UI.Xaml.Data.h>
@@ -50,6 +52,28 @@ namespace mvvm
 
         winrt::event_token ErrorsChanged(auto const& handler) { return m_eventErrorsChanged.add(handler); }
         void ErrorsChanged(winrt::event_token const& token) { m_eventErrorsChanged.remove(token); }
+
+        // 按实例启用热路径计数（默认关闭，关闭时每个热路径只多一次空指针判断）。
+        // 应在构建命令之前调用，命令在构建时才关联所属 VM 的计数器。
+        void EnableMetrics(std::wstring_view name)
+        {
+            if (m_metrics) return;
+            m_metrics = std::make_shared<::mvvm::ViewModelMetrics>(std::wstring{ name });
+            winrt::Windows::Foundation::IInspectable self = derived();
+            // 记下登记时的标识：析构时引用计数已归零，不能再对自身 QueryInterface
+            m_metricsIdentity = ::mvvm::ViewModelMetricsRegistry::IdentityOf(self);
+            ::mvvm::ViewModelMetricsRegistry::Instance().Register(m_metricsIdentity, m_metrics);
+        }
+
+        void DisableMetrics()
+        {
+            if (!m_metrics) return;
+            ::mvvm::ViewModelMetricsRegistry::Instance().Unregister(m_metricsIdentity, m_metrics.get());
+            m_metrics = nullptr;
+            m_metricsIdentity = nullptr;
+        }
+
+        std::shared_ptr<::mvvm::ViewModelMetrics> const& Metrics() const noexcept { return m_metrics; }
     private:
 
         // INotifyPropertyChanged
@@ -86,6 +110,9 @@ namespace mvvm
             {
                 m_eventPropertyChanged.remove(m_propertyChangedToken);
             }
+            // 在 IUnknown 地址释放之前注销：之后分配到同一地址的 VM 不会查到本实例的计数器，
+            // 命令仍持有的计数器也不再出现在报告中
+            DisableMetrics();
         }
 
     #pragma region GetProperty
@@ -220,6 +247,8 @@ namespace mvvm
             constexpr bool isPropertyNameMultiple = std::is_convertible_v<PropertyName, std::initializer_list<const std::wstring_view>>;
             static_assert(isPropertyNameNull || isPropertyNameSingle || isPropertyNameMultiple);
 
+            MVVM_TRACE_SCOPE(traceScope, PropertySet, FirstPropertyName(propertyNameOrNames));
+
             if constexpr (!isOldValueTypeNull)
             {
                 oldValue = valueField;
@@ -248,9 +277,27 @@ namespace mvvm
                 }
             }
 
+            if (m_metrics)
+            {
+                m_metrics->OnSetProperty(FirstPropertyName(propertyNameOrNames), valueChanged);
+            }
+
+            MVVM_TRACE_ARG(traceScope, valueChanged);
             return valueChanged;
         }
 
+        // 跟踪与统计使用的属性名：多属性时取第一个
+        template <typename PropertyName>
+        static std::wstring_view FirstPropertyName([[maybe_unused]] PropertyName const& propertyNameOrNames) noexcept
+        {
+            if constexpr (std::is_null_pointer_v<PropertyName>)
+                return {};
+            else if constexpr (std::is_convertible_v<PropertyName, const std::wstring_view>)
+                return propertyNameOrNames;
+            else
+                return propertyNameOrNames.size() ? *propertyNameOrNames.begin() : std::wstring_view{};
+        }
+
         // Single Source - Multiple Slaves
         void RegisterDependency(std::wstring_view source,
             std::initializer_list<const std::wstring_view> dependents)
@@ -299,6 +346,9 @@ namespace mvvm
         // 校验值是否正确，并在出错时存储错误信息；函数返回值表示校验结果是否正确
         bool ValidatePropertyValue(std::wstring_view property, winrt::Windows::Foundation::IInspectable const& boxedNewValue)
         {
+            MVVM_TRACE_SCOPE(traceScope, Validate, property);
+            auto const validateStart = m_metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
             if (m_eventValidationRequested)
             {
                 winrt::Mvvm::Framework::Core::ValidationRequestedEventArgs req{
@@ -362,6 +412,12 @@ namespace mvvm
                 m_eventValidationCompleted(derived(), done);
             }
 
+            if (m_metrics)
+            {
+                m_metrics->OnValidate(property, std::chrono::steady_clock::now() - validateStart);
+            }
+
+            MVVM_TRACE_ARG(traceScope, errs.size());
             return errs.empty();
         }
 
@@ -375,6 +431,12 @@ namespace mvvm
             return SetProperty(field, newValue, propertyName);
         }
 
+        // 清空已记录的校验错误（保留校验器），用于 VM 回收复用
+        void ClearValidateErrors()
+        {
+            m_validationErrors = {};
+        }
+
         bool HasValidateErrors() const { return !m_validationErrors.empty(); }
         bool HasValidateErrors(std::wstring_view property) const
         {
@@ -443,6 +505,8 @@ namespace mvvm
         {
             if (!m_eventPropertyChanged) return;
 
+            MVVM_TRACE_SCOPE(traceScope, Broadcast, name);
+
             std::unordered_set<std::wstring> visited;
             std::vector<std::wstring> stack{ std::wstring{name} };
 
@@ -458,6 +522,13 @@ namespace mvvm
                 if (auto it = m_dependsOnBySource.find(cur); it != m_dependsOnBySource.end())
                     for (auto const& dep : it->second) stack.push_back(dep);
             }
+
+            if (m_metrics)
+            {
+                m_metrics->OnBroadcast(name, visited.size());
+            }
+
+            MVVM_TRACE_ARG(traceScope, visited.size()); // 扇出数量
         }
 
         // Multi-property broadcasting: when the source of a dependent property changes, 
@@ -477,6 +548,9 @@ namespace mvvm
             std::unordered_map<std::wstring, std::vector<BoxedValidator>> m_validators;
             std::unordered_map<std::wstring, std::vector<winrt::hstring>> m_validationErrors;
 
+            std::shared_ptr<::mvvm::ViewModelMetrics> m_metrics;
+            void* m_metricsIdentity{ nullptr };     // 登记到 ViewModelMetricsRegistry 的键
+
     };
 }
 
@@ -0,0 +1,144 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_PORTABLE_EVENT_LOOP_H_INCLUDED
+#define __MVVM_CPPWINRT_PORTABLE_EVENT_LOOP_H_INCLUDED
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace mvvm
+{
+    // 与 DispatcherQueue 接口一致（TryEnqueue / HasThreadAccess）的可移植事件循环，
+    // 用于在没有 WinUI 的环境下驱动调度相关代码（例如 ProfiledEnqueue）。
+    // 运行 Run() / RunPending() 的线程即为该循环的“UI 线程”。
+    class PortableEventLoop
+    {
+    public:
+        using WorkItem = std::function<void()>;
+
+        PortableEventLoop() = default;
+        PortableEventLoop(PortableEventLoop const&) = delete;
+        PortableEventLoop& operator=(PortableEventLoop const&) = delete;
+
+        bool TryEnqueue(WorkItem work) const
+        {
+            {
+                std::scoped_lock lock{ m_mutex };
+                if (m_shutdown)
+                    return false;
+                m_queue.push_back(std::move(work));
+            }
+            m_cv.notify_one();
+            return true;
+        }
+
+        bool HasThreadAccess() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return m_owner == std::this_thread::get_id();
+        }
+
+        // 阻塞执行工作项，直到 Stop()；返回后仍可再次调用
+        void Run()
+        {
+            BindToCurrentThread();
+            for (;;)
+            {
+                WorkItem work;
+                {
+                    std::unique_lock lock{ m_mutex };
+                    m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+                    if (m_queue.empty())
+                    {
+                        m_stop = false;
+                        return;
+                    }
+                    work = std::move(m_queue.front());
+                    m_queue.pop_front();
+                }
+                work();
+            }
+        }
+
+        // 执行当前已入队的工作项（执行期间新入队的留到下次），返回执行数量
+        size_t RunPending()
+        {
+            BindToCurrentThread();
+            std::deque<WorkItem> batch;
+            {
+                std::scoped_lock lock{ m_mutex };
+                batch.swap(m_queue);
+            }
+            for (auto& work : batch)
+                work();
+            return batch.size();
+        }
+
+        // 最多等待 timeout，直到队列非空后执行一批
+        size_t RunPendingFor(std::chrono::milliseconds timeout)
+        {
+            {
+                std::unique_lock lock{ m_mutex };
+                m_cv.wait_for(lock, timeout, [this] { return m_stop || !m_queue.empty(); });
+            }
+            return RunPending();
+        }
+
+        // 让 Run() 在处理完已入队的工作项后返回
+        void Stop()
+        {
+            {
+                std::scoped_lock lock{ m_mutex };
+                m_stop = true;
+            }
+            m_cv.notify_all();
+        }
+
+        // 之后的 TryEnqueue 均返回 false（与已关闭的 DispatcherQueue 一致）
+        void Shutdown()
+        {
+            {
+                std::scoped_lock lock{ m_mutex };
+                m_shutdown = true;
+                m_stop = true;
+            }
+            m_cv.notify_all();
+        }
+
+        size_t PendingCount() const
+        {
+            std::scoped_lock lock{ m_mutex };
+            return m_queue.size();
+        }
+
+    private:
+        void BindToCurrentThread()
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_owner = std::this_thread::get_id();
+        }
+
+        mutable std::mutex              m_mutex;
+        mutable std::condition_variable m_cv;
+        mutable std::deque<WorkItem>    m_queue;
+        std::thread::id                 m_owner;
+        bool                            m_stop{ false };
+        bool                            m_shutdown{ false };
+    };
+}
+
+#endif // __MVVM_CPPWINRT_PORTABLE_EVENT_LOOP_H_INCLUDED
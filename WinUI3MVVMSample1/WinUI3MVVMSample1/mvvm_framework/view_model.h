@@ -14,8 +14,38 @@
 
 #include "view_model_base.h"
 #include "subscription_tracker.h"
+#include "mvvm_diagnostics.h"
+#include "lazy_command.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include <winrt/Microsoft.UI.Dispatching.h>
+#include <wil/cppwinrt_helpers.h>
+
+
+namespace mvvm
+{
+    // DisposeAsync 中单个命令的排空结果
+    struct CommandDrainRecord
+    {
+        std::wstring              name;                 // RegisterForAutoCleanup 时提供的名称（未提供则为序号）
+        bool                      wasRunning{ false };  // 取消时是否仍在执行
+        bool                      straggler{ false };   // 截止时间到达时仍未完成
+        std::chrono::microseconds drainTime{ 0 };       // 自 DisposeAsync 开始到命令空闲的耗时
+    };
+
+    struct DisposeReport
+    {
+        std::vector<CommandDrainRecord> commands;
+        std::chrono::microseconds       deadline{ 0 };
+        std::chrono::microseconds       totalTime{ 0 };   // 取消 + 排空 + 解除订阅的总耗时
+        size_t                          stragglers{ 0 };
+    };
+}
 
 
 namespace mvvm
@@ -49,37 +79,124 @@ namespace mvvm
 
         void RegisterForAutoCleanup(winrt::Windows::Foundation::IInspectable const& obj)
         {
-            if (obj) m_cleanupObjects.push_back(winrt::make_weak(obj));
+            RegisterForAutoCleanup(obj, {});
+        }
+
+        // name 用于 DisposeReport 中标识命令
+        void RegisterForAutoCleanup(winrt::Windows::Foundation::IInspectable const& obj, std::wstring_view name)
+        {
+            if (!obj) return;
+
+            // 延迟命令可能在任意线程首次构建并登记，故加锁
+            std::scoped_lock lock{ m_cleanupMutex };
+            std::wstring entryName{ name };
+            if (entryName.empty())
+                entryName = L"#" + std::to_wstring(m_cleanupObjects.size());
+            m_cleanupObjects.push_back({ winrt::make_weak(obj), std::move(entryName) });
+        }
+
+        // 定义延迟命令：factory 在首次访问 slot.Get() 时才执行，构建完成后自动以 name 登记清理。
+        // factory 中可继续挂接命令事件；未被访问的命令不参与 Cancel/Detach/DisposeAsync。
+        template <typename F>
+        void DefineLazyCommand(LazyCommand& slot, std::wstring_view name, F&& factory)
+        {
+            slot.Define(std::forward<F>(factory),
+                [this, entryName = std::wstring{ name }](winrt::Microsoft::UI::Xaml::Input::ICommand const& cmd)
+                {
+                    RegisterForAutoCleanup(cmd, entryName);
+                });
         }
 
         void FrameworkCleanup() noexcept
         {
-            // 取消正在执行的命令
-            for (auto it = m_cleanupObjects.begin(); it != m_cleanupObjects.end(); )
+            CancelRunningCommands();
+            ReleaseSubscriptions();
+        }
+
+        // 取消所有命令 -> 在 deadline 内等待进行中的异步命令完成（含完成回调）-> 再解除订阅。
+        // 超时未完成的命令记为 straggler，仍会继续解除订阅；报告可通过 LastDisposeReport() 获取。
+        winrt::Windows::Foundation::IAsyncAction DisposeAsync(
+            std::chrono::milliseconds deadline = std::chrono::milliseconds{ 2000 })
+        {
+            auto strong = this->derived().get_strong();
+            auto const start = std::chrono::steady_clock::now();
+
+            auto report = std::make_shared<DisposeReport>();
+            report->deadline = deadline;
+
+            CancelRunningCommands();
+
+            // 先建好全部记录再启动排空等待：协程会立即开始并可能在线程池上写入自己的记录，
+            // 此后 report->commands 不能再扩容。所有等待共享同一个截止时间
+            std::vector<winrt::Mvvm::Framework::Core::ICommandDrain> targets;
+            for (auto const& [obj, name] : SnapshotCleanupObjects())
+            {
+                auto drain = obj.try_as<winrt::Mvvm::Framework::Core::ICommandDrain>();
+                if (!drain) continue;
+
+                report->commands.push_back({ name, drain.IsRunning() });
+                targets.push_back(std::move(drain));
+            }
+
+            std::vector<winrt::Windows::Foundation::IAsyncAction> drains;
+            drains.reserve(targets.size());
+            for (size_t i = 0; i < targets.size(); ++i)
+            {
+                drains.push_back(DrainCommandAsync(targets[i], deadline, report, i, start));
+            }
+
+            for (auto const& d : drains)
+            {
+                co_await d;
+            }
+
+            // 解除订阅必须回到 UI 线程
+            if (m_dispatcher)
             {
-                if (auto obj = it->get())
+                co_await wil::resume_foreground(m_dispatcher);
+            }
+
+            ReleaseSubscriptions();
+
+            report->totalTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            for (auto const& rec : report->commands)
+            {
+                if (rec.straggler)
                 {
-                    if (auto cmdc = obj.try_as<winrt::Mvvm::Framework::Core::ICommandCleanup>())
-                        cmdc.Cancel();
-                    ++it;
+                    ++report->stragglers;
+                    MVVM_LOGS(Commands, Warning, L"DisposeAsync: command `{}` did not finish within {} ms.",
+                        rec.name, deadline.count());
                 }
-                else it = m_cleanupObjects.erase(it);
             }
 
+            m_lastDisposeReport = std::move(*report);
+        }
+
+        DisposeReport const& LastDisposeReport() const noexcept { return m_lastDisposeReport; }
+
+        // 取消正在执行的命令
+        void CancelRunningCommands() noexcept
+        {
+            for (auto const& [obj, name] : SnapshotCleanupObjects())
+            {
+                if (auto cmdc = obj.try_as<winrt::Mvvm::Framework::Core::ICommandCleanup>())
+                    cmdc.Cancel();
+            }
+        }
+
+        // 解除命令依赖/订阅/处理器，以及 VM 自身的依赖广播与校验器
+        void ReleaseSubscriptions() noexcept
+        {
             // 解除注册的依赖关系
-            for (auto it = m_cleanupObjects.begin(); it != m_cleanupObjects.end(); )
+            for (auto const& [obj, name] : SnapshotCleanupObjects())
             {
-                if (auto obj = it->get())
+                if (auto cmdc = obj.try_as<winrt::Mvvm::Framework::Core::ICommandCleanup>())
                 {
-                    if (auto cmdc = obj.try_as<winrt::Mvvm::Framework::Core::ICommandCleanup>())
-                    {
-                        cmdc.DetachAllDependencies();
-                        cmdc.ClearAllSubscribers();
-                        cmdc.ResetHandlers();
-                    }
-                    ++it;
+                    cmdc.DetachAllDependencies();
+                    cmdc.ClearAllSubscribers();
+                    cmdc.ResetHandlers();
                 }
-                else it = m_cleanupObjects.erase(it);
             }
 
             // 清理 VM 自己的依赖广播/校验器
@@ -120,6 +237,45 @@ namespace mvvm
         }
 
     private:
+        // 在锁内剔除已失效的弱引用并取出存活对象；调用方在锁外操作，避免命令回调重入时死锁
+        std::vector<std::pair<winrt::Windows::Foundation::IInspectable, std::wstring>> SnapshotCleanupObjects()
+        {
+            std::vector<std::pair<winrt::Windows::Foundation::IInspectable, std::wstring>> alive;
+            std::scoped_lock lock{ m_cleanupMutex };
+            alive.reserve(m_cleanupObjects.size());
+            for (auto it = m_cleanupObjects.begin(); it != m_cleanupObjects.end(); )
+            {
+                if (auto obj = it->obj.get())
+                {
+                    alive.emplace_back(std::move(obj), it->name);
+                    ++it;
+                }
+                else it = m_cleanupObjects.erase(it);
+            }
+            return alive;
+        }
+
+        static winrt::Windows::Foundation::IAsyncAction DrainCommandAsync(
+            winrt::Mvvm::Framework::Core::ICommandDrain drain,
+            std::chrono::milliseconds deadline,
+            std::shared_ptr<DisposeReport> report,
+            size_t index,
+            std::chrono::steady_clock::time_point start)
+        {
+            bool idle = false;
+            try
+            {
+                idle = co_await drain.WhenIdleAsync(std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(deadline));
+            }
+            catch (...) {}
+
+            // 记录在启动前已全部建好且不再扩容；每个协程只写自己的记录，无需加锁
+            auto& rec = report->commands[index];
+            rec.straggler = !idle;
+            rec.drainTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+        }
+
         ViewModel() : ViewModel(nullptr)
         {
             // Default constructor is private to ensure that the ViewModel is always constructed with a dispatcher.
@@ -131,8 +287,16 @@ namespace mvvm
     protected:
         winrt::Microsoft::UI::Dispatching::DispatcherQueue m_dispatcher{ nullptr };
 
-        std::vector<winrt::weak_ref<winrt::Windows::Foundation::IInspectable>> m_cleanupObjects;
+        struct CleanupEntry
+        {
+            winrt::weak_ref<winrt::Windows::Foundation::IInspectable> obj;
+            std::wstring name;
+        };
+
+        std::mutex                m_cleanupMutex;
+        std::vector<CleanupEntry> m_cleanupObjects;
         ::mvvm::SubscriptionTracker m_subscTracker;
+        DisposeReport m_lastDisposeReport;
     };
 }
 
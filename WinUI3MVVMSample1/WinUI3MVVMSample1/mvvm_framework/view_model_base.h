@@ -15,6 +15,7 @@
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Microsoft.UI.Dispatching.h>
 #include "notify_property_changed.h"
+#include "dispatch_profiler.h"
 
 namespace mvvm
 {
@@ -35,9 +36,16 @@ namespace mvvm
             if (!dispatcher)
                 return valueField;
 
+            if (auto const& metrics = this->Metrics())
+                metrics->Add(::mvvm::MetricCounter::CrossThreadMarshals);
+
             winrt::Windows::Foundation::IAsyncOperation<TValue> operation;
-            dispatcher.TryEnqueue([&]()
+            MVVM_TRACE_FLOW_ID(hopId);
+            MVVM_TRACE_FLOW_OUT(DispatcherHop, "GetProperty", hopId);
+            ::mvvm::ProfiledEnqueue(dispatcher, MVVM_DISPATCH_SITE("ViewModelBase::GetProperty"), [&]()
                 {
+                    MVVM_TRACE_FLOW_IN(DispatcherHop, "GetProperty", hopId);
+                    MVVM_TRACE_SCOPE(hopScope, DispatcherHop, "GetProperty");
                     operation = []() -> winrt::Windows::Foundation::IAsyncOperation<TValue>
                         {
                             co_return base::notify_property_changed::GetPropertyCore(valueField);
@@ -58,9 +66,16 @@ namespace mvvm
             if (!dispatcher)
                 return false;
 
+            if (auto const& metrics = this->Metrics())
+                metrics->Add(::mvvm::MetricCounter::CrossThreadMarshals);
+
             winrt::Windows::Foundation::IAsyncOperation<bool> operation;
-            dispatcher.TryEnqueue([&]()
+            MVVM_TRACE_FLOW_ID(hopId);
+            MVVM_TRACE_FLOW_OUT(DispatcherHop, "SetProperty", hopId);
+            ::mvvm::ProfiledEnqueue(dispatcher, MVVM_DISPATCH_SITE("ViewModelBase::SetProperty"), [&]()
                 {
+                    MVVM_TRACE_FLOW_IN(DispatcherHop, "SetProperty", hopId);
+                    MVVM_TRACE_SCOPE(hopScope, DispatcherHop, "SetProperty");
                     operation = [&]() -> winrt::Windows::Foundation::IAsyncOperation<bool>
                         {
                             co_return this->SetPropertyCore<TValue, TOldValue, compare, propertyNameType>(
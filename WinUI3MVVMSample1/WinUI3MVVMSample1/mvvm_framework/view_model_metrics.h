@@ -0,0 +1,412 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_VIEW_MODEL_METRICS_H_INCLUDED
+#define __MVVM_CPPWINRT_VIEW_MODEL_METRICS_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <winrt/Windows.Foundation.h>
+
+#include "mvvm_diagnostics.h"
+
+namespace mvvm
+{
+    // 单个 VM 的热路径计数器
+    enum class MetricCounter : uint8_t
+    {
+        SetPropertyCalls,       // SetProperty 调用次数
+        SetPropertyChanges,     // 其中值真正发生变化的次数（SetPropertyCore 的 valueChanged）
+        Broadcasts,             // 依赖广播次数
+        BroadcastFanout,        // 广播累计通知的属性数
+        ValidatorRuns,          // ValidatePropertyValue 次数
+        ValidatorTimeNs,        // 校验累计耗时
+        CanExecuteEvals,        // 该 VM 作为 notifier 的命令 CanExecute 次数
+        CrossThreadMarshals,    // ViewModelBase 跨线程封送次数
+        Count
+    };
+
+    inline constexpr const wchar_t* ToString(MetricCounter counter) noexcept
+    {
+        switch (counter)
+        {
+        case MetricCounter::SetPropertyCalls:    return L"SetPropertyCalls";
+        case MetricCounter::SetPropertyChanges:  return L"SetPropertyChanges";
+        case MetricCounter::Broadcasts:          return L"Broadcasts";
+        case MetricCounter::BroadcastFanout:     return L"BroadcastFanout";
+        case MetricCounter::ValidatorRuns:       return L"ValidatorRuns";
+        case MetricCounter::ValidatorTimeNs:     return L"ValidatorTimeNs";
+        case MetricCounter::CanExecuteEvals:     return L"CanExecuteEvals";
+        case MetricCounter::CrossThreadMarshals: return L"CrossThreadMarshals";
+        default:                                 return L"Unknown";
+        }
+    }
+
+    using MetricValues = std::array<uint64_t, static_cast<size_t>(MetricCounter::Count)>;
+
+    struct PropertyMetrics
+    {
+        uint64_t setCalls{ 0 };
+        uint64_t changes{ 0 };
+        uint64_t broadcasts{ 0 };
+        uint64_t fanout{ 0 };
+        uint64_t maxFanout{ 0 };
+        uint64_t validatorRuns{ 0 };
+        uint64_t validatorTimeNs{ 0 };
+
+        void Merge(PropertyMetrics const& o) noexcept
+        {
+            setCalls += o.setCalls;
+            changes += o.changes;
+            broadcasts += o.broadcasts;
+            fanout += o.fanout;
+            maxFanout = (std::max)(maxFanout, o.maxFanout);
+            validatorRuns += o.validatorRuns;
+            validatorTimeNs += o.validatorTimeNs;
+        }
+    };
+
+    struct ViewModelMetricsSnapshot
+    {
+        std::wstring name;
+        MetricValues counters{};
+        uint64_t     maxFanout{ 0 };
+        std::unordered_map<std::wstring, PropertyMetrics> properties;
+
+        uint64_t operator[](MetricCounter c) const noexcept { return counters[static_cast<size_t>(c)]; }
+    };
+
+    // 每个线程固定落在一个按缓存行对齐的分片上：计数为 relaxed 原子操作，
+    // 属性明细由分片自己的锁保护（同一分片通常只有一个线程写入，锁无竞争）。
+    // 快照时再汇总所有分片。
+    class ViewModelMetrics
+    {
+    public:
+        static constexpr size_t ShardCount = 8;
+
+        explicit ViewModelMetrics(std::wstring name) : m_name(std::move(name)) {}
+
+        ViewModelMetrics(ViewModelMetrics const&) = delete;
+        ViewModelMetrics& operator=(ViewModelMetrics const&) = delete;
+
+        std::wstring const& Name() const noexcept { return m_name; }
+
+        void Add(MetricCounter counter, uint64_t value = 1) noexcept
+        {
+            LocalShard().counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        void OnSetProperty(std::wstring_view property, bool changed)
+        {
+            auto& shard = LocalShard();
+            shard.counters[static_cast<size_t>(MetricCounter::SetPropertyCalls)].fetch_add(1, std::memory_order_relaxed);
+            if (changed)
+                shard.counters[static_cast<size_t>(MetricCounter::SetPropertyChanges)].fetch_add(1, std::memory_order_relaxed);
+
+            if (property.empty()) return;
+            std::scoped_lock lock{ shard.mutex };
+            auto& p = shard.PropertyOf(property);
+            ++p.setCalls;
+            if (changed) ++p.changes;
+        }
+
+        void OnBroadcast(std::wstring_view property, size_t fanout)
+        {
+            auto& shard = LocalShard();
+            shard.counters[static_cast<size_t>(MetricCounter::Broadcasts)].fetch_add(1, std::memory_order_relaxed);
+            shard.counters[static_cast<size_t>(MetricCounter::BroadcastFanout)].fetch_add(fanout, std::memory_order_relaxed);
+
+            std::scoped_lock lock{ shard.mutex };
+            auto& p = shard.PropertyOf(property);
+            ++p.broadcasts;
+            p.fanout += fanout;
+            p.maxFanout = (std::max)(p.maxFanout, static_cast<uint64_t>(fanout));
+        }
+
+        void OnValidate(std::wstring_view property, std::chrono::nanoseconds elapsed)
+        {
+            auto ns = static_cast<uint64_t>(elapsed.count());
+            auto& shard = LocalShard();
+            shard.counters[static_cast<size_t>(MetricCounter::ValidatorRuns)].fetch_add(1, std::memory_order_relaxed);
+            shard.counters[static_cast<size_t>(MetricCounter::ValidatorTimeNs)].fetch_add(ns, std::memory_order_relaxed);
+
+            std::scoped_lock lock{ shard.mutex };
+            auto& p = shard.PropertyOf(property);
+            ++p.validatorRuns;
+            p.validatorTimeNs += ns;
+        }
+
+        ViewModelMetricsSnapshot Snapshot() const
+        {
+            ViewModelMetricsSnapshot snapshot;
+            snapshot.name = m_name;
+            for (auto const& shard : m_shards)
+            {
+                for (size_t i = 0; i < snapshot.counters.size(); ++i)
+                    snapshot.counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+
+                std::scoped_lock lock{ shard.mutex };
+                for (auto const& [name, p] : shard.properties)
+                {
+                    snapshot.properties[name].Merge(p);
+                    snapshot.maxFanout = (std::max)(snapshot.maxFanout, p.maxFanout);
+                }
+            }
+            return snapshot;
+        }
+
+        void Reset()
+        {
+            for (auto& shard : m_shards)
+            {
+                for (auto& c : shard.counters)
+                    c.store(0, std::memory_order_relaxed);
+                std::scoped_lock lock{ shard.mutex };
+                shard.properties.clear();
+            }
+        }
+
+    private:
+        struct TransparentHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::wstring_view s) const noexcept { return std::hash<std::wstring_view>{}(s); }
+        };
+
+        struct alignas(64) Shard
+        {
+            std::array<std::atomic<uint64_t>, static_cast<size_t>(MetricCounter::Count)> counters{};
+            mutable std::mutex mutex;
+            std::unordered_map<std::wstring, PropertyMetrics, TransparentHash, std::equal_to<>> properties;
+
+            PropertyMetrics& PropertyOf(std::wstring_view property)
+            {
+                if (auto it = properties.find(property); it != properties.end())
+                    return it->second;
+                return properties.emplace(std::wstring{ property }, PropertyMetrics{}).first->second;
+            }
+        };
+
+        Shard& LocalShard() noexcept
+        {
+            static std::atomic<size_t> s_nextShard{ 0 };
+            thread_local size_t index = s_nextShard.fetch_add(1, std::memory_order_relaxed) % ShardCount;
+            return m_shards[index];
+        }
+
+        std::wstring m_name;
+        std::array<Shard, ShardCount> m_shards;
+    };
+
+    struct PropertyOffender
+    {
+        std::wstring    viewModel;
+        std::wstring    property;
+        PropertyMetrics metrics;
+    };
+
+    // 已启用统计的 VM 登记表。以 VM 的 IUnknown 标识为键，供命令在构造时找到所属 VM 的计数器。
+    // 键是裸地址，VM 必须在地址释放前注销（WrapNotifyPropertyChanged 在 DisableMetrics 与析构时注销），
+    // 否则之后分配到同一地址的 VM 会查到旧计数器。命令只持有弱引用，VM 销毁后计数器随之释放。
+    class ViewModelMetricsRegistry
+    {
+    public:
+        static ViewModelMetricsRegistry& Instance()
+        {
+            static ViewModelMetricsRegistry registry;
+            return registry;
+        }
+
+        ~ViewModelMetricsRegistry() { StopPeriodicDump(); }
+
+        void Register(void* identity, std::shared_ptr<ViewModelMetrics> const& metrics)
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_entries[identity] = metrics;
+        }
+
+        // 只注销 metrics 自己的条目（或已失效的条目）
+        void Unregister(void* identity, ViewModelMetrics const* metrics)
+        {
+            std::scoped_lock lock{ m_mutex };
+            auto it = m_entries.find(identity);
+            if (it == m_entries.end()) return;
+            auto current = it->second.lock();
+            if (!current || current.get() == metrics)
+                m_entries.erase(it);
+        }
+
+        std::shared_ptr<ViewModelMetrics> Find(void* identity)
+        {
+            std::scoped_lock lock{ m_mutex };
+            auto it = m_entries.find(identity);
+            if (it == m_entries.end()) return nullptr;
+
+            auto metrics = it->second.lock();
+            if (!metrics) m_entries.erase(it);
+            return metrics;
+        }
+
+        std::shared_ptr<ViewModelMetrics> Find(winrt::Windows::Foundation::IInspectable const& obj)
+        {
+            if (!obj) return nullptr;
+            return Find(IdentityOf(obj));
+        }
+
+        static void* IdentityOf(winrt::Windows::Foundation::IInspectable const& obj)
+        {
+            return winrt::get_abi(obj.as<winrt::Windows::Foundation::IUnknown>());
+        }
+
+        std::vector<ViewModelMetricsSnapshot> SnapshotAll()
+        {
+            std::vector<std::shared_ptr<ViewModelMetrics>> alive;
+            {
+                std::scoped_lock lock{ m_mutex };
+                for (auto it = m_entries.begin(); it != m_entries.end(); )
+                {
+                    if (auto m = it->second.lock())
+                    {
+                        alive.push_back(std::move(m));
+                        ++it;
+                    }
+                    else it = m_entries.erase(it);
+                }
+            }
+
+            std::vector<ViewModelMetricsSnapshot> snapshots;
+            snapshots.reserve(alive.size());
+            for (auto const& m : alive)
+                snapshots.push_back(m->Snapshot());
+            return snapshots;
+        }
+
+        // 按指定计数器排序的前 N 个 VM
+        std::vector<ViewModelMetricsSnapshot> TopViewModels(size_t n, MetricCounter by = MetricCounter::SetPropertyCalls)
+        {
+            auto all = SnapshotAll();
+            auto count = (std::min)(n, all.size());
+            std::partial_sort(all.begin(), all.begin() + count, all.end(),
+                [by](auto const& a, auto const& b) { return a[by] > b[by]; });
+            all.resize(count);
+            return all;
+        }
+
+        // 跨所有 VM 按 SetProperty 调用次数（相同则按广播扇出）排序的前 N 个属性
+        std::vector<PropertyOffender> TopProperties(size_t n)
+        {
+            std::vector<PropertyOffender> all;
+            for (auto& snapshot : SnapshotAll())
+                for (auto& [property, metrics] : snapshot.properties)
+                    all.push_back({ snapshot.name, property, metrics });
+
+            auto count = (std::min)(n, all.size());
+            std::partial_sort(all.begin(), all.begin() + count, all.end(),
+                [](auto const& a, auto const& b)
+                {
+                    if (a.metrics.setCalls != b.metrics.setCalls) return a.metrics.setCalls > b.metrics.setCalls;
+                    return a.metrics.fanout > b.metrics.fanout;
+                });
+            all.resize(count);
+            return all;
+        }
+
+        std::wstring FormatReport(size_t topN = 10)
+        {
+            std::wstring text = L"[METRICS] " + ::mvvm::diagnostics::CurrentTimestamp() + L"\n";
+
+            for (auto const& vm : TopViewModels(topN))
+            {
+                text += L"|-> " + vm.name;
+                for (size_t i = 0; i < vm.counters.size(); ++i)
+                {
+                    text += L" ";
+                    text += ToString(static_cast<MetricCounter>(i));
+                    text += L"=" + std::to_wstring(vm.counters[i]);
+                }
+                text += L" MaxFanout=" + std::to_wstring(vm.maxFanout) + L"\n";
+            }
+
+            for (auto const& p : TopProperties(topN))
+            {
+                text += L"  |-> " + p.viewModel + L"." + p.property
+                    + L" set=" + std::to_wstring(p.metrics.setCalls)
+                    + L" changed=" + std::to_wstring(p.metrics.changes)
+                    + L" broadcasts=" + std::to_wstring(p.metrics.broadcasts)
+                    + L" fanout=" + std::to_wstring(p.metrics.fanout)
+                    + L" maxFanout=" + std::to_wstring(p.metrics.maxFanout)
+                    + L" validate=" + std::to_wstring(p.metrics.validatorRuns)
+                    + L"/" + std::to_wstring(p.metrics.validatorTimeNs / 1000) + L"us\n";
+            }
+
+            return text + L"\n";
+        }
+
+        // 周期性地将报告写入诊断日志
+        void StartPeriodicDump(std::chrono::milliseconds interval, size_t topN = 10)
+        {
+            StopPeriodicDump();
+            std::scoped_lock lock{ m_dumpMutex };
+            m_dumpStop = false;
+            m_dumpThread = std::thread([this, interval, topN]
+                {
+                    std::unique_lock lock{ m_dumpMutex };
+                    while (!m_dumpCv.wait_for(lock, interval, [this] { return m_dumpStop; }))
+                    {
+                        lock.unlock();
+                        ::mvvm::diagnostics::OutputLog(FormatReport(topN));
+                        lock.lock();
+                    }
+                });
+        }
+
+        void StopPeriodicDump()
+        {
+            {
+                std::scoped_lock lock{ m_dumpMutex };
+                m_dumpStop = true;
+            }
+            m_dumpCv.notify_all();
+            if (m_dumpThread.joinable())
+                m_dumpThread.join();
+        }
+
+    private:
+        ViewModelMetricsRegistry()
+        {
+            // 先构造日志器，保证其析构晚于本对象（周期转储线程在析构时才退出）
+            ::mvvm::diagnostics::AsyncLogger::Instance();
+        }
+
+        std::mutex m_mutex;
+        std::unordered_map<void*, std::weak_ptr<ViewModelMetrics>> m_entries;
+
+        std::mutex              m_dumpMutex;
+        std::condition_variable m_dumpCv;
+        bool                    m_dumpStop{ false };
+        std::thread             m_dumpThread;
+    };
+}
+
+#endif // __MVVM_CPPWINRT_VIEW_MODEL_METRICS_H_INCLUDED
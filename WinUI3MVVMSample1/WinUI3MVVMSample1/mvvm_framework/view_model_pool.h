@@ -0,0 +1,256 @@
+﻿//*********************************************************
+//
+//    Copyright (c) Millennium R&D Team. All rights reserved.
+//    This code is licensed under the MIT License.
+//    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+//    ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+//    TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+#ifndef __MVVM_CPPWINRT_VIEW_MODEL_POOL_H_INCLUDED
+#define __MVVM_CPPWINRT_VIEW_MODEL_POOL_H_INCLUDED
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <winrt/Windows.Foundation.h>
+
+namespace mvvm
+{
+    // Reset 约定：回收时只重置数据字段（并通知绑定），
+    // 保留命令对象、依赖广播表和校验器，下次取出时仅重新绑定数据。
+    template <typename TImpl>
+    concept RecyclableViewModel = requires(TImpl & vm) { vm.Reset(); };
+
+    // 可选约定：QuiesceAsync 终止并等待实例上仍在进行的异步工作，返回后的延续位于 UI 线程；超时返回 false。
+    // 满足该约定的实例在回收时先排空再 Reset，排空完成前不会被 Acquire 取出。
+    template <typename TImpl>
+    concept QuiescableViewModel = requires(TImpl & vm, winrt::Windows::Foundation::TimeSpan timeout)
+    {
+        { vm.QuiesceAsync(timeout) } -> std::same_as<winrt::Windows::Foundation::IAsyncOperation<bool>>;
+    };
+
+    struct ViewModelPoolMetrics
+    {
+        uint64_t hits{ 0 };         // Acquire 命中空闲实例
+        uint64_t misses{ 0 };       // Acquire 新建实例
+        uint64_t releases{ 0 };     // Release 回收次数
+        uint64_t evictions{ 0 };    // 超出容量被淘汰的实例数（含排空超时的实例）
+        size_t   idle{ 0 };         // 当前空闲实例数
+        size_t   draining{ 0 };     // 已归还、仍在排空异步工作的实例数
+
+        double HitRate() const noexcept
+        {
+            auto total = hits + misses;
+            return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
+    // 类型化 VM 对象池。TProjected 为 IDL 投影类型，TImpl 为实现类型（需满足 Reset 约定）。
+    // 空闲实例按回收顺序排列：Acquire 取最近回收的（缓存更热），超出容量时淘汰最早回收的。
+    template <typename TProjected, RecyclableViewModel TImpl>
+    class ViewModelPool
+    {
+    public:
+        using Factory = std::function<TProjected()>;
+
+        explicit ViewModelPool(size_t capacity, Factory factory = [] { return TProjected{}; },
+            winrt::Windows::Foundation::TimeSpan drainTimeout = std::chrono::seconds(5))
+            : m_state(std::make_shared<State>()), m_factory(std::move(factory)), m_drainTimeout(drainTimeout)
+        {
+            m_state->capacity = capacity;
+        }
+
+        ViewModelPool(ViewModelPool const&) = delete;
+        ViewModelPool& operator=(ViewModelPool const&) = delete;
+
+        ~ViewModelPool() { Clear(); }
+
+        TProjected Acquire()
+        {
+            auto& state = *m_state;
+            {
+                std::scoped_lock lock{ state.mutex };
+                if (!state.idle.empty())
+                {
+                    auto vm = std::move(state.idle.back());
+                    state.idle.pop_back();
+                    ++state.metrics.hits;
+                    return vm;
+                }
+                ++state.metrics.misses;
+            }
+            return m_factory();
+        }
+
+        // 回收实例：执行 Reset 约定后放回空闲列表；池已满时淘汰最早回收的实例。
+        // 实例若满足 QuiescableViewModel，则先异步排空进行中的工作再 Reset 入池，
+        // 避免上一个使用者的保存等操作在实例被再次取出后才完成、写回新使用者的数据。
+        void Release(TProjected const& vm)
+        {
+            if (!vm) return;
+
+            if constexpr (QuiescableViewModel<TImpl>)
+            {
+                {
+                    std::scoped_lock lock{ m_state->mutex };
+                    ++m_state->metrics.releases;
+                    ++m_state->draining;
+                }
+                DrainAndParkAsync(m_state, vm, m_drainTimeout);
+            }
+            else
+            {
+                winrt::get_self<TImpl>(vm)->Reset();
+                {
+                    std::scoped_lock lock{ m_state->mutex };
+                    ++m_state->metrics.releases;
+                }
+                Park(*m_state, vm);
+            }
+        }
+
+        size_t Capacity() const
+        {
+            std::scoped_lock lock{ m_state->mutex };
+            return m_state->capacity;
+        }
+
+        // 缩小容量时立即淘汰多余的空闲实例
+        void Capacity(size_t capacity)
+        {
+            auto& state = *m_state;
+            std::deque<TProjected> evicted;
+            {
+                std::scoped_lock lock{ state.mutex };
+                state.capacity = capacity;
+                while (state.idle.size() > state.capacity)
+                {
+                    evicted.push_back(std::move(state.idle.front()));
+                    state.idle.pop_front();
+                    ++state.metrics.evictions;
+                }
+            }
+            for (auto const& vm : evicted) Evict(vm);
+        }
+
+        ViewModelPoolMetrics Metrics() const
+        {
+            std::scoped_lock lock{ m_state->mutex };
+            auto m = m_state->metrics;
+            m.idle = m_state->idle.size();
+            m.draining = m_state->draining;
+            return m;
+        }
+
+        void ResetMetrics()
+        {
+            std::scoped_lock lock{ m_state->mutex };
+            m_state->metrics = {};
+        }
+
+        // 淘汰所有空闲实例；仍在排空的实例完成后照常入池（池已销毁则直接淘汰）
+        void Clear()
+        {
+            std::deque<TProjected> evicted;
+            {
+                std::scoped_lock lock{ m_state->mutex };
+                evicted.swap(m_state->idle);
+            }
+            for (auto const& vm : evicted) Evict(vm);
+        }
+
+    private:
+        // 排空协程可能晚于池本身结束，因此可变状态放在共享块中，由协程持弱引用
+        struct State
+        {
+            std::mutex             mutex;
+            size_t                 capacity{ 0 };
+            size_t                 draining{ 0 };
+            std::deque<TProjected> idle;
+            ViewModelPoolMetrics   metrics;
+        };
+
+        static void Park(State& state, TProjected const& vm)
+        {
+            TProjected evicted{ nullptr };
+            {
+                std::scoped_lock lock{ state.mutex };
+                if (state.capacity == 0)
+                {
+                    evicted = vm;
+                    ++state.metrics.evictions;
+                }
+                else
+                {
+                    if (state.idle.size() >= state.capacity)
+                    {
+                        evicted = std::move(state.idle.front());
+                        state.idle.pop_front();
+                        ++state.metrics.evictions;
+                    }
+                    state.idle.push_back(vm);
+                }
+            }
+
+            // 在锁外执行完整清理，避免回调重入
+            Evict(evicted);
+        }
+
+        static winrt::fire_and_forget DrainAndParkAsync(
+            std::weak_ptr<State> weakState,
+            TProjected vm,
+            winrt::Windows::Foundation::TimeSpan timeout)
+        {
+            bool idle = false;
+            try
+            {
+                idle = co_await winrt::get_self<TImpl>(vm)->QuiesceAsync(timeout);
+                if (idle)
+                    winrt::get_self<TImpl>(vm)->Reset();
+            }
+            catch (...)
+            {
+                idle = false;
+            }
+
+            auto state = weakState.lock();
+            if (state)
+            {
+                std::scoped_lock lock{ state->mutex };
+                --state->draining;
+                if (!idle) ++state->metrics.evictions;
+            }
+
+            // 排空超时的实例仍有工作在跑，不能交给下一个使用者
+            if (idle && state)
+                Park(*state, vm);
+            else
+                Evict(vm);
+        }
+
+        static void Evict(TProjected const& vm) noexcept
+        {
+            if (!vm) return;
+            try
+            {
+                if (auto vmc = vm.template try_as<winrt::Mvvm::Framework::Core::IViewModelCleanup>())
+                    vmc.FrameworkCleanup();
+            }
+            catch (...) {}
+        }
+
+        std::shared_ptr<State>               m_state;
+        Factory                              m_factory;
+        winrt::Windows::Foundation::TimeSpan m_drainTimeout;
+    };
+}
+
+#endif // __MVVM_CPPWINRT_VIEW_MODEL_POOL_H_INCLUDED
@@ -22,6 +22,9 @@ namespace winrt::XamlUICommand::implementation
         double Weight() const noexcept { return m_weight; }
         void Weight(double v) { if (m_weight != v) { m_weight = v; Raise(L"Weight"); } }
 
+        bool IsHighlighted() const noexcept { return m_highlighted; }
+        void IsHighlighted(bool v) { if (m_highlighted != v) { m_highlighted = v; Raise(L"IsHighlighted"); } }
+
         // INotifyPropertyChanged
         winrt::event<Microsoft::UI::Xaml::Data::PropertyChangedEventHandler> m_propertyChanged;
         winrt::event_token PropertyChanged(Microsoft::UI::Xaml::Data::PropertyChangedEventHandler const& handler)
@@ -44,6 +47,7 @@ namespace winrt::XamlUICommand::implementation
         hstring m_label{};
         bool m_directed{};
         double m_weight{};
+        bool m_highlighted{};
     };
 }
 
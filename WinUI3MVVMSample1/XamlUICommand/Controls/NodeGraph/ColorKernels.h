@@ -0,0 +1,402 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include "DisplayList.h"
+
+#if defined(NODEGRAPH_COLOR_SCALAR)
+// 强制标量路径
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define NODEGRAPH_COLOR_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NODEGRAPH_COLOR_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define NODEGRAPH_COLOR_NEON 1
+#endif
+
+// 批量颜色运算（与平台无关）：对 Rgba 数组计算 WCAG 相对亮度、对比度，自动选择对比文字色，
+// 整体提亮 / 压暗，以及把数值映射到色带（热力图）。单色版本供 NodeGraphPanel 的外观计算使用，
+// 批量版本面向按元数据逐节点着色（数万节点一次算完）。
+//
+// 指令集在编译期选择：AVX2（/arch:AVX2 或 -mavx2）> SSE2（x64 默认）> NEON（AArch64）> 标量；
+// 预先定义 NODEGRAPH_COLOR_SCALAR 可强制标量路径（tests/nodegraph 用它与向量路径对照）。
+// 亮度依赖 256 项线性化查找表，只有 AVX2 能向量化查表（gather），其余路径查表为标量、之后的比值与选择为向量；
+// 提亮 / 压暗是逐字节饱和加减，各路径都完全向量化。所有路径与标量版本逐位一致（同样的浮点运算顺序）。
+// 批量函数要求输出与输入等长；输出可以与输入是同一数组。
+namespace nodegraph
+{
+    inline constexpr Rgba ContrastDark{ 0, 0, 0, 255 };
+    inline constexpr Rgba ContrastLight{ 255, 255, 255, 255 };
+
+    namespace detail
+    {
+        // 按 WCAG 系数加权后的 sRGB -> 线性分量，亮度 = r[R] + g[G] + b[B]
+        struct LuminanceTables
+        {
+            std::array<float, 256> r{};
+            std::array<float, 256> g{};
+            std::array<float, 256> b{};
+        };
+
+        inline LuminanceTables const& Luminance() noexcept
+        {
+            static LuminanceTables const tables = []
+                {
+                    LuminanceTables t;
+                    for (int i = 0; i < 256; ++i)
+                    {
+                        double u = i / 255.0;
+                        double lin = (u <= 0.03928) ? (u / 12.92) : std::pow((u + 0.055) / 1.055, 2.4);
+                        t.r[i] = static_cast<float>(0.2126 * lin);
+                        t.g[i] = static_cast<float>(0.7152 * lin);
+                        t.b[i] = static_cast<float>(0.0722 * lin);
+                    }
+                    return t;
+                }();
+            return tables;
+        }
+
+        // 对比度 (L1 + 0.05) / (L2 + 0.05) 中“深色文字更好”的判据：(L + 0.05)^2 >= 0.05 * 1.05
+        inline constexpr float DarkTextThreshold = 0.0525f;
+
+        inline uint32_t Pack(Rgba c) noexcept { return std::bit_cast<uint32_t>(c); }
+
+        // 把 delta（[-1, 1]）换算为按字节饱和加减的量；与 MakeLighterDarker 一样向零截断
+        inline int ShadeStep(float delta) noexcept
+        {
+            return std::clamp(static_cast<int>(delta * 255.0f), -255, 255);
+        }
+
+        inline Rgba ShadeBy(Rgba c, int step) noexcept
+        {
+            auto channel = [step](uint8_t v) { return static_cast<uint8_t>(std::clamp(v + step, 0, 255)); };
+            return Rgba{ channel(c.r), channel(c.g), channel(c.b), c.a };
+        }
+    }
+
+    // —— 单色 ——
+    inline float RelativeLuminance(Rgba c) noexcept
+    {
+        auto const& t = detail::Luminance();
+        return t.r[c.r] + t.g[c.g] + t.b[c.b];
+    }
+
+    inline float ContrastRatio(float la, float lb) noexcept
+    {
+        return (std::max(la, lb) + 0.05f) / (std::min(la, lb) + 0.05f);
+    }
+
+    inline float ContrastRatio(Rgba a, Rgba b) noexcept
+    {
+        return ContrastRatio(RelativeLuminance(a), RelativeLuminance(b));
+    }
+
+    // 黑白两色中与背景对比度更高的一个
+    inline Rgba ContrastText(float backgroundLuminance) noexcept
+    {
+        float s = backgroundLuminance + 0.05f;
+        return s * s >= detail::DarkTextThreshold ? ContrastDark : ContrastLight;
+    }
+
+    inline Rgba Shade(Rgba c, float delta) noexcept
+    {
+        return detail::ShadeBy(c, detail::ShadeStep(delta));
+    }
+
+    // —— 批量 ——
+    inline void Luminance(std::span<Rgba const> colors, std::span<float> out) noexcept
+    {
+        auto const& t = detail::Luminance();
+        size_t i = 0;
+#if NODEGRAPH_COLOR_AVX2
+        __m256i const mask = _mm256_set1_epi32(0xFF);
+        for (; i + 8 <= colors.size(); i += 8)
+        {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(colors.data() + i));
+            __m256 r = _mm256_i32gather_ps(t.r.data(), _mm256_and_si256(px, mask), 4);
+            __m256 g = _mm256_i32gather_ps(t.g.data(), _mm256_and_si256(_mm256_srli_epi32(px, 8), mask), 4);
+            __m256 b = _mm256_i32gather_ps(t.b.data(), _mm256_and_si256(_mm256_srli_epi32(px, 16), mask), 4);
+            _mm256_storeu_ps(out.data() + i, _mm256_add_ps(_mm256_add_ps(r, g), b));
+        }
+#endif
+        for (; i < colors.size(); ++i)
+            out[i] = t.r[colors[i].r] + t.g[colors[i].g] + t.b[colors[i].b];
+    }
+
+    // 与同一参考色的对比度
+    inline void ContrastRatio(std::span<Rgba const> colors, Rgba against, std::span<float> out) noexcept
+    {
+        Luminance(colors, out);
+        float const lb = RelativeLuminance(against);
+        size_t i = 0;
+#if NODEGRAPH_COLOR_AVX2
+        __m256 const vb = _mm256_set1_ps(lb), bias = _mm256_set1_ps(0.05f);
+        for (; i + 8 <= out.size(); i += 8)
+        {
+            __m256 la = _mm256_loadu_ps(out.data() + i);
+            __m256 hi = _mm256_add_ps(_mm256_max_ps(la, vb), bias);
+            __m256 lo = _mm256_add_ps(_mm256_min_ps(la, vb), bias);
+            _mm256_storeu_ps(out.data() + i, _mm256_div_ps(hi, lo));
+        }
+#elif NODEGRAPH_COLOR_SSE2
+        __m128 const vb = _mm_set1_ps(lb), bias = _mm_set1_ps(0.05f);
+        for (; i + 4 <= out.size(); i += 4)
+        {
+            __m128 la = _mm_loadu_ps(out.data() + i);
+            __m128 hi = _mm_add_ps(_mm_max_ps(la, vb), bias);
+            __m128 lo = _mm_add_ps(_mm_min_ps(la, vb), bias);
+            _mm_storeu_ps(out.data() + i, _mm_div_ps(hi, lo));
+        }
+#elif NODEGRAPH_COLOR_NEON
+        float32x4_t const vb = vdupq_n_f32(lb), bias = vdupq_n_f32(0.05f);
+        for (; i + 4 <= out.size(); i += 4)
+        {
+            float32x4_t la = vld1q_f32(out.data() + i);
+            float32x4_t hi = vaddq_f32(vmaxq_f32(la, vb), bias);
+            float32x4_t lo = vaddq_f32(vminq_f32(la, vb), bias);
+            vst1q_f32(out.data() + i, vdivq_f32(hi, lo));
+        }
+#endif
+        for (; i < out.size(); ++i)
+            out[i] = ContrastRatio(out[i], lb);
+    }
+
+    // 自动对比文字色：text[i] 与 backgrounds[i] 的对比度低于 threshold 时换成黑白中对比更高的一个
+    inline void AutoContrastText(std::span<Rgba const> backgrounds, std::span<Rgba> text, float threshold) noexcept
+    {
+        constexpr size_t Block = 256;
+        float lumBg[Block], lumText[Block];
+        for (size_t base = 0; base < backgrounds.size(); base += Block)
+        {
+            size_t const n = std::min(Block, backgrounds.size() - base);
+            Luminance(backgrounds.subspan(base, n), std::span<float>{ lumBg, n });
+            Luminance(text.subspan(base, n), std::span<float>{ lumText, n });
+            Rgba* dst = text.data() + base;
+            size_t i = 0;
+#if NODEGRAPH_COLOR_AVX2
+            __m256 const bias = _mm256_set1_ps(0.05f), thr = _mm256_set1_ps(threshold), darkThr = _mm256_set1_ps(detail::DarkTextThreshold);
+            __m256i const dark = _mm256_set1_epi32(static_cast<int>(detail::Pack(ContrastDark)));
+            __m256i const light = _mm256_set1_epi32(static_cast<int>(detail::Pack(ContrastLight)));
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256 lb = _mm256_loadu_ps(lumBg + i), lt = _mm256_loadu_ps(lumText + i);
+                __m256 ratio = _mm256_div_ps(_mm256_add_ps(_mm256_max_ps(lb, lt), bias), _mm256_add_ps(_mm256_min_ps(lb, lt), bias));
+                __m256 s = _mm256_add_ps(lb, bias);
+                __m256i useDark = _mm256_castps_si256(_mm256_cmp_ps(_mm256_mul_ps(s, s), darkThr, _CMP_GE_OQ));
+                __m256i keep = _mm256_castps_si256(_mm256_cmp_ps(ratio, thr, _CMP_GE_OQ));
+                __m256i pick = _mm256_blendv_epi8(light, dark, useDark);
+                __m256i cur = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(pick, cur, keep));
+            }
+#elif NODEGRAPH_COLOR_SSE2
+            __m128 const bias = _mm_set1_ps(0.05f), thr = _mm_set1_ps(threshold), darkThr = _mm_set1_ps(detail::DarkTextThreshold);
+            __m128i const dark = _mm_set1_epi32(static_cast<int>(detail::Pack(ContrastDark)));
+            __m128i const light = _mm_set1_epi32(static_cast<int>(detail::Pack(ContrastLight)));
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128 lb = _mm_loadu_ps(lumBg + i), lt = _mm_loadu_ps(lumText + i);
+                __m128 ratio = _mm_div_ps(_mm_add_ps(_mm_max_ps(lb, lt), bias), _mm_add_ps(_mm_min_ps(lb, lt), bias));
+                __m128 s = _mm_add_ps(lb, bias);
+                __m128i useDark = _mm_castps_si128(_mm_cmpge_ps(_mm_mul_ps(s, s), darkThr));
+                __m128i keep = _mm_castps_si128(_mm_cmpge_ps(ratio, thr));
+                __m128i pick = _mm_or_si128(_mm_and_si128(useDark, dark), _mm_andnot_si128(useDark, light));
+                __m128i cur = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_and_si128(keep, cur), _mm_andnot_si128(keep, pick)));
+            }
+#elif NODEGRAPH_COLOR_NEON
+            float32x4_t const bias = vdupq_n_f32(0.05f), thr = vdupq_n_f32(threshold), darkThr = vdupq_n_f32(detail::DarkTextThreshold);
+            uint32x4_t const dark = vdupq_n_u32(detail::Pack(ContrastDark));
+            uint32x4_t const light = vdupq_n_u32(detail::Pack(ContrastLight));
+            for (; i + 4 <= n; i += 4)
+            {
+                float32x4_t lb = vld1q_f32(lumBg + i), lt = vld1q_f32(lumText + i);
+                float32x4_t ratio = vdivq_f32(vaddq_f32(vmaxq_f32(lb, lt), bias), vaddq_f32(vminq_f32(lb, lt), bias));
+                float32x4_t s = vaddq_f32(lb, bias);
+                uint32x4_t useDark = vcgeq_f32(vmulq_f32(s, s), darkThr);
+                uint32x4_t keep = vcgeq_f32(ratio, thr);
+                uint32x4_t pick = vbslq_u32(useDark, dark, light);
+                uint32_t* p = reinterpret_cast<uint32_t*>(dst + i);
+                vst1q_u32(p, vbslq_u32(keep, vld1q_u32(p), pick));
+            }
+#endif
+            for (; i < n; ++i)
+            {
+                if (!(ContrastRatio(lumBg[i], lumText[i]) >= threshold))
+                    dst[i] = ContrastText(lumBg[i]);
+            }
+        }
+    }
+
+    // 统一提亮（delta > 0）或压暗（delta < 0），alpha 不变
+    inline void Shade(std::span<Rgba const> colors, float delta, std::span<Rgba> out) noexcept
+    {
+        int const d = detail::ShadeStep(delta);
+        [[maybe_unused]] uint32_t const step = static_cast<uint32_t>(d < 0 ? -d : d) * 0x010101u;   // 只作用于 r g b 三个字节
+        size_t i = 0;
+#if NODEGRAPH_COLOR_AVX2
+        __m256i const k = _mm256_set1_epi32(static_cast<int>(step));
+        for (; i + 8 <= colors.size(); i += 8)
+        {
+            __m256i px = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(colors.data() + i));
+            px = d < 0 ? _mm256_subs_epu8(px, k) : _mm256_adds_epu8(px, k);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i), px);
+        }
+#elif NODEGRAPH_COLOR_SSE2
+        __m128i const k = _mm_set1_epi32(static_cast<int>(step));
+        for (; i + 4 <= colors.size(); i += 4)
+        {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<__m128i const*>(colors.data() + i));
+            px = d < 0 ? _mm_subs_epu8(px, k) : _mm_adds_epu8(px, k);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), px);
+        }
+#elif NODEGRAPH_COLOR_NEON
+        uint8x16_t const k = vreinterpretq_u8_u32(vdupq_n_u32(step));
+        for (; i + 4 <= colors.size(); i += 4)
+        {
+            uint8x16_t px = vld1q_u8(reinterpret_cast<uint8_t const*>(colors.data() + i));
+            px = d < 0 ? vqsubq_u8(px, k) : vqaddq_u8(px, k);
+            vst1q_u8(reinterpret_cast<uint8_t*>(out.data() + i), px);
+        }
+#endif
+        for (; i < colors.size(); ++i)
+            out[i] = detail::ShadeBy(colors[i], d);
+    }
+
+    // 按亮度反向调整：亮色（L > 0.5）压暗、暗色提亮 amount，用于在填充色上派生描边色
+    inline void AutoShade(std::span<Rgba const> colors, float amount, std::span<Rgba> out) noexcept
+    {
+        constexpr size_t Block = 256;
+        float lum[Block];
+        int const d = std::abs(detail::ShadeStep(amount));
+        [[maybe_unused]] uint32_t const step = static_cast<uint32_t>(d) * 0x010101u;
+        for (size_t base = 0; base < colors.size(); base += Block)
+        {
+            size_t const n = std::min(Block, colors.size() - base);
+            Luminance(colors.subspan(base, n), std::span<float>{ lum, n });
+            Rgba const* src = colors.data() + base;
+            Rgba* dst = out.data() + base;
+            size_t i = 0;
+#if NODEGRAPH_COLOR_AVX2
+            __m256i const k = _mm256_set1_epi32(static_cast<int>(step));
+            __m256 const half = _mm256_set1_ps(0.5f);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i px = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+                __m256i light = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(lum + i), half, _CMP_GT_OQ));
+                px = _mm256_blendv_epi8(_mm256_adds_epu8(px, k), _mm256_subs_epu8(px, k), light);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), px);
+            }
+#elif NODEGRAPH_COLOR_SSE2
+            __m128i const k = _mm_set1_epi32(static_cast<int>(step));
+            __m128 const half = _mm_set1_ps(0.5f);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i px = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+                __m128i light = _mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(lum + i), half));
+                px = _mm_or_si128(_mm_and_si128(light, _mm_subs_epu8(px, k)), _mm_andnot_si128(light, _mm_adds_epu8(px, k)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), px);
+            }
+#elif NODEGRAPH_COLOR_NEON
+            uint8x16_t const k = vreinterpretq_u8_u32(vdupq_n_u32(step));
+            float32x4_t const half = vdupq_n_f32(0.5f);
+            for (; i + 4 <= n; i += 4)
+            {
+                uint8x16_t px = vld1q_u8(reinterpret_cast<uint8_t const*>(src + i));
+                uint8x16_t light = vreinterpretq_u8_u32(vcgtq_f32(vld1q_f32(lum + i), half));
+                px = vbslq_u8(light, vqsubq_u8(px, k), vqaddq_u8(px, k));
+                vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), px);
+            }
+#endif
+            for (; i < n; ++i)
+                dst[i] = detail::ShadeBy(src[i], lum[i] > 0.5f ? -d : d);
+        }
+    }
+
+    // 色带：由若干等距色标线性插值出 256 级查找表，把 [lo, hi] 内的数值映射为颜色（越界截断，NaN 取最低端）
+    class ColorRamp
+    {
+    public:
+        ColorRamp() = default;
+
+        explicit ColorRamp(std::span<Rgba const> stops)
+        {
+            if (stops.empty())
+                return;
+            for (int i = 0; i < 256; ++i)
+            {
+                float pos = stops.size() == 1 ? 0.0f : i / 255.0f * static_cast<float>(stops.size() - 1);
+                size_t k = std::min(static_cast<size_t>(pos), stops.size() - 1);
+                size_t next = std::min(k + 1, stops.size() - 1);
+                float f = pos - static_cast<float>(k);
+                auto mix = [f](uint8_t a, uint8_t b) { return static_cast<uint8_t>(a + (b - a) * f + 0.5f); };
+                Rgba const& a = stops[k];
+                Rgba const& b = stops[next];
+                m_table[i] = detail::Pack(Rgba{ mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b), mix(a.a, b.a) });
+            }
+        }
+
+        Rgba At(uint8_t index) const noexcept
+        {
+            return std::bit_cast<Rgba>(m_table[index]);
+        }
+
+        void Map(std::span<float const> values, float lo, float hi, std::span<Rgba> out) const noexcept
+        {
+            float const scale = hi > lo ? 255.0f / (hi - lo) : 0.0f;
+            uint32_t* dst = reinterpret_cast<uint32_t*>(out.data());
+            size_t i = 0;
+#if NODEGRAPH_COLOR_AVX2
+            __m256 const vlo = _mm256_set1_ps(lo), vscale = _mm256_set1_ps(scale), top = _mm256_set1_ps(255.0f), half = _mm256_set1_ps(0.5f);
+            for (; i + 8 <= values.size(); i += 8)
+            {
+                __m256 x = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(values.data() + i), vlo), vscale);
+                x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), top);     // max 在 NaN 时返回第二个操作数 0
+                __m256i index = _mm256_cvttps_epi32(_mm256_add_ps(x, half));
+                __m256i px = _mm256_i32gather_epi32(reinterpret_cast<int const*>(m_table.data()), index, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), px);
+            }
+#elif NODEGRAPH_COLOR_SSE2
+            __m128 const vlo = _mm_set1_ps(lo), vscale = _mm_set1_ps(scale), top = _mm_set1_ps(255.0f), half = _mm_set1_ps(0.5f);
+            alignas(16) int32_t index[4];
+            for (; i + 4 <= values.size(); i += 4)
+            {
+                __m128 x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values.data() + i), vlo), vscale);
+                x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), top);
+                _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_cvttps_epi32(_mm_add_ps(x, half)));
+                dst[i] = m_table[index[0]];
+                dst[i + 1] = m_table[index[1]];
+                dst[i + 2] = m_table[index[2]];
+                dst[i + 3] = m_table[index[3]];
+            }
+#elif NODEGRAPH_COLOR_NEON
+            float32x4_t const vlo = vdupq_n_f32(lo), vscale = vdupq_n_f32(scale), top = vdupq_n_f32(255.0f), half = vdupq_n_f32(0.5f);
+            uint32_t index[4];
+            for (; i + 4 <= values.size(); i += 4)
+            {
+                float32x4_t x = vmulq_f32(vsubq_f32(vld1q_f32(values.data() + i), vlo), vscale);
+                x = vminq_f32(vmaxnmq_f32(x, vdupq_n_f32(0.0f)), top);     // maxnm 在 NaN 时返回另一个数
+                vst1q_u32(index, vcvtq_u32_f32(vaddq_f32(x, half)));
+                dst[i] = m_table[index[0]];
+                dst[i + 1] = m_table[index[1]];
+                dst[i + 2] = m_table[index[2]];
+                dst[i + 3] = m_table[index[3]];
+            }
+#endif
+            for (; i < values.size(); ++i)
+            {
+                float x = (values[i] - lo) * scale;
+                x = x > 0.0f ? std::min(x, 255.0f) : 0.0f;
+                dst[i] = m_table[static_cast<uint32_t>(x + 0.5f)];
+            }
+        }
+
+    private:
+        std::array<uint32_t, 256> m_table{};   // 按内存顺序打包的 Rgba
+    };
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "QuadTree.h"
+
+// 批量渲染模式的保留显示列表（与平台无关，可脱离 WinUI 单独编译）。
+// 节点按样式（形状、填充、描边、线宽、圆角）分批，每批是一组实例包围盒；
+// 边按样式（颜色、线宽）分批，每批是一组线段。条目键为调用方的稠密整数（节点槽位 / 边槽位），
+// 删除采用与末尾交换的方式，批内下标连续。
+// 每次修改同时写入变更日志（记录携带实例数据的副本），消费方按顺序重放即可得到与列表一致的镜像，
+// NodeGraphPanel 用它维护每批一个 Path 的 XAML 几何，Rasterizer 则直接遍历列表绘制到内存位图。
+namespace nodegraph
+{
+    // 非预乘 RGBA
+    struct Rgba
+    {
+        uint8_t r{ 0 };
+        uint8_t g{ 0 };
+        uint8_t b{ 0 };
+        uint8_t a{ 255 };
+
+        friend bool operator==(Rgba const&, Rgba const&) = default;
+        uint32_t Packed() const noexcept { return (uint32_t(a) << 24) | (uint32_t(r) << 16) | (uint32_t(g) << 8) | b; }
+    };
+
+    enum class Primitive : uint8_t
+    {
+        Ellipse,
+        RoundedRect,
+    };
+
+    struct NodeStyle
+    {
+        Primitive shape{ Primitive::Ellipse };
+        Rgba      fill{};
+        Rgba      stroke{};
+        float     strokeWidth{ 1.0f };
+        float     cornerRadius{ 0.0f };
+
+        friend bool operator==(NodeStyle const&, NodeStyle const&) = default;
+    };
+
+    struct EdgeStyle
+    {
+        Rgba  color{};
+        float thickness{ 1.0f };
+
+        friend bool operator==(EdgeStyle const&, EdgeStyle const&) = default;
+    };
+
+    struct Segment
+    {
+        float x1{ 0 };
+        float y1{ 0 };
+        float x2{ 0 };
+        float y2{ 0 };
+    };
+
+    class DisplayList
+    {
+    public:
+        template <typename Style, typename Instance>
+        struct Batch
+        {
+            Style                 style{};
+            std::vector<Instance> instances;
+            std::vector<uint32_t> keys;          // 与 instances 同下标
+        };
+        using NodeBatch = Batch<NodeStyle, Box>;
+        using EdgeBatch = Batch<EdgeStyle, Segment>;
+
+        enum class Layer : uint8_t { Nodes, Edges };
+        enum class ChangeKind : uint8_t
+        {
+            AddBatch,       // 新建批次（index 无意义）
+            Append,         // 追加实例到批末尾
+            Update,         // 原位更新 index 处实例
+            RemoveSwap,     // 末尾实例移到 index 后删除末尾
+            Reset,          // 全部清空（含批次）
+        };
+
+        struct Change
+        {
+            ChangeKind kind;
+            Layer      layer;
+            uint32_t   batch{ 0 };
+            uint32_t   index{ 0 };
+            Box        bounds{};         // Layer::Nodes 的 Append / Update
+            Segment    segment{};        // Layer::Edges 的 Append / Update
+        };
+
+        // —— 样式 -> 批次 ——
+        uint32_t NodeBatchFor(NodeStyle const& style)
+        {
+            return BatchFor(m_nodeBatches, style, Layer::Nodes);
+        }
+
+        uint32_t EdgeBatchFor(EdgeStyle const& style)
+        {
+            return BatchFor(m_edgeBatches, style, Layer::Edges);
+        }
+
+        // —— 实例 ——
+        // 键已存在时：同批原位更新，换批则先删后加
+        void SetNode(uint32_t key, uint32_t batch, Box const& bounds)
+        {
+            Set(m_nodeBatches, m_nodeWhere, Layer::Nodes, key, batch, bounds);
+        }
+
+        void RemoveNode(uint32_t key)
+        {
+            Remove(m_nodeBatches, m_nodeWhere, Layer::Nodes, key);
+        }
+
+        void SetEdge(uint32_t key, uint32_t batch, Segment const& segment)
+        {
+            Set(m_edgeBatches, m_edgeWhere, Layer::Edges, key, batch, segment);
+        }
+
+        void RemoveEdge(uint32_t key)
+        {
+            Remove(m_edgeBatches, m_edgeWhere, Layer::Edges, key);
+        }
+
+        bool ContainsNode(uint32_t key) const noexcept { return Contains(m_nodeWhere, key); }
+        bool ContainsEdge(uint32_t key) const noexcept { return Contains(m_edgeWhere, key); }
+
+        std::vector<NodeBatch> const& NodeBatches() const noexcept { return m_nodeBatches; }
+        std::vector<EdgeBatch> const& EdgeBatches() const noexcept { return m_edgeBatches; }
+
+        size_t NodeCount() const noexcept { return Count(m_nodeBatches); }
+        size_t EdgeCount() const noexcept { return Count(m_edgeBatches); }
+
+        void Clear()
+        {
+            m_nodeBatches.clear();
+            m_edgeBatches.clear();
+            m_nodeWhere.clear();
+            m_edgeWhere.clear();
+            m_journal.clear();
+            m_journal.push_back(Change{ ChangeKind::Reset, Layer::Nodes });
+        }
+
+        // —— 变更日志 ——
+        bool HasChanges() const noexcept { return !m_journal.empty(); }
+
+        // 按发生顺序回放并清空日志
+        template <typename F>
+        void ConsumeChanges(F&& apply)
+        {
+            auto journal = std::move(m_journal);
+            m_journal.clear();
+            for (auto const& change : journal)
+                apply(change);
+        }
+
+    private:
+        struct Location
+        {
+            uint32_t batch{ InvalidIndex };
+            uint32_t index{ 0 };
+        };
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+        template <typename Batches, typename Style>
+        uint32_t BatchFor(Batches& batches, Style const& style, Layer layer)
+        {
+            // 样式种类很少（主题 × 形状 × 选中态），线性查找足够
+            for (uint32_t i = 0; i < batches.size(); ++i)
+                if (batches[i].style == style)
+                    return i;
+            batches.push_back({ style, {}, {} });
+            uint32_t const index = static_cast<uint32_t>(batches.size() - 1);
+            m_journal.push_back(Change{ ChangeKind::AddBatch, layer, index });
+            return index;
+        }
+
+        static bool Contains(std::vector<Location> const& where, uint32_t key) noexcept
+        {
+            return key < where.size() && where[key].batch != InvalidIndex;
+        }
+
+        template <typename Batches>
+        static size_t Count(Batches const& batches) noexcept
+        {
+            size_t n = 0;
+            for (auto const& b : batches)
+                n += b.instances.size();
+            return n;
+        }
+
+        template <typename Batches, typename Instance>
+        void Set(Batches& batches, std::vector<Location>& where, Layer layer, uint32_t key, uint32_t batch, Instance const& value)
+        {
+            if (Contains(where, key))
+            {
+                auto const at = where[key];
+                if (at.batch == batch)
+                {
+                    batches[batch].instances[at.index] = value;
+                    Record(ChangeKind::Update, layer, batch, at.index, value);
+                    return;
+                }
+                Remove(batches, where, layer, key);
+            }
+            if (key >= where.size())
+                where.resize(static_cast<size_t>(key) + 1);
+            auto& target = batches[batch];
+            where[key] = Location{ batch, static_cast<uint32_t>(target.instances.size()) };
+            target.instances.push_back(value);
+            target.keys.push_back(key);
+            Record(ChangeKind::Append, layer, batch, where[key].index, value);
+        }
+
+        template <typename Batches>
+        void Remove(Batches& batches, std::vector<Location>& where, Layer layer, uint32_t key)
+        {
+            if (!Contains(where, key))
+                return;
+            auto const at = where[key];
+            auto& b = batches[at.batch];
+            b.instances[at.index] = b.instances.back();
+            b.keys[at.index] = b.keys.back();
+            where[b.keys[at.index]].index = at.index;
+            b.instances.pop_back();
+            b.keys.pop_back();
+            where[key] = Location{};
+            m_journal.push_back(Change{ ChangeKind::RemoveSwap, layer, at.batch, at.index });
+        }
+
+        void Record(ChangeKind kind, Layer layer, uint32_t batch, uint32_t index, Box const& bounds)
+        {
+            m_journal.push_back(Change{ kind, layer, batch, index, bounds, {} });
+        }
+
+        void Record(ChangeKind kind, Layer layer, uint32_t batch, uint32_t index, Segment const& segment)
+        {
+            m_journal.push_back(Change{ kind, layer, batch, index, {}, segment });
+        }
+
+        std::vector<NodeBatch> m_nodeBatches;
+        std::vector<EdgeBatch> m_edgeBatches;
+        std::vector<Location>  m_nodeWhere;      // 节点键 -> 批次与下标
+        std::vector<Location>  m_edgeWhere;      // 边键 -> 批次与下标
+        std::vector<Change>    m_journal;
+    };
+}
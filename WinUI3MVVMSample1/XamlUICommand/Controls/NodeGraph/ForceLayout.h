@@ -0,0 +1,434 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 力导向自动布局（Fruchterman–Reingold 形式：斥力 k²/d，引力 d²/k，位移受温度限制并逐轮冷却），与平台无关。
+// 斥力用 Barnes–Hut 四叉树近似：每轮按当前位置重建树（O(n log n)），张角小于 theta 的远处子树以其质心代替。
+// 每个节点只读树、只写自己的力与位置，斥力累加与位移按节点分块并行，结果与线程数无关。
+// 节点与边的键为调用方的稠密整数（NodeGraphPanel 使用 GraphIndex 槽位）。布局进行中加入的节点可放在
+// 已放置邻居的质心附近，温度只回升一部分（热启动），已收敛的部分不会被重新打散。
+namespace nodegraph
+{
+    struct ForceLayoutSettings
+    {
+        float    springLength{ 120.0f };    // 理想边长 k
+        float    gravity{ 0.05f };          // 指向整体质心的拉力，避免不连通的分量漂远
+        float    theta{ 0.9f };             // Barnes–Hut 张角阈值，越小越精确
+        float    cooling{ 0.95f };          // 每轮温度衰减
+        float    tolerance{ 0.01f };        // 最大位移低于 tolerance * k 视为收敛
+        float    reheat{ 0.3f };            // 热启动时温度回升到初始温度的比例
+        uint32_t threads{ 0 };              // 0 = hardware_concurrency
+    };
+
+    class ForceLayout
+    {
+    public:
+        using Settings = ForceLayoutSettings;
+
+        explicit ForceLayout(Settings const& settings = {})
+            : m_settings(settings)
+        {
+            m_threads = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        Settings const& GetSettings() const noexcept { return m_settings; }
+
+        // —— 节点 ——
+        // 新键：加入并热启动；seed 为 true 时在下一轮放到已放置邻居的质心附近（无邻居则在给定位置附近散开）
+        // 已有键：视为外部移动（例如拖动），更新位置并热启动
+        void SetNode(uint32_t key, float x, float y, bool seed = false)
+        {
+            if (key >= m_index.size())
+                m_index.resize(static_cast<size_t>(key) + 1, InvalidIndex);
+            if (m_index[key] == InvalidIndex)
+            {
+                m_index[key] = static_cast<uint32_t>(m_keys.size());
+                m_keys.push_back(key);
+                m_x.push_back(x);
+                m_y.push_back(y);
+                if (seed)
+                    m_pendingSeeds.push_back(key);
+            }
+            else
+            {
+                m_x[m_index[key]] = x;
+                m_y[m_index[key]] = y;
+            }
+            Reheat();
+        }
+
+        void RemoveNode(uint32_t key)
+        {
+            if (!IsNodeAlive(key))
+                return;
+            uint32_t const at = m_index[key];
+            uint32_t const last = static_cast<uint32_t>(m_keys.size() - 1);
+            m_keys[at] = m_keys[last];
+            m_x[at] = m_x[last];
+            m_y[at] = m_y[last];
+            m_index[m_keys[at]] = at;
+            m_keys.pop_back();
+            m_x.pop_back();
+            m_y.pop_back();
+            m_index[key] = InvalidIndex;
+            Reheat();       // 关联边在 Step 中因端点失效而跳过，调用方随后会移除
+        }
+
+        bool IsNodeAlive(uint32_t key) const noexcept { return key < m_index.size() && m_index[key] != InvalidIndex; }
+        float X(uint32_t key) const noexcept { return m_x[m_index[key]]; }
+        float Y(uint32_t key) const noexcept { return m_y[m_index[key]]; }
+
+        // visit(key, x, y)
+        template <typename F>
+        void ForEachNode(F&& visit) const
+        {
+            for (size_t i = 0; i < m_keys.size(); ++i)
+                visit(m_keys[i], m_x[i], m_y[i]);
+        }
+
+        // —— 边（端点为节点键）——
+        void SetEdge(uint32_t key, uint32_t a, uint32_t b)
+        {
+            if (key >= m_edgeIndex.size())
+                m_edgeIndex.resize(static_cast<size_t>(key) + 1, InvalidIndex);
+            if (m_edgeIndex[key] == InvalidIndex)
+            {
+                m_edgeIndex[key] = static_cast<uint32_t>(m_edges.size());
+                m_edges.push_back(EdgeRecord{ key, a, b });
+            }
+            else
+            {
+                auto& e = m_edges[m_edgeIndex[key]];
+                if (e.a == a && e.b == b)
+                    return;
+                e.a = a;
+                e.b = b;
+            }
+            Reheat();
+        }
+
+        void RemoveEdge(uint32_t key)
+        {
+            if (key >= m_edgeIndex.size() || m_edgeIndex[key] == InvalidIndex)
+                return;
+            uint32_t const at = m_edgeIndex[key];
+            m_edges[at] = m_edges.back();
+            m_edgeIndex[m_edges[at].key] = at;
+            m_edges.pop_back();
+            m_edgeIndex[key] = InvalidIndex;
+            Reheat();
+        }
+
+        size_t NodeCount() const noexcept { return m_keys.size(); }
+        size_t EdgeCount() const noexcept { return m_edges.size(); }
+
+        // —— 迭代 ——
+        float Temperature() const noexcept { return m_temperature; }
+        bool IsConverged() const noexcept { return m_converged; }
+
+        // 冷启动：温度回到初始值
+        void Restart() noexcept
+        {
+            m_temperature = InitialTemperature();
+            m_converged = m_keys.empty();
+        }
+
+        // 执行一轮，返回本轮最大位移
+        float Step()
+        {
+            size_t const n = m_keys.size();
+            if (n == 0)
+            {
+                m_converged = true;
+                return 0.0f;
+            }
+            float const k = m_settings.springLength;
+            PlacePendingSeeds();
+            BuildTree();
+
+            // 引力（沿边，串行）：先写入力缓冲，斥力阶段在各自节点上累加
+            m_fx.assign(n, 0.0f);
+            m_fy.assign(n, 0.0f);
+            for (auto const& e : m_edges)
+            {
+                if (!IsNodeAlive(e.a) || !IsNodeAlive(e.b) || e.a == e.b)
+                    continue;
+                uint32_t const ia = m_index[e.a], ib = m_index[e.b];
+                float const dx = m_x[ib] - m_x[ia], dy = m_y[ib] - m_y[ia];
+                float const d = std::sqrt(dx * dx + dy * dy);
+                float const s = d / k;
+                m_fx[ia] += dx * s;
+                m_fy[ia] += dy * s;
+                m_fx[ib] -= dx * s;
+                m_fy[ib] -= dy * s;
+            }
+
+            // 斥力 + 重力 + 位移（并行）：只读树，不读其它节点的位置，因此可原地更新位置
+            auto const& root = m_cells[0];
+            float const gx = root.mx, gy = root.my;
+            float const t = m_temperature;
+            std::vector<float> maxMove(m_threads, 0.0f);
+            ParallelFor(n, [&](size_t begin, size_t end, uint32_t worker)
+                {
+                    float localMax = 0.0f;
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        float fx = m_fx[i], fy = m_fy[i];
+                        Repulse(static_cast<uint32_t>(i), m_x[i], m_y[i], fx, fy);
+                        fx += (gx - m_x[i]) * m_settings.gravity;
+                        fy += (gy - m_y[i]) * m_settings.gravity;
+                        float const len = std::sqrt(fx * fx + fy * fy);
+                        if (len <= 0.0f)
+                            continue;
+                        float const move = std::min(len, t);
+                        m_x[i] += fx / len * move;
+                        m_y[i] += fy / len * move;
+                        localMax = std::max(localMax, move);
+                    }
+                    maxMove[worker] = std::max(maxMove[worker], localMax);
+                });
+
+            float const moved = *std::max_element(maxMove.begin(), maxMove.end());
+            float const floor = m_settings.tolerance * k;
+            m_temperature = std::max(m_temperature * m_settings.cooling, floor);
+            m_converged = moved <= floor;
+            return moved;
+        }
+
+    private:
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+        static constexpr int32_t  NoBody = -1;
+        static constexpr int32_t  Bucket = -2;      // 达到最大深度、容纳多个重合节点的叶子
+        static constexpr int      MaxDepth = 24;
+        static constexpr size_t   Chunk = 512;
+
+        struct EdgeRecord
+        {
+            uint32_t key;
+            uint32_t a;
+            uint32_t b;
+        };
+
+        // 正方形单元：中心 (cx, cy)，半边长 half；建树时 (mx, my) 累加坐标和，结束后换算为质心
+        struct Cell
+        {
+            float   cx;
+            float   cy;
+            float   half;
+            float   mx{ 0 };
+            float   my{ 0 };
+            float   mass{ 0 };
+            int32_t child{ -1 };        // 四个子单元连续存放，child 为第一个的下标
+            int32_t body{ NoBody };
+        };
+
+        float InitialTemperature() const noexcept
+        {
+            return m_settings.springLength * std::max(1.0f, std::sqrt(static_cast<float>(m_keys.size())) * 0.5f);
+        }
+
+        void Reheat() noexcept
+        {
+            m_temperature = std::max(m_temperature, InitialTemperature() * m_settings.reheat);
+            m_converged = false;
+        }
+
+        // 新节点放到已放置邻居的质心，并按键做确定性的小幅偏移，避免多个节点重合
+        void PlacePendingSeeds()
+        {
+            if (m_pendingSeeds.empty())
+                return;
+            std::vector<uint8_t> pending(m_keys.size(), 0);
+            for (uint32_t key : m_pendingSeeds)
+                if (IsNodeAlive(key))
+                    pending[m_index[key]] = 1;
+            std::vector<float> sx(m_keys.size(), 0.0f), sy(m_keys.size(), 0.0f);
+            std::vector<uint32_t> count(m_keys.size(), 0);
+            for (auto const& e : m_edges)
+            {
+                if (!IsNodeAlive(e.a) || !IsNodeAlive(e.b))
+                    continue;
+                uint32_t const ia = m_index[e.a], ib = m_index[e.b];
+                if (pending[ia] && !pending[ib]) { sx[ia] += m_x[ib]; sy[ia] += m_y[ib]; ++count[ia]; }
+                if (pending[ib] && !pending[ia]) { sx[ib] += m_x[ia]; sy[ib] += m_y[ia]; ++count[ib]; }
+            }
+            float const k = m_settings.springLength;
+            for (uint32_t key : m_pendingSeeds)
+            {
+                if (!IsNodeAlive(key))
+                    continue;
+                uint32_t const i = m_index[key];
+                if (count[i])
+                {
+                    m_x[i] = sx[i] / count[i];
+                    m_y[i] = sy[i] / count[i];
+                }
+                uint32_t h = key * 2654435761u;
+                float const angle = (h >> 8) * (6.2831853f / 16777216.0f);
+                float const radius = k * (0.25f + 0.5f * ((h & 0xFF) / 255.0f));
+                m_x[i] += std::cos(angle) * radius;
+                m_y[i] += std::sin(angle) * radius;
+            }
+            m_pendingSeeds.clear();
+        }
+
+        void BuildTree()
+        {
+            float minX = m_x[0], maxX = m_x[0], minY = m_y[0], maxY = m_y[0];
+            for (size_t i = 1; i < m_keys.size(); ++i)
+            {
+                minX = std::min(minX, m_x[i]); maxX = std::max(maxX, m_x[i]);
+                minY = std::min(minY, m_y[i]); maxY = std::max(maxY, m_y[i]);
+            }
+            m_cells.clear();
+            m_cells.reserve(m_keys.size() * 2 + 1);
+            m_cells.push_back(Cell{ (minX + maxX) * 0.5f, (minY + maxY) * 0.5f,
+                                    std::max(maxX - minX, maxY - minY) * 0.5f + 1.0f });
+            for (uint32_t i = 0; i < m_keys.size(); ++i)
+                Insert(i);
+            for (auto& cell : m_cells)
+            {
+                if (cell.mass > 0)
+                {
+                    cell.mx /= cell.mass;
+                    cell.my /= cell.mass;
+                }
+            }
+        }
+
+        void Insert(uint32_t i)
+        {
+            float const x = m_x[i], y = m_y[i];
+            uint32_t at = 0;
+            for (int depth = 0;; ++depth)
+            {
+                // 沿途每个单元都计入该节点的质量
+                m_cells[at].mass += 1.0f;
+                m_cells[at].mx += x;
+                m_cells[at].my += y;
+                if (m_cells[at].child < 0)
+                {
+                    if (m_cells[at].mass == 1.0f)
+                    {
+                        m_cells[at].body = static_cast<int32_t>(i);
+                        return;
+                    }
+                    if (depth >= MaxDepth || m_cells[at].body == Bucket)
+                    {
+                        m_cells[at].body = Bucket;
+                        return;
+                    }
+                    // 叶子已有一个节点：分裂，原节点下沉到对应子单元
+                    int32_t const other = m_cells[at].body;
+                    Split(at);
+                    uint32_t const oc = static_cast<uint32_t>(m_cells[at].child) + Quadrant(m_cells[at], m_x[other], m_y[other]);
+                    m_cells[oc].mass = 1.0f;
+                    m_cells[oc].mx = m_x[other];
+                    m_cells[oc].my = m_y[other];
+                    m_cells[oc].body = other;
+                }
+                at = static_cast<uint32_t>(m_cells[at].child) + Quadrant(m_cells[at], x, y);
+            }
+        }
+
+        void Split(uint32_t at)
+        {
+            float const h = m_cells[at].half * 0.5f;
+            float const cx = m_cells[at].cx, cy = m_cells[at].cy;
+            m_cells[at].child = static_cast<int32_t>(m_cells.size());
+            m_cells[at].body = NoBody;
+            for (int q = 0; q < 4; ++q)
+                m_cells.push_back(Cell{ cx + ((q & 1) ? h : -h), cy + ((q & 2) ? h : -h), h });
+        }
+
+        static uint32_t Quadrant(Cell const& cell, float x, float y) noexcept
+        {
+            return (x < cell.cx ? 0u : 1u) + (y < cell.cy ? 0u : 2u);
+        }
+
+        void Repulse(uint32_t i, float x, float y, float& fx, float& fy) const
+        {
+            float const k2 = m_settings.springLength * m_settings.springLength;
+            float const theta2 = m_settings.theta * m_settings.theta;
+            uint32_t stack[MaxDepth * 4 + 8];
+            int top = 0;
+            stack[top++] = 0;
+            while (top > 0)
+            {
+                auto const& cell = m_cells[stack[--top]];
+                if (cell.mass <= 0 || cell.body == static_cast<int32_t>(i))
+                    continue;
+                float dx = x - cell.mx, dy = y - cell.my;
+                float d2 = dx * dx + dy * dy;
+                bool const leaf = cell.child < 0;
+                float const size = cell.half * 2.0f;
+                if (!leaf && size * size >= theta2 * d2)
+                {
+                    for (int q = 0; q < 4; ++q)
+                        stack[top++] = static_cast<uint32_t>(cell.child + q);
+                    continue;
+                }
+                float mass = cell.mass;
+                if (d2 < 1e-6f)
+                {
+                    // 与其它节点重合：沿由下标决定的方向推开（重合桶的质心含自身，扣除自身质量）
+                    if (cell.body == Bucket)
+                        mass -= 1.0f;
+                    float const angle = (i * 2654435761u >> 8) * (6.2831853f / 16777216.0f);
+                    dx = std::cos(angle) * 0.01f;
+                    dy = std::sin(angle) * 0.01f;
+                    d2 = 1e-4f;
+                }
+                float const s = k2 * mass / d2;
+                fx += dx * s;
+                fy += dy * s;
+            }
+        }
+
+        template <typename F>
+        void ParallelFor(size_t count, F&& body)
+        {
+            if (m_threads <= 1 || count < Chunk * 2)
+            {
+                body(0, count, 0u);
+                return;
+            }
+            std::atomic<size_t> next{ 0 };
+            auto run = [&](uint32_t worker)
+                {
+                    for (;;)
+                    {
+                        size_t const begin = next.fetch_add(Chunk, std::memory_order_relaxed);
+                        if (begin >= count)
+                            return;
+                        body(begin, std::min(begin + Chunk, count), worker);
+                    }
+                };
+            uint32_t const workers = static_cast<uint32_t>(std::min<size_t>(m_threads, (count + Chunk - 1) / Chunk));
+            std::vector<std::jthread> pool;
+            pool.reserve(workers - 1);
+            for (uint32_t w = 1; w < workers; ++w)
+                pool.emplace_back(run, w);
+            run(0);
+        }
+
+        Settings                m_settings;
+        uint32_t                m_threads{ 1 };
+        std::vector<uint32_t>   m_keys;         // 紧凑下标 -> 键
+        std::vector<uint32_t>   m_index;        // 键 -> 紧凑下标
+        std::vector<float>      m_x;
+        std::vector<float>      m_y;
+        std::vector<float>      m_fx;
+        std::vector<float>      m_fy;
+        std::vector<EdgeRecord> m_edges;
+        std::vector<uint32_t>   m_edgeIndex;    // 边键 -> m_edges 下标
+        std::vector<uint32_t>   m_pendingSeeds;
+        std::vector<Cell>       m_cells;
+        float                   m_temperature{ 0.0f };
+        bool                    m_converged{ true };
+    };
+}
@@ -0,0 +1,631 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 紧凑的二进制图文件（与平台无关）：文件头之后是一串独立的块，每块是若干行的列式表，
+// 节点块（Id、位置、尺寸、形状、标签 + 任意个元数据列）与边块（端点、权重、方向、标签）可以任意交错，
+// 因此写入方可以边生成边输出，读取方可以逐块解析、逐块显示，不需要先读完整个文件。
+//
+//   文件头  : "NGRF" u16 版本 u16 保留 u64 保留
+//   块头    : u32 类型 u32 保留 u64 负载字节数（8 的倍数）
+//   节点块  : u32 行数 u32 元数据列数 | i64 id[n] | f32 x[n] y[n] width[n] height[n] | u8 shape[n] | 字符串列 label
+//             每个元数据列：字符串 key | u8 类型 | u8 存在位图[(n + 7) / 8] | 值（i64 / f64 / u8 [n] 或字符串列）
+//   边块    : u32 行数 u32 保留 | i64 from[n] to[n] | f32 weight[n] | u8 flags[n]（bit0 有向）| 字符串列 label
+//   字符串列: u32 偏移[n + 1] | UTF-8 字节
+//   结束块  : 类型 End、负载为空；缺少结束块的文件视为被截断
+//
+// 所有整数为小端；每一列（及每个字符串）之后补齐到 8 字节，列在映射内存中保持自然对齐。
+// GraphFileReader 只做边界检查与列复制，字符串以 string_view 直接指向映射内存；MappedFile 负责只读映射。
+namespace nodegraph
+{
+    enum class GraphChunkKind : uint32_t
+    {
+        Nodes = 1,
+        Edges = 2,
+        End = 0xFFFFFFFFu,
+    };
+
+    enum class MetaType : uint8_t
+    {
+        Int64 = 1,
+        Double = 2,
+        Bool = 3,
+        String = 4,
+    };
+
+    using MetaValue = std::variant<int64_t, double, bool, std::string_view>;
+
+    struct StringColumn
+    {
+        std::vector<uint32_t> offsets;
+        std::string_view bytes;
+
+        std::string_view operator[](size_t row) const noexcept
+        {
+            return bytes.substr(offsets[row], offsets[row + 1] - offsets[row]);
+        }
+    };
+
+    struct MetaColumn
+    {
+        std::string_view key;
+        MetaType type{ MetaType::Int64 };
+        std::vector<uint8_t> present;   // 位图
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<uint8_t> bools;
+        StringColumn strings;
+
+        bool Has(size_t row) const noexcept { return (present[row >> 3] >> (row & 7)) & 1; }
+
+        MetaValue Value(size_t row) const noexcept
+        {
+            switch (type)
+            {
+            case MetaType::Int64:  return ints[row];
+            case MetaType::Double: return doubles[row];
+            case MetaType::Bool:   return bools[row] != 0;
+            default:               return strings[row];
+            }
+        }
+    };
+
+    // 一个块解析后的内容；Next 复用其中的存储
+    struct GraphChunk
+    {
+        GraphChunkKind kind{ GraphChunkKind::End };
+        uint32_t rows{ 0 };
+
+        // 节点块
+        std::vector<int64_t> ids;
+        std::vector<float> x, y, width, height;
+        std::vector<uint8_t> shape;
+        std::vector<MetaColumn> meta;
+
+        // 边块
+        std::vector<int64_t> from, to;
+        std::vector<float> weight;
+        std::vector<uint8_t> flags;     // bit0: 有向
+
+        StringColumn labels;            // 两种块共用
+    };
+
+    namespace graphfile
+    {
+        inline constexpr uint8_t Magic[4] = { 'N', 'G', 'R', 'F' };
+        inline constexpr uint16_t Version = 1;
+        inline constexpr size_t HeaderSize = 16;
+        inline constexpr size_t ChunkHeaderSize = 16;
+
+        constexpr size_t Pad8(size_t n) noexcept { return (n + 7) & ~size_t{ 7 }; }
+    }
+
+    enum class GraphFileResult : uint8_t
+    {
+        Chunk,      // out 中是新的一块
+        End,        // 文件结束
+        Invalid,    // 格式错误（之后的调用也返回 Invalid）
+    };
+
+    class GraphFileReader
+    {
+    public:
+        explicit GraphFileReader(std::span<uint8_t const> data) : m_data(data)
+        {
+            if (data.size() < graphfile::HeaderSize || std::memcmp(data.data(), graphfile::Magic, 4) != 0)
+            {
+                m_invalid = true;
+                return;
+            }
+            uint16_t version = 0;
+            std::memcpy(&version, data.data() + 4, sizeof(version));
+            m_invalid = version != graphfile::Version;
+            m_offset = graphfile::HeaderSize;
+        }
+
+        // 已消费的字节数 / 总字节数，用于进度
+        size_t Offset() const noexcept { return m_offset; }
+        size_t Size() const noexcept { return m_data.size(); }
+
+        GraphFileResult Next(GraphChunk& out)
+        {
+            for (;;)
+            {
+                if (m_invalid)
+                    return GraphFileResult::Invalid;
+                if (m_ended)
+                    return GraphFileResult::End;
+                if (m_data.size() - m_offset < graphfile::ChunkHeaderSize)
+                    return Fail();
+
+                uint32_t kind = 0;
+                uint64_t length = 0;
+                std::memcpy(&kind, m_data.data() + m_offset, sizeof(kind));
+                std::memcpy(&length, m_data.data() + m_offset + 8, sizeof(length));
+                size_t const start = m_offset + graphfile::ChunkHeaderSize;
+                if (length > m_data.size() - start)
+                    return Fail();
+                m_offset = start + static_cast<size_t>(length);
+
+                Cursor c{ m_data.data() + start, m_data.data() + m_offset };
+                switch (static_cast<GraphChunkKind>(kind))
+                {
+                case GraphChunkKind::End:
+                    m_offset = m_data.size();
+                    m_ended = true;
+                    return GraphFileResult::End;
+                case GraphChunkKind::Nodes:
+                    out.kind = GraphChunkKind::Nodes;
+                    return ReadNodes(c, out) ? GraphFileResult::Chunk : Fail();
+                case GraphChunkKind::Edges:
+                    out.kind = GraphChunkKind::Edges;
+                    return ReadEdges(c, out) ? GraphFileResult::Chunk : Fail();
+                default:
+                    break;      // 未知块：跳过，留给以后的版本
+                }
+            }
+        }
+
+    private:
+        struct Cursor
+        {
+            uint8_t const* p;
+            uint8_t const* end;
+
+            size_t Remaining() const noexcept { return static_cast<size_t>(end - p); }
+
+            bool Skip(size_t n) noexcept
+            {
+                n = graphfile::Pad8(n);
+                if (n > Remaining())
+                    return false;
+                p += n;
+                return true;
+            }
+
+            template <typename T>
+            bool Column(std::vector<T>& out, size_t n)
+            {
+                if (n > Remaining() / sizeof(T))
+                    return false;
+                out.resize(n);
+                if (n)
+                    std::memcpy(out.data(), p, n * sizeof(T));
+                return Skip(n * sizeof(T));
+            }
+
+            bool Words(uint32_t& a, uint32_t& b) noexcept
+            {
+                if (Remaining() < 8)
+                    return false;
+                std::memcpy(&a, p, 4);
+                std::memcpy(&b, p + 4, 4);
+                p += 8;
+                return true;
+            }
+
+            bool String(std::string_view& out) noexcept
+            {
+                uint32_t length = 0, unused = 0;
+                if (!Words(length, unused) || length > Remaining())
+                    return false;
+                out = std::string_view{ reinterpret_cast<char const*>(p), length };
+                return Skip(length);
+            }
+
+            bool Strings(StringColumn& out, size_t n)
+            {
+                if (!Column(out.offsets, n + 1) || out.offsets[0] != 0)
+                    return false;
+                for (size_t i = 0; i < n; ++i)
+                    if (out.offsets[i + 1] < out.offsets[i])
+                        return false;
+                size_t const length = out.offsets[n];
+                if (length > Remaining())
+                    return false;
+                out.bytes = std::string_view{ reinterpret_cast<char const*>(p), length };
+                return Skip(length);
+            }
+        };
+
+        GraphFileResult Fail() noexcept
+        {
+            m_invalid = true;
+            return GraphFileResult::Invalid;
+        }
+
+        static bool ReadNodes(Cursor& c, GraphChunk& out)
+        {
+            uint32_t columns = 0;
+            if (!c.Words(out.rows, columns))
+                return false;
+            size_t const n = out.rows;
+            if (!c.Column(out.ids, n) || !c.Column(out.x, n) || !c.Column(out.y, n) ||
+                !c.Column(out.width, n) || !c.Column(out.height, n) || !c.Column(out.shape, n) ||
+                !c.Strings(out.labels, n))
+                return false;
+
+            if (columns > c.Remaining() / 16)
+                return false;
+            out.meta.resize(columns);
+            for (auto& column : out.meta)
+            {
+                std::vector<uint8_t> type;
+                if (!c.String(column.key) || !c.Column(type, 1) || !c.Column(column.present, (n + 7) / 8))
+                    return false;
+                column.type = static_cast<MetaType>(type[0]);
+                bool ok = false;
+                switch (column.type)
+                {
+                case MetaType::Int64:  ok = c.Column(column.ints, n); break;
+                case MetaType::Double: ok = c.Column(column.doubles, n); break;
+                case MetaType::Bool:   ok = c.Column(column.bools, n); break;
+                case MetaType::String: ok = c.Strings(column.strings, n); break;
+                }
+                if (!ok)
+                    return false;
+            }
+            return true;
+        }
+
+        static bool ReadEdges(Cursor& c, GraphChunk& out)
+        {
+            uint32_t reserved = 0;
+            if (!c.Words(out.rows, reserved))
+                return false;
+            size_t const n = out.rows;
+            out.meta.clear();
+            return c.Column(out.from, n) && c.Column(out.to, n) && c.Column(out.weight, n) &&
+                c.Column(out.flags, n) && c.Strings(out.labels, n);
+        }
+
+        std::span<uint8_t const> m_data;
+        size_t m_offset{ 0 };
+        bool m_invalid{ false };
+        bool m_ended{ false };
+    };
+
+    // 按行追加，每满 rowsPerChunk 行输出一块；Finish 输出剩余的行与结束块
+    class GraphFileWriter
+    {
+    public:
+        explicit GraphFileWriter(std::vector<uint8_t>& out, uint32_t rowsPerChunk = 16384)
+            : m_out(out), m_rowsPerChunk(std::max<uint32_t>(rowsPerChunk, 1))
+        {
+            uint8_t header[graphfile::HeaderSize]{};
+            std::memcpy(header, graphfile::Magic, 4);
+            std::memcpy(header + 4, &graphfile::Version, sizeof(graphfile::Version));
+            m_out.insert(m_out.end(), header, header + sizeof(header));
+        }
+
+        void AddNode(int64_t id, float x, float y, float width, float height, uint8_t shape, std::string_view label)
+        {
+            // 满块在下一行到来时才输出，SetNodeMeta 仍能作用于块内最后一行
+            if (m_nodes.ids.size() >= m_rowsPerChunk)
+                FlushNodes();
+            auto& n = m_nodes;
+            n.ids.push_back(id);
+            n.x.push_back(x);
+            n.y.push_back(y);
+            n.width.push_back(width);
+            n.height.push_back(height);
+            n.shape.push_back(shape);
+            n.labels.Add(label);
+        }
+
+        // 作用于最近一次 AddNode 的节点；同一键在一块内须使用同一类型
+        void SetNodeMeta(std::string_view key, MetaValue const& value)
+        {
+            if (m_nodes.ids.empty())
+                return;
+            size_t const row = m_nodes.ids.size() - 1;
+            auto it = std::find_if(m_nodes.meta.begin(), m_nodes.meta.end(), [&](auto const& m) { return m.key == key; });
+            if (it == m_nodes.meta.end())
+            {
+                auto& added = m_nodes.meta.emplace_back();
+                added.key = key;
+                added.type = static_cast<MetaType>(value.index() + 1);
+                it = m_nodes.meta.end() - 1;
+            }
+            auto& m = *it;
+            if (m.type != static_cast<MetaType>(value.index() + 1))
+                return;
+            m.Extend(row + 1);
+            m.present[row >> 3] |= uint8_t(1u << (row & 7));
+            switch (m.type)
+            {
+            case MetaType::Int64:  m.ints[row] = std::get<int64_t>(value); break;
+            case MetaType::Double: m.doubles[row] = std::get<double>(value); break;
+            case MetaType::Bool:   m.bools[row] = std::get<bool>(value) ? 1 : 0; break;
+            case MetaType::String: m.strings.Set(row, std::get<std::string_view>(value)); break;
+            }
+        }
+
+        void AddEdge(int64_t from, int64_t to, float weight, bool directed, std::string_view label)
+        {
+            if (m_edges.from.size() >= m_rowsPerChunk)
+                FlushEdges();
+            auto& e = m_edges;
+            e.from.push_back(from);
+            e.to.push_back(to);
+            e.weight.push_back(weight);
+            e.flags.push_back(directed ? 1 : 0);
+            e.labels.Add(label);
+        }
+
+        void Finish()
+        {
+            FlushNodes();
+            FlushEdges();
+            BeginChunk(GraphChunkKind::End);
+            EndChunk();
+        }
+
+    private:
+        // 字符串列的写入端（允许按行稀疏设置，用于元数据列）
+        struct StringBuilder
+        {
+            std::vector<uint32_t> offsets{ 0 };
+            std::vector<std::string> values;
+
+            void Add(std::string_view s) { values.emplace_back(s); }
+            void Set(size_t row, std::string_view s)
+            {
+                if (values.size() <= row)
+                    values.resize(row + 1);
+                values[row] = std::string{ s };
+            }
+            void Clear() { values.clear(); }
+        };
+
+        struct PendingMeta
+        {
+            std::string key;
+            MetaType type{ MetaType::Int64 };
+            std::vector<uint8_t> present;
+            std::vector<int64_t> ints;
+            std::vector<double> doubles;
+            std::vector<uint8_t> bools;
+            StringBuilder strings;
+
+            void Extend(size_t rows)
+            {
+                present.resize((rows + 7) / 8, 0);
+                switch (type)
+                {
+                case MetaType::Int64:  ints.resize(rows, 0); break;
+                case MetaType::Double: doubles.resize(rows, 0.0); break;
+                case MetaType::Bool:   bools.resize(rows, 0); break;
+                case MetaType::String: if (strings.values.size() < rows) strings.values.resize(rows); break;
+                }
+            }
+        };
+
+        struct PendingNodes
+        {
+            std::vector<int64_t> ids;
+            std::vector<float> x, y, width, height;
+            std::vector<uint8_t> shape;
+            StringBuilder labels;
+            std::vector<PendingMeta> meta;
+        };
+
+        struct PendingEdges
+        {
+            std::vector<int64_t> from, to;
+            std::vector<float> weight;
+            std::vector<uint8_t> flags;
+            StringBuilder labels;
+        };
+
+        void FlushNodes()
+        {
+            auto& n = m_nodes;
+            if (n.ids.empty())
+                return;
+            size_t const rows = n.ids.size();
+            BeginChunk(GraphChunkKind::Nodes);
+            Words(static_cast<uint32_t>(rows), static_cast<uint32_t>(n.meta.size()));
+            Column(n.ids);
+            Column(n.x);
+            Column(n.y);
+            Column(n.width);
+            Column(n.height);
+            Column(n.shape);
+            Strings(n.labels, rows);
+            for (auto& m : n.meta)
+            {
+                m.Extend(rows);     // 之后的行没有设置该键
+                Words(static_cast<uint32_t>(m.key.size()), 0);
+                Bytes(m.key.data(), m.key.size());
+                uint8_t const type = static_cast<uint8_t>(m.type);
+                Bytes(&type, 1);
+                Column(m.present);
+                switch (m.type)
+                {
+                case MetaType::Int64:  Column(m.ints); break;
+                case MetaType::Double: Column(m.doubles); break;
+                case MetaType::Bool:   Column(m.bools); break;
+                case MetaType::String: Strings(m.strings, rows); break;
+                }
+            }
+            EndChunk();
+            n = PendingNodes{};
+        }
+
+        void FlushEdges()
+        {
+            auto& e = m_edges;
+            if (e.from.empty())
+                return;
+            size_t const rows = e.from.size();
+            BeginChunk(GraphChunkKind::Edges);
+            Words(static_cast<uint32_t>(rows), 0);
+            Column(e.from);
+            Column(e.to);
+            Column(e.weight);
+            Column(e.flags);
+            Strings(e.labels, rows);
+            EndChunk();
+            e = PendingEdges{};
+        }
+
+        void BeginChunk(GraphChunkKind kind)
+        {
+            m_chunkStart = m_out.size();
+            Words(static_cast<uint32_t>(kind), 0);
+            uint64_t const length = 0;
+            Bytes(&length, sizeof(length));
+        }
+
+        void EndChunk()
+        {
+            uint64_t const length = m_out.size() - m_chunkStart - graphfile::ChunkHeaderSize;
+            std::memcpy(m_out.data() + m_chunkStart + 8, &length, sizeof(length));
+        }
+
+        void Words(uint32_t a, uint32_t b)
+        {
+            uint32_t const words[2] = { a, b };
+            Bytes(words, sizeof(words));
+        }
+
+        // 写入并补齐到 8 字节
+        void Bytes(void const* data, size_t size)
+        {
+            auto const* p = static_cast<uint8_t const*>(data);
+            m_out.insert(m_out.end(), p, p + size);
+            m_out.resize(m_out.size() + (graphfile::Pad8(size) - size), 0);
+        }
+
+        template <typename T>
+        void Column(std::vector<T> const& values)
+        {
+            Bytes(values.data(), values.size() * sizeof(T));
+        }
+
+        void Strings(StringBuilder& s, size_t rows)
+        {
+            s.values.resize(rows);
+            s.offsets.assign(1, 0);
+            for (auto const& v : s.values)
+                s.offsets.push_back(s.offsets.back() + static_cast<uint32_t>(v.size()));
+            Column(s.offsets);
+            size_t const start = m_out.size();
+            for (auto const& v : s.values)
+                m_out.insert(m_out.end(), v.begin(), v.end());
+            size_t const size = m_out.size() - start;
+            m_out.resize(m_out.size() + (graphfile::Pad8(size) - size), 0);
+        }
+
+        std::vector<uint8_t>& m_out;
+        uint32_t m_rowsPerChunk;
+        size_t m_chunkStart{ 0 };
+        PendingNodes m_nodes;
+        PendingEdges m_edges;
+    };
+
+    // 只读内存映射；按顺序访问，由系统按页调入
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        bool Open(std::filesystem::path const& path)
+        {
+            Close();
+#ifdef _WIN32
+            m_file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                return false;
+            LARGE_INTEGER size{};
+            if (!::GetFileSizeEx(m_file, &size))
+            {
+                Close();
+                return false;
+            }
+            m_size = static_cast<size_t>(size.QuadPart);
+            if (m_size == 0)
+                return true;
+            m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            m_view = m_mapping ? ::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+            m_file = ::open(path.c_str(), O_RDONLY);
+            if (m_file < 0)
+                return false;
+            struct stat st{};
+            if (::fstat(m_file, &st) != 0)
+            {
+                Close();
+                return false;
+            }
+            m_size = static_cast<size_t>(st.st_size);
+            if (m_size == 0)
+                return true;
+            m_view = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+            if (m_view == MAP_FAILED)
+                m_view = nullptr;
+            else
+                ::madvise(m_view, m_size, MADV_SEQUENTIAL);
+#endif
+            if (!m_view)
+            {
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        void Close() noexcept
+        {
+#ifdef _WIN32
+            if (m_view) ::UnmapViewOfFile(m_view);
+            if (m_mapping) ::CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE) ::CloseHandle(m_file);
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_view) ::munmap(m_view, m_size);
+            if (m_file >= 0) ::close(m_file);
+            m_file = -1;
+#endif
+            m_view = nullptr;
+            m_size = 0;
+        }
+
+        std::span<uint8_t const> Data() const noexcept
+        {
+            return m_view ? std::span<uint8_t const>{ static_cast<uint8_t const*>(m_view), m_size } : std::span<uint8_t const>{};
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE m_file{ INVALID_HANDLE_VALUE };
+        HANDLE m_mapping{ nullptr };
+#else
+        int m_file{ -1 };
+#endif
+        void* m_view{ nullptr };
+        size_t m_size{ 0 };
+    };
+}
@@ -0,0 +1,294 @@
+﻿#pragma once
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// NodeGraphPanel 背后的索引化图模型（与平台无关，可脱离 WinUI 单独编译）。
+// 节点与边存放在槽位稳定的数组中（删除后槽位进入空闲链表复用），
+// 节点 Id -> 槽位为哈希表，每个 Id 维护关联边列表，因此按 Id 查找、删除节点及其关联边
+// 都不再需要线性扫描整个集合。边按 Id 引用端点，允许先加边后加节点。
+namespace nodegraph
+{
+    using NodeId = int64_t;
+    inline constexpr uint32_t InvalidSlot = 0xFFFFFFFFu;
+
+    template <typename NodePayload, typename EdgePayload>
+    class GraphIndex
+    {
+    public:
+        struct NodeSlot
+        {
+            NodeId      id{};
+            uint32_t    nextSameId{ InvalidSlot };   // 同 Id 的其他节点（重复 Id 时按插入顺序串联）
+            bool        alive{ false };
+            NodePayload payload{};
+        };
+
+        struct EdgeSlot
+        {
+            NodeId      from{};
+            NodeId      to{};
+            bool        alive{ false };
+            EdgePayload payload{};
+        };
+
+        // —— 节点 ——
+        uint32_t AddNode(NodeId id, NodePayload payload)
+        {
+            uint32_t slot = AllocateSlot(m_nodes, m_freeNodes);
+            auto& node = m_nodes[slot];
+            node.id = id;
+            node.nextSameId = InvalidSlot;
+            node.alive = true;
+            node.payload = std::move(payload);
+            LinkNode(slot);
+            ++m_nodeCount;
+            return slot;
+        }
+
+        // 只删除节点本身；关联边仍按 Id 保留，由调用方决定是否一并删除（见 IncidentEdges）
+        void RemoveNode(uint32_t slot)
+        {
+            if (!IsNodeAlive(slot))
+                return;
+            UnlinkNode(slot);
+            auto& node = m_nodes[slot];
+            node.alive = false;
+            node.payload = NodePayload{};
+            m_freeNodes.push_back(slot);
+            --m_nodeCount;
+        }
+
+        void RenameNode(uint32_t slot, NodeId newId)
+        {
+            if (!IsNodeAlive(slot) || m_nodes[slot].id == newId)
+                return;
+            UnlinkNode(slot);
+            m_nodes[slot].id = newId;
+            m_nodes[slot].nextSameId = InvalidSlot;
+            LinkNode(slot);
+        }
+
+        // 返回该 Id 最早插入的存活节点槽位
+        uint32_t FindNode(NodeId id) const
+        {
+            auto it = m_vertices.find(id);
+            return it == m_vertices.end() ? InvalidSlot : it->second.firstNode;
+        }
+
+        bool IsNodeAlive(uint32_t slot) const noexcept
+        {
+            return slot < m_nodes.size() && m_nodes[slot].alive;
+        }
+
+        NodeSlot const& Node(uint32_t slot) const noexcept { return m_nodes[slot]; }
+        NodeSlot& Node(uint32_t slot) noexcept { return m_nodes[slot]; }
+
+        // —— 边 ——
+        uint32_t AddEdge(NodeId from, NodeId to, EdgePayload payload)
+        {
+            uint32_t slot = AllocateSlot(m_edges, m_freeEdges);
+            auto& edge = m_edges[slot];
+            edge.from = from;
+            edge.to = to;
+            edge.alive = true;
+            edge.payload = std::move(payload);
+            LinkEdge(slot);
+            ++m_edgeCount;
+            return slot;
+        }
+
+        void RemoveEdge(uint32_t slot)
+        {
+            if (!IsEdgeAlive(slot))
+                return;
+            UnlinkEdge(slot);
+            auto& edge = m_edges[slot];
+            edge.alive = false;
+            edge.payload = EdgePayload{};
+            m_freeEdges.push_back(slot);
+            --m_edgeCount;
+        }
+
+        void RelinkEdge(uint32_t slot, NodeId from, NodeId to)
+        {
+            if (!IsEdgeAlive(slot))
+                return;
+            auto& edge = m_edges[slot];
+            if (edge.from == from && edge.to == to)
+                return;
+            UnlinkEdge(slot);
+            edge.from = from;
+            edge.to = to;
+            LinkEdge(slot);
+        }
+
+        bool IsEdgeAlive(uint32_t slot) const noexcept
+        {
+            return slot < m_edges.size() && m_edges[slot].alive;
+        }
+
+        EdgeSlot const& Edge(uint32_t slot) const noexcept { return m_edges[slot]; }
+        EdgeSlot& Edge(uint32_t slot) noexcept { return m_edges[slot]; }
+
+        // 以 id 为端点的边槽位（自环只出现一次）；返回的视图在下一次增删边之前有效
+        std::span<uint32_t const> IncidentEdges(NodeId id) const
+        {
+            auto it = m_vertices.find(id);
+            if (it == m_vertices.end())
+                return {};
+            return it->second.edges;
+        }
+
+        // —— 遍历与容量 ——
+        template <typename F>
+        void ForEachNode(F&& visit) const
+        {
+            for (uint32_t slot = 0; slot < m_nodes.size(); ++slot)
+                if (m_nodes[slot].alive)
+                    visit(slot, m_nodes[slot]);
+        }
+
+        template <typename F>
+        void ForEachEdge(F&& visit) const
+        {
+            for (uint32_t slot = 0; slot < m_edges.size(); ++slot)
+                if (m_edges[slot].alive)
+                    visit(slot, m_edges[slot]);
+        }
+
+        size_t NodeCount() const noexcept { return m_nodeCount; }
+        size_t EdgeCount() const noexcept { return m_edgeCount; }
+
+        // 槽位上界（含空闲槽），用于以槽位为下标的外部数组
+        uint32_t NodeSlotCount() const noexcept { return static_cast<uint32_t>(m_nodes.size()); }
+        uint32_t EdgeSlotCount() const noexcept { return static_cast<uint32_t>(m_edges.size()); }
+
+        void Reserve(size_t nodes, size_t edges)
+        {
+            m_nodes.reserve(nodes);
+            m_edges.reserve(edges);
+            m_vertices.reserve(nodes);
+        }
+
+        void Clear()
+        {
+            m_nodes.clear();
+            m_edges.clear();
+            m_freeNodes.clear();
+            m_freeEdges.clear();
+            m_vertices.clear();
+            m_nodeCount = 0;
+            m_edgeCount = 0;
+        }
+
+    private:
+        struct Vertex
+        {
+            uint32_t              firstNode{ InvalidSlot };
+            std::vector<uint32_t> edges;
+        };
+
+        template <typename Slot>
+        static uint32_t AllocateSlot(std::vector<Slot>& slots, std::vector<uint32_t>& freeList)
+        {
+            if (!freeList.empty())
+            {
+                uint32_t slot = freeList.back();
+                freeList.pop_back();
+                return slot;
+            }
+            slots.emplace_back();
+            return static_cast<uint32_t>(slots.size() - 1);
+        }
+
+        void LinkNode(uint32_t slot)
+        {
+            auto& vertex = m_vertices[m_nodes[slot].id];
+            if (vertex.firstNode == InvalidSlot)
+            {
+                vertex.firstNode = slot;
+                return;
+            }
+            uint32_t tail = vertex.firstNode;
+            while (m_nodes[tail].nextSameId != InvalidSlot)
+                tail = m_nodes[tail].nextSameId;
+            m_nodes[tail].nextSameId = slot;
+        }
+
+        void UnlinkNode(uint32_t slot)
+        {
+            auto it = m_vertices.find(m_nodes[slot].id);
+            if (it == m_vertices.end())
+                return;
+            auto& vertex = it->second;
+            if (vertex.firstNode == slot)
+            {
+                vertex.firstNode = m_nodes[slot].nextSameId;
+            }
+            else
+            {
+                for (uint32_t cur = vertex.firstNode; cur != InvalidSlot; cur = m_nodes[cur].nextSameId)
+                {
+                    if (m_nodes[cur].nextSameId == slot)
+                    {
+                        m_nodes[cur].nextSameId = m_nodes[slot].nextSameId;
+                        break;
+                    }
+                }
+            }
+            m_nodes[slot].nextSameId = InvalidSlot;
+            ReleaseVertexIfEmpty(it);
+        }
+
+        void LinkEdge(uint32_t slot)
+        {
+            auto const& edge = m_edges[slot];
+            m_vertices[edge.from].edges.push_back(slot);
+            if (edge.to != edge.from)
+                m_vertices[edge.to].edges.push_back(slot);
+        }
+
+        void UnlinkEdge(uint32_t slot)
+        {
+            auto const& edge = m_edges[slot];
+            DetachFromVertex(edge.from, slot);
+            if (edge.to != edge.from)
+                DetachFromVertex(edge.to, slot);
+        }
+
+        void DetachFromVertex(NodeId id, uint32_t edgeSlot)
+        {
+            auto it = m_vertices.find(id);
+            if (it == m_vertices.end())
+                return;
+            auto& edges = it->second.edges;
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                if (edges[i] == edgeSlot)
+                {
+                    edges[i] = edges.back();
+                    edges.pop_back();
+                    break;
+                }
+            }
+            ReleaseVertexIfEmpty(it);
+        }
+
+        void ReleaseVertexIfEmpty(typename std::unordered_map<NodeId, Vertex>::iterator it)
+        {
+            if (it->second.firstNode == InvalidSlot && it->second.edges.empty())
+                m_vertices.erase(it);
+        }
+
+        std::vector<NodeSlot>              m_nodes;
+        std::vector<EdgeSlot>              m_edges;
+        std::vector<uint32_t>              m_freeNodes;
+        std::vector<uint32_t>              m_freeEdges;
+        std::unordered_map<NodeId, Vertex> m_vertices;
+        size_t                             m_nodeCount{ 0 };
+        size_t                             m_edgeCount{ 0 };
+    };
+}
@@ -0,0 +1,525 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <stop_token>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// 图查询（与平台无关）：最短路径（Dijkstra / A*）、可达性、强连通分量与拓扑序。
+// 邻接以 CSR（压缩稀疏行）保存：不可变的基础行 + 写时复制的增量（新增弧、被删除的基础边）。
+// 插入与删除只改动增量，取快照时增量超过基础规模的 1/8 才整体重建，因此逐条加边的代价为 O(1)。
+// Snapshot 只持有共享指针，可交给工作线程查询，之后 UI 线程上的修改不会影响它。
+// 节点与边键为调用方的稠密整数（NodeGraphPanel 使用 GraphIndex 的槽位）；无向边展开为两条弧，负权按 0 处理。
+namespace nodegraph
+{
+    struct GraphArc
+    {
+        uint32_t to;
+        uint32_t key;       // 边键
+        float    weight;
+    };
+
+    // 完整的 CSR：from 的弧位于 arcs[offsets[from], offsets[from + 1])
+    struct GraphCsr
+    {
+        std::vector<uint32_t> offsets{ 0 };
+        std::vector<GraphArc> arcs;
+
+        uint32_t NodeCount() const noexcept { return static_cast<uint32_t>(offsets.size() - 1); }
+    };
+
+    class GraphSnapshot
+    {
+    public:
+        uint32_t NodeCount() const noexcept { return m_nodeCount; }
+        uint32_t EdgeKeyBound() const noexcept { return m_keyBound; }
+
+        // visit(GraphArc const&)
+        template <typename F>
+        void ForEachArc(uint32_t from, F&& visit) const
+        {
+            if (from < m_base->NodeCount())
+            {
+                bool const filter = m_delta && !m_delta->removed.empty();
+                uint32_t const end = m_base->offsets[from + 1];
+                for (uint32_t i = m_base->offsets[from]; i < end; ++i)
+                {
+                    auto const& arc = m_base->arcs[i];
+                    if (filter && m_delta->removed.contains(arc.key))
+                        continue;
+                    visit(arc);
+                }
+            }
+            if (m_delta)
+            {
+                auto it = m_delta->added.find(from);
+                if (it != m_delta->added.end())
+                    for (auto const& arc : it->second)
+                        visit(arc);
+            }
+        }
+
+        // 合并基础行与增量；没有增量时直接返回基础行
+        std::shared_ptr<GraphCsr const> Flatten() const
+        {
+            if (!m_delta && m_base->NodeCount() == m_nodeCount)
+                return m_base;
+            auto csr = std::make_shared<GraphCsr>();
+            csr->offsets.assign(static_cast<size_t>(m_nodeCount) + 1, 0);
+            for (uint32_t u = 0; u < m_nodeCount; ++u)
+            {
+                uint32_t n = 0;
+                ForEachArc(u, [&](GraphArc const&) { ++n; });
+                csr->offsets[u + 1] = csr->offsets[u] + n;
+            }
+            csr->arcs.reserve(csr->offsets.back());
+            for (uint32_t u = 0; u < m_nodeCount; ++u)
+                ForEachArc(u, [&](GraphArc const& arc) { csr->arcs.push_back(arc); });
+            return csr;
+        }
+
+    private:
+        friend class GraphQuery;
+
+        struct Delta
+        {
+            std::unordered_map<uint32_t, std::vector<GraphArc>> added;     // from -> 基础行之后新增的弧
+            std::unordered_set<uint32_t> removed;                           // 已删除（或已修改）的基础边键
+            size_t addedArcs{ 0 };
+        };
+
+        std::shared_ptr<GraphCsr const> m_base;
+        std::shared_ptr<Delta const>    m_delta;    // 为空表示没有增量
+        uint32_t m_nodeCount{ 0 };
+        uint32_t m_keyBound{ 0 };
+    };
+
+    class GraphQuery
+    {
+    public:
+        GraphQuery() : m_base(std::make_shared<GraphCsr>()) {}
+
+        // 新增或修改；端点、权重与方向都未变化时不产生增量
+        void SetEdge(uint32_t key, uint32_t from, uint32_t to, double weight, bool directed)
+        {
+            float const w = weight > 0.0 ? static_cast<float>(std::min(weight, double(std::numeric_limits<float>::max()))) : 0.0f;
+            if (key >= m_edges.size())
+                m_edges.resize(static_cast<size_t>(key) + 1);
+            auto& e = m_edges[key];
+            if (e.live)
+            {
+                if (e.from == from && e.to == to && e.weight == w && e.directed == directed)
+                    return;
+                Unlink(key);
+            }
+            else
+            {
+                ++m_liveEdges;
+            }
+            e = Edge{ from, to, w, directed, true, false };
+            m_nodeBound = std::max({ m_nodeBound, from + 1, to + 1 });
+
+            auto& delta = MutableDelta();
+            delta.added[from].push_back(GraphArc{ to, key, w });
+            ++delta.addedArcs;
+            if (!directed && from != to)
+            {
+                delta.added[to].push_back(GraphArc{ from, key, w });
+                ++delta.addedArcs;
+            }
+        }
+
+        void RemoveEdge(uint32_t key)
+        {
+            if (key >= m_edges.size() || !m_edges[key].live)
+                return;
+            Unlink(key);
+            m_edges[key].live = false;
+            --m_liveEdges;
+        }
+
+        void Clear()
+        {
+            m_edges.clear();
+            m_base = std::make_shared<GraphCsr>();
+            m_delta.reset();
+            m_liveEdges = 0;
+            m_nodeBound = 0;
+        }
+
+        size_t EdgeCount() const noexcept { return m_liveEdges; }
+
+        // nodeCount：调用方的节点槽位上界，孤立节点也参与拓扑序与分量
+        std::shared_ptr<GraphSnapshot const> Snapshot(uint32_t nodeCount)
+        {
+            if (m_delta)
+            {
+                size_t const pending = m_delta->addedArcs + m_delta->removed.size();
+                if (pending > std::max<size_t>(CompactMinimum, m_base->arcs.size() / 8))
+                    Compact();
+            }
+            auto snapshot = std::make_shared<GraphSnapshot>();
+            snapshot->m_base = m_base;
+            snapshot->m_delta = m_delta;
+            snapshot->m_nodeCount = std::max({ nodeCount, m_nodeBound, m_base->NodeCount() });
+            snapshot->m_keyBound = static_cast<uint32_t>(m_edges.size());
+            return snapshot;
+        }
+
+    private:
+        static constexpr size_t CompactMinimum = 1024;
+
+        struct Edge
+        {
+            uint32_t from{ 0 };
+            uint32_t to{ 0 };
+            float    weight{ 0 };
+            bool     directed{ true };
+            bool     live{ false };
+            bool     inBase{ false };   // 弧位于基础行（否则位于增量）
+        };
+
+        // 仍被快照引用的增量先复制再修改
+        GraphSnapshot::Delta& MutableDelta()
+        {
+            if (!m_delta)
+                m_delta = std::make_shared<GraphSnapshot::Delta>();
+            else if (m_delta.use_count() > 1)
+                m_delta = std::make_shared<GraphSnapshot::Delta>(*m_delta);
+            return *m_delta;
+        }
+
+        void Unlink(uint32_t key)
+        {
+            auto const& e = m_edges[key];
+            auto& delta = MutableDelta();
+            if (e.inBase)
+            {
+                delta.removed.insert(key);
+                return;
+            }
+            auto erase = [&](uint32_t from)
+                {
+                    auto it = delta.added.find(from);
+                    if (it == delta.added.end())
+                        return;
+                    auto& arcs = it->second;
+                    size_t const before = arcs.size();
+                    std::erase_if(arcs, [key](GraphArc const& arc) { return arc.key == key; });
+                    delta.addedArcs -= before - arcs.size();
+                    if (arcs.empty())
+                        delta.added.erase(it);
+                };
+            erase(e.from);
+            if (e.to != e.from)
+                erase(e.to);
+        }
+
+        // 由全部存活的边重建基础行（计数排序，O(V + E)）
+        void Compact()
+        {
+            auto csr = std::make_shared<GraphCsr>();
+            csr->offsets.assign(static_cast<size_t>(m_nodeBound) + 1, 0);
+            size_t arcs = 0;
+            for (auto const& e : m_edges)
+            {
+                if (!e.live)
+                    continue;
+                ++csr->offsets[e.from + 1];
+                ++arcs;
+                if (!e.directed && e.from != e.to)
+                {
+                    ++csr->offsets[e.to + 1];
+                    ++arcs;
+                }
+            }
+            for (size_t i = 1; i < csr->offsets.size(); ++i)
+                csr->offsets[i] += csr->offsets[i - 1];
+
+            csr->arcs.resize(arcs);
+            std::vector<uint32_t> cursor(csr->offsets.begin(), csr->offsets.end() - 1);
+            for (uint32_t key = 0; key < m_edges.size(); ++key)
+            {
+                auto& e = m_edges[key];
+                e.inBase = e.live;
+                if (!e.live)
+                    continue;
+                csr->arcs[cursor[e.from]++] = GraphArc{ e.to, key, e.weight };
+                if (!e.directed && e.from != e.to)
+                    csr->arcs[cursor[e.to]++] = GraphArc{ e.from, key, e.weight };
+            }
+            m_base = std::move(csr);
+            m_delta.reset();
+        }
+
+        std::vector<Edge>                       m_edges;    // 边键 -> 当前状态
+        std::shared_ptr<GraphCsr const>         m_base;
+        std::shared_ptr<GraphSnapshot::Delta>   m_delta;
+        size_t                                  m_liveEdges{ 0 };
+        uint32_t                                m_nodeBound{ 0 };
+    };
+
+    // —— 查询（任意线程，只读快照）——
+    // stop 被请求时尽快返回不完整的结果，调用方负责丢弃
+
+    struct GraphPath
+    {
+        std::vector<uint32_t> nodes;    // 起点到终点
+        std::vector<uint32_t> edges;    // 边键，nodes.size() - 1 条
+        double cost{ 0 };
+        bool found{ false };
+    };
+
+    // positions 给出时（每节点 x, y 两项）以欧氏距离乘可采纳系数作为 A* 启发式：
+    // 系数取所有弧上 weight / 端点距离的最小值，保证启发值不超过剩余代价
+    inline GraphPath ShortestPath(GraphSnapshot const& graph, uint32_t source, uint32_t target,
+        std::vector<float> const* positions = nullptr, std::stop_token stop = {})
+    {
+        GraphPath path;
+        uint32_t const n = graph.NodeCount();
+        if (source >= n || target >= n)
+            return path;
+
+        double scale = 0.0;
+        if (positions && positions->size() >= static_cast<size_t>(n) * 2)
+        {
+            auto const& xy = *positions;
+            auto distance = [&xy](uint32_t a, uint32_t b)
+                {
+                    return std::hypot(double(xy[a * 2]) - xy[b * 2], double(xy[a * 2 + 1]) - xy[b * 2 + 1]);
+                };
+            scale = std::numeric_limits<double>::infinity();
+            for (uint32_t u = 0; u < n && scale > 0.0; ++u)
+            {
+                graph.ForEachArc(u, [&](GraphArc const& arc)
+                    {
+                        double const length = distance(u, arc.to);
+                        if (length > 0.0)
+                            scale = std::min(scale, arc.weight / length);
+                    });
+            }
+            if (!std::isfinite(scale))
+                scale = 0.0;
+            scale *= 0.999;     // 抵消浮点误差
+        }
+        auto heuristic = [&](uint32_t u)
+            {
+                if (scale <= 0.0)
+                    return 0.0;
+                auto const& xy = *positions;
+                return scale * std::hypot(double(xy[u * 2]) - xy[target * 2], double(xy[u * 2 + 1]) - xy[target * 2 + 1]);
+            };
+
+        constexpr uint32_t None = 0xFFFFFFFFu;
+        std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+        std::vector<uint32_t> prevNode(n, None);
+        std::vector<uint32_t> prevEdge(n, None);
+        struct Entry
+        {
+            double f;       // 已知代价 + 启发值
+            double g;
+            uint32_t node;
+            bool operator>(Entry const& o) const noexcept { return f > o.f; }
+        };
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+        dist[source] = 0.0;
+        open.push(Entry{ heuristic(source), 0.0, source });
+        uint32_t popped = 0;
+        while (!open.empty())
+        {
+            auto const [f, g, u] = open.top();
+            open.pop();
+            if ((++popped & 1023) == 0 && stop.stop_requested())
+                return path;
+            if (g > dist[u])
+                continue;       // 过期条目
+            if (u == target)
+                break;
+            graph.ForEachArc(u, [&](GraphArc const& arc)
+                {
+                    double const d = g + arc.weight;
+                    if (d < dist[arc.to])
+                    {
+                        dist[arc.to] = d;
+                        prevNode[arc.to] = u;
+                        prevEdge[arc.to] = arc.key;
+                        open.push(Entry{ d + heuristic(arc.to), d, arc.to });
+                    }
+                });
+        }
+        if (!std::isfinite(dist[target]))
+            return path;
+
+        for (uint32_t v = target; v != source; v = prevNode[v])
+        {
+            path.nodes.push_back(v);
+            path.edges.push_back(prevEdge[v]);
+        }
+        path.nodes.push_back(source);
+        std::reverse(path.nodes.begin(), path.nodes.end());
+        std::reverse(path.edges.begin(), path.edges.end());
+        path.cost = dist[target];
+        path.found = true;
+        return path;
+    }
+
+    struct GraphReach
+    {
+        std::vector<uint32_t> nodes;    // 广度优先顺序，含起点
+        std::vector<uint32_t> edges;    // 从已达节点出发的边键（去重）
+    };
+
+    inline GraphReach Reachable(GraphSnapshot const& graph, std::vector<uint32_t> const& sources, std::stop_token stop = {})
+    {
+        GraphReach reach;
+        uint32_t const n = graph.NodeCount();
+        std::vector<uint8_t> seen(n, 0);
+        std::vector<uint8_t> seenEdge(graph.EdgeKeyBound(), 0);
+        for (uint32_t s : sources)
+        {
+            if (s < n && !seen[s])
+            {
+                seen[s] = 1;
+                reach.nodes.push_back(s);
+            }
+        }
+        for (size_t head = 0; head < reach.nodes.size(); ++head)
+        {
+            if ((head & 1023) == 1023 && stop.stop_requested())
+                break;
+            graph.ForEachArc(reach.nodes[head], [&](GraphArc const& arc)
+                {
+                    if (arc.key < seenEdge.size() && !seenEdge[arc.key])
+                    {
+                        seenEdge[arc.key] = 1;
+                        reach.edges.push_back(arc.key);
+                    }
+                    if (!seen[arc.to])
+                    {
+                        seen[arc.to] = 1;
+                        reach.nodes.push_back(arc.to);
+                    }
+                });
+        }
+        return reach;
+    }
+
+    // 分量 i 的节点位于 nodes[offsets[i], offsets[i + 1])；分量按逆拓扑序排列（Tarjan 的自然输出顺序）
+    struct GraphComponents
+    {
+        std::vector<uint32_t> nodes;
+        std::vector<uint32_t> offsets{ 0 };
+        std::vector<uint32_t> component;    // 节点 -> 分量下标
+
+        uint32_t Count() const noexcept { return static_cast<uint32_t>(offsets.size() - 1); }
+    };
+
+    // 迭代式 Tarjan，O(V + E)，不受递归深度限制
+    inline GraphComponents StronglyConnectedComponents(GraphSnapshot const& graph, std::stop_token stop = {})
+    {
+        GraphComponents result;
+        auto const csr = graph.Flatten();
+        uint32_t const n = csr->NodeCount();
+        constexpr uint32_t Unvisited = 0xFFFFFFFFu;
+        std::vector<uint32_t> index(n, Unvisited);
+        std::vector<uint32_t> low(n, 0);
+        std::vector<uint8_t> onStack(n, 0);
+        std::vector<uint32_t> stack;
+        std::vector<std::pair<uint32_t, uint32_t>> frames;     // (节点, 下一条弧)
+        result.component.assign(n, 0);
+        result.nodes.reserve(n);
+        uint32_t counter = 0;
+
+        for (uint32_t root = 0; root < n; ++root)
+        {
+            if (index[root] != Unvisited)
+                continue;
+            if ((root & 1023) == 0 && stop.stop_requested())
+                return result;
+            frames.emplace_back(root, csr->offsets[root]);
+            index[root] = low[root] = counter++;
+            stack.push_back(root);
+            onStack[root] = 1;
+            while (!frames.empty())
+            {
+                auto& [u, next] = frames.back();
+                if (next < csr->offsets[u + 1])
+                {
+                    uint32_t const v = csr->arcs[next++].to;
+                    if (index[v] == Unvisited)
+                    {
+                        index[v] = low[v] = counter++;
+                        stack.push_back(v);
+                        onStack[v] = 1;
+                        frames.emplace_back(v, csr->offsets[v]);
+                    }
+                    else if (onStack[v])
+                    {
+                        low[u] = std::min(low[u], index[v]);
+                    }
+                    continue;
+                }
+                uint32_t const done = u;
+                frames.pop_back();
+                if (!frames.empty())
+                {
+                    uint32_t const parent = frames.back().first;
+                    low[parent] = std::min(low[parent], low[done]);
+                }
+                if (low[done] != index[done])
+                    continue;
+                uint32_t const id = result.Count();
+                uint32_t w;
+                do
+                {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    result.component[w] = id;
+                    result.nodes.push_back(w);
+                } while (w != done);
+                result.offsets.push_back(static_cast<uint32_t>(result.nodes.size()));
+            }
+        }
+        return result;
+    }
+
+    struct GraphOrder
+    {
+        std::vector<uint32_t> order;    // 有环时只含不在环上、也不在环下游的节点
+        bool acyclic{ true };
+    };
+
+    // Kahn 算法；无向边视为双向弧，因此会构成环
+    inline GraphOrder TopologicalOrder(GraphSnapshot const& graph, std::stop_token stop = {})
+    {
+        GraphOrder result;
+        auto const csr = graph.Flatten();
+        uint32_t const n = csr->NodeCount();
+        std::vector<uint32_t> indegree(n, 0);
+        for (auto const& arc : csr->arcs)
+            ++indegree[arc.to];
+        result.order.reserve(n);
+        for (uint32_t u = 0; u < n; ++u)
+            if (indegree[u] == 0)
+                result.order.push_back(u);
+        for (size_t head = 0; head < result.order.size(); ++head)
+        {
+            if ((head & 1023) == 1023 && stop.stop_requested())
+                break;
+            uint32_t const u = result.order[head];
+            for (uint32_t i = csr->offsets[u]; i < csr->offsets[u + 1]; ++i)
+                if (--indegree[csr->arcs[i].to] == 0)
+                    result.order.push_back(csr->arcs[i].to);
+        }
+        result.acyclic = result.order.size() == n;
+        return result;
+    }
+}
@@ -0,0 +1,787 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 有向图的分层布局（Sugiyama 框架），与平台无关。
+//  1. 去环：有向边上 DFS 反转回边；无向边不参与去环，按有向部分的拓扑序定向，因此不会重新引入环。
+//  2. 分层：最长路径分层后做逐节点的跨度收缩（把节点移到使 Σ weight × 边跨度 最小的可行层），
+//     等价于网络单纯形目标上的单点坐标下降，每轮 O(V + E)。
+//  3. 长边拆成逐层的虚拟节点。
+//  4. 交叉最小化：加权重心法上下交替扫描，按双层交叉数（树状数组计数，O(E log V)）保留最好的顺序；
+//     冷启动时多组初始顺序在各自线程上并行扫描，取交叉最少的一组。
+//  5. 横坐标：Brandes–Köpf，四个方向的竖直对齐与水平压缩后取中位平衡，节点宽度参与间距。
+// 增量布局时以上次结果的层内顺序为初值，只做少量扫描，图的小改动不会打乱整体顺序。
+// 各阶段之间与每轮扫描检查 stop_token，取消时返回 nullptr。
+namespace nodegraph
+{
+    struct LayeredLayoutSettings
+    {
+        float    nodeSep{ 40.0f };          // 同层相邻节点的间距
+        float    edgeSep{ 10.0f };          // 同层相邻虚拟节点（长边）的间距
+        float    rankSep{ 80.0f };          // 层间距
+        uint32_t sweeps{ 24 };              // 冷启动的最大扫描轮数
+        uint32_t incrementalSweeps{ 4 };    // 增量布局的扫描轮数
+        uint32_t trials{ 4 };               // 冷启动时并行尝试的初始顺序数
+        uint32_t balancePasses{ 8 };        // 分层跨度收缩的最大轮数
+        uint32_t threads{ 0 };              // 0 = hardware_concurrency
+    };
+
+    struct LayeredInput
+    {
+        struct Node
+        {
+            uint32_t key;
+            float    width;
+            float    height;
+        };
+        struct Edge
+        {
+            uint32_t from;                  // 节点键
+            uint32_t to;
+            float    weight{ 1.0f };
+            bool     directed{ true };
+        };
+        std::vector<Node> nodes;
+        std::vector<Edge> edges;
+    };
+
+    // 按节点键索引；同时作为下一次增量布局的初值
+    struct LayeredResult
+    {
+        std::vector<float>    x;            // 左上角
+        std::vector<float>    y;
+        std::vector<uint32_t> layer;
+        std::vector<float>    order;        // 层内相对位置 [0, 1)
+        std::vector<uint8_t>  placed;
+        uint32_t              layerCount{ 0 };
+        uint32_t              dummyCount{ 0 };
+        uint64_t              crossings{ 0 };
+
+        bool Has(uint32_t key) const noexcept { return key < placed.size() && placed[key]; }
+    };
+
+    class LayeredLayout
+    {
+    public:
+        using Settings = LayeredLayoutSettings;
+
+        explicit LayeredLayout(Settings const& settings = {})
+            : m_settings(settings)
+        {
+            m_threads = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        std::shared_ptr<LayeredResult> Run(LayeredInput const& input, LayeredResult const* previous, std::stop_token stop)
+        {
+            Reset(input);
+            if (m_n == 0)
+                return std::make_shared<LayeredResult>();
+            Orient(input);
+            if (stop.stop_requested()) return nullptr;
+            AssignLayers();
+            if (stop.stop_requested()) return nullptr;
+            InsertDummies();
+
+            Ordering ordering = InitialOrdering(input, previous);
+            bool const warm = previous != nullptr;
+            if (!MinimizeCrossings(ordering, warm ? 1u : std::max(1u, m_settings.trials),
+                    warm ? m_settings.incrementalSweeps : m_settings.sweeps, stop))
+                return nullptr;
+
+            std::vector<float> xs;
+            if (!AssignCoordinates(ordering, xs, stop))
+                return nullptr;
+            return BuildResult(input, ordering, xs);
+        }
+
+    private:
+        static constexpr uint32_t Invalid = 0xFFFFFFFFu;
+
+        struct Link
+        {
+            uint32_t node;
+            float    weight;
+        };
+
+        // 层内顺序：layers[l] 为该层节点，pos[v] 为 v 在层内的下标
+        struct Ordering
+        {
+            std::vector<std::vector<uint32_t>> layers;
+            std::vector<uint32_t>              pos;
+            uint64_t                           crossings{ 0 };
+        };
+
+        // CSR 邻接表
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<Link>     links;
+
+            size_t Begin(uint32_t v) const noexcept { return offsets[v]; }
+            size_t End(uint32_t v) const noexcept { return offsets[v + 1]; }
+        };
+
+        struct Arc
+        {
+            uint32_t from;
+            uint32_t to;
+            float    weight;
+        };
+
+        void Reset(LayeredInput const& input)
+        {
+            m_n = static_cast<uint32_t>(input.nodes.size());
+            uint32_t maxKey = 0;
+            for (auto const& node : input.nodes)
+                maxKey = std::max(maxKey, node.key);
+            m_indexOf.assign(m_n ? static_cast<size_t>(maxKey) + 1 : 0, Invalid);
+            m_width.clear();
+            m_height.clear();
+            for (uint32_t i = 0; i < m_n; ++i)
+            {
+                m_indexOf[input.nodes[i].key] = i;
+                m_width.push_back(std::max(input.nodes[i].width, 0.0f));
+                m_height.push_back(std::max(input.nodes[i].height, 0.0f));
+            }
+            m_arcs.clear();
+            m_layer.clear();
+            m_total = m_n;
+        }
+
+        uint32_t IndexOf(uint32_t key) const noexcept { return key < m_indexOf.size() ? m_indexOf[key] : Invalid; }
+        bool IsDummy(uint32_t v) const noexcept { return v >= m_n; }
+
+        static Adjacency BuildAdjacency(uint32_t count, std::vector<Arc> const& arcs, bool reverse)
+        {
+            Adjacency adj;
+            adj.offsets.assign(static_cast<size_t>(count) + 1, 0);
+            for (auto const& a : arcs)
+                ++adj.offsets[(reverse ? a.to : a.from) + 1];
+            for (uint32_t v = 0; v < count; ++v)
+                adj.offsets[v + 1] += adj.offsets[v];
+            adj.links.resize(arcs.size());
+            std::vector<uint32_t> fill(adj.offsets.begin(), adj.offsets.end() - 1);
+            for (auto const& a : arcs)
+                adj.links[fill[reverse ? a.to : a.from]++] = Link{ reverse ? a.from : a.to, a.weight };
+            return adj;
+        }
+
+        // —— 1. 去环与定向 ——
+        void Orient(LayeredInput const& input)
+        {
+            std::vector<Arc> directed;
+            std::vector<Arc> undirected;
+            for (auto const& e : input.edges)
+            {
+                uint32_t const a = IndexOf(e.from), b = IndexOf(e.to);
+                if (a == Invalid || b == Invalid || a == b)
+                    continue;
+                Arc const arc{ a, b, std::max(e.weight, 0.01f) };
+                (e.directed ? directed : undirected).push_back(arc);
+            }
+
+            // 迭代 DFS：指向灰色节点（祖先）的边是回边，反转后逆后序即为拓扑序
+            std::vector<uint32_t> offsets(static_cast<size_t>(m_n) + 1, 0);
+            for (auto const& a : directed)
+                ++offsets[a.from + 1];
+            for (uint32_t v = 0; v < m_n; ++v)
+                offsets[v + 1] += offsets[v];
+            std::vector<uint32_t> edgeAt(directed.size());
+            {
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (uint32_t i = 0; i < directed.size(); ++i)
+                    edgeAt[fill[directed[i].from]++] = i;
+            }
+            std::vector<uint8_t> state(m_n, 0);
+            std::vector<uint32_t> postorder;
+            postorder.reserve(m_n);
+            std::vector<std::pair<uint32_t, uint32_t>> stack;
+            for (uint32_t s = 0; s < m_n; ++s)
+            {
+                if (state[s])
+                    continue;
+                state[s] = 1;
+                stack.emplace_back(s, offsets[s]);
+                while (!stack.empty())
+                {
+                    auto& [v, next] = stack.back();
+                    if (next == offsets[v + 1])
+                    {
+                        state[v] = 2;
+                        postorder.push_back(v);
+                        stack.pop_back();
+                        continue;
+                    }
+                    auto& arc = directed[edgeAt[next++]];
+                    if (state[arc.to] == 1)
+                    {
+                        std::swap(arc.from, arc.to);
+                    }
+                    else if (state[arc.to] == 0)
+                    {
+                        state[arc.to] = 1;
+                        stack.emplace_back(arc.to, offsets[arc.to]);
+                    }
+                }
+            }
+            m_topo.assign(postorder.rbegin(), postorder.rend());
+            std::vector<uint32_t> rank(m_n);
+            for (uint32_t i = 0; i < m_n; ++i)
+                rank[m_topo[i]] = i;
+            for (auto& arc : undirected)
+            {
+                if (rank[arc.from] > rank[arc.to])
+                    std::swap(arc.from, arc.to);
+            }
+            m_arcs = std::move(directed);
+            m_arcs.insert(m_arcs.end(), undirected.begin(), undirected.end());
+        }
+
+        // —— 2. 分层 ——
+        void AssignLayers()
+        {
+            auto const out = BuildAdjacency(m_n, m_arcs, false);
+            auto const in = BuildAdjacency(m_n, m_arcs, true);
+            std::vector<int32_t> layer(m_n, 0);
+            for (uint32_t v : m_topo)
+                for (size_t i = out.Begin(v); i < out.End(v); ++i)
+                    layer[out.links[i].node] = std::max(layer[out.links[i].node], layer[v] + 1);
+
+            // 跨度收缩：入边权重大于出边权重时上移到最低可行层，反之下移到最高可行层
+            constexpr int32_t none = std::numeric_limits<int32_t>::max();
+            for (uint32_t pass = 0; pass < m_settings.balancePasses; ++pass)
+            {
+                bool changed = false;
+                for (uint32_t v : m_topo)
+                {
+                    int32_t lo = -none, hi = none;
+                    float wIn = 0, wOut = 0;
+                    for (size_t i = in.Begin(v); i < in.End(v); ++i)
+                    {
+                        lo = std::max(lo, layer[in.links[i].node] + 1);
+                        wIn += in.links[i].weight;
+                    }
+                    for (size_t i = out.Begin(v); i < out.End(v); ++i)
+                    {
+                        hi = std::min(hi, layer[out.links[i].node] - 1);
+                        wOut += out.links[i].weight;
+                    }
+                    int32_t target = layer[v];
+                    if (wIn > wOut && lo != -none) target = lo;
+                    else if (wOut > wIn && hi != none) target = hi;
+                    if (target != layer[v])
+                    {
+                        layer[v] = target;
+                        changed = true;
+                    }
+                }
+                if (!changed)
+                    break;
+            }
+            int32_t const base = *std::min_element(layer.begin(), layer.end());
+            m_layer.resize(m_n);
+            for (uint32_t v = 0; v < m_n; ++v)
+                m_layer[v] = static_cast<uint32_t>(layer[v] - base);
+        }
+
+        // —— 3. 虚拟节点 ——
+        void InsertDummies()
+        {
+            std::vector<Arc> links;
+            links.reserve(m_arcs.size());
+            for (auto const& arc : m_arcs)
+            {
+                uint32_t prev = arc.from;
+                for (uint32_t l = m_layer[arc.from] + 1; l < m_layer[arc.to]; ++l)
+                {
+                    uint32_t const dummy = m_total++;
+                    m_layer.push_back(l);
+                    m_width.push_back(0.0f);
+                    m_height.push_back(0.0f);
+                    links.push_back(Arc{ prev, dummy, arc.weight });
+                    prev = dummy;
+                }
+                links.push_back(Arc{ prev, arc.to, arc.weight });
+            }
+            m_down = BuildAdjacency(m_total, links, false);
+            m_up = BuildAdjacency(m_total, links, true);
+            m_layerCount = 0;
+            for (uint32_t l : m_layer)
+                m_layerCount = std::max(m_layerCount, l + 1);
+        }
+
+        // —— 4. 交叉最小化 ——
+        Ordering InitialOrdering(LayeredInput const& input, LayeredResult const* previous) const
+        {
+            Ordering o;
+            o.layers.resize(m_layerCount);
+            o.pos.assign(m_total, 0);
+            if (previous)
+            {
+                // 自上而下：沿用上次的层内位置；新节点与虚拟节点取上层邻居的重心
+                std::vector<std::vector<uint32_t>> byLayer(m_layerCount);
+                for (uint32_t v = 0; v < m_total; ++v)
+                    byLayer[m_layer[v]].push_back(v);
+                std::vector<float> key(m_total, 0.0f);
+                for (uint32_t l = 0; l < m_layerCount; ++l)
+                {
+                    auto& layer = byLayer[l];
+                    float const size = static_cast<float>(l > 0 ? o.layers[l - 1].size() : 1);
+                    for (uint32_t v : layer)
+                    {
+                        uint32_t const k = v < m_n ? input.nodes[v].key : Invalid;
+                        if (k != Invalid && previous->Has(k))
+                        {
+                            key[v] = previous->order[k];
+                            continue;
+                        }
+                        float sum = 0, weight = 0;
+                        for (size_t i = m_up.Begin(v); i < m_up.End(v); ++i)
+                        {
+                            sum += m_up.links[i].weight * (o.pos[m_up.links[i].node] + 0.5f) / size;
+                            weight += m_up.links[i].weight;
+                        }
+                        key[v] = weight > 0 ? sum / weight : 1.0f;
+                    }
+                    std::stable_sort(layer.begin(), layer.end(), [&](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+                    o.layers[l] = std::move(layer);
+                    for (uint32_t i = 0; i < o.layers[l].size(); ++i)
+                        o.pos[o.layers[l][i]] = i;
+                }
+                return o;
+            }
+
+            // 冷启动：按层从上到下 DFS，访问顺序即层内初始顺序
+            std::vector<uint32_t> roots(m_n);
+            for (uint32_t v = 0; v < m_n; ++v)
+                roots[v] = v;
+            std::stable_sort(roots.begin(), roots.end(), [&](uint32_t a, uint32_t b) { return m_layer[a] < m_layer[b]; });
+            std::vector<uint8_t> visited(m_total, 0);
+            std::vector<uint32_t> stack;
+            for (uint32_t r : roots)
+            {
+                if (visited[r])
+                    continue;
+                stack.push_back(r);
+                while (!stack.empty())
+                {
+                    uint32_t const v = stack.back();
+                    stack.pop_back();
+                    if (visited[v])
+                        continue;
+                    visited[v] = 1;
+                    o.pos[v] = static_cast<uint32_t>(o.layers[m_layer[v]].size());
+                    o.layers[m_layer[v]].push_back(v);
+                    for (size_t i = m_down.End(v); i > m_down.Begin(v); --i)
+                        if (!visited[m_down.links[i - 1].node])
+                            stack.push_back(m_down.links[i - 1].node);
+                }
+            }
+            return o;
+        }
+
+        bool MinimizeCrossings(Ordering& ordering, uint32_t trials, uint32_t sweeps, std::stop_token const& stop) const
+        {
+            std::vector<Ordering> candidates(trials, ordering);
+            for (uint32_t t = 1; t < trials; ++t)
+            {
+                std::mt19937 rng(t);
+                for (auto& layer : candidates[t].layers)
+                {
+                    std::shuffle(layer.begin(), layer.end(), rng);
+                    for (uint32_t i = 0; i < layer.size(); ++i)
+                        candidates[t].pos[layer[i]] = i;
+                }
+            }
+
+            std::vector<uint8_t> completed(trials, 0);
+            uint32_t const workers = std::min(trials, m_threads);
+            auto run = [&](uint32_t first)
+                {
+                    for (uint32_t t = first; t < trials; t += workers)
+                        completed[t] = Sweep(candidates[t], sweeps, stop) ? 1 : 0;
+                };
+            {
+                std::vector<std::jthread> pool;
+                for (uint32_t w = 1; w < workers; ++w)
+                    pool.emplace_back(run, w);
+                run(0);
+            }
+            if (stop.stop_requested())
+                return false;
+
+            // 交叉数相同时取下标最小的一组，结果与线程数无关
+            uint32_t best = 0;
+            for (uint32_t t = 1; t < trials; ++t)
+                if (completed[t] && candidates[t].crossings < candidates[best].crossings)
+                    best = t;
+            ordering = std::move(candidates[best]);
+            return true;
+        }
+
+        bool Sweep(Ordering& o, uint32_t sweeps, std::stop_token const& stop) const
+        {
+            Ordering best = o;
+            best.crossings = CountCrossings(o);
+            uint32_t stale = 0;
+            for (uint32_t it = 0; it < sweeps && best.crossings > 0; ++it)
+            {
+                if (stop.stop_requested())
+                    return false;
+                if (it % 2 == 0)
+                {
+                    for (uint32_t l = 1; l < m_layerCount; ++l)
+                        Reorder(o, l, m_up);
+                }
+                else
+                {
+                    for (uint32_t l = m_layerCount - 1; l-- > 0;)
+                        Reorder(o, l, m_down);
+                }
+                uint64_t const c = CountCrossings(o);
+                if (c < best.crossings)
+                {
+                    best.layers = o.layers;
+                    best.pos = o.pos;
+                    best.crossings = c;
+                    stale = 0;
+                }
+                else if (++stale >= 4)
+                {
+                    break;
+                }
+            }
+            o = std::move(best);
+            return true;
+        }
+
+        // 加权重心排序；没有相邻层邻居的节点保持原位置
+        void Reorder(Ordering& o, uint32_t l, Adjacency const& neighbors) const
+        {
+            auto& layer = o.layers[l];
+            std::vector<std::pair<float, uint32_t>> keyed;
+            keyed.reserve(layer.size());
+            for (uint32_t v : layer)
+            {
+                float sum = 0, weight = 0;
+                for (size_t i = neighbors.Begin(v); i < neighbors.End(v); ++i)
+                {
+                    sum += neighbors.links[i].weight * o.pos[neighbors.links[i].node];
+                    weight += neighbors.links[i].weight;
+                }
+                keyed.emplace_back(weight > 0 ? sum / weight : static_cast<float>(o.pos[v]), v);
+            }
+            std::stable_sort(keyed.begin(), keyed.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+            for (uint32_t i = 0; i < keyed.size(); ++i)
+            {
+                layer[i] = keyed[i].second;
+                o.pos[layer[i]] = i;
+            }
+        }
+
+        uint64_t CountCrossings(Ordering const& o) const
+        {
+            uint64_t total = 0;
+            std::vector<uint32_t> sequence;
+            std::vector<uint32_t> tree;
+            for (uint32_t l = 0; l + 1 < m_layerCount; ++l)
+            {
+                // 按上层位置、再按下层位置排列的边序列中，逆序对数即交叉数
+                sequence.clear();
+                for (uint32_t u : o.layers[l])
+                {
+                    size_t const begin = sequence.size();
+                    for (size_t i = m_down.Begin(u); i < m_down.End(u); ++i)
+                        sequence.push_back(o.pos[m_down.links[i].node]);
+                    std::sort(sequence.begin() + begin, sequence.end());
+                }
+                size_t const m = o.layers[l + 1].size();
+                tree.assign(m + 1, 0);
+                uint64_t inserted = 0;
+                for (uint32_t p : sequence)
+                {
+                    uint64_t notGreater = 0;
+                    for (size_t i = p + 1; i > 0; i -= i & (~i + 1))
+                        notGreater += tree[i];
+                    total += inserted - notGreater;
+                    for (size_t i = p + 1; i <= m; i += i & (~i + 1))
+                        ++tree[i];
+                    ++inserted;
+                }
+            }
+            return total;
+        }
+
+        // —— 5. Brandes–Köpf 横坐标 ——
+        float Separation(uint32_t u, uint32_t v) const noexcept
+        {
+            float const su = IsDummy(u) ? m_settings.edgeSep : m_settings.nodeSep;
+            float const sv = IsDummy(v) ? m_settings.edgeSep : m_settings.nodeSep;
+            return (m_width[u] + m_width[v] + su + sv) * 0.5f;
+        }
+
+        static uint64_t PairKey(uint32_t a, uint32_t b) noexcept
+        {
+            if (a > b)
+                std::swap(a, b);
+            return (uint64_t(a) << 32) | b;
+        }
+
+        // 第一类冲突：非内部段与内部段（两端都是虚拟节点）交叉时，对齐时优先保持内部段竖直
+        std::unordered_set<uint64_t> FindType1Conflicts(Ordering const& o) const
+        {
+            std::unordered_set<uint64_t> conflicts;
+            for (uint32_t l = 1; l < m_layerCount; ++l)
+            {
+                auto const& layer = o.layers[l];
+                uint32_t const prevLength = static_cast<uint32_t>(o.layers[l - 1].size());
+                uint32_t k0 = 0;
+                size_t scan = 0;
+                for (size_t i = 0; i < layer.size(); ++i)
+                {
+                    uint32_t const v = layer[i];
+                    uint32_t inner = Invalid;
+                    if (IsDummy(v))
+                        for (size_t j = m_up.Begin(v); j < m_up.End(v); ++j)
+                            if (IsDummy(m_up.links[j].node))
+                                inner = m_up.links[j].node;
+                    uint32_t const k1 = inner != Invalid ? o.pos[inner] : prevLength;
+                    if (inner == Invalid && i + 1 != layer.size())
+                        continue;
+                    for (; scan <= i; ++scan)
+                    {
+                        uint32_t const s = layer[scan];
+                        for (size_t j = m_up.Begin(s); j < m_up.End(s); ++j)
+                        {
+                            uint32_t const u = m_up.links[j].node;
+                            uint32_t const p = o.pos[u];
+                            if ((p < k0 || k1 < p) && !(IsDummy(u) && IsDummy(s)))
+                                conflicts.insert(PairKey(u, s));
+                        }
+                    }
+                    k0 = k1;
+                }
+            }
+            return conflicts;
+        }
+
+        bool AssignCoordinates(Ordering const& o, std::vector<float>& xs, std::stop_token const& stop) const
+        {
+            auto const conflicts = FindType1Conflicts(o);
+            std::array<std::vector<float>, 4> candidates;
+            for (int a = 0; a < 4; ++a)
+            {
+                if (stop.stop_requested())
+                    return false;
+                bool const downward = a >= 2;       // 与下层邻居对齐（层序反转）
+                bool const rightward = a & 1;       // 从右向左压缩（层内反转）
+                auto layers = o.layers;
+                if (downward)
+                    std::reverse(layers.begin(), layers.end());
+                if (rightward)
+                    for (auto& layer : layers)
+                        std::reverse(layer.begin(), layer.end());
+                std::vector<uint32_t> root, align;
+                AlignVertically(layers, downward ? m_down : m_up, conflicts, root, align);
+                candidates[a] = CompactHorizontally(layers, root);
+                if (rightward)
+                    for (auto& x : candidates[a])
+                        x = -x;
+            }
+
+            // 以宽度最小的一组为基准对齐，再取四组的中位平均
+            auto extent = [&](std::vector<float> const& c, float& lo, float& hi)
+                {
+                    lo = std::numeric_limits<float>::max();
+                    hi = std::numeric_limits<float>::lowest();
+                    for (uint32_t v = 0; v < m_total; ++v)
+                    {
+                        lo = std::min(lo, c[v] - m_width[v] * 0.5f);
+                        hi = std::max(hi, c[v] + m_width[v] * 0.5f);
+                    }
+                };
+            int narrowest = 0;
+            float bestWidth = std::numeric_limits<float>::max();
+            for (int a = 0; a < 4; ++a)
+            {
+                float lo, hi;
+                extent(candidates[a], lo, hi);
+                if (hi - lo < bestWidth)
+                {
+                    bestWidth = hi - lo;
+                    narrowest = a;
+                }
+            }
+            auto const [alignLo, alignHi] = std::minmax_element(candidates[narrowest].begin(), candidates[narrowest].end());
+            float const targetLo = *alignLo, targetHi = *alignHi;
+            for (int a = 0; a < 4; ++a)
+            {
+                auto const [lo, hi] = std::minmax_element(candidates[a].begin(), candidates[a].end());
+                float const delta = (a & 1) ? targetHi - *hi : targetLo - *lo;
+                for (auto& x : candidates[a])
+                    x += delta;
+            }
+            xs.resize(m_total);
+            for (uint32_t v = 0; v < m_total; ++v)
+            {
+                std::array<float, 4> values{ candidates[0][v], candidates[1][v], candidates[2][v], candidates[3][v] };
+                std::sort(values.begin(), values.end());
+                xs[v] = (values[1] + values[2]) * 0.5f;
+            }
+            return true;
+        }
+
+        void AlignVertically(std::vector<std::vector<uint32_t>> const& layers, Adjacency const& neighbors,
+            std::unordered_set<uint64_t> const& conflicts, std::vector<uint32_t>& root, std::vector<uint32_t>& align) const
+        {
+            root.resize(m_total);
+            align.resize(m_total);
+            std::vector<uint32_t> pos(m_total);
+            for (auto const& layer : layers)
+                for (uint32_t i = 0; i < layer.size(); ++i)
+                {
+                    root[layer[i]] = align[layer[i]] = layer[i];
+                    pos[layer[i]] = i;
+                }
+            std::vector<uint32_t> ws;
+            for (auto const& layer : layers)
+            {
+                int64_t r = -1;
+                for (uint32_t v : layer)
+                {
+                    ws.clear();
+                    for (size_t i = neighbors.Begin(v); i < neighbors.End(v); ++i)
+                        ws.push_back(neighbors.links[i].node);
+                    if (ws.empty())
+                        continue;
+                    std::sort(ws.begin(), ws.end(), [&](uint32_t a, uint32_t b) { return pos[a] < pos[b]; });
+                    // 与中位邻居（偶数个时依次尝试两个）对齐
+                    size_t const lo = (ws.size() - 1) / 2, hi = ws.size() / 2;
+                    for (size_t i = lo; i <= hi; ++i)
+                    {
+                        uint32_t const w = ws[i];
+                        if (align[v] == v && r < static_cast<int64_t>(pos[w]) && !conflicts.contains(PairKey(v, w)))
+                        {
+                            align[w] = v;
+                            align[v] = root[v] = root[w];
+                            r = pos[w];
+                        }
+                    }
+                }
+            }
+        }
+
+        // 块图：同层相邻节点所在块之间连一条带最小间距的边，先按拓扑序左推，再逆序右拉消除多余空隙
+        std::vector<float> CompactHorizontally(std::vector<std::vector<uint32_t>> const& layers, std::vector<uint32_t> const& root) const
+        {
+            std::unordered_map<uint64_t, float> separations;
+            for (auto const& layer : layers)
+                for (size_t i = 1; i < layer.size(); ++i)
+                {
+                    uint64_t const key = (uint64_t(root[layer[i - 1]]) << 32) | root[layer[i]];
+                    auto [it, inserted] = separations.try_emplace(key, 0.0f);
+                    it->second = std::max(it->second, Separation(layer[i - 1], layer[i]));
+                }
+            std::vector<Arc> arcs;
+            arcs.reserve(separations.size());
+            for (auto const& [key, sep] : separations)
+                arcs.push_back(Arc{ static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key), sep });
+            // unordered_map 的遍历顺序不影响结果：两遍都取 max / min
+            auto const out = BuildAdjacency(m_total, arcs, false);
+            auto const in = BuildAdjacency(m_total, arcs, true);
+
+            std::vector<uint32_t> indegree(m_total, 0), order;
+            order.reserve(m_total);
+            for (uint32_t v = 0; v < m_total; ++v)
+            {
+                if (root[v] != v)
+                    continue;
+                indegree[v] = static_cast<uint32_t>(in.End(v) - in.Begin(v));
+                if (indegree[v] == 0)
+                    order.push_back(v);
+            }
+            for (size_t i = 0; i < order.size(); ++i)
+                for (size_t j = out.Begin(order[i]); j < out.End(order[i]); ++j)
+                    if (--indegree[out.links[j].node] == 0)
+                        order.push_back(out.links[j].node);
+
+            std::vector<float> xs(m_total, 0.0f);
+            for (uint32_t b : order)
+                for (size_t j = in.Begin(b); j < in.End(b); ++j)
+                    xs[b] = std::max(xs[b], xs[in.links[j].node] + in.links[j].weight);
+            for (size_t i = order.size(); i-- > 0;)
+            {
+                uint32_t const b = order[i];
+                if (out.Begin(b) == out.End(b))
+                    continue;
+                float limit = std::numeric_limits<float>::max();
+                for (size_t j = out.Begin(b); j < out.End(b); ++j)
+                    limit = std::min(limit, xs[out.links[j].node] - out.links[j].weight);
+                xs[b] = std::max(xs[b], limit);
+            }
+            for (uint32_t v = 0; v < m_total; ++v)
+                xs[v] = xs[root[v]];
+            return xs;
+        }
+
+        std::shared_ptr<LayeredResult> BuildResult(LayeredInput const& input, Ordering const& o, std::vector<float> const& xs) const
+        {
+            std::vector<float> layerHeight(m_layerCount, 0.0f);
+            for (uint32_t v = 0; v < m_n; ++v)
+                layerHeight[m_layer[v]] = std::max(layerHeight[m_layer[v]], m_height[v]);
+            std::vector<float> layerTop(m_layerCount, 0.0f);
+            for (uint32_t l = 1; l < m_layerCount; ++l)
+                layerTop[l] = layerTop[l - 1] + layerHeight[l - 1] + m_settings.rankSep;
+
+            float left = std::numeric_limits<float>::max();
+            for (uint32_t v = 0; v < m_n; ++v)
+                left = std::min(left, xs[v] - m_width[v] * 0.5f);
+
+            auto result = std::make_shared<LayeredResult>();
+            size_t const size = m_indexOf.size();
+            result->x.assign(size, 0.0f);
+            result->y.assign(size, 0.0f);
+            result->layer.assign(size, 0);
+            result->order.assign(size, 0.0f);
+            result->placed.assign(size, 0);
+            for (uint32_t v = 0; v < m_n; ++v)
+            {
+                uint32_t const key = input.nodes[v].key;
+                uint32_t const l = m_layer[v];
+                result->x[key] = xs[v] - m_width[v] * 0.5f - left;
+                result->y[key] = layerTop[l] + (layerHeight[l] - m_height[v]) * 0.5f;
+                result->layer[key] = l;
+                result->order[key] = (o.pos[v] + 0.5f) / o.layers[l].size();
+                result->placed[key] = 1;
+            }
+            result->layerCount = m_layerCount;
+            result->dummyCount = m_total - m_n;
+            result->crossings = o.crossings;
+            return result;
+        }
+
+        Settings              m_settings;
+        uint32_t              m_threads{ 1 };
+        uint32_t              m_n{ 0 };             // 实际节点数（下标 0..m_n-1），其后为虚拟节点
+        uint32_t              m_total{ 0 };
+        uint32_t              m_layerCount{ 0 };
+        std::vector<uint32_t> m_indexOf;            // 节点键 -> 下标
+        std::vector<float>    m_width;
+        std::vector<float>    m_height;
+        std::vector<Arc>      m_arcs;               // 定向后的边（实际节点之间）
+        std::vector<uint32_t> m_topo;
+        std::vector<uint32_t> m_layer;
+        Adjacency             m_up;                 // 含虚拟节点，只连相邻层
+        Adjacency             m_down;
+    };
+}
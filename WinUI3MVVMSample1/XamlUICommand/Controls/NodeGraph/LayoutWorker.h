@@ -0,0 +1,218 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "ForceLayout.h"
+
+// 在后台线程上运行 ForceLayout（与平台无关，只依赖标准库线程）。
+// 与 UI 线程之间只交换两块带锁的缓冲：命令队列（增删节点/边、外部移动、重启）与位置邮箱。
+// 工作线程按帧间隔把“相对上次交付移动过的节点”写入邮箱；UI 取走之前不会再次写入，因此增量不会丢失，
+// 迭代也不会因 UI 繁忙而停顿。notify 在新一批位置就绪时由工作线程调用一次，调用方负责切回 UI 线程。
+// 收敛且没有新命令时线程阻塞等待，不占用 CPU。
+namespace nodegraph
+{
+    class LayoutWorker
+    {
+    public:
+        struct Placement
+        {
+            uint32_t key;
+            uint32_t stamp;     // 调用方在 SetNode 时给出，用于识别槽位复用后的过期位置
+            float    x;
+            float    y;
+        };
+
+        LayoutWorker(ForceLayout::Settings const& settings, std::function<void()> notify,
+            std::chrono::milliseconds frame = std::chrono::milliseconds{ 16 })
+            : m_engine(settings), m_notify(std::move(notify)), m_frame(frame)
+        {
+        }
+
+        ~LayoutWorker() { Stop(); }
+
+        LayoutWorker(LayoutWorker const&) = delete;
+        LayoutWorker& operator=(LayoutWorker const&) = delete;
+
+        void Start()
+        {
+            if (m_thread.joinable())
+                return;
+            m_thread = std::jthread([this](std::stop_token stop) { Run(stop); });
+        }
+
+        void Stop()
+        {
+            if (!m_thread.joinable())
+                return;
+            m_thread.request_stop();
+            m_wake.notify_all();
+            m_thread.join();
+        }
+
+        bool IsStarted() const noexcept { return m_thread.joinable(); }
+
+        // —— 命令（任意线程）——
+        void SetNode(uint32_t key, uint32_t stamp, float x, float y, bool seed = false)
+        {
+            Post(Command{ CommandKind::SetNode, key, stamp, 0, x, y, seed });
+        }
+
+        void RemoveNode(uint32_t key) { Post(Command{ CommandKind::RemoveNode, key }); }
+        void SetEdge(uint32_t key, uint32_t a, uint32_t b) { Post(Command{ CommandKind::SetEdge, key, a, b }); }
+        void RemoveEdge(uint32_t key) { Post(Command{ CommandKind::RemoveEdge, key }); }
+        void Restart() { Post(Command{ CommandKind::Restart }); }
+
+        // —— 位置（消费方线程）——
+        // 取走最近一批位置；没有新数据时返回 false。out 原有的存储会被回收复用
+        bool TakePlacements(std::vector<Placement>& out)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                if (!m_hasReady)
+                    return false;
+                out.swap(m_ready);
+                m_ready.clear();
+                m_hasReady = false;
+            }
+            m_wake.notify_all();
+            return true;
+        }
+
+    private:
+        enum class CommandKind : uint8_t { SetNode, RemoveNode, SetEdge, RemoveEdge, Restart };
+
+        struct Command
+        {
+            CommandKind kind;
+            uint32_t    key{ 0 };
+            uint32_t    a{ 0 };         // SetNode: stamp；SetEdge: 起点
+            uint32_t    b{ 0 };         // SetEdge: 终点
+            float       x{ 0 };
+            float       y{ 0 };
+            bool        seed{ false };
+        };
+
+        // 交付阈值：移动不足此值（画布单位）的节点不进入下一批
+        static constexpr float MinDelivery = 0.25f;
+
+        void Post(Command const& command)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_commands.push_back(command);
+            }
+            m_wake.notify_all();
+        }
+
+        void Run(std::stop_token stop)
+        {
+            std::vector<Command> commands;
+            auto lastPublish = std::chrono::steady_clock::now();
+            while (!stop.stop_requested())
+            {
+                {
+                    std::unique_lock lock(m_mutex);
+                    // 收敛后只在有新命令，或有未交付的位置且邮箱已被取走时醒来
+                    if (m_commands.empty() && m_engine.IsConverged() && (!m_unsent || m_hasReady))
+                    {
+                        if (!m_wake.wait(lock, stop, [this] { return !m_commands.empty() || (m_unsent && !m_hasReady); }))
+                            return;
+                    }
+                    commands.swap(m_commands);
+                }
+                for (auto const& c : commands)
+                    Apply(c);
+                commands.clear();
+
+                if (!m_engine.IsConverged())
+                {
+                    m_engine.Step();
+                    m_unsent = true;
+                }
+                auto const now = std::chrono::steady_clock::now();
+                if (m_unsent && (m_engine.IsConverged() || now - lastPublish >= m_frame) && Publish())
+                    lastPublish = now;
+            }
+        }
+
+        void Apply(Command const& c)
+        {
+            switch (c.kind)
+            {
+            case CommandKind::SetNode:
+                if (c.key >= m_sent.size())
+                    m_sent.resize(static_cast<size_t>(c.key) + 1);
+                m_sent[c.key] = Placement{ c.key, c.a, c.x, c.y };   // 调用方已知该位置
+                m_engine.SetNode(c.key, c.x, c.y, c.seed);
+                break;
+            case CommandKind::RemoveNode:
+                m_engine.RemoveNode(c.key);
+                break;
+            case CommandKind::SetEdge:
+                m_engine.SetEdge(c.key, c.a, c.b);
+                break;
+            case CommandKind::RemoveEdge:
+                m_engine.RemoveEdge(c.key);
+                break;
+            case CommandKind::Restart:
+                m_engine.Restart();
+                break;
+            }
+        }
+
+        // 邮箱仍未被取走时返回 false（稍后重试）
+        bool Publish()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_hasReady)
+                    return false;
+            }
+            m_scratch.clear();
+            m_engine.ForEachNode([this](uint32_t key, float x, float y)
+                {
+                    auto& sent = m_sent[key];
+                    if (std::abs(x - sent.x) < MinDelivery && std::abs(y - sent.y) < MinDelivery)
+                        return;
+                    sent.x = x;
+                    sent.y = y;
+                    m_scratch.push_back(sent);
+                });
+            m_unsent = false;
+            if (m_scratch.empty())
+                return true;
+            {
+                std::lock_guard lock(m_mutex);
+                m_ready.swap(m_scratch);
+                m_hasReady = true;
+            }
+            if (m_notify)
+                m_notify();
+            return true;
+        }
+
+        // 仅工作线程访问
+        ForceLayout                  m_engine;
+        std::vector<Placement>       m_sent;        // 键 -> 最近交付的位置
+        std::vector<Placement>       m_scratch;
+        bool                         m_unsent{ false };
+
+        std::function<void()>        m_notify;
+        std::chrono::milliseconds    m_frame;
+
+        // 由 m_mutex 保护
+        std::mutex                   m_mutex;
+        std::condition_variable_any  m_wake;
+        std::vector<Command>         m_commands;
+        std::vector<Placement>       m_ready;
+        bool                         m_hasReady{ false };
+
+        std::jthread                 m_thread;      // 最后声明：析构时最先停止
+    };
+}
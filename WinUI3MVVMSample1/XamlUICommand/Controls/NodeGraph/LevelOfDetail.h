@@ -0,0 +1,349 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "QuadTree.h"
+
+// 缩小视图时的细节层次（与平台无关，可脱离 WinUI 单独编译）。
+// SelectDetailLevel 按节点在屏幕上的像素尺寸选择层次：完整 -> 去标签 -> 点 -> 聚类。
+// ClusterHierarchy 是多级均匀网格（第 l 级单元边长为 baseCellSize * 2^l），每级记录单元内节点数与质心，
+// 以及跨单元的边数（相同单元对的边合并为一束）。节点移动时逐级比较新旧单元，只有单元变化的层级
+// 才调整计数和关联边束，代价为 O(层数 × 度)，不需要整体重建。
+namespace nodegraph
+{
+    enum class DetailLevel : uint8_t
+    {
+        Full,       // 形状 + 标签 + 提示
+        Reduced,    // 去掉标签、提示与描边
+        Points,     // 节点画成点，过短的边省略
+        Clusters,   // 网格聚类符号 + 聚类间边束
+    };
+
+    // 以屏幕像素计的阈值
+    struct LodThresholds
+    {
+        float labelMinPx{ 24.0f };      // 节点小于该尺寸时去掉标签
+        float shapeMinPx{ 8.0f };       // 小于该尺寸时画成点
+        float pointMinPx{ 3.0f };       // 小于该尺寸时聚类
+        float clusterCellPx{ 24.0f };   // 聚类单元的最小屏幕边长
+        float minEdgePx{ 3.0f };        // 点层次下短于该长度的边不画
+    };
+
+    inline DetailLevel SelectDetailLevel(float nodeExtent, float zoom, LodThresholds const& t = {}) noexcept
+    {
+        float const px = nodeExtent * zoom;
+        if (px >= t.labelMinPx) return DetailLevel::Full;
+        if (px >= t.shapeMinPx) return DetailLevel::Reduced;
+        if (px >= t.pointMinPx) return DetailLevel::Points;
+        return DetailLevel::Clusters;
+    }
+
+    class ClusterHierarchy
+    {
+    public:
+        struct Cluster
+        {
+            int32_t  cx{ 0 };
+            int32_t  cy{ 0 };
+            uint32_t count{ 0 };
+            double   sumX{ 0 };
+            double   sumY{ 0 };
+
+            float CenterX() const noexcept { return count ? static_cast<float>(sumX / count) : 0.0f; }
+            float CenterY() const noexcept { return count ? static_cast<float>(sumY / count) : 0.0f; }
+        };
+
+        explicit ClusterHierarchy(float baseCellSize = 32.0f, uint32_t levelCount = 12)
+            : m_baseCellSize(std::max(baseCellSize, 1.0f)), m_levels(std::max<uint32_t>(levelCount, 1))
+        {
+        }
+
+        uint32_t LevelCount() const noexcept { return static_cast<uint32_t>(m_levels.size()); }
+        float CellSize(uint32_t level) const noexcept { return std::ldexp(m_baseCellSize, static_cast<int>(level)); }
+
+        // 单元屏幕边长不小于 cellPx 的最细层级
+        uint32_t LevelFor(float zoom, float cellPx) const noexcept
+        {
+            for (uint32_t l = 0; l < m_levels.size(); ++l)
+                if (CellSize(l) * zoom >= cellPx)
+                    return l;
+            return LevelCount() - 1;
+        }
+
+        // —— 节点（键为调用方的稠密整数，NodeGraphPanel 使用节点槽位）——
+        // 插入或移动；(x, y) 为中心，extent 为较大边长
+        void SetNode(uint32_t key, float x, float y, float extent)
+        {
+            if (key >= m_nodes.size())
+                m_nodes.resize(static_cast<size_t>(key) + 1);
+            auto& node = m_nodes[key];
+            if (!node.alive)
+            {
+                node.alive = true;
+                node.x = x;
+                node.y = y;
+                node.extent = extent;
+                node.edges.clear();
+                for (uint32_t l = 0; l < m_levels.size(); ++l)
+                    AddToCell(l, CellOf(x, y, l), x, y, +1);
+                m_extentSum += extent;
+                ++m_nodeCount;
+                return;
+            }
+
+            float const ox = node.x, oy = node.y;
+            m_extentSum += extent - node.extent;
+            node.extent = extent;
+            if (ox == x && oy == y)
+                return;
+            for (uint32_t l = 0; l < m_levels.size(); ++l)
+            {
+                auto const oc = CellOf(ox, oy, l);
+                auto const nc = CellOf(x, y, l);
+                if (oc == nc)
+                {
+                    auto& cell = m_levels[l].cells[oc];
+                    cell.sumX += double(x) - ox;
+                    cell.sumY += double(y) - oy;
+                    continue;
+                }
+                // 单元变化：迁移计数，并把关联边束从旧单元对挪到新单元对
+                for (uint32_t e : node.edges)
+                    ContributeEdge(l, e, -1);
+                AddToCell(l, oc, ox, oy, -1);
+                node.x = x;
+                node.y = y;
+                AddToCell(l, nc, x, y, +1);
+                for (uint32_t e : node.edges)
+                    ContributeEdge(l, e, +1);
+                node.x = ox;
+                node.y = oy;
+            }
+            node.x = x;
+            node.y = y;
+        }
+
+        // 同时移除其关联边
+        void RemoveNode(uint32_t key)
+        {
+            if (!IsNodeAlive(key))
+                return;
+            auto edges = m_nodes[key].edges;
+            for (uint32_t e : edges)
+                RemoveEdge(e);
+            auto& node = m_nodes[key];
+            for (uint32_t l = 0; l < m_levels.size(); ++l)
+                AddToCell(l, CellOf(node.x, node.y, l), node.x, node.y, -1);
+            m_extentSum -= node.extent;
+            --m_nodeCount;
+            node = NodeRecord{};
+        }
+
+        bool IsNodeAlive(uint32_t key) const noexcept { return key < m_nodes.size() && m_nodes[key].alive; }
+
+        // —— 边（端点须已插入，否则忽略）——
+        void SetEdge(uint32_t key, uint32_t a, uint32_t b)
+        {
+            if (key < m_edges.size() && m_edges[key].alive)
+            {
+                if (m_edges[key].a == a && m_edges[key].b == b)
+                    return;
+                RemoveEdge(key);
+            }
+            if (!IsNodeAlive(a) || !IsNodeAlive(b))
+                return;
+            if (key >= m_edges.size())
+                m_edges.resize(static_cast<size_t>(key) + 1);
+            m_edges[key] = EdgeRecord{ true, a, b };
+            m_nodes[a].edges.push_back(key);
+            if (b != a)
+                m_nodes[b].edges.push_back(key);
+            for (uint32_t l = 0; l < m_levels.size(); ++l)
+                ContributeEdge(l, key, +1);
+        }
+
+        void RemoveEdge(uint32_t key)
+        {
+            if (key >= m_edges.size() || !m_edges[key].alive)
+                return;
+            for (uint32_t l = 0; l < m_levels.size(); ++l)
+                ContributeEdge(l, key, -1);
+            auto const e = m_edges[key];
+            Detach(m_nodes[e.a].edges, key);
+            if (e.b != e.a)
+                Detach(m_nodes[e.b].edges, key);
+            m_edges[key] = EdgeRecord{};
+        }
+
+        // —— 查询 ——
+        size_t NodeCount() const noexcept { return m_nodeCount; }
+        float MeanExtent() const noexcept { return m_nodeCount ? static_cast<float>(m_extentSum / m_nodeCount) : 0.0f; }
+
+        Box CellBounds(uint32_t level, int32_t cx, int32_t cy) const noexcept
+        {
+            float const s = CellSize(level);
+            return Box{ cx * s, cy * s, (cx + 1) * s, (cy + 1) * s };
+        }
+
+        // visit(Cluster const&)：与 area 相交的非空单元
+        template <typename F>
+        void ForEachCluster(uint32_t level, Box const& area, F&& visit) const
+        {
+            auto const& cells = m_levels[level].cells;
+            double const s = CellSize(level);
+            double const x0 = std::floor(area.minX / s), x1 = std::floor(area.maxX / s);
+            double const y0 = std::floor(area.minY / s), y1 = std::floor(area.maxY / s);
+            if (x1 < x0 || y1 < y0)
+                return;
+            // 区域覆盖的单元数少于非空单元数时按坐标查表，否则遍历非空单元
+            if ((x1 - x0 + 1) * (y1 - y0 + 1) <= static_cast<double>(cells.size()))
+            {
+                for (auto y = static_cast<int32_t>(y0); y <= static_cast<int32_t>(y1); ++y)
+                    for (auto x = static_cast<int32_t>(x0); x <= static_cast<int32_t>(x1); ++x)
+                        if (auto it = cells.find(PackCell(x, y)); it != cells.end())
+                            visit(it->second);
+                return;
+            }
+            for (auto const& kv : cells)
+                if (CellBounds(level, kv.second.cx, kv.second.cy).Intersects(area))
+                    visit(kv.second);
+        }
+
+        // visit(Cluster const& a, Cluster const& b, uint32_t edgeCount)：至少一端与 area 相交的边束
+        template <typename F>
+        void ForEachBundle(uint32_t level, Box const& area, F&& visit) const
+        {
+            auto const& lv = m_levels[level];
+            for (auto const& kv : lv.bundles)
+            {
+                auto const& a = lv.cells.at(kv.first.a);
+                auto const& b = lv.cells.at(kv.first.b);
+                if (CellBounds(level, a.cx, a.cy).Intersects(area) || CellBounds(level, b.cx, b.cy).Intersects(area))
+                    visit(a, b, kv.second);
+            }
+        }
+
+        size_t ClusterCount(uint32_t level) const noexcept { return m_levels[level].cells.size(); }
+        size_t BundleCount(uint32_t level) const noexcept { return m_levels[level].bundles.size(); }
+
+        void Clear()
+        {
+            m_nodes.clear();
+            m_edges.clear();
+            for (auto& lv : m_levels)
+            {
+                lv.cells.clear();
+                lv.bundles.clear();
+            }
+            m_nodeCount = 0;
+            m_extentSum = 0;
+        }
+
+    private:
+        using CellKey = uint64_t;
+
+        struct NodeRecord
+        {
+            bool                  alive{ false };
+            float                 x{ 0 };
+            float                 y{ 0 };
+            float                 extent{ 0 };
+            std::vector<uint32_t> edges;
+        };
+
+        struct EdgeRecord
+        {
+            bool     alive{ false };
+            uint32_t a{ 0 };
+            uint32_t b{ 0 };
+        };
+
+        // 无序单元对，a <= b
+        struct CellPair
+        {
+            CellKey a;
+            CellKey b;
+            friend bool operator==(CellPair const&, CellPair const&) = default;
+        };
+
+        struct CellPairHash
+        {
+            size_t operator()(CellPair const& p) const noexcept
+            {
+                uint64_t h = p.a * 0x9E3779B97F4A7C15ull;
+                h ^= p.b + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+                return static_cast<size_t>(h);
+            }
+        };
+
+        struct Level
+        {
+            std::unordered_map<CellKey, Cluster>            cells;
+            std::unordered_map<CellPair, uint32_t, CellPairHash> bundles;
+        };
+
+        static CellKey PackCell(int32_t x, int32_t y) noexcept
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+        }
+
+        CellKey CellOf(float x, float y, uint32_t level) const noexcept
+        {
+            float const s = CellSize(level);
+            return PackCell(static_cast<int32_t>(std::floor(x / s)), static_cast<int32_t>(std::floor(y / s)));
+        }
+
+        void AddToCell(uint32_t level, CellKey key, float x, float y, int sign)
+        {
+            auto& cells = m_levels[level].cells;
+            auto [it, inserted] = cells.try_emplace(key);
+            auto& cell = it->second;
+            if (inserted)
+            {
+                cell.cx = static_cast<int32_t>(key >> 32);
+                cell.cy = static_cast<int32_t>(key & 0xFFFFFFFFu);
+            }
+            cell.count += sign;
+            cell.sumX += sign * double(x);
+            cell.sumY += sign * double(y);
+            if (cell.count == 0)
+                cells.erase(it);
+        }
+
+        void ContributeEdge(uint32_t level, uint32_t edgeKey, int sign)
+        {
+            auto const& e = m_edges[edgeKey];
+            auto const& na = m_nodes[e.a];
+            auto const& nb = m_nodes[e.b];
+            CellKey ca = CellOf(na.x, na.y, level);
+            CellKey cb = CellOf(nb.x, nb.y, level);
+            if (ca == cb)
+                return;     // 单元内部的边在该层级不画
+            if (cb < ca)
+                std::swap(ca, cb);
+            auto& bundles = m_levels[level].bundles;
+            auto [it, inserted] = bundles.try_emplace(CellPair{ ca, cb }, 0u);
+            it->second += sign;
+            if (it->second == 0)
+                bundles.erase(it);
+        }
+
+        static void Detach(std::vector<uint32_t>& edges, uint32_t key)
+        {
+            if (auto it = std::find(edges.begin(), edges.end(), key); it != edges.end())
+            {
+                *it = edges.back();
+                edges.pop_back();
+            }
+        }
+
+        float                   m_baseCellSize;
+        std::vector<Level>      m_levels;
+        std::vector<NodeRecord> m_nodes;
+        std::vector<EdgeRecord> m_edges;
+        size_t                  m_nodeCount{ 0 };
+        double                  m_extentSum{ 0 };
+    };
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 列式的节点元数据表（与平台无关）：每个键一列、每个节点一行，取代“每个节点一张装箱值哈希表”。
+// 列内按行连续存放 1 字节类型标记与值：整数 / 浮点 / 布尔共用一条 8 字节标量通道，
+// 文本与其他对象各有独立通道，只在该列首次出现对应类型时才分配。
+// 按键查一次列号之后，取值就是数组下标；行释放后进入空闲链表复用，清空时只需扫一遍列。
+// Text / Object 由调用方决定（WinRT 层为 hstring / IInspectable），表本身不做装箱，也不加锁。
+namespace nodegraph
+{
+    enum class MetaKind : uint8_t
+    {
+        Empty = 0,
+        Int64 = 1,
+        Double = 2,
+        Bool = 3,
+        Text = 4,
+        Object = 5,
+    };
+
+    inline constexpr uint32_t InvalidMetaRow = 0xFFFFFFFFu;
+    inline constexpr uint32_t InvalidMetaColumn = 0xFFFFFFFFu;
+
+    template <typename Text, typename Object>
+    class MetaStore
+    {
+    public:
+        // —— 行 ——
+        uint32_t AllocateRow()
+        {
+            if (!m_freeRows.empty())
+            {
+                uint32_t row = m_freeRows.back();
+                m_freeRows.pop_back();
+                return row;
+            }
+            m_counts.push_back(0);
+            return static_cast<uint32_t>(m_counts.size() - 1);
+        }
+
+        void FreeRow(uint32_t row)
+        {
+            ClearRow(row);
+            m_freeRows.push_back(row);
+        }
+
+        void ClearRow(uint32_t row)
+        {
+            if (m_counts[row] == 0)
+                return;
+            for (auto& column : m_columns)
+            {
+                if (row < column.kinds.size() && column.kinds[row] != MetaKind::Empty)
+                    Release(column, row);
+            }
+            m_counts[row] = 0;
+        }
+
+        // 该行有值的键数
+        uint32_t Count(uint32_t row) const noexcept { return m_counts[row]; }
+
+        // —— 列 ——
+        uint32_t FindColumn(std::wstring_view key) const
+        {
+            auto it = m_lookup.find(key);
+            return it == m_lookup.end() ? InvalidMetaColumn : it->second;
+        }
+
+        // 查找或新建列；列一旦建立就不再移除，列号保持稳定
+        uint32_t Column(std::wstring_view key)
+        {
+            auto it = m_lookup.find(key);
+            if (it != m_lookup.end())
+                return it->second;
+            uint32_t index = static_cast<uint32_t>(m_columns.size());
+            m_columns.emplace_back().key = key;
+            m_lookup.emplace(std::wstring{ key }, index);
+            return index;
+        }
+
+        uint32_t ColumnCount() const noexcept { return static_cast<uint32_t>(m_columns.size()); }
+        std::wstring const& Key(uint32_t column) const noexcept { return m_columns[column].key; }
+
+        // —— 取值 ——
+        MetaKind Kind(uint32_t row, uint32_t column) const noexcept
+        {
+            if (column >= m_columns.size())
+                return MetaKind::Empty;
+            auto const& kinds = m_columns[column].kinds;
+            return row < kinds.size() ? kinds[row] : MetaKind::Empty;
+        }
+
+        int64_t Int(uint32_t row, uint32_t column) const noexcept { return std::bit_cast<int64_t>(m_columns[column].scalars[row]); }
+        double Double(uint32_t row, uint32_t column) const noexcept { return std::bit_cast<double>(m_columns[column].scalars[row]); }
+        bool Bool(uint32_t row, uint32_t column) const noexcept { return m_columns[column].scalars[row] != 0; }
+        Text const& TextAt(uint32_t row, uint32_t column) const noexcept { return m_columns[column].texts[row]; }
+        Object const& ObjectAt(uint32_t row, uint32_t column) const noexcept { return m_columns[column].objects[row]; }
+
+        // 按列号顺序访问该行所有有值的列：visit(column)
+        template <typename Visit>
+        void ForEach(uint32_t row, Visit&& visit) const
+        {
+            uint32_t remaining = m_counts[row];
+            for (uint32_t c = 0; c < m_columns.size() && remaining > 0; ++c)
+            {
+                if (Kind(row, c) != MetaKind::Empty)
+                {
+                    visit(c);
+                    --remaining;
+                }
+            }
+        }
+
+        // —— 写入 ——（返回 true 表示覆盖了已有的值）
+        bool SetInt(uint32_t row, uint32_t column, int64_t value) { return SetScalar(row, column, MetaKind::Int64, std::bit_cast<uint64_t>(value)); }
+        bool SetDouble(uint32_t row, uint32_t column, double value) { return SetScalar(row, column, MetaKind::Double, std::bit_cast<uint64_t>(value)); }
+        bool SetBool(uint32_t row, uint32_t column, bool value) { return SetScalar(row, column, MetaKind::Bool, value ? 1u : 0u); }
+
+        bool SetText(uint32_t row, uint32_t column, Text value)
+        {
+            auto& c = m_columns[column];
+            bool replaced = Prepare(c, row, MetaKind::Text);
+            Lane(c.texts, c, row) = std::move(value);
+            return replaced;
+        }
+
+        bool SetObject(uint32_t row, uint32_t column, Object value)
+        {
+            auto& c = m_columns[column];
+            bool replaced = Prepare(c, row, MetaKind::Object);
+            Lane(c.objects, c, row) = std::move(value);
+            return replaced;
+        }
+
+        bool Remove(uint32_t row, uint32_t column)
+        {
+            if (Kind(row, column) == MetaKind::Empty)
+                return false;
+            Release(m_columns[column], row);
+            --m_counts[row];
+            return true;
+        }
+
+    private:
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::wstring_view key) const noexcept { return std::hash<std::wstring_view>{}(key); }
+        };
+
+        struct ColumnData
+        {
+            std::wstring          key;
+            std::vector<MetaKind> kinds;     // 按行；Empty 表示该行没有这个键
+            std::vector<uint64_t> scalars;   // Int64 / Double / Bool 的位模式
+            std::vector<Text>     texts;
+            std::vector<Object>   objects;
+        };
+
+        template <typename T>
+        static T& Lane(std::vector<T>& lane, ColumnData const& column, uint32_t row)
+        {
+            if (lane.size() <= row)
+                lane.resize(std::max<size_t>(row + 1, column.kinds.size()));
+            return lane[row];
+        }
+
+        // 为写入腾出位置：扩展类型标记、释放旧值的引用并维护行计数
+        bool Prepare(ColumnData& column, uint32_t row, MetaKind kind)
+        {
+            if (column.kinds.size() <= row)
+                column.kinds.resize(std::max<size_t>(row + 1, m_counts.size()), MetaKind::Empty);
+            bool replaced = column.kinds[row] != MetaKind::Empty;
+            if (replaced)
+                Release(column, row);
+            else
+                ++m_counts[row];
+            column.kinds[row] = kind;
+            return replaced;
+        }
+
+        bool SetScalar(uint32_t row, uint32_t column, MetaKind kind, uint64_t bits)
+        {
+            auto& c = m_columns[column];
+            bool replaced = Prepare(c, row, kind);
+            Lane(c.scalars, c, row) = bits;
+            return replaced;
+        }
+
+        static void Release(ColumnData& column, uint32_t row)
+        {
+            if (column.kinds[row] == MetaKind::Text)
+                column.texts[row] = Text{};
+            else if (column.kinds[row] == MetaKind::Object)
+                column.objects[row] = Object{};
+            column.kinds[row] = MetaKind::Empty;
+        }
+
+        std::vector<ColumnData> m_columns;
+        std::unordered_map<std::wstring, uint32_t, StringHash, std::equal_to<>> m_lookup;
+        std::vector<uint32_t> m_counts;     // 按行：有值的键数
+        std::vector<uint32_t> m_freeRows;
+    };
+}
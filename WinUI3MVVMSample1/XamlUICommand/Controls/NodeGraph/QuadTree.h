@@ -0,0 +1,362 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 节点包围盒的空间索引（松散四叉树）。
+// 单元的查询边界向外扩展半个边长，条目按中心点下沉到尺寸足以容纳它的最深单元，
+// 因此跨越分割线的小节点不会堆积在上层单元里；叶子超过容量时分裂，根单元在插入越界条目时向外倍增，
+// 因此坐标不需要预先给定范围。条目键为调用方的稠密整数（NodeGraphPanel 使用 GraphIndex 的节点槽位），
+// 点选、框选与视口查询的代价为 O(log n + k)。
+// 含 NaN 的包围盒不入树，无穷大或超出 ±MaxCoordinate 的坐标先钳制，保证根单元的倍增必然有限次结束。
+namespace nodegraph
+{
+    struct Box
+    {
+        float minX{ 0 };
+        float minY{ 0 };
+        float maxX{ 0 };
+        float maxY{ 0 };
+
+        static Box FromRect(float x, float y, float width, float height) noexcept
+        {
+            return Box{ x, y, x + std::max(width, 0.0f), y + std::max(height, 0.0f) };
+        }
+
+        // 与任何盒子都不相交
+        static constexpr Box Empty() noexcept
+        {
+            return Box{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+        }
+
+        static constexpr Box Unbounded() noexcept
+        {
+            return Box{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                        std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+        }
+
+        friend bool operator==(Box const&, Box const&) = default;
+
+        bool Intersects(Box const& o) const noexcept
+        {
+            return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY && o.minY <= maxY;
+        }
+
+        bool Encloses(Box const& o) const noexcept
+        {
+            return o.minX >= minX && o.maxX <= maxX && o.minY >= minY && o.maxY <= maxY;
+        }
+
+        bool Contains(float x, float y) const noexcept
+        {
+            return x >= minX && x <= maxX && y >= minY && y <= maxY;
+        }
+
+        Box Inflate(float margin) const noexcept
+        {
+            return Box{ minX - margin, minY - margin, maxX + margin, maxY + margin };
+        }
+    };
+
+    class QuadTree
+    {
+    public:
+        // 坐标的有效范围；超出的坐标（含 ±inf）钳制到边界
+        static constexpr float MaxCoordinate = 1.0e9f;
+
+        explicit QuadTree(uint32_t leafCapacity = 8, float minCellSize = 8.0f)
+            : m_leafCapacity(std::max<uint32_t>(leafCapacity, 1)),
+              m_minCellSize(minCellSize >= MinCellSize ? minCellSize : MinCellSize)   // 同时挡住 NaN
+        {
+        }
+
+        // 包围盒含 NaN 时返回 false，且该键不再留在树中
+        bool Insert(uint32_t key, Box const& box)
+        {
+            if (Contains(key))
+                Remove(key);
+            auto const clamped = Sanitize(box);
+            if (!clamped)
+                return false;
+            if (m_cells.empty())
+                CreateRoot(*clamped);
+            GrowToContain(*clamped);
+            Place(key, *clamped, m_root);
+            ++m_count;
+            return true;
+        }
+
+        // 仍在原单元内时原地更新，否则重新插入
+        bool Update(uint32_t key, Box const& box)
+        {
+            if (!Contains(key))
+                return Insert(key, box);
+            auto const clamped = Sanitize(box);
+            if (!clamped)
+            {
+                Remove(key);
+                return false;
+            }
+            auto const& where = m_where[key];
+            auto& cell = m_cells[where.cell];
+            if (cell.LooseBounds().Encloses(*clamped) && (cell.IsLeaf() || cell.Quadrant(*clamped) < 0))
+            {
+                cell.items[where.index].box = *clamped;
+                return true;
+            }
+            Remove(key);
+            return Insert(key, *clamped);
+        }
+
+        void Remove(uint32_t key)
+        {
+            if (!Contains(key))
+                return;
+            auto where = m_where[key];
+            auto& items = m_cells[where.cell].items;
+            items[where.index] = items.back();
+            m_where[items[where.index].key].index = where.index;
+            items.pop_back();
+            m_where[key] = Location{};
+            --m_count;
+        }
+
+        bool Contains(uint32_t key) const noexcept
+        {
+            return key < m_where.size() && m_where[key].cell != InvalidCell;
+        }
+
+        // visit(key, box)；返回 false 可提前结束
+        template <typename F>
+        void Query(Box const& area, F&& visit) const
+        {
+            if (m_cells.empty())
+                return;
+            std::vector<uint32_t> stack;
+            stack.reserve(64);
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                auto const& cell = m_cells[stack.back()];
+                stack.pop_back();
+                if (!cell.LooseBounds().Intersects(area))
+                    continue;
+                for (auto const& item : cell.items)
+                {
+                    if (item.box.Intersects(area))
+                    {
+                        if constexpr (std::is_same_v<decltype(visit(item.key, item.box)), bool>)
+                        {
+                            if (!visit(item.key, item.box))
+                                return;
+                        }
+                        else
+                        {
+                            visit(item.key, item.box);
+                        }
+                    }
+                }
+                if (!cell.IsLeaf())
+                    for (uint32_t child : cell.children)
+                        stack.push_back(child);
+            }
+        }
+
+        template <typename F>
+        void QueryPoint(float x, float y, F&& visit) const
+        {
+            Query(Box{ x, y, x, y }, std::forward<F>(visit));
+        }
+
+        size_t Size() const noexcept { return m_count; }
+
+        void Clear()
+        {
+            m_cells.clear();
+            m_where.clear();
+            m_count = 0;
+            m_root = InvalidCell;
+        }
+
+    private:
+        static constexpr uint32_t InvalidCell = 0xFFFFFFFFu;
+        static constexpr float    MinCellSize = 1.0f / 64.0f;
+        // 根单元从 minCellSize*8 起倍增到覆盖 ±MaxCoordinate 至多需要约 40 次，此上限只作兜底
+        static constexpr int      MaxGrowSteps = 64;
+
+        struct Item
+        {
+            uint32_t key{ 0 };
+            Box      box;
+        };
+
+        struct Location
+        {
+            uint32_t cell{ InvalidCell };
+            uint32_t index{ 0 };
+        };
+
+        // 正方形单元：中心 (cx, cy)，半边长 half
+        struct Cell
+        {
+            float             cx{ 0 };
+            float             cy{ 0 };
+            float             half{ 0 };
+            uint32_t          children[4]{ InvalidCell, InvalidCell, InvalidCell, InvalidCell };
+            std::vector<Item> items;
+
+            bool IsLeaf() const noexcept { return children[0] == InvalidCell; }
+
+            // 条目只在中心落入本单元且尺寸不超过 half 时存放于此，故必然位于该边界内
+            Box LooseBounds() const noexcept
+            {
+                float const r = half * 2.0f;
+                return Box{ cx - r, cy - r, cx + r, cy + r };
+            }
+
+            bool Encloses(Box const& b) const noexcept
+            {
+                return b.minX >= cx - half && b.maxX <= cx + half && b.minY >= cy - half && b.maxY <= cy + half;
+            }
+
+            // 按中心点选择子象限（0..3）；条目超出该子单元的松散边界时返回 -1
+            int Quadrant(Box const& b) const noexcept
+            {
+                int qx = (b.minX + b.maxX) * 0.5f < cx ? 0 : 1;
+                int qy = (b.minY + b.maxY) * 0.5f < cy ? 0 : 1;
+                float const h = half * 0.5f;
+                float const ccx = cx + (qx ? h : -h);
+                float const ccy = cy + (qy ? h : -h);
+                Box const loose{ ccx - half, ccy - half, ccx + half, ccy + half };
+                return loose.Encloses(b) ? qy * 2 + qx : -1;
+            }
+        };
+
+        static std::optional<Box> Sanitize(Box const& box) noexcept
+        {
+            if (std::isnan(box.minX) || std::isnan(box.minY) || std::isnan(box.maxX) || std::isnan(box.maxY))
+                return std::nullopt;
+            auto clamp = [](float v) { return std::clamp(v, -MaxCoordinate, MaxCoordinate); };
+            return Box{ clamp(box.minX), clamp(box.minY), clamp(box.maxX), clamp(box.maxY) };
+        }
+
+        static Cell MakeCell(float cx, float cy, float half)
+        {
+            Cell cell;
+            cell.cx = cx;
+            cell.cy = cy;
+            cell.half = half;
+            return cell;
+        }
+
+        void CreateRoot(Box const& box)
+        {
+            float w = box.maxX - box.minX;
+            float h = box.maxY - box.minY;
+            float half = std::max({ w, h, m_minCellSize * 8.0f });
+            m_cells.push_back(MakeCell((box.minX + box.maxX) * 0.5f, (box.minY + box.maxY) * 0.5f, half));
+            m_root = 0;
+        }
+
+        // 根单元成为新根的一个象限，新根边长加倍并朝越界方向扩展
+        void GrowToContain(Box const& box)
+        {
+            for (int step = 0; step < MaxGrowSteps && !m_cells[m_root].Encloses(box); ++step)
+            {
+                struct { float cx, cy, half; } const old{ m_cells[m_root].cx, m_cells[m_root].cy, m_cells[m_root].half };
+                bool const growLeft = box.minX < old.cx - old.half;
+                bool const growUp = box.minY < old.cy - old.half;
+                Cell root = MakeCell(growLeft ? old.cx - old.half : old.cx + old.half,
+                                     growUp ? old.cy - old.half : old.cy + old.half,
+                                     old.half * 2.0f);
+
+                uint32_t const newRoot = static_cast<uint32_t>(m_cells.size());
+                // 旧根之外的三个象限按需创建，旧根所在象限直接复用
+                int const oldQuadrant = (growUp ? 2 : 0) + (growLeft ? 1 : 0);
+                m_cells.push_back(root);
+                for (int q = 0; q < 4; ++q)
+                {
+                    if (q == oldQuadrant)
+                    {
+                        m_cells[newRoot].children[q] = m_root;
+                        continue;
+                    }
+                    float const h = old.half;
+                    float const qx = m_cells[newRoot].cx + ((q & 1) ? h : -h);
+                    float const qy = m_cells[newRoot].cy + ((q & 2) ? h : -h);
+                    m_cells[newRoot].children[q] = static_cast<uint32_t>(m_cells.size());
+                    m_cells.push_back(MakeCell(qx, qy, h));
+                }
+                m_root = newRoot;
+            }
+        }
+
+        void Place(uint32_t key, Box const& box, uint32_t cellIndex)
+        {
+            for (;;)
+            {
+                auto& cell = m_cells[cellIndex];
+                if (cell.IsLeaf())
+                {
+                    if (cell.items.size() < m_leafCapacity || cell.half * 0.5f < m_minCellSize)
+                    {
+                        Store(key, box, cellIndex);
+                        return;
+                    }
+                    Split(cellIndex);
+                }
+                int q = m_cells[cellIndex].Quadrant(box);
+                if (q < 0)
+                {
+                    Store(key, box, cellIndex);
+                    return;
+                }
+                cellIndex = m_cells[cellIndex].children[q];
+            }
+        }
+
+        void Store(uint32_t key, Box const& box, uint32_t cellIndex)
+        {
+            if (key >= m_where.size())
+                m_where.resize(static_cast<size_t>(key) + 1);
+            auto& items = m_cells[cellIndex].items;
+            m_where[key] = Location{ cellIndex, static_cast<uint32_t>(items.size()) };
+            items.push_back(Item{ key, box });
+        }
+
+        void Split(uint32_t cellIndex)
+        {
+            float const h = m_cells[cellIndex].half * 0.5f;
+            for (int q = 0; q < 4; ++q)
+            {
+                float const qx = m_cells[cellIndex].cx + ((q & 1) ? h : -h);
+                float const qy = m_cells[cellIndex].cy + ((q & 2) ? h : -h);
+                uint32_t const child = static_cast<uint32_t>(m_cells.size());
+                m_cells.push_back(MakeCell(qx, qy, h));
+                m_cells[cellIndex].children[q] = child;
+            }
+
+            // 能完整落入子象限的条目下沉，跨线条目留在本单元
+            std::vector<Item> items;
+            items.swap(m_cells[cellIndex].items);
+            for (auto const& item : items)
+            {
+                int q = m_cells[cellIndex].Quadrant(item.box);
+                Store(item.key, item.box, q < 0 ? cellIndex : m_cells[cellIndex].children[q]);
+            }
+        }
+
+        std::vector<Cell>             m_cells;
+        std::vector<Location>         m_where;     // key -> 所在单元与下标
+        uint32_t                      m_root{ InvalidCell };
+        uint32_t                      m_leafCapacity;
+        float                         m_minCellSize;
+        size_t                        m_count{ 0 };
+    };
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "DisplayList.h"
+
+// DisplayList 的软件光栅化（与平台无关）。
+// 把显示列表按“先边后节点、批次顺序”绘制到内存中的 RGBA 位图，覆盖率由像素中心到图形边界的
+// 有符号距离换算（约 1 像素抗锯齿）。用于在无窗口环境下校验显示列表的内容与测量构建开销，
+// 也可作为导出缩略图的后备路径；交互渲染仍由 NodeGraphPanel 的批量几何完成。
+namespace nodegraph
+{
+    class Rasterizer
+    {
+    public:
+        Rasterizer(uint32_t width, uint32_t height)
+            : m_width(width), m_height(height), m_pixels(static_cast<size_t>(width) * height)
+        {
+        }
+
+        uint32_t Width() const noexcept { return m_width; }
+        uint32_t Height() const noexcept { return m_height; }
+        std::vector<Rgba> const& Pixels() const noexcept { return m_pixels; }
+        Rgba Pixel(uint32_t x, uint32_t y) const noexcept { return m_pixels[static_cast<size_t>(y) * m_width + x]; }
+
+        // 画布坐标 -> 像素：p * scale + offset
+        void SetTransform(float scale, float offsetX, float offsetY) noexcept
+        {
+            m_scale = scale;
+            m_offsetX = offsetX;
+            m_offsetY = offsetY;
+        }
+
+        void Clear(Rgba color)
+        {
+            std::fill(m_pixels.begin(), m_pixels.end(), color);
+        }
+
+        void Draw(DisplayList const& list)
+        {
+            for (auto const& batch : list.EdgeBatches())
+                for (auto const& s : batch.instances)
+                    DrawSegment(s, batch.style);
+            for (auto const& batch : list.NodeBatches())
+                for (auto const& b : batch.instances)
+                    DrawNode(b, batch.style);
+        }
+
+    private:
+        static float Coverage(float v) noexcept { return std::clamp(v, 0.0f, 1.0f); }
+
+        void DrawSegment(Segment const& s, EdgeStyle const& style)
+        {
+            float const x1 = s.x1 * m_scale + m_offsetX, y1 = s.y1 * m_scale + m_offsetY;
+            float const x2 = s.x2 * m_scale + m_offsetX, y2 = s.y2 * m_scale + m_offsetY;
+            float const half = std::max(style.thickness * m_scale, 1.0f) * 0.5f;
+            float const reach = half + 0.5f;        // 覆盖率大于 0 的最大距离
+            float const dx = x2 - x1, dy = y2 - y1;
+            float const len2 = dx * dx + dy * dy;
+
+            // 每行只遍历线段在该行 ±reach 范围内的部分，斜线不再扫描整个外接矩形
+            auto span = [&](float py, float& lo, float& hi) -> bool
+                {
+                    float t0 = 0.0f, t1 = 1.0f;
+                    if (dy != 0)
+                    {
+                        t0 = (py - reach - y1) / dy;
+                        t1 = (py + reach - y1) / dy;
+                        if (t0 > t1)
+                            std::swap(t0, t1);
+                        t0 = std::max(t0, 0.0f);
+                        t1 = std::min(t1, 1.0f);
+                        if (t0 > t1)
+                            return false;
+                    }
+                    else if (std::abs(py - y1) > reach)
+                    {
+                        return false;
+                    }
+                    float const xa = x1 + t0 * dx, xb = x1 + t1 * dx;
+                    lo = std::min(xa, xb) - reach - 1;
+                    hi = std::max(xa, xb) + reach + 1;
+                    return true;
+                };
+
+            ForEachRowSpan(std::min(y1, y2) - half - 1, std::max(y1, y2) + half + 1, span,
+                [&](float px, float py) -> float
+                {
+                    float t = len2 > 0 ? ((px - x1) * dx + (py - y1) * dy) / len2 : 0.0f;
+                    t = std::clamp(t, 0.0f, 1.0f);
+                    float const ex = px - (x1 + t * dx), ey = py - (y1 + t * dy);
+                    return Coverage(half + 0.5f - std::sqrt(ex * ex + ey * ey));
+                }, style.color);
+        }
+
+        void DrawNode(Box const& box, NodeStyle const& style)
+        {
+            float const minX = box.minX * m_scale + m_offsetX, minY = box.minY * m_scale + m_offsetY;
+            float const maxX = box.maxX * m_scale + m_offsetX, maxY = box.maxY * m_scale + m_offsetY;
+            float const cx = (minX + maxX) * 0.5f, cy = (minY + maxY) * 0.5f;
+            float const rx = (maxX - minX) * 0.5f, ry = (maxY - minY) * 0.5f;
+            if (rx <= 0 || ry <= 0)
+                return;
+            float const halfStroke = style.strokeWidth * m_scale * 0.5f;
+            float const corner = std::min({ style.cornerRadius * m_scale, rx, ry });
+
+            // 有符号距离：内部为负
+            auto distance = [&](float px, float py) -> float
+                {
+                    float const qx = px - cx, qy = py - cy;
+                    if (style.shape == Primitive::Ellipse)
+                    {
+                        float const f = (qx * qx) / (rx * rx) + (qy * qy) / (ry * ry) - 1.0f;
+                        float const gx = 2.0f * qx / (rx * rx), gy = 2.0f * qy / (ry * ry);
+                        float const g = std::sqrt(gx * gx + gy * gy);
+                        return g > 0 ? f / g : -std::min(rx, ry);
+                    }
+                    float const ax = std::abs(qx) - (rx - corner), ay = std::abs(qy) - (ry - corner);
+                    float const ox = std::max(ax, 0.0f), oy = std::max(ay, 0.0f);
+                    return std::sqrt(ox * ox + oy * oy) + std::min(std::max(ax, ay), 0.0f) - corner;
+                };
+
+            float const pad = halfStroke + 1.0f;
+            float const x0 = minX - pad, y0 = minY - pad, x1 = maxX + pad, y1 = maxY + pad;
+            if (style.fill.a != 0)
+                ForEachPixel(x0, y0, x1, y1, [&](float px, float py) { return Coverage(0.5f - distance(px, py)); }, style.fill);
+            if (style.stroke.a != 0 && halfStroke > 0)
+                ForEachPixel(x0, y0, x1, y1, [&](float px, float py) { return Coverage(halfStroke + 0.5f - std::abs(distance(px, py))); }, style.stroke);
+        }
+
+        template <typename F>
+        void ForEachPixel(float minX, float minY, float maxX, float maxY, F&& coverage, Rgba color)
+        {
+            ForEachRowSpan(minY, maxY, [&](float, float& lo, float& hi) { lo = minX; hi = maxX; return true; },
+                std::forward<F>(coverage), color);
+        }
+
+        // span(行中心 y, lo, hi) 给出该行需要计算覆盖率的横向范围，返回 false 跳过该行
+        template <typename Span, typename F>
+        void ForEachRowSpan(float minY, float maxY, Span&& span, F&& coverage, Rgba color)
+        {
+            // 先把范围限制在画布内再取整，远离画布的坐标不会溢出 int
+            float const w = static_cast<float>(m_width), h = static_cast<float>(m_height);
+            int const y0 = static_cast<int>(std::floor(std::clamp(minY, 0.0f, h)));
+            int const y1 = static_cast<int>(std::ceil(std::clamp(maxY, -1.0f, h - 1)));
+            for (int y = y0; y <= y1; ++y)
+            {
+                float lo = 0, hi = 0;
+                if (!span(y + 0.5f, lo, hi))
+                    continue;
+                int const x0 = static_cast<int>(std::floor(std::clamp(lo, 0.0f, w)));
+                int const x1 = static_cast<int>(std::ceil(std::clamp(hi, -1.0f, w - 1)));
+                for (int x = x0; x <= x1; ++x)
+                {
+                    float const c = coverage(x + 0.5f, y + 0.5f);
+                    if (c > 0)
+                        Blend(m_pixels[static_cast<size_t>(y) * m_width + x], color, c);
+                }
+            }
+        }
+
+        // 非预乘 source-over
+        static void Blend(Rgba& dst, Rgba src, float coverage) noexcept
+        {
+            float const sa = src.a / 255.0f * coverage;
+            float const da = dst.a / 255.0f;
+            float const oa = sa + da * (1.0f - sa);
+            if (oa <= 0)
+            {
+                dst = Rgba{ 0, 0, 0, 0 };
+                return;
+            }
+            auto mix = [&](uint8_t s, uint8_t d)
+                {
+                    float const v = (s * sa + d * da * (1.0f - sa)) / oa;
+                    return static_cast<uint8_t>(std::clamp(v + 0.5f, 0.0f, 255.0f));
+                };
+            dst = Rgba{ mix(src.r, dst.r), mix(src.g, dst.g), mix(src.b, dst.b), static_cast<uint8_t>(oa * 255.0f + 0.5f) };
+        }
+
+        uint32_t          m_width;
+        uint32_t          m_height;
+        std::vector<Rgba> m_pixels;
+        float             m_scale{ 1.0f };
+        float             m_offsetX{ 0.0f };
+        float             m_offsetY{ 0.0f };
+    };
+}
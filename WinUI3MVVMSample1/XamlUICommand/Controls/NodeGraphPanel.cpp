@@ -14,6 +14,8 @@
 #include <winrt/Microsoft.UI.Content.h>
 #include <winrt/Microsoft.UI.Xaml.Hosting.h>
 
+#include "../../WinUI3MVVMSample1/mvvm_framework/mvvm_diagnostics.h"
+
 
 using namespace winrt;
 using namespace Microsoft::UI::Xaml;
@@ -29,28 +31,19 @@ namespace winrt::XamlUICommand::implementation
     // Helper functions, use macros to avoid polluting global namespace and avoid redefinition errors.
 #ifndef NODEGRAPHPANEL_HELPERS_API
 #define NODEGRAPHPANEL_HELPERS_API
-    // 相对亮度 & 对比度（WCAG）
+    // 相对亮度 & 对比度（WCAG）；单色版本，与批量版本共用 NodeGraph/ColorKernels.h 的查找表
     static double Luminance(Windows::UI::Color c)
     {
-        auto toLin = [](double u)
-            {
-                u /= 255.0;
-                return (u <= 0.03928) ? (u / 12.92) : std::pow((u + 0.055) / 1.055, 2.4);
-            };
-        return 0.2126 * toLin(c.R) + 0.7152 * toLin(c.G) + 0.0722 * toLin(c.B);
+        return nodegraph::RelativeLuminance(nodegraph::Rgba{ c.R, c.G, c.B, c.A });
     }
     static double Contrast(Windows::UI::Color a, Windows::UI::Color b)
     {
-        double la = Luminance(a), lb = Luminance(b);
-        double L1 = std::max(la, lb) + 0.05;
-        double L2 = std::min(la, lb) + 0.05;
-        return L1 / L2;
+        return nodegraph::ContrastRatio(nodegraph::Rgba{ a.R, a.G, a.B, a.A }, nodegraph::Rgba{ b.R, b.G, b.B, b.A });
     }
     static Windows::UI::Color MakeLighterDarker(Windows::UI::Color c, double delta) // delta: [-1,1]
     {
-        auto clamp = [](int v) { return std::min(255, std::max(0, v)); };
-        int d = int(delta * 255.0);
-        return Windows::UI::Color{ c.A, (uint8_t)clamp(c.R + d), (uint8_t)clamp(c.G + d), (uint8_t)clamp(c.B + d) };
+        auto s = nodegraph::Shade(nodegraph::Rgba{ c.R, c.G, c.B, c.A }, static_cast<float>(delta));
+        return Windows::UI::Color{ s.a, s.r, s.g, s.b };
     }
     static bool TryGetSolid(Brush const& b, Windows::UI::Color& out)
     {
@@ -102,6 +95,11 @@ namespace winrt::XamlUICommand::implementation
             xaml_typename<XamlUICommand::NodeGraphPanel>(),
             PropertyMetadata{ winrt::box_value(4.5), PropertyChangedCallback{ &NodeGraphPanel::OnAppearanceChanged } });
 
+    DependencyProperty NodeGraphPanel::s_HighlightBrushProperty =
+        DependencyProperty::Register(L"HighlightBrush", xaml_typename<Brush>(),
+            xaml_typename<XamlUICommand::NodeGraphPanel>(),
+            PropertyMetadata{ nullptr, PropertyChangedCallback{ &NodeGraphPanel::OnAppearanceChanged } });
+
 
     // 注册（保持你原有的 Register 代码，但改用 s_ 前缀）
     DependencyProperty NodeGraphPanel::NodeFillProperty()
@@ -136,6 +134,10 @@ namespace winrt::XamlUICommand::implementation
     {
         return s_ContrastThresholdProperty;
     }
+    DependencyProperty NodeGraphPanel::HighlightBrushProperty()
+    {
+        return s_HighlightBrushProperty;
+    }
 
     Microsoft::UI::Xaml::Media::Brush NodeGraphPanel::NodeFill()
     {
@@ -209,17 +211,45 @@ namespace winrt::XamlUICommand::implementation
         SetValue(ContrastThresholdProperty(), winrt::box_value(v));
     }
 
+    Microsoft::UI::Xaml::Media::Brush NodeGraphPanel::HighlightBrush()
+    {
+        return GetValue(HighlightBrushProperty()).as<Microsoft::UI::Xaml::Media::Brush>();
+    }
+    void NodeGraphPanel::HighlightBrush(Microsoft::UI::Xaml::Media::Brush const& v)
+    {
+        SetValue(HighlightBrushProperty(), v);
+    }
+
 #pragma endregion
 
     NodeGraphPanel::NodeGraphPanel()
     {
         DefaultStyleKey(box_value(L"XamlUICommand.NodeGraphPanel"));
+        ConnectCollectionEvents();
     }
 
     void NodeGraphPanel::OnApplyTemplate()
     {
         NodeGraphPanelT<NodeGraphPanel>::OnApplyTemplate();
         m_canvas = GetTemplateChild(L"NodeGraphPanelCanvas").as<Canvas>();
+        // 批量模式没有逐节点的 Tapped，统一在画布上按空间索引命中
+        m_canvasTappedToken = m_canvas.Tapped(
+            [weak = get_weak()](IInspectable const&, TappedRoutedEventArgs const& e)
+            {
+                if (auto self = weak.get())
+                {
+                    self->OnCanvasTapped(e);
+                }
+            });
+        // 有效视口包含外层 ScrollView 的平移与缩放，坐标已换算到画布空间
+        m_viewportToken = m_canvas.EffectiveViewportChanged(
+            [weak = get_weak()](FrameworkElement const&, EffectiveViewportChangedEventArgs const& e)
+            {
+                if (auto self = weak.get())
+                {
+                    self->OnEffectiveViewportChanged(e.EffectiveViewport());
+                }
+            });
         RebuildAll();
         ConnectCollectionEvents();
 
@@ -233,7 +263,13 @@ namespace winrt::XamlUICommand::implementation
             {
                 if (auto self = weak.get())
                 {
-                    self->RedrawEdges();
+                    self->InvalidateAppearance();
+                    if (self->IsBatched())
+                    {
+                        self->RebuildDisplayList();
+                        return;
+                    }
+                    self->RestyleEdges();
                     self->RedrawNodes();
                 }
             });
@@ -244,7 +280,8 @@ namespace winrt::XamlUICommand::implementation
         if (m_nodes != value)
         {
             DisconnectCollectionEvents();
-            m_nodes = value ? value : single_threaded_observable_vector<XamlUICommand::NodeViewModel>();
+            m_nodes = value ? value : mvvm::make_range_observable_vector<XamlUICommand::NodeViewModel>();
+            RebuildNodeIndex();
             ConnectCollectionEvents();
             RebuildAll();
         }
@@ -255,9 +292,9 @@ namespace winrt::XamlUICommand::implementation
         if (m_edges != value)
         {
             DisconnectCollectionEvents();
-            m_edges = value ? value : single_threaded_observable_vector<XamlUICommand::EdgeViewModel>();
+            m_edges = value ? value : mvvm::make_range_observable_vector<XamlUICommand::EdgeViewModel>();
+            RebuildEdgeIndex();     // 逐条重建边线元素
             ConnectCollectionEvents();
-            RedrawEdges();
         }
     }
 
@@ -265,14 +302,18 @@ namespace winrt::XamlUICommand::implementation
     {
         if (m_selected != value)
         {
+            auto previous = m_selected;
             m_selected = value;
-            // Update visuals: bold border for selected, etc.
-            for (auto& kv : m_nodeElements)
+            if (IsBatched())
             {
-                auto fe = kv.second;
-                auto border = fe.as<Controls::Grid>().Children().GetAt(0).as<Shapes::Shape>();
-                border.StrokeThickness(kv.first == (m_selected ? m_selected.Id() : INT64_MIN) ? 3.0 : 1.0);
+                if (previous) SyncNodeInstance(m_graph.FindNode(previous.Id()));
+                if (m_selected) SyncNodeInstance(m_graph.FindNode(m_selected.Id()));
+                return;
             }
+            // Update visuals: bold border for selected, etc.
+            // 只有新旧两个节点的描边会变化，由 BindNodeElement 统一决定（高亮节点保持高亮描边）
+            if (previous) UpdateNodeElement(previous);
+            if (m_selected) UpdateNodeElement(m_selected);
         }
     }
 
@@ -303,6 +344,48 @@ namespace winrt::XamlUICommand::implementation
         }
     }
 
+    void NodeGraphPanel::RenderMode(XamlUICommand::NodeGraphRenderMode const& value)
+    {
+        if (m_renderMode != value)
+        {
+            m_renderMode = value;
+            if (!IsBatched())
+            {
+                m_displayList.Clear();
+                m_displayList.ConsumeChanges([](auto const&) {});
+            }
+            RebuildAll();
+        }
+    }
+
+    void NodeGraphPanel::IsVirtualizing(bool value)
+    {
+        if (m_virtualizing != value)
+        {
+            m_virtualizing = value;
+            UpdateRealization(true);
+        }
+    }
+
+    void NodeGraphPanel::RealizationMargin(double value)
+    {
+        value = std::max(0.0, value);
+        if (m_realizationMargin != value)
+        {
+            m_realizationMargin = value;
+            UpdateRealization(true);
+        }
+    }
+
+    void NodeGraphPanel::IsLevelOfDetailEnabled(bool value)
+    {
+        if (m_lodEnabled != value)
+        {
+            m_lodEnabled = value;
+            if (UpdateDetailLevel()) UpdateRealization(true);
+        }
+    }
+
     XamlUICommand::NodeViewModel NodeGraphPanel::AddNode(int64_t id, hstring const& label, Point const& position)
     {
         auto node = winrt::make<XamlUICommand::implementation::NodeViewModel>();
@@ -318,33 +401,96 @@ namespace winrt::XamlUICommand::implementation
 
     void NodeGraphPanel::RemoveNode(int64_t id)
     {
-        for (uint32_t i = 0; i < m_nodes.Size(); ++i)
+        if (m_updateDepth > 0)
         {
-            if (m_nodes.GetAt(i).Id() == id)
+            // 批量期间 m_nodeOrder / m_edgeOrder 不随集合变化同步，按集合本身定位；索引与元素由 EndUpdate 重建
+            uint32_t const count = m_nodes.Size();
+            for (uint32_t i = 0; i < count; ++i)
             {
-                m_nodes.RemoveAt(i);
-                RemoveNodeElement(id);
-                break;
+                if (m_nodes.GetAt(i).Id() == id)
+                {
+                    m_nodes.RemoveAt(i);
+                    break;
+                }
             }
+            RemoveBatchedEdges([id](XamlUICommand::EdgeViewModel const& e) { return e.FromId() == id || e.ToId() == id; });
+            return;
         }
-        // Remove edges referencing this node
-        for (int32_t i = (int32_t)m_edges.Size() - 1; i >= 0; --i)
+        auto slot = m_graph.FindNode(id);
+        if (slot != nodegraph::InvalidSlot)
         {
-            auto e = m_edges.GetAt(i);
-            if (e.FromId() == id || e.ToId() == id)
+            auto it = std::find(m_nodeOrder.begin(), m_nodeOrder.end(), slot);
+            if (it != m_nodeOrder.end())
             {
-                m_edges.RemoveAt(i);
+                m_nodes.RemoveAt(static_cast<uint32_t>(it - m_nodeOrder.begin()));
+                RemoveNodeElement(id);
             }
         }
-        RedrawEdges();
+        // Remove edges referencing this node (via adjacency list)
+        auto incident = m_graph.IncidentEdges(id);
+        RemoveEdgeSlots(std::vector<uint32_t>(incident.begin(), incident.end()));
     }
 
     XamlUICommand::NodeViewModel NodeGraphPanel::GetNode(int64_t id)
     {
-        for (auto const& n : m_nodes) if (n.Id() == id) return n;
+        // 批量期间：索引只覆盖已跟踪的前缀，且集合有非追加修改时可能已过期，其余部分按集合查找
+        uint32_t begin = 0;
+        if (m_updateDepth > 0 && !m_rebuildNodes)
+            begin = static_cast<uint32_t>(m_nodeOrder.size());
+        if (m_updateDepth == 0 || !m_rebuildNodes)
+        {
+            auto slot = m_graph.FindNode(id);
+            if (slot != nodegraph::InvalidSlot) return m_graph.Node(slot).payload.vm;
+            if (m_updateDepth == 0) return nullptr;
+        }
+        uint32_t const count = m_nodes.Size();
+        for (uint32_t i = begin; i < count; ++i)
+        {
+            auto node = m_nodes.GetAt(i);
+            if (node.Id() == id) return node;
+        }
         return nullptr;
     }
 
+    XamlUICommand::NodeViewModel NodeGraphPanel::HitTest(Point const& point)
+    {
+        // 多个节点重叠时取中心最近者；圆形节点按椭圆精确判定
+        XamlUICommand::NodeViewModel hit{ nullptr };
+        float best = std::numeric_limits<float>::max();
+        m_spatial.QueryPoint(point.X, point.Y, [&](uint32_t slot, nodegraph::Box const& b)
+            {
+                auto const& node = m_graph.Node(slot).payload.vm;
+                float const cx = (b.minX + b.maxX) * 0.5f;
+                float const cy = (b.minY + b.maxY) * 0.5f;
+                float const rx = (b.maxX - b.minX) * 0.5f;
+                float const ry = (b.maxY - b.minY) * 0.5f;
+                if (node.Shape() == XamlUICommand::NodeShape::Circle && rx > 0 && ry > 0)
+                {
+                    float const dx = (point.X - cx) / rx;
+                    float const dy = (point.Y - cy) / ry;
+                    if (dx * dx + dy * dy > 1.0f) return;
+                }
+                float const d = (point.X - cx) * (point.X - cx) + (point.Y - cy) * (point.Y - cy);
+                if (d < best)
+                {
+                    best = d;
+                    hit = node;
+                }
+            });
+        return hit;
+    }
+
+    IVectorView<XamlUICommand::NodeViewModel> NodeGraphPanel::FindNodesInRect(Rect const& rect)
+    {
+        std::vector<XamlUICommand::NodeViewModel> found;
+        m_spatial.Query(nodegraph::Box::FromRect(rect.X, rect.Y, rect.Width, rect.Height),
+            [&](uint32_t slot, nodegraph::Box const&)
+            {
+                found.push_back(m_graph.Node(slot).payload.vm);
+            });
+        return single_threaded_vector(std::move(found)).GetView();
+    }
+
     void NodeGraphPanel::AddOrUpdateMeta(int64_t id, hstring const& key, IInspectable const& value)
     {
         auto node = GetNode(id);
@@ -371,42 +517,304 @@ namespace winrt::XamlUICommand::implementation
         edge.FromId(fromId);
         edge.ToId(toId);
         edge.Label(label);
-        m_edges.Append(edge);
-        RedrawEdges();
+        m_edges.Append(edge);   // 边线元素由 TrackEdge 创建
         return edge;
     }
 
     void NodeGraphPanel::RemoveEdge(int64_t fromId, int64_t toId)
     {
-        for (int32_t i = (int32_t)m_edges.Size() - 1; i >= 0; --i)
+        if (m_updateDepth > 0)
         {
-            auto e = m_edges.GetAt(i);
-            if (e.FromId() == fromId && e.ToId() == toId)
-            {
+            RemoveBatchedEdges([fromId, toId](XamlUICommand::EdgeViewModel const& e) { return e.FromId() == fromId && e.ToId() == toId; });
+            return;
+        }
+        std::vector<uint32_t> matches;
+        for (auto slot : m_graph.IncidentEdges(fromId))
+        {
+            auto const& e = m_graph.Edge(slot);
+            if (e.from == fromId && e.to == toId)
+                matches.push_back(slot);
+        }
+        RemoveEdgeSlots(matches);
+    }
+
+    void NodeGraphPanel::RemoveEdgeSlots(std::vector<uint32_t> const& edgeSlots)
+    {
+        if (edgeSlots.empty()) return;
+        std::vector<bool> doomed(m_graph.EdgeSlotCount(), false);
+        for (auto slot : edgeSlots) doomed[slot] = true;
+        // 从后往前删除，m_edgeOrder 由 VectorChanged 同步
+        for (uint32_t i = static_cast<uint32_t>(m_edgeOrder.size()); i-- > 0;)
+        {
+            if (i < m_edgeOrder.size() && doomed[m_edgeOrder[i]])
+                m_edges.RemoveAt(i);
+        }
+    }
+
+    template <typename Predicate>
+    void NodeGraphPanel::RemoveBatchedEdges(Predicate&& doomed)
+    {
+        for (uint32_t i = m_edges.Size(); i-- > 0;)
+        {
+            if (doomed(m_edges.GetAt(i)))
                 m_edges.RemoveAt(i);
+        }
+    }
+
+    nodegraph::Box NodeGraphPanel::NodeBounds(XamlUICommand::NodeViewModel const& node)
+    {
+        auto pos = node.Position();
+        auto size = node.Size();
+        return nodegraph::Box::FromRect(pos.X, pos.Y, size.Width, size.Height);
+    }
+
+    uint32_t NodeGraphPanel::TrackNode(XamlUICommand::NodeViewModel const& node)
+    {
+        // 加入时即补齐默认尺寸/形状，不再依赖集合变化后的全量重绘
+        EnsureNodeDefaults(node);
+        auto slot = m_graph.AddNode(node.Id(), NodeEntry{ node, {}, ++m_layoutStamp });
+        m_spatial.Insert(slot, NodeBounds(node));
+        SyncLodNode(slot);
+        if (m_layout) PostLayoutNode(slot, true);
+        ScheduleLayeredRelayout();
+        UpdateIncidentEdges(node.Id());     // 端点出现，补齐之前悬空的边
+        m_graph.Node(slot).payload.token = node.PropertyChanged(
+            [weak = get_weak(), slot](IInspectable const&, Microsoft::UI::Xaml::Data::PropertyChangedEventArgs const& e)
+            {
+                if (auto self = weak.get())
+                {
+                    self->OnNodePropertyChanged(slot, e.PropertyName());
+                }
+            });
+        SyncNodeInstance(slot);
+        RealizeNode(slot);
+        return slot;
+    }
+
+    void NodeGraphPanel::UntrackNode(uint32_t slot)
+    {
+        if (!m_graph.IsNodeAlive(slot)) return;
+        auto& entry = m_graph.Node(slot).payload;
+        entry.vm.PropertyChanged(entry.token);
+        auto id = m_graph.Node(slot).id;
+        if (IsBatched())
+        {
+            m_displayList.RemoveNode(slot);
+            ScheduleBatchFlush();
+        }
+        if (m_graph.FindNode(id) == slot) RemoveNodeElement(id);
+        m_spatial.Remove(slot);
+        m_lod.RemoveNode(slot);
+        if (m_layout) m_layout->RemoveNode(slot);
+        m_graph.RemoveNode(slot);
+        ScheduleLayeredRelayout();
+        SyncOverviewNode(slot);
+        // 同 Id 的后继节点（若有）接替元素
+        if (auto next = m_graph.FindNode(id); next != nodegraph::InvalidSlot) RealizeNode(next);
+        UpdateIncidentEdges(id);
+    }
+
+    uint32_t NodeGraphPanel::TrackEdge(XamlUICommand::EdgeViewModel const& edge)
+    {
+        auto slot = m_graph.AddEdge(edge.FromId(), edge.ToId(), EdgeEntry{ edge, {} });
+        m_graph.Edge(slot).payload.token = edge.PropertyChanged(
+            [weak = get_weak(), slot](IInspectable const&, Microsoft::UI::Xaml::Data::PropertyChangedEventArgs const& e)
+            {
+                auto self = weak.get();
+                if (!self || !self->m_graph.IsEdgeAlive(slot)) return;
+                if (e.PropertyName() == L"FromId" || e.PropertyName() == L"ToId")
+                {
+                    auto const& vm = self->m_graph.Edge(slot).payload.vm;
+                    self->m_graph.RelinkEdge(slot, vm.FromId(), vm.ToId());
+                    self->UpdateEdgeBounds(slot);
+                    self->UpdateEdgeElement(slot);
+                    self->ScheduleLayeredRelayout();
+                }
+                else if (e.PropertyName() == L"IsDirected" || e.PropertyName() == L"Weight")
+                {
+                    self->UpdateEdgeBounds(slot);   // 查询图的弧方向与权重
+                    self->ScheduleLayeredRelayout();
+                }
+                else if (e.PropertyName() == L"IsHighlighted")
+                {
+                    self->RestyleEdge(slot);
+                }
+            });
+        ScheduleLayeredRelayout();
+        UpdateEdgeBounds(slot);
+        AttachEdgeElement(slot);
+        return slot;
+    }
+
+    void NodeGraphPanel::UntrackEdge(uint32_t slot)
+    {
+        if (!m_graph.IsEdgeAlive(slot)) return;
+        RemoveEdgeElement(slot);
+        m_edgeSpatial.Remove(slot);
+        m_lod.RemoveEdge(slot);
+        if (m_layout) m_layout->RemoveEdge(slot);
+        m_query.RemoveEdge(slot);
+        ScheduleLayeredRelayout();
+        auto& entry = m_graph.Edge(slot).payload;
+        entry.vm.PropertyChanged(entry.token);
+        m_graph.RemoveEdge(slot);
+    }
+
+    void NodeGraphPanel::RebuildNodeIndex()
+    {
+        for (auto slot : m_nodeOrder) UntrackNode(slot);
+        m_nodeOrder.clear();
+        if (!m_nodes) return;
+        m_nodeOrder.reserve(m_nodes.Size());
+        for (auto const& node : m_nodes) m_nodeOrder.push_back(TrackNode(node));
+    }
+
+    void NodeGraphPanel::RebuildEdgeIndex()
+    {
+        for (auto slot : m_edgeOrder) UntrackEdge(slot);
+        m_edgeOrder.clear();
+        if (!m_edges) return;
+        m_edgeOrder.reserve(m_edges.Size());
+        for (auto const& edge : m_edges) m_edgeOrder.push_back(TrackEdge(edge));
+    }
+
+    void NodeGraphPanel::OnNodesVectorChanged(IVectorChangedEventArgs const& args)
+    {
+        uint32_t const index = args.Index();
+        if (m_updateDepth > 0)
+        {
+            // 批量期间只记录是否仍是末尾追加，索引与渲染推迟到 EndUpdate
+            if (args.CollectionChange() != CollectionChange::ItemInserted || index + 1 != m_nodes.Size()) m_rebuildNodes = true;
+            return;
+        }
+        switch (args.CollectionChange())
+        {
+        case CollectionChange::ItemInserted:
+            if (index <= m_nodeOrder.size())
+                m_nodeOrder.insert(m_nodeOrder.begin() + index, TrackNode(m_nodes.GetAt(index)));
+            break;
+        case CollectionChange::ItemRemoved:
+            if (index < m_nodeOrder.size())
+            {
+                UntrackNode(m_nodeOrder[index]);
+                m_nodeOrder.erase(m_nodeOrder.begin() + index);
+            }
+            break;
+        case CollectionChange::ItemChanged:
+            if (index < m_nodeOrder.size())
+            {
+                UntrackNode(m_nodeOrder[index]);
+                m_nodeOrder[index] = TrackNode(m_nodes.GetAt(index));
+            }
+            break;
+        default:
+            RebuildNodeIndex();
+            return;
+        }
+        // 集合未按约定发出通知时退回全量重建
+        if (m_nodeOrder.size() != m_nodes.Size()) RebuildNodeIndex();
+    }
+
+    void NodeGraphPanel::OnEdgesVectorChanged(IVectorChangedEventArgs const& args)
+    {
+        uint32_t const index = args.Index();
+        if (m_updateDepth > 0)
+        {
+            if (args.CollectionChange() != CollectionChange::ItemInserted || index + 1 != m_edges.Size()) m_rebuildEdges = true;
+            return;
+        }
+        switch (args.CollectionChange())
+        {
+        case CollectionChange::ItemInserted:
+            if (index <= m_edgeOrder.size())
+                m_edgeOrder.insert(m_edgeOrder.begin() + index, TrackEdge(m_edges.GetAt(index)));
+            break;
+        case CollectionChange::ItemRemoved:
+            if (index < m_edgeOrder.size())
+            {
+                UntrackEdge(m_edgeOrder[index]);
+                m_edgeOrder.erase(m_edgeOrder.begin() + index);
+            }
+            break;
+        case CollectionChange::ItemChanged:
+            if (index < m_edgeOrder.size())
+            {
+                UntrackEdge(m_edgeOrder[index]);
+                m_edgeOrder[index] = TrackEdge(m_edges.GetAt(index));
+            }
+            break;
+        default:
+            RebuildEdgeIndex();
+            return;
+        }
+        if (m_edgeOrder.size() != m_edges.Size()) RebuildEdgeIndex();
+    }
+
+    void NodeGraphPanel::OnNodePropertyChanged(uint32_t slot, hstring const& propertyName)
+    {
+        if (!m_graph.IsNodeAlive(slot)) return;
+        auto node = m_graph.Node(slot).payload.vm;
+
+        if (propertyName == L"Id")
+        {
+            // 元素表按 Id 索引，随之改键
+            auto oldId = m_graph.Node(slot).id;
+            m_graph.RenameNode(slot, node.Id());
+            if (auto it = m_nodeElements.find(oldId); it != m_nodeElements.end())
+            {
+                auto fe = it->second;
+                m_nodeElements.erase(it);
+                m_nodeElements.insert_or_assign(node.Id(), fe);
             }
+            UpdateNodeElement(node);
+            SyncNodeInstance(slot);
+            UpdateIncidentEdges(oldId);
+            UpdateIncidentEdges(node.Id());
+            return;
+        }
+
+        UpdateNodeElement(node);
+        if (propertyName == L"IsHighlighted" || propertyName == L"IsSelected")
+        {
+            SyncNodeInstance(slot);
+            return;
+        }
+        if (propertyName == L"Position" || propertyName == L"Size")
+        {
+            m_spatial.Update(slot, NodeBounds(node));
+            SyncLodNode(slot);
+            if (m_layout && !m_applyingLayout && propertyName == L"Position") PostLayoutNode(slot, false);
+            if (propertyName == L"Size") ScheduleLayeredRelayout();
+            SyncNodeInstance(slot);
+            RealizeNode(slot);      // 移入/移出实现区域
+#ifdef NODEGRAPH_RENDER_STATS
+            auto before = m_edgeStats;
+#endif
+            // 只更新与该节点相连的边
+            UpdateIncidentEdges(node.Id());
+#ifdef NODEGRAPH_RENDER_STATS
+            MVVM_LOGS(GraphPanel, Info, L"node {} {}: edges created {}, updated {}, removed {}",
+                node.Id(), std::wstring_view{ propertyName },
+                m_edgeStats.created - before.created,
+                m_edgeStats.updated - before.updated,
+                m_edgeStats.removed - before.removed);
+#endif
         }
-        RedrawEdges();
     }
 
     void NodeGraphPanel::ConnectCollectionEvents()
     {
+        // 可重复调用（构造、OnApplyTemplate、集合替换），先断开避免重复订阅
+        DisconnectCollectionEvents();
+
         if (m_nodes)
         {
             m_nodesToken = m_nodes.VectorChanged(
                 [this](Windows::Foundation::Collections::IObservableVector<XamlUICommand::NodeViewModel> const&,
                     Windows::Foundation::Collections::IVectorChangedEventArgs const& args)
                 {
-                    switch (args.CollectionChange())
-                    {
-                    case Windows::Foundation::Collections::CollectionChange::ItemInserted:
-                    case Windows::Foundation::Collections::CollectionChange::ItemChanged:
-                    case Windows::Foundation::Collections::CollectionChange::ItemRemoved:
-                    case Windows::Foundation::Collections::CollectionChange::Reset:
-                        RedrawNodes();
-                        RedrawEdges();
-                        break;
-                    }
+                    // 元素与批量实例均由 TrackNode / UntrackNode 增量维护（元素只实现可见部分）
+                    OnNodesVectorChanged(args);
                 });
         }
 
@@ -414,9 +822,9 @@ namespace winrt::XamlUICommand::implementation
         {
             m_edgesToken = m_edges.VectorChanged(
                 [this](Windows::Foundation::Collections::IObservableVector<XamlUICommand::EdgeViewModel> const&,
-                    Windows::Foundation::Collections::IVectorChangedEventArgs const&)
+                    Windows::Foundation::Collections::IVectorChangedEventArgs const& args)
                 {
-                    RedrawEdges();
+                    OnEdgesVectorChanged(args);     // 逐条增删边线元素
                 });
         }
     }
@@ -425,6 +833,21 @@ namespace winrt::XamlUICommand::implementation
     {
         if (m_nodes && m_nodesToken.value) m_nodes.VectorChanged(m_nodesToken);
         if (m_edges && m_edgesToken.value) m_edges.VectorChanged(m_edgesToken);
+        m_nodesToken = {};
+        m_edgesToken = {};
+    }
+
+    NodeGraphPanel::InnerAppearance const& NodeGraphPanel::Appearance()
+    {
+        // 外观只取决于主题与几个外观属性：缓存一份，所有节点共享同一组画刷；
+        // 属性变化由 OnAppearanceChanged 作废，主题则随缓存一起记录，切换后下一次访问重新计算
+        auto const theme = ActualTheme();
+        if (!m_appearance || m_appearanceTheme != theme)
+        {
+            m_appearance = ComputeAppearance();
+            m_appearanceTheme = theme;
+        }
+        return *m_appearance;
     }
 
     NodeGraphPanel::InnerAppearance NodeGraphPanel::ComputeAppearance()
@@ -469,163 +892,535 @@ namespace winrt::XamlUICommand::implementation
         if (!m_canvas) return;
         m_canvas.Children().Clear();
         m_nodeElements.clear();
-        // Edges first so they render behind
-        RedrawEdges();
-        RedrawNodes();
+        m_edgeLines.clear();
+        m_realizedEdges.clear();
+        for (auto& pool : m_nodePool) pool.clear();
+        m_linePool.clear();
+        m_batchPaths = {};
+        m_overviewPaths = {};
+        m_overviewArea = nodegraph::Box::Empty();
+        m_overview.Clear();
+        m_overview.ConsumeChanges([](auto const&) {});
+        if (IsBatched())
+        {
+            RebuildDisplayList();
+            FlushBatches();
+            return;
+        }
+        // 只实现视口内的边与节点（边的 ZIndex 为 0，始终位于节点之下）
+        UpdateRealization(true);
     }
 
     void NodeGraphPanel::RedrawEdges()
     {
+        if (IsBatched())
+        {
+            m_graph.ForEachEdge([this](uint32_t slot, auto const&) { SyncEdgeInstance(slot); });
+            return;
+        }
         if (!m_canvas) return;
-        // Remove existing lines (tagged as L"Edge")
-        for (int32_t i = (int32_t)m_canvas.Children().Size() - 1; i >= 0; --i)
+        for (auto slot : m_realizedEdges)
         {
-            if (auto fe = m_canvas.Children().GetAt(i).try_as<FrameworkElement>())
-            {
-                if (fe.Tag() && unbox_value<hstring>(fe.Tag()) == L"Edge")
-                    m_canvas.Children().RemoveAt(i);
-            }
+            RemoveEdgeElement(slot);
         }
+        m_realizedEdges.clear();
+        RealizeVisibleEdges();
+    }
 
-        for (auto const& e : m_edges)
-        {
-            auto from = GetNode(e.FromId());
-            auto to = GetNode(e.ToId());
-            if (!from || !to) continue;
+    static nodegraph::Box SegmentBounds(Point const& a, Point const& b)
+    {
+        return nodegraph::Box{ std::min(a.X, b.X), std::min(a.Y, b.Y), std::max(a.X, b.X), std::max(a.Y, b.Y) };
+    }
 
-            // Draw straight line (center-to-center)
-            auto line = Shapes::Line{};
-            auto eb = EdgeBrush();
-            line.Stroke(eb ? eb : SolidColorBrush{ Windows::UI::Colors::Gray() });
-            line.StrokeThickness(EdgeThickness());         // 默认线条粗细为 2.5
-            line.X1(from.Position().X + from.Size().Width / 2.0);
-            line.Y1(from.Position().Y + from.Size().Height / 2.0);
-            line.X2(to.Position().X + to.Size().Width / 2.0);
-            line.Y2(to.Position().Y + to.Size().Height / 2.0);
-            line.Tag(box_value(L"Edge"));
-            Canvas::SetZIndex(line, 0);
-            m_canvas.Children().Append(line);
-        }
+    Brush NodeGraphPanel::EdgeStroke()
+    {
+        if (auto eb = EdgeBrush()) return eb;
+        if (!m_defaultEdgeBrush) m_defaultEdgeBrush = SolidColorBrush{ Windows::UI::Colors::Gray() };
+        return m_defaultEdgeBrush;
     }
 
-    hstring NodeGraphPanel::ResolveLabel(XamlUICommand::NodeViewModel const& node) const
+    Brush NodeGraphPanel::HighlightStroke()
     {
-        hstring label = node.Label();
-        auto key = node.LabelMetaKey();
-        if (key.empty()) key = m_defaultLabelKey;
-        if (!key.empty() && node.Meta() && node.Meta().HasKey(key))
+        if (auto hb = HighlightBrush()) return hb;
+        if (!m_defaultHighlightBrush) m_defaultHighlightBrush = SolidColorBrush{ Windows::UI::Colors::Orange() };
+        return m_defaultHighlightBrush;
+    }
+
+    bool NodeGraphPanel::TryGetEdgeEndpoints(uint32_t slot, Point& from, Point& to)
+    {
+        auto const& e = m_graph.Edge(slot);
+        auto a = GetNode(e.from);
+        auto b = GetNode(e.to);
+        if (!a || !b) return false;
+
+        // Straight line, center-to-center
+        auto pa = a.Position(); auto sa = a.Size();
+        auto pb = b.Position(); auto sb = b.Size();
+        from = Point{ pa.X + sa.Width / 2.0f, pa.Y + sa.Height / 2.0f };
+        to = Point{ pb.X + sb.Width / 2.0f, pb.Y + sb.Height / 2.0f };
+        return true;
+    }
+
+    void NodeGraphPanel::AttachEdgeElement(uint32_t slot)
+    {
+        if (IsBatched())
         {
-            auto v = node.Meta().Lookup(key);
-            try
-            {
-                label = unbox_value<hstring>(v);
-            }
-            catch (...) { /* Non-string values will be ToString() */
-                label = hstring{};
-            }
+            SyncEdgeInstance(slot);
+            return;
         }
-        return label;
+        if (IsOverview())
+        {
+            SyncOverviewEdge(slot);
+            return;
+        }
+        if (!m_canvas || !m_graph.IsEdgeAlive(slot)) return;
+        if (slot < m_edgeLines.size() && m_edgeLines[slot]) return;
+        Point from{}, to{};
+        if (!TryGetEdgeEndpoints(slot, from, to)) return;   // 端点尚未加入，待 TrackNode 时补齐
+        if (!m_realizedArea.Intersects(SegmentBounds(from, to))) return;   // 实现区域之外不创建
+
+        auto line = AcquireEdgeLine();
+        ApplyEdgeStyle(line, slot);
+        line.X1(from.X);
+        line.Y1(from.Y);
+        line.X2(to.X);
+        line.Y2(to.Y);
+
+        if (slot >= m_edgeLines.size()) m_edgeLines.resize(slot + 1, Shapes::Line{ nullptr });
+        m_edgeLines[slot] = line;
+        m_realizedEdges.push_back(slot);
     }
 
-    hstring NodeGraphPanel::ResolveTooltip(XamlUICommand::NodeViewModel const& node) const
+    void NodeGraphPanel::UpdateEdgeElement(uint32_t slot)
     {
-        auto key = node.TooltipMetaKey();
-        if (key.empty()) key = m_defaultTipKey;
-        if (!key.empty() && node.Meta() && node.Meta().HasKey(key))
+        if (IsBatched())
+        {
+            SyncEdgeInstance(slot);
+            return;
+        }
+        if (IsOverview())
         {
-            auto v = node.Meta().Lookup(key);
-            return v ? unbox_value<hstring>(v) : hstring{};
+            SyncOverviewEdge(slot);
+            return;
         }
-        return node.Label();
+        if (!m_canvas) return;
+
+        Point from{}, to{};
+        if (!m_graph.IsEdgeAlive(slot) || !TryGetEdgeEndpoints(slot, from, to) ||
+            !m_realizedArea.Intersects(SegmentBounds(from, to)))
+        {
+            RemoveEdgeElement(slot);
+            return;
+        }
+
+        auto line = slot < m_edgeLines.size() ? m_edgeLines[slot] : Shapes::Line{ nullptr };
+        if (!line)
+        {
+            AttachEdgeElement(slot);
+            return;
+        }
+        line.X1(from.X);
+        line.Y1(from.Y);
+        line.X2(to.X);
+        line.Y2(to.Y);
+        ++m_edgeStats.updated;
     }
 
-    void NodeGraphPanel::AttachNodeElement(XamlUICommand::NodeViewModel const& node)
+    void NodeGraphPanel::RemoveEdgeElement(uint32_t slot)
     {
-        auto grid = Controls::Grid{};
-        grid.Tag(box_value(L"Node"));
-        grid.Width(node.Size().Width);
-        grid.Height(node.Size().Height);
+        if (IsBatched())
+        {
+            m_displayList.RemoveEdge(slot);
+            ScheduleBatchFlush();
+            return;
+        }
+        if (IsOverview())
+        {
+            // 边仍在图中，不能走 SyncOverviewEdge；聚类层次下边束整体重算
+            if (m_detailLevel == nodegraph::DetailLevel::Points) m_overview.RemoveEdge(slot);
+            else m_overviewDirty = true;
+            ScheduleBatchFlush();
+        }
+        if (slot >= m_edgeLines.size() || !m_edgeLines[slot]) return;
+        RecycleEdgeLine(m_edgeLines[slot]);
+        m_edgeLines[slot] = nullptr;
+        ++m_edgeStats.removed;
+    }
 
-        auto ap = ComputeAppearance();
+    void NodeGraphPanel::UpdateIncidentEdges(int64_t nodeId)
+    {
+        for (auto slot : m_graph.IncidentEdges(nodeId))
+        {
+            UpdateEdgeBounds(slot);
+            UpdateEdgeElement(slot);
+        }
+    }
 
-        Shapes::Shape shape{ nullptr };
-        if (node.Shape() == XamlUICommand::NodeShape::Circle)
+    void NodeGraphPanel::RestyleEdges()
+    {
+        if (IsBatched())
         {
-            auto ellipse = Shapes::Ellipse{};
-            ellipse.Fill(ap.fill);
-            ellipse.Stroke(ap.stroke);
-            ellipse.StrokeThickness(node.IsSelected() ? 3.0 : 1.0);
-            shape = ellipse;
+            // 样式即批次键，换样式等同于全部换批
+            RebuildDisplayList();
+            return;
         }
-        else if(node.Shape() == XamlUICommand::NodeShape::RoundedRect)
+        for (uint32_t slot = 0; slot < m_edgeLines.size(); ++slot)
         {
-            auto rect = Shapes::Rectangle{};
-            rect.RadiusX(ap.cornerRadius);
-            rect.RadiusY(ap.cornerRadius);
-            rect.Fill(ap.fill);
-            rect.Stroke(ap.stroke);
-            rect.StrokeThickness(node.IsSelected() ? 3.0 : 1.0);
-            shape = rect;
+            if (!m_edgeLines[slot]) continue;
+            ApplyEdgeStyle(m_edgeLines[slot], slot);
+            ++m_edgeStats.updated;
         }
-        else {
-            // TODO... for other shapes
+    }
+
+    void NodeGraphPanel::RestyleEdge(uint32_t slot)
+    {
+        if (IsBatched())
+        {
+            SyncEdgeInstance(slot);
             return;
         }
-        grid.Children().Append(shape);
+        if (slot < m_edgeLines.size() && m_edgeLines[slot]) ApplyEdgeStyle(m_edgeLines[slot], slot);
+    }
 
-        auto text = Controls::TextBlock{};
-        text.Text(ResolveLabel(node));
-        text.HorizontalAlignment(HorizontalAlignment::Center);
-        text.VerticalAlignment(VerticalAlignment::Center);
-        text.TextTrimming(TextTrimming::CharacterEllipsis);
-        text.Margin(Thickness{ 6 });
-        text.Foreground(ap.text);                  // 使用对比度适应算法调整后的前景
-        grid.Children().Append(text);
+    void NodeGraphPanel::ApplyEdgeStyle(Shapes::Line const& line, uint32_t slot)
+    {
+        // 高亮的边换用高亮色并加粗一倍
+        bool const highlighted = m_graph.IsEdgeAlive(slot) && m_graph.Edge(slot).payload.vm.IsHighlighted();
+        line.Stroke(highlighted ? HighlightStroke() : EdgeStroke());
+        line.StrokeThickness(highlighted ? EdgeThickness() * 2.0 : EdgeThickness());   // 默认线条粗细为 2.5
+    }
 
-        // Tooltip (on hover)
-        Controls::ToolTipService::SetToolTip(grid, box_value(ResolveTooltip(node)));
+#pragma region NodeGraphPanel_Batched
+    // 批量模式按纯色分批；非纯色画刷退化为默认色
+    static nodegraph::Rgba ToRgba(Windows::UI::Color c)
+    {
+        return nodegraph::Rgba{ c.R, c.G, c.B, c.A };
+    }
+    static Brush ToBrush(nodegraph::Rgba c)
+    {
+        return SolidColorBrush{ Windows::UI::Color{ c.a, c.r, c.g, c.b } };
+    }
+
+    // 节点轮廓：椭圆为两段半弧，圆角矩形为四边 + 四角弧；figure 已有分段时原位改写坐标
+    static void LayoutNodeFigure(PathFigure const& figure, nodegraph::NodeStyle const& style, nodegraph::Box const& b)
+    {
+        struct Step { bool arc; Point to; };
+        std::array<Step, 8> steps{};
+        size_t count = 0;
+        Point start{};
+        Size radius{};
+
+        float const cx = (b.minX + b.maxX) * 0.5f;
+        float const cy = (b.minY + b.maxY) * 0.5f;
+        float const rx = (b.maxX - b.minX) * 0.5f;
+        float const ry = (b.maxY - b.minY) * 0.5f;
+        if (style.shape == nodegraph::Primitive::Ellipse)
+        {
+            start = Point{ b.maxX, cy };
+            steps[count++] = { true, Point{ b.minX, cy } };
+            steps[count++] = { true, Point{ b.maxX, cy } };
+            radius = Size{ rx, ry };
+        }
+        else
+        {
+            float const r = std::min({ style.cornerRadius, rx, ry });
+            start = Point{ b.minX + r, b.minY };
+            steps[count++] = { false, Point{ b.maxX - r, b.minY } };
+            steps[count++] = { true,  Point{ b.maxX, b.minY + r } };
+            steps[count++] = { false, Point{ b.maxX, b.maxY - r } };
+            steps[count++] = { true,  Point{ b.maxX - r, b.maxY } };
+            steps[count++] = { false, Point{ b.minX + r, b.maxY } };
+            steps[count++] = { true,  Point{ b.minX, b.maxY - r } };
+            steps[count++] = { false, Point{ b.minX, b.minY + r } };
+            steps[count++] = { true,  Point{ b.minX + r, b.minY } };
+            radius = Size{ r, r };
+        }
 
-        // Input: click to select + flyout
-        grid.Tapped([this, node, grid](IInspectable const&, TappedRoutedEventArgs const&)
+        figure.StartPoint(start);
+        auto segments = figure.Segments();
+        bool const create = segments.Size() == 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (steps[i].arc)
+            {
+                auto arc = create ? ArcSegment{} : segments.GetAt(static_cast<uint32_t>(i)).as<ArcSegment>();
+                arc.Point(steps[i].to);
+                arc.Size(radius);
+                if (create)
+                {
+                    arc.SweepDirection(SweepDirection::Clockwise);
+                    segments.Append(arc);
+                }
+            }
+            else
             {
-                SelectedNode(node);
+                auto line = create ? LineSegment{} : segments.GetAt(static_cast<uint32_t>(i)).as<LineSegment>();
+                line.Point(steps[i].to);
+                if (create) segments.Append(line);
+            }
+        }
+    }
 
-                XamlUICommand::NodeInvokedEventArgs args{};
-                args.Node(node);
-                m_NodeInvoked(*this, args); // 触发事件（注意：用私有字段 m_NodeInvoked）
+    static void LayoutEdgeFigure(PathFigure const& figure, nodegraph::Segment const& s)
+    {
+        figure.StartPoint(Point{ s.x1, s.y1 });
+        auto segments = figure.Segments();
+        if (segments.Size() == 0)
+        {
+            LineSegment line{};
+            line.Point(Point{ s.x2, s.y2 });
+            segments.Append(line);
+        }
+        else
+        {
+            segments.GetAt(0).as<LineSegment>().Point(Point{ s.x2, s.y2 });
+        }
+    }
+
+    void NodeGraphPanel::RefreshBatchAppearance()
+    {
+        auto const& ap = Appearance();
+        Windows::UI::Color c{};
+        m_batchAppearance.fill = TryGetSolid(ap.fill, c) ? ToRgba(c) : nodegraph::Rgba{ 255, 255, 255, 255 };
+        m_batchAppearance.stroke = TryGetSolid(ap.stroke, c) ? ToRgba(c) : nodegraph::Rgba{ 70, 130, 180, 255 };
+        m_batchAppearance.cornerRadius = static_cast<float>(ap.cornerRadius);
+        m_batchAppearance.edge = nodegraph::EdgeStyle{
+            TryGetSolid(EdgeStroke(), c) ? ToRgba(c) : nodegraph::Rgba{ 128, 128, 128, 255 },
+            static_cast<float>(EdgeThickness()) };
+        m_batchAppearance.highlight = TryGetSolid(HighlightStroke(), c) ? ToRgba(c) : nodegraph::Rgba{ 255, 165, 0, 255 };
+    }
 
-                auto fly = CreateDetailsFlyout(node);
-                fly.ShowAt(grid);
+    void NodeGraphPanel::RebuildDisplayList()
+    {
+        m_displayList.Clear();
+        RefreshBatchAppearance();
+        m_graph.ForEachNode([this](uint32_t slot, auto const& n)
+            {
+                EnsureNodeDefaults(n.payload.vm);
+                SyncNodeInstance(slot);
             });
+        m_graph.ForEachEdge([this](uint32_t slot, auto const&) { SyncEdgeInstance(slot); });
+        ScheduleBatchFlush();
+    }
 
-        // Position on canvas
-        Canvas::SetLeft(grid, node.Position().X);
-        Canvas::SetTop(grid, node.Position().Y);
-        Canvas::SetZIndex(grid, 1);
-        m_canvas.Children().Append(grid);
+    void NodeGraphPanel::SyncNodeInstance(uint32_t slot)
+    {
+        if (!IsBatched() || slot == nodegraph::InvalidSlot) return;
+        ScheduleBatchFlush();
+        if (!m_graph.IsNodeAlive(slot))
+        {
+            m_displayList.RemoveNode(slot);
+            return;
+        }
 
-        // m_nodeElements[node.Id()] = grid; 
-        // std::unordered_map::operator[] 的坑：operator[] 在 键不存在 时会使用默认构造。
-        // 映射值类型是 Microsoft::UI::Xaml::FrameworkElement，在当前编译单元里它不是可默认构造的，
-        // 于是会触发模板实例化错误。采用带值插入将避免此问题。
-        m_nodeElements.insert_or_assign(node.Id(), grid.as<Microsoft::UI::Xaml::FrameworkElement>());  
+        auto const& node = m_graph.Node(slot).payload.vm;
+        nodegraph::NodeStyle style{};   // 默认即 Ellipse（Circle）
+        switch (node.Shape())
+        {
+        case XamlUICommand::NodeShape::Circle:
+            style.shape = nodegraph::Primitive::Ellipse;
+            break;
+        case XamlUICommand::NodeShape::RoundedRect:
+            style.shape = nodegraph::Primitive::RoundedRect;
+            style.cornerRadius = m_batchAppearance.cornerRadius;
+            break;
+        }
+        style.fill = m_batchAppearance.fill;
+        style.stroke = node.IsHighlighted() ? m_batchAppearance.highlight : m_batchAppearance.stroke;
+        style.strokeWidth = (node.IsSelected() || node == m_selected || node.IsHighlighted()) ? 3.0f : 1.0f;
+        m_displayList.SetNode(slot, m_displayList.NodeBatchFor(style), NodeBounds(node));
+    }
+
+    void NodeGraphPanel::SyncEdgeInstance(uint32_t slot)
+    {
+        if (!IsBatched()) return;
+        ScheduleBatchFlush();
+        Point from{}, to{};
+        if (!m_graph.IsEdgeAlive(slot) || !TryGetEdgeEndpoints(slot, from, to))
+        {
+            m_displayList.RemoveEdge(slot);
+            return;
+        }
+        auto style = m_batchAppearance.edge;
+        if (m_graph.Edge(slot).payload.vm.IsHighlighted())
+        {
+            style.color = m_batchAppearance.highlight;
+            style.thickness *= 2.0f;
+        }
+        m_displayList.SetEdge(slot, m_displayList.EdgeBatchFor(style),
+            nodegraph::Segment{ from.X, from.Y, to.X, to.Y });
+    }
 
-        // Listen for VM changes to live-update visuals
-        auto weak = get_weak();
-        node.PropertyChanged([weak, id = node.Id()](IInspectable const& sender, Microsoft::UI::Xaml::Data::PropertyChangedEventArgs const& e)
+    void NodeGraphPanel::ScheduleBatchFlush()
+    {
+        // 同一轮消息内的修改合并到一次回放
+        if (m_batchFlushPending || !m_canvas) return;
+        m_batchFlushPending = true;
+        DispatcherQueue().TryEnqueue([weak = get_weak()]()
             {
                 if (auto self = weak.get())
                 {
-                    auto vm = sender.as<XamlUICommand::NodeViewModel>();
-                    self->UpdateNodeElement(vm);
-                    if (e.PropertyName() == L"Position" || e.PropertyName() == L"Size")
+                    self->m_batchFlushPending = false;
+                    self->FlushBatches();
+                }
+            });
+    }
+
+    void NodeGraphPanel::FlushBatches()
+    {
+        if (!m_canvas) return;      // 模板应用后由 RebuildAll 整体重建
+        if (m_overviewDirty) RebuildOverview();
+        FlushDisplayList(m_displayList, m_batchPaths);
+        FlushDisplayList(m_overview, m_overviewPaths);
+    }
+
+    // 回放显示列表的变更日志，使 paths 中每批一个 Path 与列表保持一致
+    void NodeGraphPanel::FlushDisplayList(nodegraph::DisplayList& list, BatchPaths& paths)
+    {
+        using Change = nodegraph::DisplayList::Change;
+        using Kind = nodegraph::DisplayList::ChangeKind;
+
+        list.ConsumeChanges([this, &list, &paths](Change const& c)
+            {
+                bool const nodes = c.layer == nodegraph::DisplayList::Layer::Nodes;
+                auto& target = nodes ? paths.nodes : paths.edges;
+                switch (c.kind)
+                {
+                case Kind::Reset:
+                    for (auto* group : { &paths.nodes, &paths.edges })
                     {
-                        self->RedrawEdges();
+                        for (auto const& path : *group)
+                        {
+                            uint32_t index = 0;
+                            if (m_canvas.Children().IndexOf(path, index)) m_canvas.Children().RemoveAt(index);
+                        }
+                        group->clear();
                     }
+                    break;
+                case Kind::AddBatch:
+                {
+                    Shapes::Path path{};
+                    PathGeometry geometry{};
+                    geometry.FillRule(FillRule::Nonzero);
+                    path.Data(geometry);
+                    if (nodes)
+                    {
+                        auto const& style = list.NodeBatches()[c.batch].style;
+                        path.Fill(ToBrush(style.fill));
+                        path.Stroke(ToBrush(style.stroke));
+                        path.StrokeThickness(style.strokeWidth);
+                        path.Tag(box_value(L"NodeBatch"));
+                        Canvas::SetZIndex(path, 1);
+                    }
+                    else
+                    {
+                        auto const& style = list.EdgeBatches()[c.batch].style;
+                        path.Stroke(ToBrush(style.color));
+                        path.StrokeThickness(style.thickness);
+                        path.Tag(box_value(L"EdgeBatch"));
+                        Canvas::SetZIndex(path, 0);
+                    }
+                    m_canvas.Children().Append(path);
+                    target.push_back(path);
+                    break;
+                }
+                case Kind::Append:
+                {
+                    PathFigure figure{};
+                    figure.IsClosed(nodes);
+                    figure.IsFilled(nodes);
+                    if (nodes) LayoutNodeFigure(figure, list.NodeBatches()[c.batch].style, c.bounds);
+                    else LayoutEdgeFigure(figure, c.segment);
+                    target[c.batch].Data().as<PathGeometry>().Figures().Append(figure);
+                    break;
+                }
+                case Kind::Update:
+                {
+                    auto figure = target[c.batch].Data().as<PathGeometry>().Figures().GetAt(c.index);
+                    if (nodes) LayoutNodeFigure(figure, list.NodeBatches()[c.batch].style, c.bounds);
+                    else LayoutEdgeFigure(figure, c.segment);
+                    break;
+                }
+                case Kind::RemoveSwap:
+                {
+                    auto figures = target[c.batch].Data().as<PathGeometry>().Figures();
+                    auto last = figures.GetAt(figures.Size() - 1);
+                    figures.RemoveAtEnd();
+                    if (c.index < figures.Size()) figures.SetAt(c.index, last);
+                    break;
+                }
                 }
             });
     }
 
+    void NodeGraphPanel::OnCanvasTapped(TappedRoutedEventArgs const& args)
+    {
+        if (!IsBatched() || !m_canvas) return;
+        auto point = args.GetPosition(m_canvas);
+        auto node = HitTest(point);
+        if (!node) return;
+        args.Handled(true);
+
+        SelectedNode(node);
+
+        XamlUICommand::NodeInvokedEventArgs invoked{};
+        invoked.Node(node);
+        m_NodeInvoked(*this, invoked);
+
+        auto fly = CreateDetailsFlyout(node);
+        Controls::Primitives::FlyoutShowOptions options{};
+        options.Position(point);
+        fly.ShowAt(m_canvas, options);
+    }
+#pragma endregion
+
+    hstring NodeGraphPanel::ResolveLabel(XamlUICommand::NodeViewModel const& node) const
+    {
+        hstring label = node.Label();
+        auto key = node.LabelMetaKey();
+        if (key.empty()) key = m_defaultLabelKey;
+        if (!key.empty())
+        {
+            // 列式元数据：一次列查找 + 按行取值，不经过 IMap 与拆箱；非字符串值转为文本
+            if (auto text = get_self<XamlUICommand::implementation::NodeViewModel>(node)->MetaText(key))
+                label = *text;
+        }
+        return label;
+    }
+
+    hstring NodeGraphPanel::ResolveTooltip(XamlUICommand::NodeViewModel const& node) const
+    {
+        auto key = node.TooltipMetaKey();
+        if (key.empty()) key = m_defaultTipKey;
+        if (!key.empty())
+        {
+            if (auto text = get_self<XamlUICommand::implementation::NodeViewModel>(node)->MetaText(key))
+                return *text;
+        }
+        return node.Label();
+    }
+
+    void NodeGraphPanel::AttachNodeElement(XamlUICommand::NodeViewModel const& node, InnerAppearance const& ap)
+    {
+        if (node.Shape() != XamlUICommand::NodeShape::Circle && node.Shape() != XamlUICommand::NodeShape::RoundedRect)
+        {
+            // TODO... for other shapes
+            return;
+        }
+
+        // 容器（Grid + 形状 + 文本 + 输入处理）优先从回收池取出，只重新绑定数据
+        auto grid = AcquireNodeContainer(node.Shape());
+        BindNodeElement(grid, node, ap);
+
+        // m_nodeElements[node.Id()] = grid; 
+        // std::unordered_map::operator[] 的坑：operator[] 在 键不存在 时会使用默认构造。
+        // 映射值类型是 Microsoft::UI::Xaml::FrameworkElement，在当前编译单元里它不是可默认构造的，
+        // 于是会触发模板实例化错误。采用带值插入将避免此问题。
+        m_nodeElements.insert_or_assign(node.Id(), grid.as<Microsoft::UI::Xaml::FrameworkElement>());  
+
+        // VM 变更的监听由 TrackNode 统一注册（见 OnNodePropertyChanged），这里不再逐元素订阅
+    }
+
     void NodeGraphPanel::UpdateNodeElement(XamlUICommand::NodeViewModel const& node)
     {
         auto it = m_nodeElements.find(node.Id());
@@ -634,97 +1429,959 @@ namespace winrt::XamlUICommand::implementation
         auto grid = it->second.as<Controls::Grid>();
         if (!grid) return;
 
-        // 尺寸、位置
-        grid.Width(node.Size().Width);
-        grid.Height(node.Size().Height);
-        Canvas::SetLeft(grid, node.Position().X);
-        Canvas::SetTop(grid, node.Position().Y);
-
-        // 形状、文本
+        // 如果形状类型变了，则换用对应形状的容器
         auto shape = grid.Children().GetAt(0).as<Shapes::Shape>();
-        auto text = grid.Children().GetAt(1).as<Controls::TextBlock>();
-
-        // 选中态
-        shape.StrokeThickness(node.IsSelected() ? 3.0 : 1.0);
-
-        // 如果形状类型变了，则重建元素
         if ((node.Shape() == NodeShape::Circle && !shape.try_as<Shapes::Ellipse>()) ||
             (node.Shape() == NodeShape::RoundedRect && !shape.try_as<Shapes::Rectangle>()))
         {
-            uint32_t index = 0;
-            m_canvas.Children().IndexOf(grid, index);
-            m_canvas.Children().RemoveAt(index);
-            m_nodeElements.erase(it);
-            AttachNodeElement(node);
+            RemoveNodeElement(node.Id());
+            AttachNodeElement(node, Appearance());
             return;
         }
 
-        // 增量更新外观
-        auto ap = ComputeAppearance();
+        // 增量更新尺寸、位置、外观与文本
+        BindNodeElement(grid, node, Appearance());
+    }
+
+    void NodeGraphPanel::RemoveNodeElement(int64_t id)
+    {
+        auto it = m_nodeElements.find(id);
+        if (it == m_nodeElements.end()) return;
+        RecycleNodeContainer(it->second.as<Controls::Grid>());
+        m_nodeElements.erase(it);
+    }
+
+    void NodeGraphPanel::RedrawNodes()
+    {
+        if (IsBatched())
+        {
+            RebuildDisplayList();
+            return;
+        }
+        if (!m_canvas) return;
+        // Recycle all realized node visuals, then realize the visible ones again
+        std::vector<int64_t> ids;
+        ids.reserve(m_nodeElements.size());
+        for (auto const& kv : m_nodeElements) ids.push_back(kv.first);
+        for (auto id : ids) RemoveNodeElement(id);
+        RealizeVisibleNodes();
+    }
+
+    void NodeGraphPanel::EnsureNodeDefaults(XamlUICommand::NodeViewModel const& node)
+    {
+        // Default size if unset
+        auto size = node.Size();
+        if (size.Width == 0 || size.Height == 0)
+        {
+            node.Size(Size{ 64, 64 });
+        }
+        // Default shape if unset
+        if (node.Shape() != XamlUICommand::NodeShape::Circle && node.Shape() != XamlUICommand::NodeShape::RoundedRect)
+        {
+            node.Shape(m_defaultShape);
+        }
+    }
+
+#pragma region NodeGraphPanel_Virtualization
+    void NodeGraphPanel::OnEffectiveViewportChanged(Rect const& viewport)
+    {
+        // 面板完全移出可视范围时有效视口为空，保留现有元素
+        if (viewport.Width <= 0 || viewport.Height <= 0) return;
+        m_viewport = viewport;
+        m_hasViewport = true;
+
+        // 画布到窗口根的缩放（包含外层 ScrollView 的 ZoomFactor）
+        auto const scaled = m_canvas.TransformToVisual(nullptr).TransformBounds(Rect{ 0, 0, 1000, 1000 });
+        float const zoom = scaled.Width > 0 ? scaled.Width / 1000.0f : 1.0f;
+        bool const zoomChanged = std::abs(zoom - m_zoom) > m_zoom * 1e-3f;
+        m_zoom = zoom;
+        bool const levelChanged = UpdateDetailLevel();
+        // 概览的点半径、线宽与聚类层级都随缩放变化
+        UpdateRealization(levelChanged || (zoomChanged && IsOverview()));
+    }
+
+    void NodeGraphPanel::UpdateRealization(bool force)
+    {
+        if (IsBatched() || !m_canvas) return;
+
+        bool const overview = IsOverview();
+        auto const& last = overview ? m_overviewArea : m_realizedArea;
+        auto area = nodegraph::Box::Unbounded();
+        if (!m_virtualizing)
+        {
+            if (!force && last == area) return;
+        }
+        else if (!m_hasViewport)
+        {
+            area = nodegraph::Box::Empty();     // 尚未布局，暂不实现
+        }
+        else
+        {
+            auto const margin = static_cast<float>(m_realizationMargin);
+            auto const view = nodegraph::Box::FromRect(m_viewport.X, m_viewport.Y, m_viewport.Width, m_viewport.Height);
+            // 视口仍位于上次实现区域内（至少留有半个边距）时不必重新查询，平移的大多数帧都走这里
+            if (!force && last.Inflate(-margin * 0.5f).Encloses(view)) return;
+            area = view.Inflate(margin);
+        }
+
+        if (overview)
+        {
+            // 概览层次不保留逐节点元素，区域内的几何在下一次刷新时整体生成
+            m_overviewArea = area;
+            m_realizedArea = nodegraph::Box::Empty();
+            m_overviewDirty = true;
+            ScheduleBatchFlush();
+        }
+        else
+        {
+            m_realizedArea = area;
+            if (!(m_overviewArea == nodegraph::Box::Empty()))
+            {
+                m_overviewArea = nodegraph::Box::Empty();
+                m_overviewDirty = true;
+                ScheduleBatchFlush();
+            }
+        }
+        RealizeVisibleEdges();
+        RealizeVisibleNodes();
+    }
+
+    void NodeGraphPanel::RealizeVisibleNodes()
+    {
+        if (IsBatched() || !m_canvas) return;
+        ++m_realizePass;
+        m_nodeStamp.resize(m_graph.NodeSlotCount(), 0);
+
+        std::vector<XamlUICommand::NodeViewModel> entering;
+        m_spatial.Query(m_realizedArea, [&](uint32_t slot, nodegraph::Box const&)
+            {
+                m_nodeStamp[slot] = m_realizePass;
+                auto const& node = m_graph.Node(slot);
+                if (m_graph.FindNode(node.id) == slot && !m_nodeElements.contains(node.id))
+                    entering.push_back(node.payload.vm);
+            });
+
+        // 先回收离开区域的容器，新进入的节点可直接复用
+        std::vector<int64_t> leaving;
+        for (auto const& kv : m_nodeElements)
+        {
+            auto slot = m_graph.FindNode(kv.first);
+            if (slot == nodegraph::InvalidSlot || m_nodeStamp[slot] != m_realizePass)
+                leaving.push_back(kv.first);
+        }
+        for (auto id : leaving) RemoveNodeElement(id);
+
+        if (!entering.empty())
+        {
+            auto const& ap = Appearance();
+            for (auto const& node : entering) AttachNodeElement(node, ap);
+        }
+    }
+
+    void NodeGraphPanel::RealizeVisibleEdges()
+    {
+        if (IsBatched() || !m_canvas) return;
+        ++m_realizePass;
+        m_edgeStamp.resize(m_graph.EdgeSlotCount(), 0);
+
+        std::vector<uint32_t> entering;
+        std::vector<uint32_t> kept;
+        m_edgeSpatial.Query(m_realizedArea, [&](uint32_t slot, nodegraph::Box const&)
+            {
+                m_edgeStamp[slot] = m_realizePass;
+                if (slot < m_edgeLines.size() && m_edgeLines[slot]) kept.push_back(slot);
+                else entering.push_back(slot);
+            });
+
+        for (auto slot : m_realizedEdges)
+        {
+            if (slot >= m_edgeStamp.size() || m_edgeStamp[slot] != m_realizePass)
+                RemoveEdgeElement(slot);
+        }
+        m_realizedEdges = std::move(kept);
+        for (auto slot : entering) AttachEdgeElement(slot);
+    }
+
+    void NodeGraphPanel::RealizeNode(uint32_t slot)
+    {
+        if (IsBatched() || !m_canvas || !m_graph.IsNodeAlive(slot)) return;
+        if (IsOverview())
+        {
+            SyncOverviewNode(slot);
+            return;
+        }
+        auto const& entry = m_graph.Node(slot);
+        if (m_graph.FindNode(entry.id) != slot) return;     // 重复 Id 只实现最早的节点
+
+        bool const visible = m_realizedArea.Intersects(NodeBounds(entry.payload.vm));
+        bool const realized = m_nodeElements.contains(entry.id);
+        if (visible && !realized) AttachNodeElement(entry.payload.vm, Appearance());
+        else if (!visible && realized) RemoveNodeElement(entry.id);
+    }
+
+    void NodeGraphPanel::UpdateEdgeBounds(uint32_t slot)
+    {
+        Point from{}, to{};
+        if (m_graph.IsEdgeAlive(slot) && TryGetEdgeEndpoints(slot, from, to))
+        {
+            auto const& e = m_graph.Edge(slot);
+            auto const a = m_graph.FindNode(e.from), b = m_graph.FindNode(e.to);
+            m_edgeSpatial.Update(slot, SegmentBounds(from, to));
+            m_lod.SetEdge(slot, a, b);
+            if (m_layout) m_layout->SetEdge(slot, a, b);
+            m_query.SetEdge(slot, a, b, e.payload.vm.Weight(), e.payload.vm.IsDirected());
+        }
+        else
+        {
+            m_edgeSpatial.Remove(slot);
+            m_lod.RemoveEdge(slot);
+            if (m_layout) m_layout->RemoveEdge(slot);
+            m_query.RemoveEdge(slot);
+        }
+    }
+
+    Controls::Grid NodeGraphPanel::AcquireNodeContainer(XamlUICommand::NodeShape shape)
+    {
+        auto& pool = m_nodePool[shape == XamlUICommand::NodeShape::RoundedRect ? 1 : 0];
+        if (!pool.empty())
+        {
+            auto grid = pool.back();
+            pool.pop_back();
+            grid.Visibility(Visibility::Visible);
+            return grid;
+        }
+
+        auto grid = Controls::Grid{};
+        grid.Tag(box_value(L"Node"));
+
+        Shapes::Shape outline{ nullptr };
+        if (shape == XamlUICommand::NodeShape::RoundedRect) outline = Shapes::Rectangle{};
+        else outline = Shapes::Ellipse{};
+        grid.Children().Append(outline);
+
+        auto text = Controls::TextBlock{};
+        text.HorizontalAlignment(HorizontalAlignment::Center);
+        text.VerticalAlignment(VerticalAlignment::Center);
+        text.TextTrimming(TextTrimming::CharacterEllipsis);
+        text.Margin(Thickness{ 6 });
+        grid.Children().Append(text);
+
+        // Input: click to select + flyout；容器会被复用，当前节点取自 DataContext
+        grid.Tapped([weak = get_weak()](IInspectable const& sender, TappedRoutedEventArgs const&)
+            {
+                auto self = weak.get();
+                if (!self) return;
+                auto fe = sender.as<FrameworkElement>();
+                auto node = fe.DataContext().try_as<XamlUICommand::NodeViewModel>();
+                if (!node) return;
+
+                self->SelectedNode(node);
 
+                XamlUICommand::NodeInvokedEventArgs args{};
+                args.Node(node);
+                self->m_NodeInvoked(*self, args); // 触发事件（注意：用私有字段 m_NodeInvoked）
+
+                auto fly = self->CreateDetailsFlyout(node);
+                fly.ShowAt(fe);
+            });
+
+        Canvas::SetZIndex(grid, 1);
+        m_canvas.Children().Append(grid);
+        return grid;
+    }
+
+    void NodeGraphPanel::BindNodeElement(Controls::Grid const& grid, XamlUICommand::NodeViewModel const& node, InnerAppearance const& ap)
+    {
+        grid.DataContext(node);
+
+        // 尺寸、位置
+        grid.Width(node.Size().Width);
+        grid.Height(node.Size().Height);
+        Canvas::SetLeft(grid, node.Position().X);
+        Canvas::SetTop(grid, node.Position().Y);
+
+        // 形状外观与选中态
+        auto shape = grid.Children().GetAt(0).as<Shapes::Shape>();
         if (auto rect = shape.try_as<Shapes::Rectangle>())
         {
             rect.RadiusX(ap.cornerRadius);
             rect.RadiusY(ap.cornerRadius);
         }
         shape.Fill(ap.fill);
-        shape.Stroke(ap.stroke);
-        text.Foreground(ap.text);
+        bool const highlighted = node.IsHighlighted();
+        shape.Stroke(highlighted ? HighlightStroke() : ap.stroke);
+        bool const detailed = m_detailLevel == nodegraph::DetailLevel::Full;
+        shape.StrokeThickness((node.IsSelected() || node == m_selected || highlighted) ? 3.0 : (detailed ? 1.0 : 0.0));
 
-        // 文本/Tooltip
+        // 文本/Tooltip（Reduced 层次下文字已不可读，省去排版与提示）
+        auto text = grid.Children().GetAt(1).as<Controls::TextBlock>();
+        text.Visibility(detailed ? Visibility::Visible : Visibility::Collapsed);
+        if (!detailed)
+        {
+            Controls::ToolTipService::SetToolTip(grid, nullptr);
+            return;
+        }
         text.Text(ResolveLabel(node));
+        text.Foreground(ap.text);                  // 使用对比度适应算法调整后的前景
         Controls::ToolTipService::SetToolTip(grid, box_value(ResolveTooltip(node)));
     }
 
-    void NodeGraphPanel::RemoveNodeElement(int64_t id)
+    void NodeGraphPanel::RecycleNodeContainer(Controls::Grid const& grid)
     {
-        auto it = m_nodeElements.find(id);
-        if (it == m_nodeElements.end()) return;
-        auto fe = it->second;
-        // Remove child from canvas
-        for (uint32_t i = 0; i < m_canvas.Children().Size(); ++i)
+        grid.DataContext(nullptr);
+        auto& pool = m_nodePool[grid.Children().GetAt(0).try_as<Shapes::Rectangle>() ? 1 : 0];
+        if (pool.size() < MaxPooledElements)
         {
-            if (m_canvas.Children().GetAt(i) == fe)
+            grid.Visibility(Visibility::Collapsed);
+            pool.push_back(grid);
+            return;
+        }
+        uint32_t index = 0;
+        if (m_canvas && m_canvas.Children().IndexOf(grid, index))
+            m_canvas.Children().RemoveAt(index);
+    }
+
+    Shapes::Line NodeGraphPanel::AcquireEdgeLine()
+    {
+        Shapes::Line line{ nullptr };
+        if (!m_linePool.empty())
+        {
+            line = m_linePool.back();
+            m_linePool.pop_back();
+            line.Visibility(Visibility::Visible);
+            ++m_edgeStats.reused;
+        }
+        else
+        {
+            line = Shapes::Line{};
+            line.Tag(box_value(L"Edge"));
+            Canvas::SetZIndex(line, 0);
+            m_canvas.Children().Append(line);
+            ++m_edgeStats.created;
+        }
+        // 池中的线条可能错过了 RestyleEdges，由调用方按边的状态统一设置（ApplyEdgeStyle）
+        return line;
+    }
+
+    void NodeGraphPanel::RecycleEdgeLine(Shapes::Line const& line)
+    {
+        if (m_linePool.size() < MaxPooledElements)
+        {
+            line.Visibility(Visibility::Collapsed);
+            m_linePool.push_back(line);
+            return;
+        }
+        uint32_t index = 0;
+        if (m_canvas && m_canvas.Children().IndexOf(line, index))
+            m_canvas.Children().RemoveAt(index);
+    }
+#pragma endregion
+
+#pragma region NodeGraphPanel_LevelOfDetail
+    // 由缩放与平均节点尺寸选择层次；返回是否发生变化
+    bool NodeGraphPanel::UpdateDetailLevel()
+    {
+        auto level = nodegraph::DetailLevel::Full;
+        if (m_lodEnabled && !IsBatched() && m_lod.NodeCount() > 0)
+            level = nodegraph::SelectDetailLevel(m_lod.MeanExtent(), m_zoom, m_lodThresholds);
+        if (level == m_detailLevel) return false;
+
+        bool const wasOverview = IsOverview();
+        m_detailLevel = level;
+        if (!wasOverview && !IsOverview())
+        {
+            // Full <-> Reduced：只需重新绑定已实现的节点（标签、提示、描边）
+            auto const& ap = Appearance();
+            for (auto const& kv : m_nodeElements)
             {
-                m_canvas.Children().RemoveAt(i);
-                break;
+                if (auto node = GetNode(kv.first)) BindNodeElement(kv.second.as<Controls::Grid>(), node, ap);
             }
         }
-        m_nodeElements.erase(it);
+        return true;
     }
 
-    void NodeGraphPanel::RedrawNodes()
+    void NodeGraphPanel::SyncLodNode(uint32_t slot)
     {
-        if (!m_canvas) return;
-        // Remove all existing node visuals
-        for (int32_t i = (int32_t)m_canvas.Children().Size() - 1; i >= 0; --i)
+        auto const b = NodeBounds(m_graph.Node(slot).payload.vm);
+        m_lod.SetNode(slot, (b.minX + b.maxX) * 0.5f, (b.minY + b.maxY) * 0.5f,
+            std::max(b.maxX - b.minX, b.maxY - b.minY));
+    }
+
+    void NodeGraphPanel::SyncOverviewNode(uint32_t slot)
+    {
+        if (!IsOverview() || slot == nodegraph::InvalidSlot) return;
+        ScheduleBatchFlush();
+        // 聚类符号按可见单元整体重算，代价只与屏幕上的单元数有关
+        if (m_overviewDirty || m_detailLevel == nodegraph::DetailLevel::Clusters)
+        {
+            m_overviewDirty = true;
+            return;
+        }
+        if (!m_graph.IsNodeAlive(slot))
+        {
+            m_overview.RemoveNode(slot);
+            return;
+        }
+        auto const b = NodeBounds(m_graph.Node(slot).payload.vm);
+        if (!m_overviewArea.Intersects(b))
+        {
+            m_overview.RemoveNode(slot);
+            return;
+        }
+        // 点的屏幕半径不小于 1.5 像素，颜色取描边色以便在小尺寸下保持对比
+        float const px = 1.0f / std::max(m_zoom, 1e-4f);
+        float const r = std::max(std::min(b.maxX - b.minX, b.maxY - b.minY) * 0.5f, 1.5f * px);
+        float const cx = (b.minX + b.maxX) * 0.5f, cy = (b.minY + b.maxY) * 0.5f;
+        nodegraph::NodeStyle const dot{ nodegraph::Primitive::Ellipse, m_batchAppearance.stroke, nodegraph::Rgba{ 0, 0, 0, 0 }, 0.0f, 0.0f };
+        m_overview.SetNode(slot, m_overview.NodeBatchFor(dot), nodegraph::Box{ cx - r, cy - r, cx + r, cy + r });
+    }
+
+    void NodeGraphPanel::SyncOverviewEdge(uint32_t slot)
+    {
+        if (!IsOverview()) return;
+        ScheduleBatchFlush();
+        if (m_overviewDirty || m_detailLevel == nodegraph::DetailLevel::Clusters)
+        {
+            m_overviewDirty = true;
+            return;
+        }
+        // 屏幕上短于 minEdgePx 的边与节点点位重叠，直接省略
+        float const px = 1.0f / std::max(m_zoom, 1e-4f);
+        Point from{}, to{};
+        if (!m_graph.IsEdgeAlive(slot) || !TryGetEdgeEndpoints(slot, from, to) ||
+            !m_overviewArea.Intersects(SegmentBounds(from, to)) ||
+            std::hypot(to.X - from.X, to.Y - from.Y) < m_lodThresholds.minEdgePx * px)
+        {
+            m_overview.RemoveEdge(slot);
+            return;
+        }
+        m_overview.SetEdge(slot, m_overview.EdgeBatchFor(nodegraph::EdgeStyle{ m_batchAppearance.edge.color, px }),
+            nodegraph::Segment{ from.X, from.Y, to.X, to.Y });
+    }
+
+    // 按当前层次与概览区域重新生成概览显示列表（FlushBatches 中合并执行）
+    void NodeGraphPanel::RebuildOverview()
+    {
+        m_overviewDirty = false;
+        m_overview.Clear();
+        if (!IsOverview()) return;
+        RefreshBatchAppearance();
+
+        if (m_detailLevel == nodegraph::DetailLevel::Points)
+        {
+            m_spatial.Query(m_overviewArea, [this](uint32_t slot, nodegraph::Box const&) { SyncOverviewNode(slot); });
+            m_edgeSpatial.Query(m_overviewArea, [this](uint32_t slot, nodegraph::Box const&) { SyncOverviewEdge(slot); });
+            return;
+        }
+
+        // 聚类：取单元在屏幕上不小于 clusterCellPx 的最细网格层级
+        float const px = 1.0f / std::max(m_zoom, 1e-4f);
+        uint32_t const level = m_lod.LevelFor(m_zoom, m_lodThresholds.clusterCellPx);
+        float const cell = m_lod.CellSize(level);
+        nodegraph::NodeStyle const glyph{ nodegraph::Primitive::Ellipse, m_batchAppearance.fill, m_batchAppearance.stroke, px, 0.0f };
+        uint32_t const glyphBatch = m_overview.NodeBatchFor(glyph);
+        uint32_t key = 0;
+        m_lod.ForEachCluster(level, m_overviewArea, [&](nodegraph::ClusterHierarchy::Cluster const& c)
+            {
+                // 符号半径随成员数按对数增长，不超过单元边长的一半
+                float const r = std::min(cell * 0.5f, (2.0f + 2.0f * std::log2(static_cast<float>(c.count))) * px);
+                float const cx = c.CenterX(), cy = c.CenterY();
+                m_overview.SetNode(key++, glyphBatch, nodegraph::Box{ cx - r, cy - r, cx + r, cy + r });
+            });
+        key = 0;
+        m_lod.ForEachBundle(level, m_overviewArea,
+            [&](nodegraph::ClusterHierarchy::Cluster const& a, nodegraph::ClusterHierarchy::Cluster const& b, uint32_t count)
+            {
+                // 边束按数量分级加粗（1~6 像素），同粗细的边束合并到同一个 Path
+                float const width = std::min(6.0f, 1.0f + std::floor(std::log2(static_cast<float>(count))));
+                uint32_t const batch = m_overview.EdgeBatchFor(nodegraph::EdgeStyle{ m_batchAppearance.edge.color, width * px });
+                m_overview.SetEdge(key++, batch, nodegraph::Segment{ a.CenterX(), a.CenterY(), b.CenterX(), b.CenterY() });
+            });
+    }
+#pragma endregion
+
+#pragma region NodeGraphPanel_Layout
+    void NodeGraphPanel::StartLayout()
+    {
+        // 力导向布局接管位置：作废进行中的分层布局，之后的修改也不再触发分层重排
+        m_layeredStop.request_stop();
+        m_layeredResult = nullptr;
+        if (!m_layout)
+        {
+            // 工作线程在每批位置就绪时通知一次，回到 UI 线程写回 Position
+            m_layout = std::make_unique<nodegraph::LayoutWorker>(m_layoutSettings,
+                [queue = DispatcherQueue(), weak = get_weak()]()
+                {
+                    queue.TryEnqueue([weak]()
+                        {
+                            if (auto self = weak.get()) self->ApplyLayoutPlacements();
+                        });
+                });
+            m_graph.ForEachNode([this](uint32_t slot, auto const&) { PostLayoutNode(slot, true); });
+            m_graph.ForEachEdge([this](uint32_t slot, auto const&) { UpdateEdgeBounds(slot); });
+            m_layout->Start();
+        }
+        m_layout->Restart();
+    }
+
+    void NodeGraphPanel::StopLayout()
+    {
+        m_layout.reset();       // 等待工作线程退出，尚未写回的位置一并丢弃
+    }
+
+    void NodeGraphPanel::PostLayoutNode(uint32_t slot, bool added)
+    {
+        auto const& entry = m_graph.Node(slot).payload;
+        auto const pos = entry.vm.Position();
+        // 位于原点的新节点视为未指定位置，由布局放到邻居附近
+        bool const seed = added && pos.X == 0.0f && pos.Y == 0.0f;
+        m_layout->SetNode(slot, entry.layoutStamp, pos.X, pos.Y, seed);
+    }
+
+    void NodeGraphPanel::ApplyLayoutPlacements()
+    {
+        if (!m_layout || !m_layout->TakePlacements(m_placements)) return;
+        m_applyingLayout = true;
+        for (auto const& p : m_placements)
         {
-            if (auto fe = m_canvas.Children().GetAt(i).try_as<FrameworkElement>())
+            if (!m_graph.IsNodeAlive(p.key)) continue;
+            auto const& entry = m_graph.Node(p.key).payload;
+            if (entry.layoutStamp != p.stamp) continue;     // 槽位已被之后加入的节点复用
+            entry.vm.Position(Point{ p.x, p.y });
+        }
+        m_applyingLayout = false;
+    }
+
+    IAsyncAction NodeGraphPanel::LayoutLayeredAsync()
+    {
+        auto strong = get_strong();
+        auto cancellation = co_await get_cancellation_token();
+
+        // 两种布局都写 Position：先停止力导向布局，并作废进行中的上一次分层布局
+        StopLayout();
+        m_layeredStop.request_stop();
+        std::stop_source stop;
+        m_layeredStop = stop;
+        cancellation.callback([stop]() mutable { stop.request_stop(); });
+
+        // 在 UI 线程上取快照，后台只访问快照
+        nodegraph::LayeredInput input;
+        std::vector<uint32_t> stamps(m_graph.NodeSlotCount(), 0);
+        m_graph.ForEachNode([&](uint32_t slot, auto const& n)
+            {
+                auto const size = n.payload.vm.Size();
+                input.nodes.push_back({ slot, size.Width, size.Height });
+                stamps[slot] = n.payload.layoutStamp;
+            });
+        m_graph.ForEachEdge([&](uint32_t, auto const& e)
+            {
+                auto const a = m_graph.FindNode(e.from), b = m_graph.FindNode(e.to);
+                if (a == nodegraph::InvalidSlot || b == nodegraph::InvalidSlot) return;
+                auto const& vm = e.payload.vm;
+                input.edges.push_back({ a, b, static_cast<float>(vm.Weight()), vm.IsDirected() });
+            });
+        auto previous = m_layeredResult;
+        auto const settings = m_layeredSettings;
+
+        apartment_context ui;
+        co_await resume_background();
+        auto result = nodegraph::LayeredLayout(settings).Run(input, previous.get(), stop.get_token());
+        co_await ui;
+        if (!result || stop.stop_requested()) co_return;
+
+        m_layeredResult = result;
+        m_applyingLayout = true;
+        m_graph.ForEachNode([&](uint32_t slot, auto const& n)
+            {
+                // 取快照之后新加入（或复用槽位）的节点留在原处，由下一次增量重排放置
+                if (result->Has(slot) && slot < stamps.size() && stamps[slot] == n.payload.layoutStamp)
+                    n.payload.vm.Position(Point{ result->x[slot], result->y[slot] });
+            });
+        m_applyingLayout = false;
+    }
+
+    void NodeGraphPanel::ScheduleLayeredRelayout()
+    {
+        // 只在已有分层结果时重排；同一轮消息内的多次修改合并为一次
+        if (!m_relayoutOnChange || !m_layeredResult || m_relayoutPending) return;
+        m_relayoutPending = true;
+        DispatcherQueue().TryEnqueue(Microsoft::UI::Dispatching::DispatcherQueuePriority::Low, [weak = get_weak()]()
             {
-                if (fe.Tag() && unbox_value<hstring>(fe.Tag()) == L"Node")
+                if (auto self = weak.get())
                 {
-                    m_canvas.Children().RemoveAt(i);
+                    self->m_relayoutPending = false;
+                    self->LayoutLayeredAsync();
                 }
-            }
+            });
+    }
+#pragma endregion
+
+#pragma region NodeGraphPanel_BulkLoad
+    void NodeGraphPanel::EndUpdate()
+    {
+        if (m_updateDepth == 0 || --m_updateDepth > 0) return;
+        bool const rebuildNodes = std::exchange(m_rebuildNodes, false);
+        bool const rebuildEdges = std::exchange(m_rebuildEdges, false);
+        // 要重建的边先整体撤下，节点重建时就不会逐条更新即将删除的边
+        if (rebuildEdges)
+        {
+            for (auto slot : m_edgeOrder) UntrackEdge(slot);
+            m_edgeOrder.clear();
         }
-        m_nodeElements.clear();
+        // 节点先于边加入，TrackEdge 时端点已可解析
+        if (rebuildNodes) RebuildNodeIndex();
+        else TrackAppendedNodes();
+        if (rebuildEdges) RebuildEdgeIndex();
+        else TrackAppendedEdges();
+    }
+
+    void NodeGraphPanel::TrackAppendedNodes()
+    {
+        auto const tracked = static_cast<uint32_t>(m_nodeOrder.size());
+        uint32_t const size = m_nodes ? m_nodes.Size() : 0;
+        if (size < tracked) RebuildNodeIndex();     // 集合未按约定发出通知
+        if (size <= tracked) return;
+        std::vector<XamlUICommand::NodeViewModel> appended(size - tracked, nullptr);
+        m_nodes.GetMany(tracked, appended);
+        m_nodeOrder.reserve(size);
+        for (auto const& node : appended) m_nodeOrder.push_back(TrackNode(node));
+    }
 
-        for (auto const& n : m_nodes)
+    void NodeGraphPanel::TrackAppendedEdges()
+    {
+        auto const tracked = static_cast<uint32_t>(m_edgeOrder.size());
+        uint32_t const size = m_edges ? m_edges.Size() : 0;
+        if (size < tracked) RebuildEdgeIndex();
+        if (size <= tracked) return;
+        std::vector<XamlUICommand::EdgeViewModel> appended(size - tracked, nullptr);
+        m_edges.GetMany(tracked, appended);
+        m_edgeOrder.reserve(size);
+        for (auto const& edge : appended) m_edgeOrder.push_back(TrackEdge(edge));
+    }
+
+    void NodeGraphPanel::LoadGraph(IIterable<XamlUICommand::NodeViewModel> const& nodes, IIterable<XamlUICommand::EdgeViewModel> const& edges)
+    {
+        std::vector<XamlUICommand::NodeViewModel> n;
+        std::vector<XamlUICommand::EdgeViewModel> e;
+        if (nodes) for (auto const& node : nodes) n.push_back(node);
+        if (edges) for (auto const& edge : edges) e.push_back(edge);
+        BeginUpdate();
+        m_edges.ReplaceAll(e);
+        m_nodes.ReplaceAll(n);
+        EndUpdate();
+    }
+
+    IAsyncActionWithProgress<double> NodeGraphPanel::LoadGraphFileAsync(hstring path)
+    {
+        auto strong = get_strong();
+        auto cancellation = co_await get_cancellation_token();
+        auto progress = co_await get_progress_token();
+
+        // 新的加载作废进行中的上一次；取消后保留已显示的块
+        m_loadStop.request_stop();
+        std::stop_source stop;
+        m_loadStop = stop;
+        cancellation.callback([stop]() mutable { stop.request_stop(); });
+
+        auto const defaultShape = m_defaultShape;
+        auto const labelKey = m_defaultLabelKey;
+        auto const tipKey = m_defaultTipKey;
+        // 文件打开并读出第一块之后才清空当前图：打不开或格式不对时保留原来显示的内容
+        bool cleared = false;
+
+        apartment_context ui;
+        co_await resume_background();
+        nodegraph::MappedFile file;
+        if (!file.Open(std::filesystem::path{ std::wstring_view{ path } }))
+            throw hresult_error(HRESULT_FROM_WIN32(ERROR_OPEN_FAILED), L"Cannot open graph file: " + path);
+
+        nodegraph::GraphFileReader reader(file.Data());
+        nodegraph::GraphChunk chunk;
+        std::vector<uint32_t> rows;
+        std::vector<XamlUICommand::NodeViewModel> nodes;
+        std::vector<XamlUICommand::EdgeViewModel> edges;
+        for (;;)
         {
-            // Default size if unset
-            auto size = n.Size();
-            if (size.Width == 0 || size.Height == 0)
+            auto const result = reader.Next(chunk);
+            if (result == nodegraph::GraphFileResult::End) break;
+            if (result == nodegraph::GraphFileResult::Invalid)
+                throw hresult_error(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), L"Malformed graph file: " + path);
+
+            // 视图模型不依附于线程，在后台创建并填好；UI 线程只负责追加、索引与实现
+            nodes.clear();
+            edges.clear();
+            if (chunk.kind == nodegraph::GraphChunkKind::Nodes)
             {
-                n.Size(Size{ 64, 64 });
+                nodes.reserve(chunk.rows);
+                for (uint32_t i = 0; i < chunk.rows; ++i)
+                {
+                    auto node = winrt::make<XamlUICommand::implementation::NodeViewModel>();
+                    node.Id(chunk.ids[i]);
+                    node.Label(to_hstring(chunk.labels[i]));
+                    node.Position(Point{ chunk.x[i], chunk.y[i] });
+                    if (chunk.width[i] > 0 && chunk.height[i] > 0) node.Size(Size{ chunk.width[i], chunk.height[i] });
+                    node.Shape(chunk.shape[i] <= static_cast<uint8_t>(XamlUICommand::NodeShape::RoundedRect)
+                        ? static_cast<XamlUICommand::NodeShape>(chunk.shape[i]) : defaultShape);
+                    if (!labelKey.empty()) node.LabelMetaKey(labelKey);
+                    if (!tipKey.empty()) node.TooltipMetaKey(tipKey);
+                    nodes.push_back(node);
+                }
+
+                // 元数据按列直接写入共享的列式表：整块只加一次写锁，值不经过装箱
+                if (!chunk.meta.empty())
+                {
+                    rows.assign(chunk.rows, nodegraph::InvalidMetaRow);
+                    for (uint32_t i = 0; i < chunk.rows; ++i)
+                    {
+                        if (std::ranges::any_of(chunk.meta, [i](auto const& column) { return column.Has(i); }))
+                            rows[i] = get_self<XamlUICommand::implementation::NodeViewModel>(nodes[i])->EnsureMetaRow();
+                    }
+                    XamlUICommand::implementation::NodeMetaTable::Shared().Write([&](auto& store)
+                        {
+                            for (auto const& column : chunk.meta)
+                            {
+                                uint32_t const c = store.Column(to_hstring(column.key));
+                                for (uint32_t i = 0; i < chunk.rows; ++i)
+                                {
+                                    if (!column.Has(i)) continue;
+                                    switch (column.type)
+                                    {
+                                    case nodegraph::MetaType::Int64:  store.SetInt(rows[i], c, column.ints[i]); break;
+                                    case nodegraph::MetaType::Double: store.SetDouble(rows[i], c, column.doubles[i]); break;
+                                    case nodegraph::MetaType::Bool:   store.SetBool(rows[i], c, column.bools[i] != 0); break;
+                                    default:                          store.SetText(rows[i], c, to_hstring(column.strings[i])); break;
+                                    }
+                                }
+                            }
+                        });
+                }
             }
-            // Default shape if unset
-            if (n.Shape() != XamlUICommand::NodeShape::Circle && n.Shape() != XamlUICommand::NodeShape::RoundedRect)
+            else
             {
-                n.Shape(m_defaultShape);
+                edges.reserve(chunk.rows);
+                for (uint32_t i = 0; i < chunk.rows; ++i)
+                {
+                    auto edge = winrt::make<XamlUICommand::implementation::EdgeViewModel>();
+                    edge.FromId(chunk.from[i]);
+                    edge.ToId(chunk.to[i]);
+                    edge.Weight(chunk.weight[i]);
+                    edge.IsDirected((chunk.flags[i] & 1) != 0);
+                    if (!chunk.labels[i].empty()) edge.Label(to_hstring(chunk.labels[i]));
+                    edges.push_back(edge);
+                }
             }
-            AttachNodeElement(n);
+
+            co_await ui;
+            if (stop.stop_requested()) co_return;
+            if (!std::exchange(cleared, true)) LoadGraph(nullptr, nullptr);
+            // 每块一次批量更新：先到的边等端点所在的块到达后由 TrackNode 补齐
+            BeginUpdate();
+            for (auto const& node : nodes) m_nodes.Append(node);
+            for (auto const& edge : edges) m_edges.Append(edge);
+            EndUpdate();
+            progress(static_cast<double>(reader.Offset()) / static_cast<double>(reader.Size()));
+            co_await resume_background();
         }
+        if (!cleared)
+        {
+            // 合法但没有任何块的文件：结果是空图
+            co_await ui;
+            if (stop.stop_requested()) co_return;
+            LoadGraph(nullptr, nullptr);
+        }
+        progress(1.0);
     }
+#pragma endregion
+
+#pragma region NodeGraphPanel_Query
+    NodeGraphPanel::QuerySnapshot NodeGraphPanel::TakeQuerySnapshot(bool centers)
+    {
+        // 邻接由 UpdateEdgeBounds 增量维护，这里只取共享快照；节点戳与中心点是 O(V) 的复制
+        QuerySnapshot snapshot;
+        auto const count = static_cast<uint32_t>(m_graph.NodeSlotCount());
+        snapshot.graph = m_query.Snapshot(count);
+        snapshot.stamps.assign(count, 0);
+        if (centers) snapshot.centers.assign(static_cast<size_t>(count) * 2, 0.0f);
+        m_graph.ForEachNode([&](uint32_t slot, auto const& n)
+            {
+                snapshot.stamps[slot] = n.payload.layoutStamp;
+                if (!centers) return;
+                auto const pos = n.payload.vm.Position();
+                auto const size = n.payload.vm.Size();
+                snapshot.centers[slot * 2] = pos.X + size.Width / 2.0f;
+                snapshot.centers[slot * 2 + 1] = pos.Y + size.Height / 2.0f;
+            });
+        return snapshot;
+    }
+
+    std::stop_source NodeGraphPanel::BeginHighlightQuery()
+    {
+        // 高亮只有一份：新的查询作废进行中的上一次
+        m_highlightStop.request_stop();
+        m_highlightStop = std::stop_source{};
+        return m_highlightStop;
+    }
+
+    bool NodeGraphPanel::IsSnapshotNode(QuerySnapshot const& snapshot, uint32_t slot) const
+    {
+        return slot < snapshot.stamps.size() && snapshot.stamps[slot] != 0 &&
+            m_graph.IsNodeAlive(slot) && m_graph.Node(slot).payload.layoutStamp == snapshot.stamps[slot];
+    }
+
+    std::vector<XamlUICommand::NodeViewModel> NodeGraphPanel::ResolveNodes(QuerySnapshot const& snapshot, std::span<uint32_t const> slots) const
+    {
+        // 取快照之后被移除（或槽位被复用）的节点不出现在结果中
+        std::vector<XamlUICommand::NodeViewModel> nodes;
+        nodes.reserve(slots.size());
+        for (auto slot : slots)
+        {
+            if (IsSnapshotNode(snapshot, slot)) nodes.push_back(m_graph.Node(slot).payload.vm);
+        }
+        return nodes;
+    }
+
+    std::vector<XamlUICommand::NodeViewModel> NodeGraphPanel::ApplyHighlight(QuerySnapshot const& snapshot,
+        std::span<uint32_t const> nodeSlots, std::span<uint32_t const> edgeSlots)
+    {
+        ResetHighlight();
+        auto nodes = ResolveNodes(snapshot, nodeSlots);
+        for (auto const& node : nodes) node.IsHighlighted(true);
+        m_highlightedNodes = nodes;
+        for (auto slot : edgeSlots)
+        {
+            if (!m_graph.IsEdgeAlive(slot)) continue;
+            auto const& e = m_graph.Edge(slot);
+            // 边槽位没有戳：两端仍是快照中的节点才视为同一条边
+            if (!IsSnapshotNode(snapshot, m_graph.FindNode(e.from)) || !IsSnapshotNode(snapshot, m_graph.FindNode(e.to))) continue;
+            if (e.payload.vm.IsHighlighted()) continue;
+            e.payload.vm.IsHighlighted(true);
+            m_highlightedEdges.push_back(e.payload.vm);
+        }
+        return nodes;
+    }
+
+    void NodeGraphPanel::ResetHighlight()
+    {
+        for (auto const& node : m_highlightedNodes) node.IsHighlighted(false);
+        for (auto const& edge : m_highlightedEdges) edge.IsHighlighted(false);
+        m_highlightedNodes.clear();
+        m_highlightedEdges.clear();
+    }
+
+    void NodeGraphPanel::ClearHighlight()
+    {
+        m_highlightStop.request_stop();
+        ResetHighlight();
+    }
+
+    IAsyncOperation<IVectorView<XamlUICommand::NodeViewModel>> NodeGraphPanel::FindPathAsync(int64_t fromId, int64_t toId)
+    {
+        auto strong = get_strong();
+        auto cancellation = co_await get_cancellation_token();
+        auto stop = BeginHighlightQuery();
+        cancellation.callback([stop]() mutable { stop.request_stop(); });
+
+        auto const source = m_graph.FindNode(fromId), target = m_graph.FindNode(toId);
+        auto const snapshot = TakeQuerySnapshot(true);
+
+        apartment_context ui;
+        co_await resume_background();
+        nodegraph::GraphPath path;
+        if (source != nodegraph::InvalidSlot && target != nodegraph::InvalidSlot)
+            path = nodegraph::ShortestPath(*snapshot.graph, source, target, &snapshot.centers, stop.get_token());
+        co_await ui;
+        if (stop.stop_requested()) co_return single_threaded_vector<XamlUICommand::NodeViewModel>().GetView();
+
+        // 不可达时清除原有高亮并返回空序列
+        co_return single_threaded_vector(ApplyHighlight(snapshot, path.nodes, path.edges)).GetView();
+    }
+
+    IAsyncOperation<IVectorView<XamlUICommand::NodeViewModel>> NodeGraphPanel::FindDownstreamAsync(int64_t id)
+    {
+        auto strong = get_strong();
+        auto cancellation = co_await get_cancellation_token();
+        auto stop = BeginHighlightQuery();
+        cancellation.callback([stop]() mutable { stop.request_stop(); });
+
+        auto const source = m_graph.FindNode(id);
+        auto const snapshot = TakeQuerySnapshot(false);
+
+        apartment_context ui;
+        co_await resume_background();
+        nodegraph::GraphReach reach;
+        if (source != nodegraph::InvalidSlot)
+            reach = nodegraph::Reachable(*snapshot.graph, { source }, stop.get_token());
+        co_await ui;
+        if (stop.stop_requested()) co_return single_threaded_vector<XamlUICommand::NodeViewModel>().GetView();
+
+        co_return single_threaded_vector(ApplyHighlight(snapshot, reach.nodes, reach.edges)).GetView();
+    }
+
+    IAsyncOperation<IVectorView<IVectorView<XamlUICommand::NodeViewModel>>> NodeGraphPanel::FindCyclesAsync()
+    {
+        auto strong = get_strong();
+        auto cancellation = co_await get_cancellation_token();
+        auto stop = BeginHighlightQuery();
+        cancellation.callback([stop]() mutable { stop.request_stop(); });
+
+        auto const snapshot = TakeQuerySnapshot(false);
+
+        apartment_context ui;
+        co_await resume_background();
+        // 只保留多于一个节点（或带自环）的分量，连同分量内部的边
+        auto const& graph = *snapshot.graph;
+        auto const components = nodegraph::StronglyConnectedComponents(graph, stop.get_token());
+        std::vector<uint32_t> nodes, offsets{ 0 }, edges;
+        for (uint32_t c = 0; c < components.Count() && !stop.stop_requested(); ++c)
+        {
+            auto const first = components.nodes.begin() + components.offsets[c];
+            auto const last = components.nodes.begin() + components.offsets[c + 1];
+            size_t const before = edges.size();
+            for (auto it = first; it != last; ++it)
+            {
+                graph.ForEachArc(*it, [&](nodegraph::GraphArc const& arc)
+                    {
+                        if (components.component[arc.to] == c) edges.push_back(arc.key);
+                    });
+            }
+            if (edges.size() == before) continue;
+            nodes.insert(nodes.end(), first, last);
+            offsets.push_back(static_cast<uint32_t>(nodes.size()));
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());     // 无向边有两条弧
+        co_await ui;
+
+        std::vector<IVectorView<XamlUICommand::NodeViewModel>> cycles;
+        if (stop.stop_requested()) co_return single_threaded_vector(std::move(cycles)).GetView();
+
+        ApplyHighlight(snapshot, nodes, edges);
+        for (size_t i = 0; i + 1 < offsets.size(); ++i)
+        {
+            auto group = ResolveNodes(snapshot, std::span<uint32_t const>{ nodes }.subspan(offsets[i], offsets[i + 1] - offsets[i]));
+            if (!group.empty()) cycles.push_back(single_threaded_vector(std::move(group)).GetView());
+        }
+        co_return single_threaded_vector(std::move(cycles)).GetView();
+    }
+
+    IAsyncOperation<IVectorView<XamlUICommand::NodeViewModel>> NodeGraphPanel::TopologicalOrderAsync()
+    {
+        auto strong = get_strong();
+        auto cancellation = co_await get_cancellation_token();
+        std::stop_source stop;
+        cancellation.callback([stop]() mutable { stop.request_stop(); });
+
+        auto const snapshot = TakeQuerySnapshot(false);
+
+        apartment_context ui;
+        co_await resume_background();
+        auto const order = nodegraph::TopologicalOrder(*snapshot.graph, stop.get_token());
+        co_await ui;
+
+        // 空槽位（及取快照后移除的节点）在 ResolveNodes 中剔除；不改变高亮
+        co_return single_threaded_vector(ResolveNodes(snapshot, order.order)).GetView();
+    }
+#pragma endregion
 
     static void SetupAcrylicPresenter(Flyout const& fly, double corner = 12.0)
     {
@@ -769,7 +2426,8 @@ namespace winrt::XamlUICommand::implementation
         panel.Children().Append(lbl);
 
         // meta list
-        if (node.Meta() && node.Meta().Size() > 0)
+        auto entries = get_self<XamlUICommand::implementation::NodeViewModel>(node)->MetaEntries();
+        if (!entries.empty())
         {
             auto grid = Controls::Grid{};
             auto row = RowDefinition{};
@@ -783,13 +2441,13 @@ namespace winrt::XamlUICommand::implementation
             colStar.Width(GridLengthHelper::FromValueAndType(1.0, GridUnitType::Star));
             grid.ColumnDefinitions().Append(colStar);
 
-            for (auto const& kvp : node.Meta())
+            for (auto const& [key, text] : entries)
             {
                 uint32_t r = grid.RowDefinitions().Size();
                 grid.RowDefinitions().Append(RowDefinition{});
 
-                auto k = Controls::TextBlock{}; k.Text(kvp.Key()); k.Margin(Thickness{ 0,2,8,2 });
-                auto v = Controls::TextBlock{}; v.Text(kvp.Value() ? unbox_value<hstring>(kvp.Value()) : L"<null>"); v.Margin(Thickness{ 0,2,0,2 });
+                auto k = Controls::TextBlock{}; k.Text(key); k.Margin(Thickness{ 0,2,8,2 });
+                auto v = Controls::TextBlock{}; v.Text(text); v.Margin(Thickness{ 0,2,0,2 });
 
                 Grid::SetRow(k, r); Grid::SetColumn(k, 0);
                 Grid::SetRow(v, r); Grid::SetColumn(v, 1);
@@ -818,16 +2476,22 @@ namespace winrt::XamlUICommand::implementation
             auto p = e.Property();
 
             // 边线外观
-            if (p == s_EdgeBrushProperty || p == s_EdgeThicknessProperty)
+            if (p == s_EdgeBrushProperty || p == s_EdgeThicknessProperty || p == s_HighlightBrushProperty)
             {
-                self->RedrawEdges();
+                self->RestyleEdges();
             }
 
             // 节点外观
             if (p == s_NodeFillProperty || p == s_NodeStrokeProperty ||
                 p == s_NodeTextBrushProperty || p == s_NodeCornerRadiusProperty ||
-                p == s_AutoContrastProperty || p == s_ContrastThresholdProperty)
+                p == s_AutoContrastProperty || p == s_ContrastThresholdProperty || p == s_HighlightBrushProperty)
             {
+                self->InvalidateAppearance();
+                if (self->IsBatched())
+                {
+                    self->RebuildDisplayList();
+                    return;
+                }
                 // 增量更新样式
                 for (auto const& kv : self->m_nodeElements)
                 {
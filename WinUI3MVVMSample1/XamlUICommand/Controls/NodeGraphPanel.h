@@ -1,6 +1,23 @@
 #pragma once
 #include "NodeGraphPanel.g.h"
+#include <array>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stop_token>
 #include <unordered_map>
+#include <vector>
+#include <mvvm_observable_vector.h>
+#include "NodeGraph/GraphIndex.h"
+#include "NodeGraph/QuadTree.h"
+#include "NodeGraph/DisplayList.h"
+#include "NodeGraph/LevelOfDetail.h"
+#include "NodeGraph/LayoutWorker.h"
+#include "NodeGraph/LayeredLayout.h"
+#include "NodeGraph/GraphQuery.h"
+#include "NodeGraph/GraphFile.h"
+#include "NodeGraph/ColorKernels.h"
 
 namespace winrt::XamlUICommand::implementation
 {
@@ -27,16 +44,58 @@ namespace winrt::XamlUICommand::implementation
         hstring DefaultLabelMetaKey() const { return m_defaultLabelKey; }
         void DefaultLabelMetaKey(hstring const& v);
 
+        XamlUICommand::NodeGraphRenderMode RenderMode() const { return m_renderMode; }
+        void RenderMode(XamlUICommand::NodeGraphRenderMode const& value);
+
+        bool IsVirtualizing() const { return m_virtualizing; }
+        void IsVirtualizing(bool value);
+
+        double RealizationMargin() const { return m_realizationMargin; }
+        void RealizationMargin(double value);
+
+        bool IsLevelOfDetailEnabled() const { return m_lodEnabled; }
+        void IsLevelOfDetailEnabled(bool value);
+
+        XamlUICommand::NodeGraphDetailLevel DetailLevel() const { return static_cast<XamlUICommand::NodeGraphDetailLevel>(m_detailLevel); }
+
         // Public API
         XamlUICommand::NodeViewModel AddNode(int64_t id, hstring const& label, Windows::Foundation::Point const& position);
         void RemoveNode(int64_t id);
         XamlUICommand::NodeViewModel GetNode(int64_t id);
+        XamlUICommand::NodeViewModel HitTest(Windows::Foundation::Point const& point);
+        Windows::Foundation::Collections::IVectorView<XamlUICommand::NodeViewModel> FindNodesInRect(Windows::Foundation::Rect const& rect);
         void AddOrUpdateMeta(int64_t id, hstring const& key, IInspectable const& value);
         void RemoveMeta(int64_t id, hstring const& key);
 
         XamlUICommand::EdgeViewModel AddEdge(int64_t fromId, int64_t toId, hstring const& label);
         void RemoveEdge(int64_t fromId, int64_t toId);
 
+        void BeginUpdate() noexcept { ++m_updateDepth; }
+        void EndUpdate();
+        void LoadGraph(Windows::Foundation::Collections::IIterable<XamlUICommand::NodeViewModel> const& nodes,
+            Windows::Foundation::Collections::IIterable<XamlUICommand::EdgeViewModel> const& edges);
+        Windows::Foundation::IAsyncActionWithProgress<double> LoadGraphFileAsync(hstring path);
+
+        void StartLayout();
+        void StopLayout();
+        bool IsLayoutActive() const noexcept { return m_layout != nullptr; }
+
+        // 布局参数在 StartLayout 创建工作线程时读取
+        nodegraph::ForceLayout::Settings& LayoutSettings() noexcept { return m_layoutSettings; }
+
+        Windows::Foundation::IAsyncAction LayoutLayeredAsync();
+        bool RelayoutOnChange() const noexcept { return m_relayoutOnChange; }
+        void RelayoutOnChange(bool value) noexcept { m_relayoutOnChange = value; }
+
+        // 分层布局参数在每次 LayoutLayeredAsync 开始时复制
+        nodegraph::LayeredLayout::Settings& LayeredLayoutSettings() noexcept { return m_layeredSettings; }
+
+        Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVectorView<XamlUICommand::NodeViewModel>> FindPathAsync(int64_t fromId, int64_t toId);
+        Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVectorView<XamlUICommand::NodeViewModel>> FindDownstreamAsync(int64_t id);
+        Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVectorView<Windows::Foundation::Collections::IVectorView<XamlUICommand::NodeViewModel>>> FindCyclesAsync();
+        Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVectorView<XamlUICommand::NodeViewModel>> TopologicalOrderAsync();
+        void ClearHighlight();
+
         // Events
         winrt::event<XamlUICommand::NodeInvokedEventHandler> m_NodeInvoked;
         winrt::event_token NodeInvoked(XamlUICommand::NodeInvokedEventHandler const& handler)
@@ -54,6 +113,7 @@ namespace winrt::XamlUICommand::implementation
         static winrt::Microsoft::UI::Xaml::DependencyProperty NodeCornerRadiusProperty();
         static winrt::Microsoft::UI::Xaml::DependencyProperty AutoContrastProperty();
         static winrt::Microsoft::UI::Xaml::DependencyProperty ContrastThresholdProperty();
+        static winrt::Microsoft::UI::Xaml::DependencyProperty HighlightBrushProperty();
 
         Microsoft::UI::Xaml::Media::Brush NodeFill();
         void NodeFill(Microsoft::UI::Xaml::Media::Brush const& v);
@@ -79,9 +139,31 @@ namespace winrt::XamlUICommand::implementation
         double ContrastThreshold();
         void ContrastThreshold(double v);
 
+        Microsoft::UI::Xaml::Media::Brush HighlightBrush();
+        void HighlightBrush(Microsoft::UI::Xaml::Media::Brush const& v);
+
         // Templating
         void OnApplyTemplate();
 
+        // 边线元素的创建/更新/删除计数，用于衡量拖拽时的增量渲染开销
+        // （定义 NODEGRAPH_RENDER_STATS 时每次节点移动输出到调试器）
+        struct EdgeRenderStats
+        {
+            uint64_t created{ 0 };
+            uint64_t reused{ 0 };       // 从回收池取出
+            uint64_t updated{ 0 };
+            uint64_t removed{ 0 };
+        };
+        EdgeRenderStats const& EdgeStats() const noexcept { return m_edgeStats; }
+        void ResetEdgeStats() noexcept { m_edgeStats = {}; }
+
+        // 批量模式的保留显示列表（可交给 nodegraph::Rasterizer 离屏绘制）
+        nodegraph::DisplayList const& DisplayList() const noexcept { return m_displayList; }
+
+        // 细节层次：聚类层级随图增量维护；阈值以屏幕像素计，修改后在下次视口变化时生效
+        nodegraph::ClusterHierarchy const& ClusterHierarchy() const noexcept { return m_lod; }
+        nodegraph::LodThresholds& LevelOfDetailThresholds() noexcept { return m_lodThresholds; }
+
     private:
         struct InnerAppearance
         {
@@ -90,16 +172,125 @@ namespace winrt::XamlUICommand::implementation
             Microsoft::UI::Xaml::Media::Brush text;
             double cornerRadius;
         };
+        InnerAppearance const& Appearance();
         InnerAppearance ComputeAppearance();
+        void InvalidateAppearance() noexcept { m_appearance.reset(); }
 
         // Helpers
         void RebuildAll();
         void RedrawEdges();
         void RedrawNodes();
+
+        // Edge visuals keyed by edge slot, updated in place
+        void AttachEdgeElement(uint32_t slot);
+        void UpdateEdgeElement(uint32_t slot);
+        void RemoveEdgeElement(uint32_t slot);
+        void UpdateIncidentEdges(int64_t nodeId);
+        void RestyleEdges();
+        void RestyleEdge(uint32_t slot);
+        void ApplyEdgeStyle(Microsoft::UI::Xaml::Shapes::Line const& line, uint32_t slot);
+        bool TryGetEdgeEndpoints(uint32_t slot, Windows::Foundation::Point& from, Windows::Foundation::Point& to);
+        Microsoft::UI::Xaml::Media::Brush EdgeStroke();
+        Microsoft::UI::Xaml::Media::Brush HighlightStroke();
         void ConnectCollectionEvents();
+
+        // Batched render mode: display list mirrored into one Path per style batch
+        struct BatchAppearance
+        {
+            nodegraph::Rgba fill{};
+            nodegraph::Rgba stroke{};
+            float cornerRadius{ 0 };
+            nodegraph::EdgeStyle edge{};
+            nodegraph::Rgba highlight{};
+        };
+        bool IsBatched() const noexcept { return m_renderMode == XamlUICommand::NodeGraphRenderMode::Batched; }
+        void RefreshBatchAppearance();
+        void RebuildDisplayList();
+        void SyncNodeInstance(uint32_t slot);
+        void SyncEdgeInstance(uint32_t slot);
+        void ScheduleBatchFlush();
+        void FlushBatches();
+        struct BatchPaths
+        {
+            std::vector<Microsoft::UI::Xaml::Shapes::Path> nodes;   // display list node batch -> Path
+            std::vector<Microsoft::UI::Xaml::Shapes::Path> edges;   // display list edge batch -> Path
+        };
+        void FlushDisplayList(nodegraph::DisplayList& list, BatchPaths& paths);
+        void OnCanvasTapped(Microsoft::UI::Xaml::Input::TappedRoutedEventArgs const& args);
+        void EnsureNodeDefaults(XamlUICommand::NodeViewModel const& node);
+
+        // Viewport virtualization (Elements mode): realize what intersects m_realizedArea, recycle the rest
+        void OnEffectiveViewportChanged(Windows::Foundation::Rect const& viewport);
+        void UpdateRealization(bool force);
+        void RealizeVisibleNodes();
+        void RealizeVisibleEdges();
+        void RealizeNode(uint32_t slot);
+        void UpdateEdgeBounds(uint32_t slot);
+        Microsoft::UI::Xaml::Controls::Grid AcquireNodeContainer(XamlUICommand::NodeShape shape);
+        void RecycleNodeContainer(Microsoft::UI::Xaml::Controls::Grid const& grid);
+        void BindNodeElement(Microsoft::UI::Xaml::Controls::Grid const& grid, XamlUICommand::NodeViewModel const& node, InnerAppearance const& ap);
+        Microsoft::UI::Xaml::Shapes::Line AcquireEdgeLine();
+        void RecycleEdgeLine(Microsoft::UI::Xaml::Shapes::Line const& line);
+
+        // Level of detail: Points / Clusters are drawn as an overview display list instead of elements
+        bool IsOverview() const noexcept { return !IsBatched() && m_detailLevel >= nodegraph::DetailLevel::Points; }
+        bool UpdateDetailLevel();
+        void SyncLodNode(uint32_t slot);
+        void SyncOverviewNode(uint32_t slot);
+        void SyncOverviewEdge(uint32_t slot);
+        void RebuildOverview();
+
+        // Auto layout: positions are streamed back from the worker and written to NodeViewModel::Position
+        void PostLayoutNode(uint32_t slot, bool added);
+        void ApplyLayoutPlacements();
+        void ScheduleLayeredRelayout();
         void DisconnectCollectionEvents();
 
-        void AttachNodeElement(XamlUICommand::NodeViewModel const& node);
+        // Graph queries: the CSR is kept in sync by UpdateEdgeBounds; results are mapped back through node stamps
+        struct QuerySnapshot
+        {
+            std::shared_ptr<nodegraph::GraphSnapshot const> graph;
+            std::vector<uint32_t> stamps;       // node slot -> layoutStamp（0 为空槽）
+            std::vector<float> centers;         // node slot -> 中心 x, y（仅最短路径的 A* 启发式使用）
+        };
+        QuerySnapshot TakeQuerySnapshot(bool centers);
+        std::stop_source BeginHighlightQuery();
+        bool IsSnapshotNode(QuerySnapshot const& snapshot, uint32_t slot) const;
+        std::vector<XamlUICommand::NodeViewModel> ResolveNodes(QuerySnapshot const& snapshot, std::span<uint32_t const> slots) const;
+        std::vector<XamlUICommand::NodeViewModel> ApplyHighlight(QuerySnapshot const& snapshot,
+            std::span<uint32_t const> nodeSlots, std::span<uint32_t const> edgeSlots);
+        void ResetHighlight();
+
+        // Graph index (id map, adjacency, spatial index) kept in sync with m_nodes / m_edges
+        struct NodeEntry
+        {
+            XamlUICommand::NodeViewModel vm{ nullptr };
+            winrt::event_token token{};
+            uint32_t layoutStamp{ 0 };      // 每次加入递增，识别布局线程（及后台查询）送回的过期结果
+        };
+        struct EdgeEntry
+        {
+            XamlUICommand::EdgeViewModel vm{ nullptr };
+            winrt::event_token token{};
+        };
+
+        void RebuildNodeIndex();
+        void RebuildEdgeIndex();
+        void OnNodesVectorChanged(Windows::Foundation::Collections::IVectorChangedEventArgs const& args);
+        void OnEdgesVectorChanged(Windows::Foundation::Collections::IVectorChangedEventArgs const& args);
+        void TrackAppendedNodes();
+        void TrackAppendedEdges();
+        uint32_t TrackNode(XamlUICommand::NodeViewModel const& node);
+        void UntrackNode(uint32_t slot);
+        uint32_t TrackEdge(XamlUICommand::EdgeViewModel const& edge);
+        void UntrackEdge(uint32_t slot);
+        void OnNodePropertyChanged(uint32_t slot, hstring const& propertyName);
+        void RemoveEdgeSlots(std::vector<uint32_t> const& edgeSlots);
+        template <typename Predicate>
+        void RemoveBatchedEdges(Predicate&& doomed);     // BeginUpdate 期间按集合从后往前删除
+        static nodegraph::Box NodeBounds(XamlUICommand::NodeViewModel const& node);
+
+        void AttachNodeElement(XamlUICommand::NodeViewModel const& node, InnerAppearance const& ap);
         void UpdateNodeElement(XamlUICommand::NodeViewModel const& node);
         void RemoveNodeElement(int64_t id);
 
@@ -114,8 +305,8 @@ namespace winrt::XamlUICommand::implementation
             Microsoft::UI::Xaml::DependencyPropertyChangedEventArgs const&);
 
         Microsoft::UI::Xaml::Controls::Canvas m_canvas{ nullptr };
-        Windows::Foundation::Collections::IObservableVector<XamlUICommand::NodeViewModel> m_nodes{ winrt::single_threaded_observable_vector<XamlUICommand::NodeViewModel>() };
-        Windows::Foundation::Collections::IObservableVector<XamlUICommand::EdgeViewModel> m_edges{ winrt::single_threaded_observable_vector<XamlUICommand::EdgeViewModel>() };
+        Windows::Foundation::Collections::IObservableVector<XamlUICommand::NodeViewModel> m_nodes{ mvvm::make_range_observable_vector<XamlUICommand::NodeViewModel>() };
+        Windows::Foundation::Collections::IObservableVector<XamlUICommand::EdgeViewModel> m_edges{ mvvm::make_range_observable_vector<XamlUICommand::EdgeViewModel>() };
         XamlUICommand::NodeViewModel m_selected{ nullptr };
         XamlUICommand::NodeShape m_defaultShape{ XamlUICommand::NodeShape::Circle };
         hstring m_defaultTipKey{};
@@ -128,6 +319,71 @@ namespace winrt::XamlUICommand::implementation
         // Map nodeId -> container element (Grid) for quick update
         std::unordered_map<int64_t, Microsoft::UI::Xaml::FrameworkElement> m_nodeElements;
 
+        nodegraph::GraphIndex<NodeEntry, EdgeEntry> m_graph;
+        nodegraph::QuadTree m_spatial;              // key: node slot
+        std::vector<uint32_t> m_nodeOrder;          // m_nodes[i] -> node slot
+        std::vector<uint32_t> m_edgeOrder;          // m_edges[i] -> edge slot
+        std::vector<Microsoft::UI::Xaml::Shapes::Line> m_edgeLines;    // edge slot -> line (nullptr if not realized)
+        Microsoft::UI::Xaml::Media::Brush m_defaultEdgeBrush{ nullptr };
+        Microsoft::UI::Xaml::Media::Brush m_defaultHighlightBrush{ nullptr };
+        std::optional<InnerAppearance> m_appearance;    // 见 Appearance()
+        Microsoft::UI::Xaml::ElementTheme m_appearanceTheme{ Microsoft::UI::Xaml::ElementTheme::Default };
+        EdgeRenderStats m_edgeStats{};
+
+        XamlUICommand::NodeGraphRenderMode m_renderMode{ XamlUICommand::NodeGraphRenderMode::Elements };
+        nodegraph::DisplayList m_displayList;
+        BatchAppearance m_batchAppearance{};
+        BatchPaths m_batchPaths;
+        bool m_batchFlushPending{ false };
+        winrt::event_token m_canvasTappedToken{};
+
+        static constexpr size_t MaxPooledElements = 256;    // 每个回收池保留的隐藏元素上限
+        bool m_virtualizing{ true };
+        double m_realizationMargin{ 256.0 };
+        bool m_hasViewport{ false };
+        Windows::Foundation::Rect m_viewport{};
+        nodegraph::Box m_realizedArea{ nodegraph::Box::Empty() };  // 上次实现所用区域（视口 + 边距）
+        nodegraph::QuadTree m_edgeSpatial;                  // key: edge slot, 线段包围盒
+        std::vector<uint32_t> m_realizedEdges;              // 已实现的边槽位（可能含已回收的陈旧项）
+        std::vector<uint32_t> m_nodeStamp;                  // node slot -> 最近一次命中的实现轮次
+        std::vector<uint32_t> m_edgeStamp;                  // edge slot -> 最近一次命中的实现轮次
+        uint32_t m_realizePass{ 0 };
+        std::array<std::vector<Microsoft::UI::Xaml::Controls::Grid>, 2> m_nodePool;   // [0] Circle, [1] RoundedRect
+        std::vector<Microsoft::UI::Xaml::Shapes::Line> m_linePool;
+        winrt::event_token m_viewportToken{};
+
+        nodegraph::ClusterHierarchy m_lod;                  // key: node slot / edge slot
+        nodegraph::LodThresholds m_lodThresholds{};
+        nodegraph::DetailLevel m_detailLevel{ nodegraph::DetailLevel::Full };
+        bool m_lodEnabled{ true };
+        float m_zoom{ 1.0f };                               // 画布到窗口根的缩放
+        nodegraph::DisplayList m_overview;                  // Points / Clusters 层次的概览几何
+        BatchPaths m_overviewPaths;
+        nodegraph::Box m_overviewArea{ nodegraph::Box::Empty() };
+        bool m_overviewDirty{ false };
+
+        std::unique_ptr<nodegraph::LayoutWorker> m_layout;  // StartLayout 至 StopLayout 之间存在
+        nodegraph::ForceLayout::Settings m_layoutSettings{};
+        std::vector<nodegraph::LayoutWorker::Placement> m_placements;
+        uint32_t m_layoutStamp{ 0 };
+        bool m_applyingLayout{ false };                     // 写回布局位置期间不把 Position 变化回送给布局
+
+        nodegraph::LayeredLayout::Settings m_layeredSettings{};
+        std::shared_ptr<nodegraph::LayeredResult const> m_layeredResult;   // 上次分层结果，增量重排的初值
+        std::stop_source m_layeredStop{ std::nostopstate };                 // 进行中的分层布局
+        bool m_relayoutOnChange{ false };
+        bool m_relayoutPending{ false };
+
+        nodegraph::GraphQuery m_query;                      // key: edge slot -> 端点的 node slot
+        std::stop_source m_highlightStop{ std::nostopstate };               // 进行中的高亮查询
+        std::vector<XamlUICommand::NodeViewModel> m_highlightedNodes;
+        std::vector<XamlUICommand::EdgeViewModel> m_highlightedEdges;
+
+        uint32_t m_updateDepth{ 0 };                        // BeginUpdate 嵌套层数
+        bool m_rebuildNodes{ false };                       // 批量期间出现了追加以外的节点集合变化
+        bool m_rebuildEdges{ false };
+        std::stop_source m_loadStop{ std::nostopstate };    // 进行中的 LoadGraphFileAsync
+
         static Microsoft::UI::Xaml::DependencyProperty s_NodeFillProperty;
         static Microsoft::UI::Xaml::DependencyProperty s_NodeStrokeProperty;
         static Microsoft::UI::Xaml::DependencyProperty s_NodeTextBrushProperty;
@@ -136,6 +392,7 @@ namespace winrt::XamlUICommand::implementation
         static Microsoft::UI::Xaml::DependencyProperty s_NodeCornerRadiusProperty;
         static Microsoft::UI::Xaml::DependencyProperty s_AutoContrastProperty;
         static Microsoft::UI::Xaml::DependencyProperty s_ContrastThresholdProperty;
+        static Microsoft::UI::Xaml::DependencyProperty s_HighlightBrushProperty;
     };
 }
 
@@ -1,5 +1,301 @@
-#include "pch.h"
+﻿#include "pch.h"
 #include "NodeViewModel.h"
 #if __has_include("NodeViewModel.g.cpp")
 #include "NodeViewModel.g.cpp"
-#endif
\ No newline at end of file
+#endif
+
+using namespace winrt;
+using namespace Windows::Foundation;
+using namespace Windows::Foundation::Collections;
+
+namespace winrt::XamlUICommand::implementation
+{
+    namespace
+    {
+        using Store = NodeMetaTable::Store;
+
+        // 被覆盖或删除的对象值先复制出来、到锁外再释放：
+        // 对象的最后一次释放可能正是另一个节点视图模型，它的析构会再次进入元数据表
+        IInspectable TakeObject(Store const& store, uint32_t row, uint32_t column)
+        {
+            return store.Kind(row, column) == nodegraph::MetaKind::Object ? store.ObjectAt(row, column) : nullptr;
+        }
+
+        void ClearRow(Store& store, uint32_t row, std::vector<IInspectable>& released)
+        {
+            store.ForEach(row, [&](uint32_t column)
+                {
+                    if (auto object = TakeObject(store, row, column)) released.push_back(std::move(object));
+                });
+            store.ClearRow(row);
+        }
+    }
+
+#pragma region NodeMetaTable
+    NodeMetaTable& NodeMetaTable::Shared()
+    {
+        // 有意不析构：进程退出时仍可能有视图模型在归还行
+        static auto* table = new NodeMetaTable();
+        return *table;
+    }
+
+    IInspectable NodeMetaTable::Box(Store const& store, uint32_t row, uint32_t column)
+    {
+        switch (store.Kind(row, column))
+        {
+        case nodegraph::MetaKind::Int64:  return box_value(store.Int(row, column));
+        case nodegraph::MetaKind::Double: return box_value(store.Double(row, column));
+        case nodegraph::MetaKind::Bool:   return box_value(store.Bool(row, column));
+        case nodegraph::MetaKind::Text:   return box_value(store.TextAt(row, column));
+        case nodegraph::MetaKind::Object: return store.ObjectAt(row, column);
+        default:                          return nullptr;
+        }
+    }
+
+    void NodeMetaTable::Assign(Store& store, uint32_t row, uint32_t column, IInspectable const& value)
+    {
+        // 只拆开与 Box 能原样还原的类型，Int32 等仍按对象保存，unbox_value 的类型不会变
+        if (auto property = value ? value.try_as<IPropertyValue>() : nullptr)
+        {
+            switch (property.Type())
+            {
+            case PropertyType::String:  store.SetText(row, column, property.GetString()); return;
+            case PropertyType::Int64:   store.SetInt(row, column, property.GetInt64()); return;
+            case PropertyType::Double:  store.SetDouble(row, column, property.GetDouble()); return;
+            case PropertyType::Boolean: store.SetBool(row, column, property.GetBoolean()); return;
+            default: break;
+            }
+        }
+        store.SetObject(row, column, value);
+    }
+
+    hstring NodeMetaTable::Format(Store const& store, uint32_t row, uint32_t column)
+    {
+        // 对象值由调用方取出后在锁外格式化（见 Format(IInspectable)）
+        switch (store.Kind(row, column))
+        {
+        case nodegraph::MetaKind::Int64:  return hstring{ std::format(L"{}", store.Int(row, column)) };
+        case nodegraph::MetaKind::Double: return hstring{ std::format(L"{}", store.Double(row, column)) };
+        case nodegraph::MetaKind::Bool:   return store.Bool(row, column) ? L"true" : L"false";
+        case nodegraph::MetaKind::Text:   return store.TextAt(row, column);
+        default:                          return {};
+        }
+    }
+
+    hstring NodeMetaTable::Format(IInspectable const& value)
+    {
+        if (!value)
+            return {};
+        if (auto property = value.try_as<IPropertyValue>())
+        {
+            switch (property.Type())
+            {
+            case PropertyType::String:  return property.GetString();
+            case PropertyType::UInt8:   return hstring{ std::format(L"{}", property.GetUInt8()) };
+            case PropertyType::Int16:   return hstring{ std::format(L"{}", property.GetInt16()) };
+            case PropertyType::UInt16:  return hstring{ std::format(L"{}", property.GetUInt16()) };
+            case PropertyType::Int32:   return hstring{ std::format(L"{}", property.GetInt32()) };
+            case PropertyType::UInt32:  return hstring{ std::format(L"{}", property.GetUInt32()) };
+            case PropertyType::Int64:   return hstring{ std::format(L"{}", property.GetInt64()) };
+            case PropertyType::UInt64:  return hstring{ std::format(L"{}", property.GetUInt64()) };
+            case PropertyType::Single:  return hstring{ std::format(L"{}", property.GetSingle()) };
+            case PropertyType::Double:  return hstring{ std::format(L"{}", property.GetDouble()) };
+            case PropertyType::Boolean: return property.GetBoolean() ? L"true" : L"false";
+            default: break;
+            }
+        }
+        if (auto stringable = value.try_as<IStringable>())
+            return stringable.ToString();
+        return {};
+    }
+
+    NodeMetaRow::NodeMetaRow()
+        : row{ NodeMetaTable::Shared().Write([](Store& store) { return store.AllocateRow(); }) }
+    {
+    }
+
+    NodeMetaRow::~NodeMetaRow()
+    {
+        std::vector<IInspectable> released;
+        NodeMetaTable::Shared().Write([&](Store& store)
+            {
+                ClearRow(store, row, released);
+                store.FreeRow(row);
+            });
+    }
+#pragma endregion
+
+#pragma region NodeMetaView
+    IInspectable NodeMetaView::Lookup(hstring const& key) const
+    {
+        auto value = NodeMetaTable::Shared().Read([&](Store const& store) -> std::optional<IInspectable>
+            {
+                uint32_t column = store.FindColumn(key);
+                if (store.Kind(m_row->row, column) == nodegraph::MetaKind::Empty) return std::nullopt;
+                return NodeMetaTable::Box(store, m_row->row, column);
+            });
+        if (!value)
+            throw hresult_out_of_bounds();
+        return *value;
+    }
+
+    uint32_t NodeMetaView::Size() const
+    {
+        return NodeMetaTable::Shared().Read([&](Store const& store) { return store.Count(m_row->row); });
+    }
+
+    bool NodeMetaView::HasKey(hstring const& key) const
+    {
+        return NodeMetaTable::Shared().Read([&](Store const& store)
+            {
+                return store.Kind(m_row->row, store.FindColumn(key)) != nodegraph::MetaKind::Empty;
+            });
+    }
+
+    IMapView<hstring, IInspectable> NodeMetaView::GetView() const
+    {
+        return Snapshot().GetView();
+    }
+
+    bool NodeMetaView::Insert(hstring const& key, IInspectable const& value)
+    {
+        IInspectable previous;
+        return NodeMetaTable::Shared().Write([&](Store& store)
+            {
+                uint32_t column = store.Column(key);
+                bool replaced = store.Kind(m_row->row, column) != nodegraph::MetaKind::Empty;
+                previous = TakeObject(store, m_row->row, column);
+                NodeMetaTable::Assign(store, m_row->row, column, value);
+                return replaced;
+            });
+    }
+
+    void NodeMetaView::Remove(hstring const& key)
+    {
+        IInspectable previous;
+        bool removed = NodeMetaTable::Shared().Write([&](Store& store)
+            {
+                uint32_t column = store.FindColumn(key);
+                previous = TakeObject(store, m_row->row, column);
+                return store.Remove(m_row->row, column);
+            });
+        if (!removed)
+            throw hresult_out_of_bounds();
+    }
+
+    void NodeMetaView::Clear()
+    {
+        std::vector<IInspectable> released;
+        NodeMetaTable::Shared().Write([&](Store& store) { ClearRow(store, m_row->row, released); });
+    }
+
+    IIterator<IKeyValuePair<hstring, IInspectable>> NodeMetaView::First() const
+    {
+        return Snapshot().First();
+    }
+
+    IMap<hstring, IInspectable> NodeMetaView::Snapshot() const
+    {
+        std::map<hstring, IInspectable> entries;
+        NodeMetaTable::Shared().Read([&](Store const& store)
+            {
+                store.ForEach(m_row->row, [&](uint32_t column)
+                    {
+                        entries.emplace(hstring{ store.Key(column) }, NodeMetaTable::Box(store, m_row->row, column));
+                    });
+            });
+        return single_threaded_map<hstring, IInspectable>(std::move(entries));
+    }
+#pragma endregion
+
+#pragma region NodeViewModel_Meta
+    IMap<hstring, IInspectable> NodeViewModel::Meta() const
+    {
+        if (m_externalMeta)
+            return m_externalMeta;
+        if (!m_metaView)
+        {
+            EnsureMetaRow();
+            m_metaView = winrt::make<NodeMetaView>(m_metaRow);
+        }
+        return m_metaView;
+    }
+
+    void NodeViewModel::Meta(IMap<hstring, IInspectable> const& value)
+    {
+        if (value && (value == m_metaView || value == m_externalMeta))
+            return;
+
+        // 设为空：回到清空后的列式存储；设为外部 IMap：此后读写都委托给它
+        m_externalMeta = value;
+        if (m_metaRow)
+        {
+            std::vector<IInspectable> released;
+            NodeMetaTable::Shared().Write([&](Store& store) { ClearRow(store, m_metaRow->row, released); });
+        }
+        Raise(L"Meta");
+    }
+
+    std::optional<hstring> NodeViewModel::MetaText(std::wstring_view key) const
+    {
+        if (m_externalMeta)
+        {
+            hstring name{ key };
+            if (!m_externalMeta.HasKey(name))
+                return std::nullopt;
+            return NodeMetaTable::Format(m_externalMeta.Lookup(name));
+        }
+        if (!m_metaRow)
+            return std::nullopt;
+
+        // 一次列查找 + 按行取值；对象值带出锁外再格式化
+        IInspectable object;
+        auto text = NodeMetaTable::Shared().Read([&](Store const& store) -> std::optional<hstring>
+            {
+                uint32_t column = store.FindColumn(key);
+                auto kind = store.Kind(m_metaRow->row, column);
+                if (kind == nodegraph::MetaKind::Empty) return std::nullopt;
+                if (kind == nodegraph::MetaKind::Object) object = store.ObjectAt(m_metaRow->row, column);
+                return NodeMetaTable::Format(store, m_metaRow->row, column);
+            });
+        if (object)
+            return NodeMetaTable::Format(object);
+        return text;
+    }
+
+    std::vector<std::pair<hstring, hstring>> NodeViewModel::MetaEntries() const
+    {
+        std::vector<std::pair<hstring, hstring>> entries;
+        if (m_externalMeta)
+        {
+            for (auto const& kvp : m_externalMeta)
+                entries.emplace_back(kvp.Key(), kvp.Value() ? NodeMetaTable::Format(kvp.Value()) : hstring{ L"<null>" });
+        }
+        else if (m_metaRow)
+        {
+            std::vector<std::pair<size_t, IInspectable>> objects;
+            NodeMetaTable::Shared().Read([&](Store const& store)
+                {
+                    uint32_t const row = m_metaRow->row;
+                    store.ForEach(row, [&](uint32_t column)
+                        {
+                            if (store.Kind(row, column) == nodegraph::MetaKind::Object)
+                                objects.emplace_back(entries.size(), store.ObjectAt(row, column));
+                            entries.emplace_back(hstring{ store.Key(column) }, NodeMetaTable::Format(store, row, column));
+                        });
+                });
+            for (auto const& [index, object] : objects)
+                entries[index].second = object ? NodeMetaTable::Format(object) : hstring{ L"<null>" };
+        }
+        std::sort(entries.begin(), entries.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+        return entries;
+    }
+
+    uint32_t NodeViewModel::EnsureMetaRow() const
+    {
+        if (!m_metaRow)
+            m_metaRow = std::make_shared<NodeMetaRow>();
+        return m_metaRow->row;
+    }
+#pragma endregion
+}
@@ -1,8 +1,80 @@
 #pragma once
 #include "NodeViewModel.g.h"
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+#include "NodeGraph/MetaStore.h"
 
 namespace winrt::XamlUICommand::implementation
 {
+    // 所有节点共享的列式元数据表（见 NodeGraph/MetaStore.h）。视图模型可能在后台线程创建并填充
+    // （LoadGraphFileAsync），因此读写都在读写锁内完成；节点只持有行号，Meta 属性是按需创建的 IMap 视图。
+    class NodeMetaTable
+    {
+    public:
+        using Store = nodegraph::MetaStore<hstring, Windows::Foundation::IInspectable>;
+
+        static NodeMetaTable& Shared();
+
+        template <typename F>
+        decltype(auto) Read(F&& f) const
+        {
+            std::shared_lock lock{ m_lock };
+            return f(m_store);
+        }
+
+        template <typename F>
+        decltype(auto) Write(F&& f)
+        {
+            std::unique_lock lock{ m_lock };
+            return f(m_store);
+        }
+
+        // 装箱只发生在 IMap 视图上：String / Int64 / Double / Boolean 拆成列内的类型化值，其余对象原样保存
+        static Windows::Foundation::IInspectable Box(Store const& store, uint32_t row, uint32_t column);
+        static void Assign(Store& store, uint32_t row, uint32_t column, Windows::Foundation::IInspectable const& value);
+        // 标签、提示与详情使用的文本形式
+        static hstring Format(Store const& store, uint32_t row, uint32_t column);
+        static hstring Format(Windows::Foundation::IInspectable const& value);
+
+    private:
+        mutable std::shared_mutex m_lock;
+        Store m_store;
+    };
+
+    // 一行的所有权：节点与它的 IMap 视图共同持有，最后一个释放时把行还给表
+    struct NodeMetaRow
+    {
+        NodeMetaRow();
+        ~NodeMetaRow();
+        NodeMetaRow(NodeMetaRow const&) = delete;
+        NodeMetaRow& operator=(NodeMetaRow const&) = delete;
+
+        uint32_t const row;
+    };
+
+    // Meta 的 IMap 实现：直接读写列式表中的一行；枚举与 GetView 返回按键排序的快照
+    struct NodeMetaView : winrt::implements<NodeMetaView, Windows::Foundation::Collections::IMap<hstring, Windows::Foundation::IInspectable>>
+    {
+        explicit NodeMetaView(std::shared_ptr<NodeMetaRow> row) noexcept : m_row{ std::move(row) } {}
+
+        Windows::Foundation::IInspectable Lookup(hstring const& key) const;
+        uint32_t Size() const;
+        bool HasKey(hstring const& key) const;
+        Windows::Foundation::Collections::IMapView<hstring, Windows::Foundation::IInspectable> GetView() const;
+        bool Insert(hstring const& key, Windows::Foundation::IInspectable const& value);
+        void Remove(hstring const& key);
+        void Clear();
+        Windows::Foundation::Collections::IIterator<Windows::Foundation::Collections::IKeyValuePair<hstring, Windows::Foundation::IInspectable>> First() const;
+
+    private:
+        Windows::Foundation::Collections::IMap<hstring, Windows::Foundation::IInspectable> Snapshot() const;
+
+        std::shared_ptr<NodeMetaRow> m_row;
+    };
+
     struct NodeViewModel : NodeViewModelT<NodeViewModel>
     {
         NodeViewModel() = default;
@@ -22,14 +94,14 @@ namespace winrt::XamlUICommand::implementation
         bool IsSelected() const noexcept { return m_selected; }
         void IsSelected(bool value) { if (m_selected != value) { m_selected = value; Raise(L"IsSelected"); } }
 
+        bool IsHighlighted() const noexcept { return m_highlighted; }
+        void IsHighlighted(bool value) { if (m_highlighted != value) { m_highlighted = value; Raise(L"IsHighlighted"); } }
+
         XamlUICommand::NodeShape Shape() const noexcept { return m_shape; }
         void Shape(XamlUICommand::NodeShape value) { if (m_shape != value) { m_shape = value; Raise(L"Shape"); } }
 
-        Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> Meta() const noexcept { return m_meta; }
-        void Meta(Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> const& value)
-        {
-            if (m_meta != value) { m_meta = value; Raise(L"Meta"); }
-        }
+        Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> Meta() const;
+        void Meta(Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> const& value);
 
         hstring LabelMetaKey() const noexcept { return m_labelKey; }
         void LabelMetaKey(hstring const& v) { if (m_labelKey != v) { m_labelKey = v; Raise(L"LabelMetaKey"); } }
@@ -37,6 +109,12 @@ namespace winrt::XamlUICommand::implementation
         hstring TooltipMetaKey() const noexcept { return m_tipKey; }
         void TooltipMetaKey(hstring const& v) { if (m_tipKey != v) { m_tipKey = v; Raise(L"TooltipMetaKey"); } }
 
+        // 面板使用的快速路径：不经过 IMap 与装箱。MetaText 在键不存在时返回空；
+        // MetaEntries 按键排序；EnsureMetaRow 供批量写入（见 NodeMetaTable::Write）先分配好行
+        std::optional<hstring> MetaText(std::wstring_view key) const;
+        std::vector<std::pair<hstring, hstring>> MetaEntries() const;
+        uint32_t EnsureMetaRow() const;
+
         // INotifyPropertyChanged
         winrt::event<Microsoft::UI::Xaml::Data::PropertyChangedEventHandler> m_propertyChanged;
         winrt::event_token PropertyChanged(Microsoft::UI::Xaml::Data::PropertyChangedEventHandler const& handler)
@@ -59,8 +137,13 @@ namespace winrt::XamlUICommand::implementation
         Windows::Foundation::Point m_pos{ 0, 0 };
         Windows::Foundation::Size m_size{ 64, 64 };
         bool m_selected{};
+        bool m_highlighted{};
         XamlUICommand::NodeShape m_shape{ XamlUICommand::NodeShape::Circle };
-        Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> m_meta{ winrt::single_threaded_map<hstring, winrt::Windows::Foundation::IInspectable>() };
+        // 元数据默认存放在共享列式表的一行中（首次写入或访问 Meta 时分配）；
+        // 若外部通过 Meta 属性设置了自己的 IMap，则按原样委托给它
+        mutable std::shared_ptr<NodeMetaRow> m_metaRow;
+        mutable Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> m_metaView{ nullptr };
+        Windows::Foundation::Collections::IMap<hstring, winrt::Windows::Foundation::IInspectable> m_externalMeta{ nullptr };
         hstring m_labelKey{};
         hstring m_tipKey{};
     };
@@ -27,8 +27,9 @@ namespace winrt::XamlUICommand::implementation
 
     void NodeGraphPage::BuildSample()
     {
-        auto nodes = single_threaded_observable_vector<XamlUICommand::NodeViewModel>();
-        auto edges = single_threaded_observable_vector<XamlUICommand::EdgeViewModel>();
+        // 支持批量/差异更新的集合，大批量变更只触发一次 Reset
+        auto nodes = mvvm::make_range_observable_vector<XamlUICommand::NodeViewModel>();
+        auto edges = mvvm::make_range_observable_vector<XamlUICommand::EdgeViewModel>();
         Graph().Nodes(nodes);
         Graph().Edges(edges);
 
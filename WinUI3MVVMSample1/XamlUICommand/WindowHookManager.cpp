@@ -2,6 +2,8 @@
 #include "WindowHookManager.h"
 #include <winternl.h>
 
+#include "../WinUI3MVVMSample1/mvvm_framework/mvvm_diagnostics.h"
+
 // 静态成员初始化
 WindowHookManager::WindowEventCallback WindowHookManager::s_windowCallback;
 WindowHookManager::ErrorCallback WindowHookManager::s_errorCallback;
@@ -96,7 +98,7 @@ void WindowHookManager::InstallMainThreadHook() {
         return;
     }
     if (s_debugEnabled) {
-        OutputDebugStringW(L"Main thread hook installed\n");
+        MVVM_LOGS(WindowHooks, Info, L"Main thread hook installed");
     }
 }
 
@@ -108,9 +110,7 @@ void WindowHookManager::InstallThreadHook() {
         std::lock_guard<std::mutex> lock(s_dataMutex);
         if (s_threadHooks.find(threadId) != s_threadHooks.end()) {
             if (s_debugEnabled) {
-                std::wstringstream ss;
-                ss << L"Hook already installed for thread " << threadId << L"\n";
-                OutputDebugStringW(ss.str().c_str());
+                MVVM_LOGS(WindowHooks, Info, L"Hook already installed for thread {}", threadId);
             }
             return;
         }
@@ -133,9 +133,7 @@ void WindowHookManager::InstallThreadHook() {
     }
 
     if (s_debugEnabled) {
-        std::wstringstream ss;
-        ss << L"Hook installed for thread " << threadId << L"\n";
-        OutputDebugStringW(ss.str().c_str());
+        MVVM_LOGS(WindowHooks, Info, L"Hook installed for thread {}", threadId);
     }
 }
 
@@ -293,10 +291,9 @@ void WindowHookManager::TrackWindow(HWND hwnd, bool created) {
         }
 
         ss << L", Visible=" << (info.isVisible ? L"true" : L"false")
-            << L", TopLevel=" << (info.isTopLevel ? L"true" : L"false")
-            << L"\n";
+            << L", TopLevel=" << (info.isTopLevel ? L"true" : L"false");
 
-        OutputDebugStringW(ss.str().c_str());
+        MVVM_LOGS(WindowHooks, Info, ss.str());
     }
 }
 
@@ -310,15 +307,8 @@ void WindowHookManager::LogError(const std::wstring& message) const {
         s_errorCallback(message);
     }
 
-    if (s_debugEnabled) {
-        SYSTEMTIME st;
-        GetLocalTime(&st);
-        wchar_t timestamp[64];
-        swprintf_s(timestamp, L"[%02d:%02d:%02d.%03d] ",
-            st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
-
-        OutputDebugStringW((timestamp + std::wstring(L"ERROR: ") + message + L"\n").c_str());
-    }
+    // 错误不受调试开关限制；时间戳、位置由日志后端添加，可用 SetLogThreshold(LogSubsystem::WindowHooks, ...) 过滤
+    MVVM_LOGS(WindowHooks, Error, message);
 }
 
 std::vector<WindowHookManager::WindowInfo> WindowHookManager::GetTrackedWindows() const {
@@ -53,6 +53,14 @@
 #include "Mvvm/Framework/Core/ObservableString.g.cpp"
 #endif
 
+#if __has_include("Mvvm/Framework/Core/ObservableSlot.g.cpp")
+#include "Mvvm/Framework/Core/ObservableSlot.g.cpp"
+#endif
+
+#if __has_include("Mvvm/Framework/Core/ObservablePropertyStore.g.cpp")
+#include "Mvvm/Framework/Core/ObservablePropertyStore.g.cpp"
+#endif
+
 namespace winrt::Mvvm::Framework::Core::implementation
 {
     // 模板基类已在头文件中实现，这里不需要额外方法实现
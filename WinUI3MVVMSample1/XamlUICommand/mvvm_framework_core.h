@@ -16,28 +16,151 @@
 #include "Mvvm/Framework/Core/ObservableDouble.g.h"
 #include "Mvvm/Framework/Core/ObservableChar16.g.h"
 #include "Mvvm/Framework/Core/ObservableString.g.h"
+#include "Mvvm/Framework/Core/ObservableSlot.g.h"
+#include "Mvvm/Framework/Core/ObservablePropertyStore.g.h"
+
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "mvvm_reactive.h"
+#include "mvvm_slot_columns.h"
 
 namespace winrt::Mvvm::Framework::Core::implementation
 {
+    // IObservablePropertyBase 的公共实现：IObservableProperty.ValueChanged 事件与 IObservable 订阅。
+    // 没有 WinRT 监听者时不装箱。BoxedValue 由派生类提供。
     struct ObservablePropertyBase
     {
         bool IsObservable() { return true; }
+
+        winrt::event_token ValueChanged(Windows::Foundation::TypedEventHandler<XamlUICommand::IObservableProperty, Windows::Foundation::IInspectable> const& handler)
+        {
+            return m_valueChanged.add(handler);
+        }
+        void ValueChanged(winrt::event_token const& token) noexcept
+        {
+            m_valueChanged.remove(token);
+        }
+
+        Windows::Foundation::IClosable Subscribe(XamlUICommand::IObserver const& observer)
+        {
+            return winrt::make<ObserverSubscription>(m_boxedChanges.Connect(ObserverSink{ observer }));
+        }
+
+    protected:
+        bool HasValueListeners() const noexcept { return m_valueChanged || m_boxedChanges.HasObservers(); }
+
+        template <typename V>
+        static Windows::Foundation::IInspectable Box(V const& value)
+        {
+            if constexpr (std::is_same_v<V, wchar_t>)
+                return winrt::box_value(static_cast<char16_t>(value)); // WinRT 的 Char16
+            else
+                return winrt::box_value(value);
+        }
+
+        template <typename V>
+        static V Unbox(Windows::Foundation::IInspectable const& value)
+        {
+            if constexpr (std::is_same_v<V, wchar_t>)
+                return static_cast<wchar_t>(winrt::unbox_value<char16_t>(value));
+            else
+                return winrt::unbox_value<V>(value);
+        }
+
+        template <typename Sender, typename V>
+        void PublishValue(Sender const& sender, V const& value)
+        {
+            if (!HasValueListeners())
+                return;
+
+            auto boxed = Box(value);
+            m_valueChanged(sender, boxed);
+            m_boxedChanges.OnNext(boxed);
+        }
+
+        // 已装箱的值（ObservableSlot 从仓库取出的值）
+        template <typename Sender>
+        void PublishBoxed(Sender const& sender, Windows::Foundation::IInspectable const& boxed)
+        {
+            m_valueChanged(sender, boxed);
+            m_boxedChanges.OnNext(boxed);
+        }
+
+    private:
+        struct ObserverSink
+        {
+            XamlUICommand::IObserver observer;
+
+            void OnNext(Windows::Foundation::IInspectable const& value) { observer.OnNext(value); }
+            void OnError(std::exception_ptr error)
+            {
+                try { std::rethrow_exception(error); }
+                catch (winrt::hresult_error const& e) { observer.OnError(winrt::box_value(e.message())); }
+                catch (std::exception const& e) { observer.OnError(winrt::box_value(winrt::to_hstring(e.what()))); }
+                catch (...) { observer.OnError(nullptr); }
+            }
+            void OnCompleted() { observer.OnCompleted(); }
+        };
+
+        struct ObserverSubscription : winrt::implements<ObserverSubscription, Windows::Foundation::IClosable>
+        {
+            explicit ObserverSubscription(::mvvm::rx::Subscription&& subscription) : m_subscription(std::move(subscription)) {}
+            void Close() { m_subscription.Dispose(); }
+
+            ::mvvm::rx::Subscription m_subscription;
+        };
+
+        winrt::event<Windows::Foundation::TypedEventHandler<XamlUICommand::IObservableProperty, Windows::Foundation::IInspectable>> m_valueChanged;
+        ::mvvm::rx::Subject<Windows::Foundation::IInspectable> m_boxedChanges;
     };
 
-    template <typename T>
-    struct ObservableBaseT : ObservablePropertyBase
+    // 带强类型变化流的值存储。Changes() 可直接作为 mvvm::rx 管道的数据源：
+    //   auto sub = mvvm::rx::From(impl.Changes()) | mvvm::rx::Map(...) | mvvm::rx::Subscribe(...);
+    template <typename D, typename T>
+    struct ObservableValue : ObservablePropertyBase
     {
-        ObservableBaseT() = default;
-        ObservableBaseT(T const& value) : m_value(value) {}
+        ObservableValue() = default;
+        ObservableValue(T const& value) : m_value(value) {}
 
-        T Value() const { return m_value; }
-        void Value(T const& value) { m_value = value; }
+        ::mvvm::rx::Subject<T>& Changes() noexcept { return m_changes; }
+
+        // IObservableProperty
+        Windows::Foundation::IInspectable BoxedValue() const { return Box(m_value); }
+        void BoxedValue(Windows::Foundation::IInspectable const& value) { SetValue(Unbox<T>(value)); }
+
+    protected:
+        T const& GetValue() const noexcept { return m_value; }
+
+        // 值未变化时不通知
+        bool SetValue(T const& value)
+        {
+            if (m_value == value)
+                return false;
+
+            m_value = value;
+            m_changes.OnNext(m_value);
+            PublishValue(static_cast<D const&>(*this), m_value);
+            return true;
+        }
 
     private:
         T m_value{};
+        ::mvvm::rx::Subject<T> m_changes;
+    };
+
+    template <typename D, typename T>
+    struct ObservableBaseT : ObservableValue<D, T>
+    {
+        ObservableBaseT() = default;
+        ObservableBaseT(T const& value) : ObservableValue<D, T>(value) {}
+
+        T Value() const { return this->GetValue(); }
+        void Value(T const& value) { this->SetValue(value); }
     };
 
-    struct ObservableBoolean : ObservableBooleanT<ObservableBoolean>, ObservableBaseT<bool>
+    struct ObservableBoolean : ObservableBooleanT<ObservableBoolean>, ObservableBaseT<ObservableBoolean, bool>
     {
         // 在 C++11 中，引入了构造函数继承的特性，允许派生类通过简单的声明来继承基类的构造函数。
         // 这一特性主要解决了在继承体系中，派生类需要显式调用基类构造函数以完成初始化的问题。
@@ -46,76 +169,255 @@ namespace winrt::Mvvm::Framework::Core::implementation
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableByte : ObservableByteT<ObservableByte>, ObservableBaseT<uint8_t>
+    struct ObservableByte : ObservableByteT<ObservableByte>, ObservableBaseT<ObservableByte, uint8_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableInt8 : ObservableInt8T<ObservableInt8>, ObservablePropertyBase
+    struct ObservableInt8 : ObservableInt8T<ObservableInt8>, ObservableValue<ObservableInt8, uint8_t>
     {
         ObservableInt8() = default;
-        ObservableInt8(int8_t v) : m_value(static_cast<uint8_t>(v)) {}
-
-        uint8_t RawValue() const { return m_value; }
-        void RawValue(uint8_t v) { m_value = v; }
-        int32_t SignedValue() const { return static_cast<int8_t>(m_value); }
+        ObservableInt8(int8_t v) : ObservableValue(static_cast<uint8_t>(v)) {}
 
-        int8_t ValueSigned() const { return static_cast<int8_t>(m_value); }
-        void ValueSigned(int8_t v) { m_value = static_cast<uint8_t>(v); }
+        uint8_t RawValue() const { return GetValue(); }
+        void RawValue(uint8_t v) { SetValue(v); }
+        int32_t SignedValue() const { return static_cast<int8_t>(GetValue()); }
 
-    private:
-        uint8_t m_value{};
+        int8_t ValueSigned() const { return static_cast<int8_t>(GetValue()); }
+        void ValueSigned(int8_t v) { SetValue(static_cast<uint8_t>(v)); }
     };
 
-    struct ObservableInt16 : ObservableInt16T<ObservableInt16>, ObservableBaseT<int16_t>
+    struct ObservableInt16 : ObservableInt16T<ObservableInt16>, ObservableBaseT<ObservableInt16, int16_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableUInt16 : ObservableUInt16T<ObservableUInt16>, ObservableBaseT<uint16_t>
+    struct ObservableUInt16 : ObservableUInt16T<ObservableUInt16>, ObservableBaseT<ObservableUInt16, uint16_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableInt32 : ObservableInt32T<ObservableInt32>, ObservableBaseT<int32_t>
+    struct ObservableInt32 : ObservableInt32T<ObservableInt32>, ObservableBaseT<ObservableInt32, int32_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableUInt32 : ObservableUInt32T<ObservableUInt32>, ObservableBaseT<uint32_t>
+    struct ObservableUInt32 : ObservableUInt32T<ObservableUInt32>, ObservableBaseT<ObservableUInt32, uint32_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableInt64 : ObservableInt64T<ObservableInt64>, ObservableBaseT<int64_t>
+    struct ObservableInt64 : ObservableInt64T<ObservableInt64>, ObservableBaseT<ObservableInt64, int64_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableUInt64 : ObservableUInt64T<ObservableUInt64>, ObservableBaseT<uint64_t>
+    struct ObservableUInt64 : ObservableUInt64T<ObservableUInt64>, ObservableBaseT<ObservableUInt64, uint64_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableSingle : ObservableSingleT<ObservableSingle>, ObservableBaseT<float>
+    struct ObservableSingle : ObservableSingleT<ObservableSingle>, ObservableBaseT<ObservableSingle, float>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableDouble : ObservableDoubleT<ObservableDouble>, ObservableBaseT<double>
+    struct ObservableDouble : ObservableDoubleT<ObservableDouble>, ObservableBaseT<ObservableDouble, double>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableChar16 : ObservableChar16T<ObservableChar16>, ObservableBaseT<wchar_t>
+    struct ObservableChar16 : ObservableChar16T<ObservableChar16>, ObservableBaseT<ObservableChar16, wchar_t>
     {
         using ObservableBaseT::ObservableBaseT;
     };
 
-    struct ObservableString : ObservableStringT<ObservableString>, ObservableBaseT<hstring>
+    struct ObservableString : ObservableStringT<ObservableString>, ObservableBaseT<ObservableString, hstring>
     {
         using ObservableBaseT::ObservableBaseT;
     };
+
+    using ::mvvm::SlotKind;
+
+    struct ObservableSlot : ObservableSlotT<ObservableSlot>, ObservablePropertyBase
+    {
+        ObservableSlot(Core::ObservablePropertyStore const& store, uint32_t handle) : m_store(store), m_handle(handle) {}
+
+        uint32_t Handle() const noexcept { return m_handle; }
+
+        winrt::Windows::Foundation::IInspectable Value() const { return m_store.GetValue(m_handle); }
+        void Value(winrt::Windows::Foundation::IInspectable const& value) { m_store.SetValue(m_handle, value); }
+
+        // IObservableProperty：值本身就是装箱的
+        winrt::Windows::Foundation::IInspectable BoxedValue() const { return Value(); }
+        void BoxedValue(winrt::Windows::Foundation::IInspectable const& value) { Value(value); }
+
+        // INotifyPropertyChanged
+        winrt::event_token PropertyChanged(Microsoft::UI::Xaml::Data::PropertyChangedEventHandler const& handler)
+        {
+            return m_propertyChanged.add(handler);
+        }
+        void PropertyChanged(winrt::event_token const& token) noexcept
+        {
+            m_propertyChanged.remove(token);
+        }
+
+        // 由仓库在槽位变化时调用
+        void RaiseValueChanged()
+        {
+            m_propertyChanged(*this, Microsoft::UI::Xaml::Data::PropertyChangedEventArgs{ L"Value" });
+            if (HasValueListeners())
+                PublishBoxed(*this, Value());
+        }
+
+    private:
+        Core::ObservablePropertyStore m_store;
+        uint32_t m_handle;
+        winrt::event<Microsoft::UI::Xaml::Data::PropertyChangedEventHandler> m_propertyChanged;
+    };
+
+    // 值的存放与批量合并见 mvvm::SlotColumns（与平台无关，可单独测试与测量），这里负责句柄校验、装箱与事件
+    struct ObservablePropertyStore : ObservablePropertyStoreT<ObservablePropertyStore>
+    {
+        ObservablePropertyStore() = default;
+
+#define MVVM_STORE_SLOT_ACCESSORS(Name, Type) \
+        uint32_t Add##Name(Type const& value) { return Add<SlotKind::Name>(value); } \
+        Type Get##Name(uint32_t slot) const { return Get<SlotKind::Name>(slot); } \
+        void Set##Name(uint32_t slot, Type const& value) { Set<SlotKind::Name>(slot, value); }
+
+        MVVM_STORE_SLOT_ACCESSORS(Boolean, bool)
+        MVVM_STORE_SLOT_ACCESSORS(Byte, uint8_t)
+        MVVM_STORE_SLOT_ACCESSORS(Int16, int16_t)
+        MVVM_STORE_SLOT_ACCESSORS(UInt16, uint16_t)
+        MVVM_STORE_SLOT_ACCESSORS(Int32, int32_t)
+        MVVM_STORE_SLOT_ACCESSORS(UInt32, uint32_t)
+        MVVM_STORE_SLOT_ACCESSORS(Int64, int64_t)
+        MVVM_STORE_SLOT_ACCESSORS(UInt64, uint64_t)
+        MVVM_STORE_SLOT_ACCESSORS(Single, float)
+        MVVM_STORE_SLOT_ACCESSORS(Double, double)
+        MVVM_STORE_SLOT_ACCESSORS(String, hstring)
+
+#undef MVVM_STORE_SLOT_ACCESSORS
+
+        winrt::Windows::Foundation::IInspectable GetValue(uint32_t slot) const
+        {
+            return Visit(slot, [&](auto kind) -> winrt::Windows::Foundation::IInspectable
+                {
+                    return winrt::box_value(Get<decltype(kind)::value>(slot));
+                });
+        }
+
+        void SetValue(uint32_t slot, winrt::Windows::Foundation::IInspectable const& value)
+        {
+            Visit(slot, [&](auto kind)
+                {
+                    using T = ValueOf<decltype(kind)::value>;
+                    Set<decltype(kind)::value>(slot, winrt::unbox_value<T>(value));
+                });
+        }
+
+        uint32_t Count() const noexcept { return m_columns.Count(); }
+
+        void BeginUpdate() noexcept { m_columns.BeginUpdate(); }
+
+        void EndUpdate()
+        {
+            if (m_columns.UpdateDepth() == 0)
+                throw winrt::hresult_illegal_method_call(L"EndUpdate without matching BeginUpdate.");
+            for (auto slot : m_columns.EndUpdate())
+                Raise(slot);
+        }
+
+        Core::ObservableSlot Slot(uint32_t slot)
+        {
+            Visit(slot, [&](auto kind) { Check<decltype(kind)::value>(slot); }); // 校验句柄
+
+            if (auto it = m_slots.find(slot); it != m_slots.end())
+            {
+                if (auto existing = it->second.get())
+                    return existing;
+            }
+
+            auto proxy = winrt::make<ObservableSlot>(*this, slot);
+            m_slots[slot] = winrt::make_weak(proxy);
+            return proxy;
+        }
+
+        winrt::event_token SlotChanged(Windows::Foundation::TypedEventHandler<Core::ObservablePropertyStore, uint32_t> const& handler)
+        {
+            return m_slotChanged.add(handler);
+        }
+        void SlotChanged(winrt::event_token const& token) noexcept
+        {
+            m_slotChanged.remove(token);
+        }
+
+    private:
+        using Columns = ::mvvm::SlotColumns<hstring>;
+
+        template <SlotKind K>
+        using ValueOf = Columns::ValueOf<K>;
+
+        template <SlotKind K>
+        void Check(uint32_t slot) const
+        {
+            if (!m_columns.IsValid<K>(slot))
+                throw winrt::hresult_invalid_argument(L"Invalid slot handle.");
+        }
+
+        // 按句柄中的类型分派，f 接收 std::integral_constant<SlotKind, K>
+        template <typename F>
+        static auto Visit(uint32_t slot, F&& f)
+        {
+            if (!Columns::IsValidKind(slot))
+                throw winrt::hresult_invalid_argument(L"Invalid slot handle.");
+            return Columns::VisitKind(slot >> Columns::IndexBits, std::forward<F>(f));
+        }
+
+        template <SlotKind K>
+        uint32_t Add(ValueOf<K> const& value)
+        {
+            auto slot = m_columns.Add<K>(value);
+            if (slot == Columns::InvalidSlot)
+                throw winrt::hresult_out_of_bounds(L"Too many slots of this type.");
+            return slot;
+        }
+
+        template <SlotKind K>
+        ValueOf<K> Get(uint32_t slot) const
+        {
+            Check<K>(slot);
+            return m_columns.Get<K>(slot);
+        }
+
+        template <SlotKind K>
+        void Set(uint32_t slot, ValueOf<K> const& value)
+        {
+            Check<K>(slot);
+            if (m_columns.Set<K>(slot, value) == ::mvvm::SlotSetResult::Changed)
+                Raise(slot);
+        }
+
+        void Raise(uint32_t slot)
+        {
+            m_slotChanged(*this, slot);
+
+            if (m_slots.empty())
+                return;
+            if (auto it = m_slots.find(slot); it != m_slots.end())
+            {
+                if (auto proxy = it->second.get())
+                    winrt::get_self<ObservableSlot>(proxy)->RaiseValueChanged();
+                else
+                    m_slots.erase(it);
+            }
+        }
+
+        Columns  m_columns;
+        std::unordered_map<uint32_t, winrt::weak_ref<Core::ObservableSlot>> m_slots;   // 仅已创建绑定代理的槽位
+        winrt::event<Windows::Foundation::TypedEventHandler<Core::ObservablePropertyStore, uint32_t>> m_slotChanged;
+    };
 }
 
 namespace winrt::Mvvm::Framework::Core::factory_implementation
@@ -133,6 +435,7 @@ namespace winrt::Mvvm::Framework::Core::factory_implementation
     struct ObservableDouble : ObservableDoubleT<ObservableDouble, implementation::ObservableDouble> {};
     struct ObservableChar16 : ObservableChar16T<ObservableChar16, implementation::ObservableChar16> {};
     struct ObservableString : ObservableStringT<ObservableString, implementation::ObservableString> {};
+    struct ObservablePropertyStore : ObservablePropertyStoreT<ObservablePropertyStore, implementation::ObservablePropertyStore> {};
 }
 
 #endif  // MVVM_FRAMEWORK_CORE_H
\ No newline at end of file
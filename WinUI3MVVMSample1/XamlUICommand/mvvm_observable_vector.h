@@ -0,0 +1,420 @@
+﻿#pragma once
+#ifndef MVVM_OBSERVABLE_VECTOR_H
+#define MVVM_OBSERVABLE_VECTOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <unknwn.h>
+#include <winrt/Windows.Foundation.Collections.h>
+#endif
+
+// 支持批量操作与差异更新的可观察集合。
+// single_threaded_observable_vector 每次 Append / RemoveAt 都会触发一次 VectorChanged，
+// 批量装载时订阅方（例如 NodeGraphPanel）会被重复重绘。RangeObservableVector 在此基础上增加
+// AddRange / InsertRange / RemoveRange / ReplaceAll / ApplyDiff：
+// 变更量不超过 ResetThreshold() 时逐项通知（ItemInserted / ItemRemoved / ItemChanged），
+// 超过时只修改一次底层容器并发出单个 Reset。
+//
+//   auto nodes = mvvm::make_range_observable_vector<XamlUICommand::NodeViewModel>();
+//   mvvm::as_range_vector(nodes)->ApplyDiff(latest, [](auto const& n) { return n.Id(); });
+
+namespace mvvm::diff
+{
+    enum class EditKind : uint8_t
+    {
+        Keep,
+        Insert,
+        Remove,
+    };
+
+    // 连续的同类编辑：Keep 对应 old[oldIndex..] 与 next[newIndex..]，
+    // Insert 取 next[newIndex..]，Remove 删除 old[oldIndex..]
+    struct EditRun
+    {
+        EditKind kind;
+        uint32_t oldIndex;
+        uint32_t newIndex;
+        uint32_t count;
+    };
+
+    struct EditScript
+    {
+        std::vector<EditRun> runs;
+        uint32_t             cost{ 0 };   // 插入 + 删除的元素数
+    };
+
+    namespace details
+    {
+        inline void PushRun(std::vector<EditRun>& runs, EditKind kind, uint32_t oldIndex, uint32_t newIndex)
+        {
+            if (!runs.empty())
+            {
+                auto& last = runs.back();
+                if (last.kind == kind)
+                {
+                    // 回溯时逆序生成：新元素位于当前 run 之前
+                    if ((kind == EditKind::Keep && last.oldIndex == oldIndex + 1 && last.newIndex == newIndex + 1) ||
+                        (kind == EditKind::Insert && last.newIndex == newIndex + 1) ||
+                        (kind == EditKind::Remove && last.oldIndex == oldIndex + 1))
+                    {
+                        last.oldIndex = oldIndex;
+                        last.newIndex = newIndex;
+                        ++last.count;
+                        return;
+                    }
+                }
+            }
+            runs.push_back({ kind, oldIndex, newIndex, 1 });
+        }
+    }
+
+    // Myers O((N+M)·D) 差异算法，按键比较。先裁掉公共前后缀，
+    // 编辑距离超过 maxCost 时提前放弃并返回 nullopt（调用方改用 Reset），
+    // 因此回溯所需的内存被限制在 O(maxCost²)。
+    template <typename Key>
+    std::optional<EditScript> Compute(std::vector<Key> const& a, std::vector<Key> const& b, uint32_t maxCost)
+    {
+        uint32_t const n = static_cast<uint32_t>(a.size());
+        uint32_t const m = static_cast<uint32_t>(b.size());
+
+        uint32_t prefix = 0;
+        while (prefix < n && prefix < m && a[prefix] == b[prefix])
+            ++prefix;
+        uint32_t suffix = 0;
+        while (suffix < n - prefix && suffix < m - prefix && a[n - 1 - suffix] == b[m - 1 - suffix])
+            ++suffix;
+
+        int32_t const N = static_cast<int32_t>(n - prefix - suffix);
+        int32_t const M = static_cast<int32_t>(m - prefix - suffix);
+        if (static_cast<uint32_t>(std::abs(N - M)) > maxCost)   // 编辑距离下界
+            return std::nullopt;
+
+        auto keyA = [&](int32_t i) -> Key const& { return a[prefix + i]; };
+        auto keyB = [&](int32_t j) -> Key const& { return b[prefix + j]; };
+
+        int32_t const maxD = static_cast<int32_t>(std::min<uint32_t>(maxCost, static_cast<uint32_t>(N + M)));
+        std::vector<int32_t> v(2 * static_cast<size_t>(maxD) + 3, 0);
+        int32_t const offset = maxD + 1;
+        std::vector<std::vector<int32_t>> trace;   // trace[d] 为第 d 轮结束时 k∈[-d, d] 的 V
+        int32_t found = -1;
+
+        for (int32_t d = 0; d <= maxD && found < 0; ++d)
+        {
+            for (int32_t k = -d; k <= d; k += 2)
+            {
+                int32_t x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+                    ? v[offset + k + 1]
+                    : v[offset + k - 1] + 1;
+                int32_t y = x - k;
+                while (x < N && y < M && keyA(x) == keyB(y))
+                {
+                    ++x;
+                    ++y;
+                }
+                v[offset + k] = x;
+                if (x >= N && y >= M)
+                {
+                    found = d;
+                    break;
+                }
+            }
+            if (found < 0)
+                trace.emplace_back(v.begin() + (offset - d), v.begin() + (offset + d + 1));
+        }
+        if (found < 0)
+            return std::nullopt;
+
+        EditScript script;
+        script.cost = static_cast<uint32_t>(found);
+
+        // 逆序回溯，结果整体翻转
+        std::vector<EditRun>& runs = script.runs;
+        if (suffix)
+            runs.push_back({ EditKind::Keep, n - suffix, m - suffix, suffix });
+
+        int32_t x = N, y = M;
+        for (int32_t d = found; d > 0; --d)
+        {
+            auto const& prev = trace[d - 1];
+            auto at = [&](int32_t k) { return prev[k + (d - 1)]; };
+            int32_t const k = x - y;
+            bool const down = (k == -d || (k != d && at(k - 1) < at(k + 1)));
+            int32_t const prevK = down ? k + 1 : k - 1;
+            int32_t const prevX = at(prevK);
+            int32_t const prevY = prevX - prevK;
+            while (x > prevX && y > prevY)
+            {
+                --x;
+                --y;
+                details::PushRun(runs, EditKind::Keep, prefix + x, prefix + y);
+            }
+            if (down)
+                details::PushRun(runs, EditKind::Insert, prefix + x, prefix + prevY);
+            else
+                details::PushRun(runs, EditKind::Remove, prefix + prevX, prefix + y);
+            x = prevX;
+            y = prevY;
+        }
+        while (x > 0 && y > 0)
+        {
+            --x;
+            --y;
+            details::PushRun(runs, EditKind::Keep, prefix + x, prefix + y);
+        }
+        if (prefix)
+        {
+            if (!runs.empty() && runs.back().kind == EditKind::Keep && runs.back().oldIndex == prefix && runs.back().newIndex == prefix)
+            {
+                runs.back().oldIndex = 0;
+                runs.back().newIndex = 0;
+                runs.back().count += prefix;
+            }
+            else
+            {
+                runs.push_back({ EditKind::Keep, 0, 0, prefix });
+            }
+        }
+        std::reverse(runs.begin(), runs.end());
+        return script;
+    }
+
+    enum class Change : uint8_t
+    {
+        Inserted,
+        Removed,
+        Changed,
+    };
+
+    // 按编辑脚本把 values 原位变为 next，每修改一个位置调用一次 raise(change, index)，
+    // index 为修改后的当前位置，与 IObservableVector 的逐项通知一致。
+    // Keep 段中与 next 不相等的元素被替换并报告 Changed：只有键相同而值不同时才会发生。
+    // 返回是否有任何修改。
+    template <typename T, typename Next, typename Raise>
+    bool ApplyEditScript(std::vector<T>& values, EditScript const& script, Next const& next, Raise&& raise)
+    {
+        bool changed = false;
+        uint32_t pos = 0;   // 当前容器中的位置（随插入/删除移动）
+        for (auto const& run : script.runs)
+        {
+            switch (run.kind)
+            {
+            case EditKind::Keep:
+                for (uint32_t i = 0; i < run.count; ++i, ++pos)
+                {
+                    auto const& incoming = next[run.newIndex + i];
+                    if (!(values[pos] == incoming))
+                    {
+                        values[pos] = incoming;
+                        changed = true;
+                        raise(Change::Changed, pos);
+                    }
+                }
+                break;
+            case EditKind::Remove:
+                for (uint32_t i = 0; i < run.count; ++i)
+                {
+                    values.erase(values.begin() + pos);
+                    changed = true;
+                    raise(Change::Removed, pos);
+                }
+                break;
+            case EditKind::Insert:
+                for (uint32_t i = 0; i < run.count; ++i, ++pos)
+                {
+                    values.insert(values.begin() + pos, next[run.newIndex + i]);
+                    changed = true;
+                    raise(Change::Inserted, pos);
+                }
+                break;
+            }
+        }
+        return changed;
+    }
+}
+
+#ifdef _WIN32
+namespace mvvm
+{
+    // 经典 COM 标记接口：通过 QueryInterface 确认对象确为 RangeObservableVector，
+    // 避免对任意 IObservableVector 使用 get_self
+    struct __declspec(uuid("8c2f5a64-3d1e-4b7a-9f06-2e51c7d4a9b3")) IRangeObservableVectorIdentity : ::IUnknown
+    {
+        virtual void* __stdcall RangeVectorSelf() noexcept = 0;
+    };
+
+    // 默认的标识键：WinRT 对象取 ABI 指针（同一实例），其余类型取值本身
+    struct IdentityKey
+    {
+        template <typename T>
+        auto operator()(T const& item) const
+        {
+            if constexpr (std::is_base_of_v<winrt::Windows::Foundation::IUnknown, T>)
+                return winrt::get_abi(item);
+            else
+                return item;
+        }
+    };
+
+    enum class DiffOutcome : uint8_t
+    {
+        Unchanged,
+        Incremental,
+        Reset,
+    };
+
+    template <typename T>
+    struct RangeObservableVector :
+        winrt::implements<RangeObservableVector<T>,
+            winrt::Windows::Foundation::Collections::IObservableVector<T>,
+            winrt::Windows::Foundation::Collections::IVector<T>,
+            winrt::Windows::Foundation::Collections::IVectorView<T>,
+            winrt::Windows::Foundation::Collections::IIterable<T>,
+            IRangeObservableVectorIdentity>,
+        winrt::observable_vector_base<RangeObservableVector<T>, T>
+    {
+        using base_type = winrt::observable_vector_base<RangeObservableVector<T>, T>;
+        using CollectionChange = winrt::Windows::Foundation::Collections::CollectionChange;
+
+        static constexpr uint32_t DefaultResetThreshold = 64;
+
+        RangeObservableVector() = default;
+        explicit RangeObservableVector(std::vector<T>&& values) : m_values(std::move(values)) {}
+
+        auto& get_container() noexcept { return m_values; }
+        auto const& get_container() const noexcept { return m_values; }
+
+        void* __stdcall RangeVectorSelf() noexcept override { return this; }
+
+        // IVector::ReplaceAll 仍由基类提供
+        using base_type::ReplaceAll;
+
+        uint32_t ResetThreshold() const noexcept { return m_resetThreshold; }
+        void ResetThreshold(uint32_t value) noexcept { m_resetThreshold = value; }
+
+        void AddRange(winrt::array_view<T const> items)
+        {
+            InsertRange(static_cast<uint32_t>(m_values.size()), items);
+        }
+
+        void InsertRange(uint32_t index, winrt::array_view<T const> items)
+        {
+            if (index > m_values.size())
+                throw winrt::hresult_out_of_bounds();
+            if (items.empty())
+                return;
+
+            this->increment_version();
+            if (items.size() > m_resetThreshold)
+            {
+                m_values.insert(m_values.begin() + index, items.begin(), items.end());
+                this->call_changed(CollectionChange::Reset, 0);
+                return;
+            }
+            for (uint32_t i = 0; i < items.size(); ++i)
+            {
+                m_values.insert(m_values.begin() + index + i, items[i]);
+                this->call_changed(CollectionChange::ItemInserted, index + i);
+            }
+        }
+
+        void RemoveRange(uint32_t index, uint32_t count)
+        {
+            if (index > m_values.size() || count > m_values.size() - index)
+                throw winrt::hresult_out_of_bounds();
+            if (count == 0)
+                return;
+
+            this->increment_version();
+            if (count > m_resetThreshold)
+            {
+                m_values.erase(m_values.begin() + index, m_values.begin() + index + count);
+                this->call_changed(CollectionChange::Reset, 0);
+                return;
+            }
+            // 从尾部逐项删除，保证每次通知的索引在删除后仍然有效
+            for (uint32_t i = count; i-- > 0;)
+            {
+                m_values.erase(m_values.begin() + index + i);
+                this->call_changed(CollectionChange::ItemRemoved, index + i);
+            }
+        }
+
+        void ReplaceAll(std::vector<T>&& items)
+        {
+            this->increment_version();
+            m_values = std::move(items);
+            this->call_changed(CollectionChange::Reset, 0);
+        }
+
+        // 把当前内容变为 next：按 keyOf 计算最小编辑脚本，
+        // 编辑数不超过 ResetThreshold() 时逐项应用并通知，否则整体替换后发出 Reset。
+        // 键相同但实例不同的元素以 ItemChanged 替换。默认的 IdentityKey 对 WinRT 对象取 ABI 指针，
+        // 键相同即同一实例，因此不会产生 ItemChanged；需要“同一逻辑项换了新实例”时传入业务键（如 Id）。
+        template <typename KeyOf = IdentityKey>
+        DiffOutcome ApplyDiff(winrt::array_view<T const> next, KeyOf&& keyOf = {})
+        {
+            using Key = std::decay_t<decltype(keyOf(std::declval<T const&>()))>;
+            std::vector<Key> oldKeys, newKeys;
+            oldKeys.reserve(m_values.size());
+            newKeys.reserve(next.size());
+            for (auto const& item : m_values) oldKeys.push_back(keyOf(item));
+            for (auto const& item : next) newKeys.push_back(keyOf(item));
+
+            auto script = diff::Compute(oldKeys, newKeys, m_resetThreshold);
+            if (!script)
+            {
+                this->increment_version();
+                m_values.assign(next.begin(), next.end());
+                this->call_changed(CollectionChange::Reset, 0);
+                return DiffOutcome::Reset;
+            }
+
+            bool versioned = false;
+            bool const changed = diff::ApplyEditScript(m_values, *script, next, [&](diff::Change change, uint32_t index)
+                {
+                    if (!versioned)
+                    {
+                        this->increment_version();
+                        versioned = true;
+                    }
+                    switch (change)
+                    {
+                    case diff::Change::Inserted: this->call_changed(CollectionChange::ItemInserted, index); break;
+                    case diff::Change::Removed:  this->call_changed(CollectionChange::ItemRemoved, index); break;
+                    case diff::Change::Changed:  this->call_changed(CollectionChange::ItemChanged, index); break;
+                    }
+                });
+            return changed ? DiffOutcome::Incremental : DiffOutcome::Unchanged;
+        }
+
+    private:
+        std::vector<T> m_values;
+        uint32_t       m_resetThreshold{ DefaultResetThreshold };
+    };
+
+    template <typename T>
+    winrt::Windows::Foundation::Collections::IObservableVector<T> make_range_observable_vector(std::vector<T>&& values = {})
+    {
+        return winrt::make<RangeObservableVector<T>>(std::move(values));
+    }
+
+    // 仅当 vector 由 make_range_observable_vector 创建时返回实现指针，否则返回 nullptr
+    template <typename T>
+    RangeObservableVector<T>* as_range_vector(winrt::Windows::Foundation::Collections::IObservableVector<T> const& vector) noexcept
+    {
+        if (!vector)
+            return nullptr;
+        auto identity = vector.template try_as<IRangeObservableVectorIdentity>();
+        return identity ? static_cast<RangeObservableVector<T>*>(identity->RangeVectorSelf()) : nullptr;
+    }
+}
+#endif
+
+#endif // MVVM_OBSERVABLE_VECTOR_H
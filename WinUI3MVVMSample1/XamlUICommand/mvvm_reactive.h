@@ -0,0 +1,700 @@
+﻿#pragma once
+#ifndef MVVM_REACTIVE_H
+#define MVVM_REACTIVE_H
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winrt/Microsoft.UI.Dispatching.h>
+#include <winrt/Windows.System.Threading.h>
+#endif
+
+// 强类型的响应式管道。
+// 操作符在编译期融合为一个嵌套的 sink 类型，每条管道只在订阅时分配一次，
+// 值沿管道按原类型传递，不经过装箱的 Object 回调：
+//
+//   auto sub = mvvm::rx::From(impl.Changes())
+//       | mvvm::rx::Where([](int32_t v) { return v >= 0; })
+//       | mvvm::rx::Map([](int32_t v) { return v * 2; })
+//       | mvvm::rx::DistinctUntilChanged()
+//       | mvvm::rx::ObserveOn(mvvm::rx::ThreadPoolScheduler{})
+//       | mvvm::rx::Subscribe([](int32_t v) { ... });
+//
+// 数据源只需提供 value_type 与 Connect(sink) -> Subscription，Subject<T> 与管道本身均满足。
+namespace mvvm::rx
+{
+    // 取消订阅句柄（RAII，仅可移动）
+    class Subscription
+    {
+    public:
+        Subscription() = default;
+        explicit Subscription(std::function<void()> dispose) : m_dispose(std::move(dispose)) {}
+
+        Subscription(Subscription&& other) noexcept : m_dispose(std::exchange(other.m_dispose, nullptr)) {}
+        Subscription& operator=(Subscription&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Dispose();
+                m_dispose = std::exchange(other.m_dispose, nullptr);
+            }
+            return *this;
+        }
+
+        Subscription(Subscription const&) = delete;
+        Subscription& operator=(Subscription const&) = delete;
+
+        ~Subscription() { Dispose(); }
+
+        void Dispose()
+        {
+            if (auto dispose = std::exchange(m_dispose, nullptr))
+                dispose();
+        }
+
+        explicit operator bool() const noexcept { return static_cast<bool>(m_dispose); }
+
+    private:
+        std::function<void()> m_dispose;
+    };
+
+    // 单线程的多播数据源。没有订阅者时不分配任何内存；
+    // 允许在通知过程中订阅或取消订阅（取消的条目在本轮通知结束后才释放）。
+    template <typename T>
+    class Subject
+    {
+    public:
+        using value_type = T;
+
+        template <typename Sink>
+        Subscription Connect(Sink sink)
+        {
+            if (!m_state)
+                m_state = std::make_shared<State>();
+
+            auto id = m_state->nextId++;
+            ++m_state->live;
+            m_state->entries.push_back({ id, std::make_unique<Holder<Sink>>(std::move(sink)), false });
+            return Subscription{ [weak = std::weak_ptr<State>(m_state), id]
+                {
+                    if (auto state = weak.lock())
+                        state->Remove(id);
+                } };
+        }
+
+        bool HasObservers() const noexcept { return m_state && m_state->live > 0; }
+
+        void OnNext(T const& value) { Publish([&](ErasedSink& sink) { sink.OnNext(value); }); }
+        void OnError(std::exception_ptr error) { Publish([&](ErasedSink& sink) { sink.OnError(error); }); }
+        void OnCompleted() { Publish([&](ErasedSink& sink) { sink.OnCompleted(); }); }
+
+    private:
+        struct ErasedSink
+        {
+            virtual ~ErasedSink() = default;
+            virtual void OnNext(T const& value) = 0;
+            virtual void OnError(std::exception_ptr error) = 0;
+            virtual void OnCompleted() = 0;
+        };
+
+        template <typename Sink>
+        struct Holder final : ErasedSink
+        {
+            explicit Holder(Sink&& s) : sink(std::move(s)) {}
+            void OnNext(T const& value) override { sink.OnNext(value); }
+            void OnError(std::exception_ptr error) override { sink.OnError(error); }
+            void OnCompleted() override { sink.OnCompleted(); }
+            Sink sink;
+        };
+
+        struct Entry
+        {
+            uint64_t                    id;
+            std::unique_ptr<ErasedSink> sink;
+            bool                        disposed;
+        };
+
+        struct State
+        {
+            std::vector<Entry> entries;
+            uint64_t nextId{ 1 };
+            size_t   live{ 0 };
+            int      publishing{ 0 };
+            bool     dirty{ false };
+
+            void Remove(uint64_t id)
+            {
+                for (auto it = entries.begin(); it != entries.end(); ++it)
+                {
+                    if (it->id != id || it->disposed)
+                        continue;
+
+                    --live;
+                    if (publishing)
+                    {
+                        it->disposed = true;
+                        dirty = true;
+                    }
+                    else
+                    {
+                        entries.erase(it);
+                    }
+                    return;
+                }
+            }
+
+            void Compact()
+            {
+                std::erase_if(entries, [](Entry const& e) { return e.disposed; });
+                dirty = false;
+            }
+        };
+
+        template <typename F>
+        void Publish(F&& f)
+        {
+            if (!m_state || m_state->entries.empty())
+                return;
+
+            auto state = m_state; // 通知过程中 Subject 本身可能被销毁
+            ++state->publishing;
+            size_t count = state->entries.size();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!state->entries[i].disposed)
+                    f(*state->entries[i].sink);
+            }
+            if (--state->publishing == 0 && state->dirty)
+                state->Compact();
+        }
+
+        std::shared_ptr<State> m_state;
+    };
+
+    namespace details
+    {
+        struct OperatorTag {};
+        struct TerminalTag {};
+
+        // 转发 OnError / OnCompleted 的 sink 基类
+        template <typename Down>
+        struct ForwardingSink
+        {
+            explicit ForwardingSink(Down&& d) : down(std::move(d)) {}
+            void OnError(std::exception_ptr error) { down.OnError(error); }
+            void OnCompleted() { down.OnCompleted(); }
+            Down down;
+        };
+    }
+
+    // ---------------------------------------------------------------- Map
+    template <typename F, typename Down>
+    struct MapSink : details::ForwardingSink<Down>
+    {
+        MapSink(F&& f, Down&& d) : details::ForwardingSink<Down>(std::move(d)), f(std::move(f)) {}
+        template <typename In>
+        void OnNext(In const& value) { this->down.OnNext(f(value)); }
+        F f;
+    };
+
+    template <typename F>
+    struct MapOp : details::OperatorTag
+    {
+        F f;
+        template <typename In> using Output = std::decay_t<std::invoke_result_t<F&, In const&>>;
+        template <typename In, typename Down>
+        auto Bind(Down&& down) { return MapSink<F, std::decay_t<Down>>{ std::move(f), std::forward<Down>(down) }; }
+    };
+
+    template <typename F>
+    MapOp<std::decay_t<F>> Map(F&& f) { return { {}, std::forward<F>(f) }; }
+
+    // ---------------------------------------------------------------- Where
+    template <typename P, typename Down>
+    struct WhereSink : details::ForwardingSink<Down>
+    {
+        WhereSink(P&& p, Down&& d) : details::ForwardingSink<Down>(std::move(d)), predicate(std::move(p)) {}
+        template <typename In>
+        void OnNext(In const& value)
+        {
+            if (predicate(value))
+                this->down.OnNext(value);
+        }
+        P predicate;
+    };
+
+    template <typename P>
+    struct WhereOp : details::OperatorTag
+    {
+        P predicate;
+        template <typename In> using Output = In;
+        template <typename In, typename Down>
+        auto Bind(Down&& down) { return WhereSink<P, std::decay_t<Down>>{ std::move(predicate), std::forward<Down>(down) }; }
+    };
+
+    template <typename P>
+    WhereOp<std::decay_t<P>> Where(P&& predicate) { return { {}, std::forward<P>(predicate) }; }
+
+    // ---------------------------------------------------------------- DistinctUntilChanged
+    template <typename In, typename Down>
+    struct DistinctSink : details::ForwardingSink<Down>
+    {
+        using details::ForwardingSink<Down>::ForwardingSink;
+        void OnNext(In const& value)
+        {
+            if (last && *last == value)
+                return;
+            last = value;
+            this->down.OnNext(value);
+        }
+        std::optional<In> last;
+    };
+
+    struct DistinctOp : details::OperatorTag
+    {
+        template <typename In> using Output = In;
+        template <typename In, typename Down>
+        auto Bind(Down&& down) { return DistinctSink<In, std::decay_t<Down>>{ std::forward<Down>(down) }; }
+    };
+
+    inline DistinctOp DistinctUntilChanged() { return {}; }
+
+    // ---------------------------------------------------------------- Buffer
+    // 每 count 个值打包为一个 std::vector 向下游发送；完成时发送剩余部分
+    template <typename In, typename Down>
+    struct BufferSink : details::ForwardingSink<Down>
+    {
+        BufferSink(size_t n, Down&& d) : details::ForwardingSink<Down>(std::move(d)), count(n) { items.reserve(count); }
+
+        void OnNext(In const& value)
+        {
+            items.push_back(value);
+            if (items.size() >= count)
+                Flush();
+        }
+
+        void OnCompleted()
+        {
+            if (!items.empty())
+                Flush();
+            this->down.OnCompleted();
+        }
+
+        void Flush()
+        {
+            std::vector<In> batch;
+            batch.reserve(count);
+            batch.swap(items);
+            this->down.OnNext(batch);
+        }
+
+        size_t count;
+        std::vector<In> items;
+    };
+
+    struct BufferOp : details::OperatorTag
+    {
+        size_t count;
+        template <typename In> using Output = std::vector<In>;
+        template <typename In, typename Down>
+        auto Bind(Down&& down) { return BufferSink<In, std::decay_t<Down>>{ count, std::forward<Down>(down) }; }
+    };
+
+    inline BufferOp Buffer(size_t count) { return { {}, count ? count : 1 }; }
+
+    // ---------------------------------------------------------------- ObserveOn
+    // 在调度器上继续下游；调度器需提供 Post(callable)。订阅取消后尚未执行的投递变为空操作。
+    template <typename In, typename Scheduler, typename Down>
+    struct ObserveOnSink
+    {
+        struct Core
+        {
+            Core(Scheduler s, Down&& d) : scheduler(std::move(s)), down(std::move(d)) {}
+
+            Scheduler scheduler;
+            Down      down;
+        };
+
+        ObserveOnSink(Scheduler s, Down&& d) : core(std::make_shared<Core>(std::move(s), std::move(d))) {}
+
+        void OnNext(In const& value)
+        {
+            core->scheduler.Post([weak = std::weak_ptr<Core>(core), value]()
+                {
+                    if (auto c = weak.lock()) c->down.OnNext(value);
+                });
+        }
+
+        void OnError(std::exception_ptr error)
+        {
+            core->scheduler.Post([weak = std::weak_ptr<Core>(core), error]()
+                {
+                    if (auto c = weak.lock()) c->down.OnError(error);
+                });
+        }
+
+        void OnCompleted()
+        {
+            core->scheduler.Post([weak = std::weak_ptr<Core>(core)]()
+                {
+                    if (auto c = weak.lock()) c->down.OnCompleted();
+                });
+        }
+
+        std::shared_ptr<Core> core;
+    };
+
+    template <typename Scheduler>
+    struct ObserveOnOp : details::OperatorTag
+    {
+        Scheduler scheduler;
+        template <typename In> using Output = In;
+        template <typename In, typename Down>
+        auto Bind(Down&& down) { return ObserveOnSink<In, Scheduler, std::decay_t<Down>>{ std::move(scheduler), std::forward<Down>(down) }; }
+    };
+
+    template <typename Scheduler>
+    ObserveOnOp<Scheduler> ObserveOn(Scheduler scheduler) { return { {}, std::move(scheduler) }; }
+
+    // ---------------------------------------------------------------- Throttle
+    // 静默 dueTime 后才发送最后一个值（去抖）；调度器需提供 PostAfter(duration, callable)，
+    // 下游在调度器线程上执行。
+    template <typename In, typename Scheduler, typename Down>
+    struct ThrottleSink
+    {
+        struct Core
+        {
+            Core(Scheduler s, std::chrono::nanoseconds due, Down&& d)
+                : scheduler(std::move(s)), dueTime(due), down(std::move(d)) {}
+
+            std::mutex               mutex;
+            Scheduler                scheduler;
+            std::chrono::nanoseconds dueTime;
+            Down                     down;
+            std::optional<In>        pending;
+            uint64_t                 generation{ 0 };
+        };
+
+        ThrottleSink(Scheduler s, std::chrono::nanoseconds dueTime, Down&& d)
+            : core(std::make_shared<Core>(std::move(s), dueTime, std::move(d))) {}
+
+        void OnNext(In const& value)
+        {
+            uint64_t generation;
+            {
+                std::scoped_lock lock{ core->mutex };
+                core->pending = value;
+                generation = ++core->generation;
+            }
+
+            core->scheduler.PostAfter(core->dueTime, [weak = std::weak_ptr<Core>(core), generation]()
+                {
+                    auto c = weak.lock();
+                    if (!c) return;
+
+                    std::optional<In> value;
+                    {
+                        std::scoped_lock lock{ c->mutex };
+                        if (c->generation != generation) return;   // 期间又有新值
+                        value.swap(c->pending);
+                    }
+                    if (value) c->down.OnNext(*value);
+                });
+        }
+
+        void OnError(std::exception_ptr error)
+        {
+            Cancel();
+            core->down.OnError(error);
+        }
+
+        void OnCompleted()
+        {
+            std::optional<In> value;
+            {
+                std::scoped_lock lock{ core->mutex };
+                ++core->generation;
+                value.swap(core->pending);
+            }
+            if (value) core->down.OnNext(*value);
+            core->down.OnCompleted();
+        }
+
+        void Cancel()
+        {
+            std::scoped_lock lock{ core->mutex };
+            ++core->generation;
+            core->pending.reset();
+        }
+
+        std::shared_ptr<Core> core;
+    };
+
+    template <typename Scheduler>
+    struct ThrottleOp : details::OperatorTag
+    {
+        Scheduler scheduler;
+        std::chrono::nanoseconds dueTime;
+        template <typename In> using Output = In;
+        template <typename In, typename Down>
+        auto Bind(Down&& down) { return ThrottleSink<In, Scheduler, std::decay_t<Down>>{ std::move(scheduler), dueTime, std::forward<Down>(down) }; }
+    };
+
+    template <typename Scheduler, typename Rep, typename Period>
+    ThrottleOp<Scheduler> Throttle(std::chrono::duration<Rep, Period> dueTime, Scheduler scheduler)
+    {
+        return { {}, std::move(scheduler), std::chrono::duration_cast<std::chrono::nanoseconds>(dueTime) };
+    }
+
+    // ---------------------------------------------------------------- Pipeline
+    template <typename Source, typename... Ops>
+    struct Pipeline;
+
+    namespace details
+    {
+        template <typename In, typename... Ops>
+        struct OutputOf { using type = In; };
+
+        template <typename In, typename Op, typename... Rest>
+        struct OutputOf<In, Op, Rest...> : OutputOf<typename Op::template Output<In>, Rest...> {};
+
+        // 自右向左把操作符套在下游 sink 外面，得到一个融合后的 sink
+        template <typename In, size_t I, typename Tuple, typename Sink>
+        auto BindFrom(Tuple& ops, Sink&& sink)
+        {
+            if constexpr (I == std::tuple_size_v<Tuple>)
+            {
+                return std::forward<Sink>(sink);
+            }
+            else
+            {
+                auto& op = std::get<I>(ops);
+                using Out = typename std::decay_t<decltype(op)>::template Output<In>;
+                return op.template Bind<In>(BindFrom<Out, I + 1>(ops, std::forward<Sink>(sink)));
+            }
+        }
+    }
+
+    template <typename Source, typename... Ops>
+    struct Pipeline
+    {
+        using value_type = typename details::OutputOf<typename Source::value_type, Ops...>::type;
+
+        Source* source;
+        std::tuple<Ops...> ops;
+
+        // 管道本身也是数据源（可作为 CombineLatest 的另一侧）；每次 Connect 消耗操作符的状态
+        template <typename Sink>
+        Subscription Connect(Sink sink)
+        {
+            return source->Connect(details::BindFrom<typename Source::value_type, 0>(ops, std::move(sink)));
+        }
+    };
+
+    template <typename Source>
+    Pipeline<Source> From(Source& source) { return { &source, {} }; }
+
+    template <typename Source, typename... Ops, typename Op>
+        requires std::is_base_of_v<details::OperatorTag, std::decay_t<Op>>
+    Pipeline<Source, Ops..., std::decay_t<Op>> operator|(Pipeline<Source, Ops...>&& pipeline, Op&& op)
+    {
+        return { pipeline.source, std::tuple_cat(std::move(pipeline.ops), std::make_tuple(std::forward<Op>(op))) };
+    }
+
+    // ---------------------------------------------------------------- CombineLatest
+    // 两侧都至少产生过一个值后，任一侧变化都以 combiner(左, 右) 的结果向下游发送
+    template <typename In, typename Other, typename F, typename Down>
+    struct CombineLatestSink
+    {
+        struct Core
+        {
+            Core(F&& f, Down&& d) : combiner(std::move(f)), down(std::move(d)) {}
+
+            std::mutex           mutex;
+            F                    combiner;
+            Down                 down;
+            std::optional<In>    left;
+            std::optional<Other> right;
+            Subscription         rightSubscription;
+
+            void Emit()
+            {
+                std::unique_lock lock{ mutex };
+                if (!left || !right) return;
+                auto result = combiner(*left, *right);
+                lock.unlock();
+                down.OnNext(result);
+            }
+        };
+
+        struct RightSink
+        {
+            std::weak_ptr<Core> core;
+            void OnNext(Other const& value)
+            {
+                if (auto c = core.lock())
+                {
+                    {
+                        std::scoped_lock lock{ c->mutex };
+                        c->right = value;
+                    }
+                    c->Emit();
+                }
+            }
+            void OnError(std::exception_ptr error) { if (auto c = core.lock()) c->down.OnError(error); }
+            void OnCompleted() {}   // 另一侧完成不结束合并，仍使用其最后的值
+        };
+
+        template <typename RightSource>
+        CombineLatestSink(RightSource& other, F&& f, Down&& d)
+            : core(std::make_shared<Core>(std::move(f), std::move(d)))
+        {
+            core->rightSubscription = other.Connect(RightSink{ core });
+        }
+
+        void OnNext(In const& value)
+        {
+            {
+                std::scoped_lock lock{ core->mutex };
+                core->left = value;
+            }
+            core->Emit();
+        }
+
+        void OnError(std::exception_ptr error) { core->down.OnError(error); }
+        void OnCompleted() { core->down.OnCompleted(); }
+
+        std::shared_ptr<Core> core;
+    };
+
+    template <typename OtherSource, typename F>
+    struct CombineLatestOp : details::OperatorTag
+    {
+        OtherSource* other;
+        F combiner;
+
+        using OtherValue = typename OtherSource::value_type;
+        template <typename In> using Output = std::decay_t<std::invoke_result_t<F&, In const&, OtherValue const&>>;
+        template <typename In, typename Down>
+        auto Bind(Down&& down)
+        {
+            return CombineLatestSink<In, OtherValue, F, std::decay_t<Down>>{ *other, std::move(combiner), std::forward<Down>(down) };
+        }
+    };
+
+    template <typename OtherSource, typename F>
+    CombineLatestOp<OtherSource, std::decay_t<F>> CombineLatest(OtherSource& other, F&& combiner)
+    {
+        return { {}, &other, std::forward<F>(combiner) };
+    }
+
+    // ---------------------------------------------------------------- Subscribe
+    template <typename OnNextF, typename OnErrorF, typename OnCompletedF>
+    struct LambdaSink
+    {
+        OnNextF      onNext;
+        OnErrorF     onError;
+        OnCompletedF onCompleted;
+
+        template <typename In>
+        void OnNext(In const& value) { onNext(value); }
+        void OnError(std::exception_ptr error) { onError(error); }
+        void OnCompleted() { onCompleted(); }
+    };
+
+    template <typename Sink>
+    struct SubscribeOp : details::TerminalTag
+    {
+        Sink sink;
+    };
+
+    template <typename OnNextF,
+        typename OnErrorF = void(*)(std::exception_ptr),
+        typename OnCompletedF = void(*)()>
+    auto Subscribe(OnNextF&& onNext,
+        OnErrorF&& onError = [](std::exception_ptr) {},
+        OnCompletedF&& onCompleted = [] {})
+    {
+        using Sink = LambdaSink<std::decay_t<OnNextF>, std::decay_t<OnErrorF>, std::decay_t<OnCompletedF>>;
+        return SubscribeOp<Sink>{ {}, Sink{ std::forward<OnNextF>(onNext), std::forward<OnErrorF>(onError), std::forward<OnCompletedF>(onCompleted) } };
+    }
+
+    template <typename Source, typename... Ops, typename Sink>
+    [[nodiscard]] Subscription operator|(Pipeline<Source, Ops...>&& pipeline, SubscribeOp<Sink>&& terminal)
+    {
+        return pipeline.Connect(std::move(terminal.sink));
+    }
+
+    // ---------------------------------------------------------------- Schedulers
+    // 在调用线程上立即执行（不支持 PostAfter）
+    struct ImmediateScheduler
+    {
+        template <typename F>
+        void Post(F&& f) const { f(); }
+    };
+
+#ifdef _WIN32
+    // 投递到 DispatcherQueue（通常为 UI 线程）
+    struct DispatcherScheduler
+    {
+        winrt::Microsoft::UI::Dispatching::DispatcherQueue queue{ nullptr };
+
+        static DispatcherScheduler Current()
+        {
+            return { winrt::Microsoft::UI::Dispatching::DispatcherQueue::GetForCurrentThread() };
+        }
+
+        template <typename F>
+        void Post(F&& f) const
+        {
+            queue.TryEnqueue([f = std::forward<F>(f)]() mutable { f(); });
+        }
+
+        template <typename F>
+        void PostAfter(std::chrono::nanoseconds delay, F&& f) const
+        {
+            // 计时器在 Tick 中释放自身，打断 计时器 -> 回调 -> 计时器 的循环引用
+            auto holder = std::make_shared<winrt::Microsoft::UI::Dispatching::DispatcherQueueTimer>(queue.CreateTimer());
+            holder->Interval(std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(delay));
+            holder->IsRepeating(false);
+            holder->Tick([holder, f = std::forward<F>(f)](auto&&, auto&&) mutable
+                {
+                    auto timer = std::exchange(*holder, nullptr);
+                    if (timer) timer.Stop();
+                    f();
+                });
+            holder->Start();
+        }
+    };
+
+    // 投递到系统线程池，用于把管道移出 UI 线程
+    struct ThreadPoolScheduler
+    {
+        template <typename F>
+        void Post(F&& f) const
+        {
+            winrt::Windows::System::Threading::ThreadPool::RunAsync([f = std::forward<F>(f)](auto&&) mutable { f(); });
+        }
+
+        template <typename F>
+        void PostAfter(std::chrono::nanoseconds delay, F&& f) const
+        {
+            winrt::Windows::System::Threading::ThreadPoolTimer::CreateTimer(
+                [f = std::forward<F>(f)](auto&&) mutable { f(); },
+                std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(delay));
+        }
+    };
+#endif
+}
+
+#endif  // MVVM_REACTIVE_H
@@ -0,0 +1,173 @@
+﻿#pragma once
+#ifndef MVVM_SLOT_COLUMNS_H
+#define MVVM_SLOT_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ObservablePropertyStore 中与平台无关的部分：按类型分列存放槽位值、句柄编码，以及
+// BeginUpdate / EndUpdate 期间按槽位合并变更。不依赖 WinRT，字符串类型由模板参数给出
+// （仓库使用 hstring，测试与基准使用 std::wstring）。
+// 句柄为 UInt32：高 8 位是 SlotKind（列序号），低 24 位是列内下标。
+// 句柄校验失败、列已满时只返回结果，由 ObservablePropertyStore 转换为 WinRT 异常。
+
+namespace mvvm
+{
+    // 与 ObservablePropertyStore 的各列一一对应，值即列序号（也是句柄的高 8 位）
+    enum class SlotKind : uint8_t
+    {
+        Boolean, Byte, Int16, UInt16, Int32, UInt32, Int64, UInt64, Single, Double, String,
+        Count
+    };
+
+    template <typename T>
+    struct SlotColumn
+    {
+        using value_type = T;
+
+        std::vector<T>       values;    // 同类型槽位连续存放（bool 按位存放）
+        std::vector<uint8_t> pending;   // BeginUpdate 期间已记录变更的槽位
+    };
+
+    enum class SlotSetResult : uint8_t
+    {
+        Unchanged,  // 值相同，不通知
+        Deferred,   // 处于批量更新中，已记入待通知列表
+        Changed,    // 调用方应立即通知
+    };
+
+    template <typename String>
+    class SlotColumns
+    {
+    public:
+        static constexpr uint32_t IndexBits = 24;
+        static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+        static constexpr uint32_t InvalidSlot = 0xFFFFFFFFu;
+
+        using Columns = std::tuple<
+            SlotColumn<bool>, SlotColumn<uint8_t>, SlotColumn<int16_t>, SlotColumn<uint16_t>,
+            SlotColumn<int32_t>, SlotColumn<uint32_t>, SlotColumn<int64_t>, SlotColumn<uint64_t>,
+            SlotColumn<float>, SlotColumn<double>, SlotColumn<String>>;
+        static_assert(std::tuple_size_v<Columns> == static_cast<size_t>(SlotKind::Count));
+
+        template <SlotKind K>
+        using ValueOf = typename std::tuple_element_t<static_cast<size_t>(K), Columns>::value_type;
+
+        static constexpr bool IsValidKind(uint32_t slot) noexcept
+        {
+            return (slot >> IndexBits) < static_cast<uint32_t>(SlotKind::Count);
+        }
+
+        // 按 kind 分派，f 接收 std::integral_constant<SlotKind, K>；调用方保证 kind 有效
+        template <size_t I = 0, typename F>
+        static auto VisitKind(uint32_t kind, F&& f)
+        {
+            if constexpr (I + 1 < static_cast<size_t>(SlotKind::Count))
+            {
+                if (kind != I)
+                    return VisitKind<I + 1>(kind, std::forward<F>(f));
+            }
+            return f(std::integral_constant<SlotKind, static_cast<SlotKind>(I)>{});
+        }
+
+        template <SlotKind K>
+        bool IsValid(uint32_t slot) const noexcept
+        {
+            return (slot >> IndexBits) == static_cast<uint32_t>(K) && (slot & IndexMask) < ColumnOf<K>().values.size();
+        }
+
+        // 列已满时返回 InvalidSlot
+        template <SlotKind K>
+        uint32_t Add(ValueOf<K> const& value)
+        {
+            auto& column = ColumnOf<K>();
+            if (column.values.size() > IndexMask)
+                return InvalidSlot;
+
+            column.values.push_back(value);
+            column.pending.push_back(0);
+            ++m_count;
+            return (static_cast<uint32_t>(K) << IndexBits) | static_cast<uint32_t>(column.values.size() - 1);
+        }
+
+        // 以下访问要求句柄已通过 IsValid<K>
+        template <SlotKind K>
+        ValueOf<K> Get(uint32_t slot) const
+        {
+            return ColumnOf<K>().values[slot & IndexMask];
+        }
+
+        template <SlotKind K>
+        SlotSetResult Set(uint32_t slot, ValueOf<K> const& value)
+        {
+            auto& column = ColumnOf<K>();
+            auto const index = slot & IndexMask;
+            if (column.values[index] == value)
+                return SlotSetResult::Unchanged;
+
+            column.values[index] = value;
+            if (!m_updateDepth)
+                return SlotSetResult::Changed;
+            if (!column.pending[index])
+            {
+                column.pending[index] = 1;
+                m_pendingSlots.push_back(slot);
+            }
+            return SlotSetResult::Deferred;
+        }
+
+        void BeginUpdate() noexcept { ++m_updateDepth; }
+        uint32_t UpdateDepth() const noexcept { return m_updateDepth; }
+
+        // 要求 UpdateDepth() > 0。结束最外层批量更新时返回期间变化过的槽位（每个一次，按首次变化的顺序），否则返回空
+        std::vector<uint32_t> EndUpdate()
+        {
+            if (--m_updateDepth)
+                return {};
+            auto slots = std::move(m_pendingSlots);
+            m_pendingSlots.clear();
+            for (auto slot : slots)
+                VisitKind(slot >> IndexBits, [&](auto kind) { ColumnOf<decltype(kind)::value>().pending[slot & IndexMask] = 0; });
+            return slots;
+        }
+
+        uint32_t Count() const noexcept { return m_count; }
+
+        // 各列已分配的容量（字节），不含字符串自身的堆内存
+        size_t CapacityBytes() const noexcept
+        {
+            size_t bytes = m_pendingSlots.capacity() * sizeof(uint32_t);
+            std::apply([&](auto const&... column)
+                {
+                    ((bytes += ValueBytes(column.values) + column.pending.capacity()), ...);
+                }, m_columns);
+            return bytes;
+        }
+
+    private:
+        template <SlotKind K>
+        auto& ColumnOf() noexcept { return std::get<static_cast<size_t>(K)>(m_columns); }
+        template <SlotKind K>
+        auto const& ColumnOf() const noexcept { return std::get<static_cast<size_t>(K)>(m_columns); }
+
+        template <typename T>
+        static size_t ValueBytes(std::vector<T> const& values) noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return (values.capacity() + 7) / 8;
+            else
+                return values.capacity() * sizeof(T);
+        }
+
+        Columns  m_columns;
+        uint32_t m_count{ 0 };
+        uint32_t m_updateDepth{ 0 };
+        std::vector<uint32_t> m_pendingSlots;
+    };
+}
+
+#endif // MVVM_SLOT_COLUMNS_H
@@ -0,0 +1,333 @@
+#include "concurrent_observable_vector.h"
+#include "portable_event_loop.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mvvm;
+
+namespace
+{
+    // 与 ConcurrentObservableVector 相同的流程，只是把 DispatcherQueue 换成 PortableEventLoop：
+    // 写入方入队并在由空闲变为待处理时投递一次 Flush，Flush 在循环线程合并应用，
+    // 并按通知把变化重放到 mirror 上，每次 Flush 之后 mirror 必须与投影一致。
+    struct Projection
+    {
+        explicit Projection(PortableEventLoop& loop, uint32_t resetThreshold = 64)
+            : loop(loop), resetThreshold(resetThreshold)
+        {
+        }
+
+        void Add(int value)
+        {
+            if (store.Add(value))
+                Schedule();
+        }
+
+        void AddRange(std::vector<int> const& values)
+        {
+            if (store.AddRange(values))
+                Schedule();
+        }
+
+        void Remove(int value)
+        {
+            if (store.Remove(value))
+                Schedule();
+        }
+
+        void Clear()
+        {
+            if (store.Clear())
+                Schedule();
+        }
+
+        void Flush()
+        {
+            NG_CHECK(loop.HasThreadAccess());
+            auto ops = store.Drain();
+            for (size_t i = 1; i < ops.size(); ++i)
+                NG_CHECK(ops[i - 1].seq < ops[i].seq);
+
+            ApplyProjectionOps(values, ops, resetThreshold, [this](ProjectionChange change, uint32_t index)
+                {
+                    switch (change)
+                    {
+                    case ProjectionChange::Inserted:
+                        NG_CHECK(index < values.size());
+                        mirror.insert(mirror.begin() + index, values[index]);
+                        break;
+                    case ProjectionChange::Removed:
+                        NG_CHECK(index < mirror.size());
+                        mirror.erase(mirror.begin() + index);
+                        break;
+                    case ProjectionChange::Reset:
+                        mirror = values;
+                        ++resets;
+                        break;
+                    }
+                });
+            NG_CHECK(mirror == values);
+            ++flushes;
+        }
+
+        void Schedule()
+        {
+            NG_CHECK(ProfiledEnqueue(loop, MVVM_DISPATCH_SITE("concurrent_vector_test::Flush"), [this] { Flush(); }));
+        }
+
+        PortableEventLoop&          loop;
+        uint32_t                    resetThreshold;
+        ConcurrentVectorStore<int>  store;
+        std::vector<int>            values;
+        std::vector<int>            mirror;
+        size_t                      flushes{ 0 };
+        size_t                      resets{ 0 };
+    };
+
+    // 单线程：操作顺序、Remove 只删第一个相等元素、Clear、合并为 Reset
+    void SingleThreadSemantics()
+    {
+        PortableEventLoop loop;
+        Projection p{ loop, 4 };
+
+        p.Add(1);
+        p.Add(2);
+        p.Add(1);
+        p.Remove(1);
+        NG_CHECK(loop.RunPending() == 1);
+        NG_CHECK((p.values == std::vector<int>{ 2, 1 }));
+        NG_CHECK(p.resets == 0);
+
+        p.Remove(42);                   // 不存在：不产生通知
+        NG_CHECK(loop.RunPending() == 1);
+        NG_CHECK((p.values == std::vector<int>{ 2, 1 }));
+
+        p.AddRange(std::vector<int>{ 3, 4, 5, 6, 7 });
+        p.Clear();
+        p.Add(8);
+        NG_CHECK(loop.RunPending() == 1);
+        NG_CHECK((p.values == std::vector<int>{ 8 }));
+        NG_CHECK(p.resets == 1);        // 7 个操作超过阈值 4，只发出一次 Reset
+
+        NG_CHECK(!p.store.HasPending());
+        NG_CHECK(p.store.Drain().empty());
+    }
+
+    // 复制时可以被拦住的值：用来让写入方持有分片锁，把 Drain 卡在两个分片之间
+    struct GatedItem
+    {
+        int id{ 0 };
+        bool gated{ false };
+
+        static inline std::atomic<bool> entered{ false };
+        static inline std::atomic<bool> released{ false };
+
+        GatedItem() = default;
+        GatedItem(int id, bool gated = false) : id(id), gated(gated) {}
+        GatedItem(GatedItem&&) = default;
+        GatedItem& operator=(GatedItem&&) = default;
+        GatedItem& operator=(GatedItem const&) = default;
+        GatedItem(GatedItem const& other) : id(other.id), gated(false)
+        {
+            if (other.gated)
+            {
+                entered.store(true);
+                while (!released.load())
+                    std::this_thread::yield();
+            }
+        }
+    };
+
+    // 确定性地复现“Drain 处理完分片 0、尚未处理分片 1 时又有写入”的交错：
+    //   A（分片 0）写入 w；C（分片 1）AddRange({ g1, g2 })，在复制 g1 时持锁停住（g1 的序号已分配）；
+    //   D 开始 Drain，取完分片 0 后阻塞在分片 1；此时 A 写入 x；放行 C，g2 取得比 x 更大的序号。
+    //   写入顺序为 w, g1, x, g2。若 Drain 直接取走整个分片 1，就会先于 x 交出 g2。
+    void DrainStopsAtSnapshotSequence()
+    {
+        ConcurrentVectorStore<GatedItem, 2> store;
+        std::vector<int> order;
+        auto take = [&](auto ops)
+            {
+                for (auto& op : ops)
+                    order.push_back(op.value.id);
+            };
+
+        std::atomic<int> step{ 0 };
+        std::thread a([&]
+            {
+                store.Add(GatedItem{ 1 });                  // 第一个写入线程：分片 0
+                step.store(1);
+                while (step.load() != 2)
+                    std::this_thread::yield();
+                store.Add(GatedItem{ 3 });
+                step.store(3);
+            });
+        while (step.load() != 1)
+            std::this_thread::yield();
+
+        std::thread c([&]
+            {
+                store.AddRange(std::initializer_list<GatedItem>{ GatedItem{ 2, true }, GatedItem{ 4 } });   // 分片 1
+            });
+        while (!GatedItem::entered.load())
+            std::this_thread::yield();
+
+        std::thread d([&] { take(store.Drain()); });
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });  // 让 D 越过分片 0、阻塞在分片 1 的锁上
+
+        step.store(2);
+        while (step.load() != 3)
+            std::this_thread::yield();
+        GatedItem::released.store(true);
+
+        c.join();
+        d.join();
+        a.join();
+        take(store.Drain());
+
+        NG_CHECK((order == std::vector<int>{ 1, 2, 3, 4 }));
+        NG_CHECK(store.Drain().empty());
+    }
+
+    // 多写入方 + 模拟 UI 循环：
+    //   adder 写入 Add(x) 后把 x 交给 remover，remover 再写入 Remove(x)。两次写入在不同线程、通常落在不同分片，
+    //   且 Add 先于 Remove 发生；Flush 若把 Remove 排到 Add 之前（或先取走 Remove、下一轮才取到 Add），
+    //   x 会残留在投影中。另有 keeper 只写入不删除的值，结束时投影必须恰好是这些值。
+    void ManyWritersWithUiPump()
+    {
+        constexpr int Adders = 4;
+        constexpr int Keepers = 2;
+        constexpr int PerAdder = 10000;
+        constexpr int PerKeeper = 2000;
+
+        PortableEventLoop loop;
+        Projection p{ loop };
+
+        std::thread ui([&] { loop.Run(); });
+
+        std::mutex handoffMutex;
+        std::deque<int> handoff;
+        std::atomic<int> addersDone{ 0 };
+
+        std::vector<std::thread> writers;
+        for (int a = 0; a < Adders; ++a)
+        {
+            writers.emplace_back([&, a]
+                {
+                    for (int i = 0; i < PerAdder; ++i)
+                    {
+                        int const value = a * PerAdder + i;
+                        p.Add(value);
+                        std::scoped_lock lock{ handoffMutex };
+                        handoff.push_back(value);
+                    }
+                    addersDone.fetch_add(1);
+                });
+        }
+        for (int r = 0; r < Adders; ++r)
+        {
+            writers.emplace_back([&]
+                {
+                    for (;;)
+                    {
+                        int value = -1;
+                        {
+                            std::scoped_lock lock{ handoffMutex };
+                            if (!handoff.empty())
+                            {
+                                value = handoff.front();
+                                handoff.pop_front();
+                            }
+                        }
+                        if (value >= 0)
+                            p.Remove(value);
+                        else if (addersDone.load() == Adders)
+                        {
+                            std::scoped_lock lock{ handoffMutex };
+                            if (handoff.empty())
+                                return;
+                        }
+                        else
+                            std::this_thread::yield();
+                    }
+                });
+        }
+        for (int k = 0; k < Keepers; ++k)
+        {
+            writers.emplace_back([&, k]
+                {
+                    for (int i = 0; i < PerKeeper; ++i)
+                        p.Add(-1 - (k * PerKeeper + i));
+                });
+        }
+
+        for (auto& t : writers)
+            t.join();
+        loop.Stop();
+        ui.join();
+
+        // 停止之后排队的 Flush（如果有）在本线程执行完
+        while (loop.RunPending() > 0) {}
+        NG_CHECK(!p.store.HasPending());
+
+        auto values = p.values;
+        std::sort(values.begin(), values.end());
+        std::vector<int> expected;
+        for (int v = -Keepers * PerKeeper; v < 0; ++v)
+            expected.push_back(v);
+        NG_CHECK(values == expected);
+    }
+
+    // 写入方持续写入时 UI 循环不断 Flush：每次 Flush 后投影满足“同一写入方的值按写入顺序出现”
+    void PerWriterOrderIsPreserved()
+    {
+        constexpr int Writers = 8;
+        constexpr int PerWriter = 10000;
+
+        PortableEventLoop loop;
+        Projection p{ loop, 1u << 30 };     // 逐项通知，检查每个 Inserted 的位置
+
+        std::thread ui([&] { loop.Run(); });
+        std::vector<std::thread> writers;
+        for (int w = 0; w < Writers; ++w)
+        {
+            writers.emplace_back([&, w]
+                {
+                    for (int i = 0; i < PerWriter; ++i)
+                        p.Add(w * PerWriter + i);
+                });
+        }
+        for (auto& t : writers)
+            t.join();
+        loop.Stop();
+        ui.join();
+        while (loop.RunPending() > 0) {}
+
+        NG_CHECK(p.values.size() == size_t{ Writers } * PerWriter);
+        std::vector<int> last(Writers, -1);
+        for (int v : p.values)
+        {
+            int const w = v / PerWriter;
+            NG_CHECK(v > last[w]);
+            last[w] = v;
+        }
+    }
+}
+
+int main()
+{
+    SingleThreadSemantics();
+    DrainStopsAtSnapshotSequence();
+    for (int round = 0; round < 5; ++round)
+        ManyWritersWithUiPump();
+    PerWriterOrderIsPreserved();
+    return 0;
+}
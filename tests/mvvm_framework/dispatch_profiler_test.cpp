@@ -0,0 +1,254 @@
+#include "dispatch_profiler.h"
+#include "portable_event_loop.h"
+#include "test_check.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+
+using namespace mvvm;
+
+namespace
+{
+    using Histogram = HdrHistogram;
+
+    // 桶首尾相接覆盖 [0, MaxValue]：每个桶的上下界都映射回自身，子桶宽度不超过下界的 1/64
+    constexpr bool BucketsAreContiguous()
+    {
+        for (size_t i = 0; i < Histogram::BucketCount; ++i)
+        {
+            auto low = Histogram::LowestEquivalentValue(i);
+            auto high = Histogram::HighestEquivalentValue(i);
+            if (Histogram::IndexOf(low) != i || Histogram::IndexOf(high) != i || high < low)
+                return false;
+            if (i + 1 < Histogram::BucketCount && Histogram::LowestEquivalentValue(i + 1) != high + 1)
+                return false;
+            if (i >= Histogram::SubBucketCount && (high - low + 1) * Histogram::SubBucketHalf > low)
+                return false;
+        }
+        return Histogram::LowestEquivalentValue(0) == 0
+            && Histogram::HighestEquivalentValue(Histogram::BucketCount - 1) == Histogram::MaxValue;
+    }
+    static_assert(BucketsAreContiguous());
+
+    void HistogramBucketIndex()
+    {
+        // 线性区：每个值一个桶
+        for (uint64_t v = 0; v < Histogram::SubBucketCount; ++v)
+            NG_CHECK(Histogram::IndexOf(v) == v);
+
+        // 对数区的几个边界
+        NG_CHECK(Histogram::IndexOf(128) == 128);
+        NG_CHECK(Histogram::IndexOf(129) == 128);
+        NG_CHECK(Histogram::IndexOf(130) == 129);
+        NG_CHECK(Histogram::IndexOf(255) == 191);
+        NG_CHECK(Histogram::IndexOf(256) == 192);
+        NG_CHECK(Histogram::IndexOf(Histogram::MaxValue) == Histogram::BucketCount - 1);
+
+        // 单调
+        size_t last = 0;
+        for (uint64_t v = 1; v < (uint64_t{ 1 } << 24); v = v + v / 7 + 1)
+        {
+            auto index = Histogram::IndexOf(v);
+            NG_CHECK(index >= last);
+            NG_CHECK(Histogram::LowestEquivalentValue(index) <= v && v <= Histogram::HighestEquivalentValue(index));
+            last = index;
+        }
+    }
+
+    void HistogramPercentiles()
+    {
+        Histogram h;
+        NG_CHECK(h.Count() == 0);
+        NG_CHECK(h.ValueAtPercentile(50) == 0);
+        NG_CHECK(h.Mean() == 0.0);
+
+        constexpr uint64_t N = 10000;
+        for (uint64_t v = 1; v <= N; ++v)
+            h.Record(v);
+
+        NG_CHECK(h.Count() == N);
+        NG_CHECK(h.Max() == N);
+        NG_CHECK(h.Mean() == 5000.5);
+
+        // 1..N 中第 k 小的值是 k；返回值为所在子桶的上界，不小于精确值，误差不超过 1/64
+        for (double p : { 1.0, 10.0, 50.0, 90.0, 99.0, 99.9 })
+        {
+            auto exact = static_cast<uint64_t>(p / 100.0 * N + 0.5);
+            auto value = h.ValueAtPercentile(p);
+            NG_CHECK(value >= exact);
+            NG_CHECK(value <= exact + exact / 64);
+        }
+        NG_CHECK(h.ValueAtPercentile(100) == N);
+        NG_CHECK(h.ValueAtPercentile(0) == 1);
+        NG_CHECK(h.ValueAtPercentile(250) == N);
+
+        // 超出范围的值截断到 MaxValue
+        h.Record(std::numeric_limits<uint64_t>::max());
+        NG_CHECK(h.Max() == Histogram::MaxValue);
+        NG_CHECK(h.ValueAtPercentile(100) == Histogram::MaxValue);
+
+        h.Reset();
+        NG_CHECK(h.Count() == 0);
+        NG_CHECK(h.Max() == 0);
+        NG_CHECK(h.ValueAtPercentile(99) == 0);
+    }
+
+    // 找到名为 name 的调用点，不存在时返回 nullptr
+    DispatchSiteReport const* FindSite(DispatchReport const& report, std::string const& name)
+    {
+        for (auto const& s : report.sites)
+        {
+            if (s.name == name)
+                return &s;
+        }
+        return nullptr;
+    }
+
+    void EnqueueFast(PortableEventLoop const& loop, int& runs)
+    {
+        NG_CHECK(ProfiledEnqueue(loop, MVVM_DISPATCH_SITE("dispatch_profiler_test::Fast"), [&runs] { ++runs; }));
+    }
+
+    void EnqueueSlow(PortableEventLoop const& loop, std::chrono::milliseconds duration, int& runs)
+    {
+        NG_CHECK(ProfiledEnqueue(loop, MVVM_DISPATCH_SITE("dispatch_profiler_test::Slow"), [duration, &runs]
+            {
+                std::this_thread::sleep_for(duration);
+                ++runs;
+            }));
+    }
+
+    // 每轮 RunPending 之后 MarkFrame：只有包含慢工作项的帧超出预算，并记下最慢的调用点
+    void OverBudgetFramesOnPortableLoop()
+    {
+        constexpr auto Budget = std::chrono::milliseconds{ 20 };
+        constexpr auto SlowItem = std::chrono::milliseconds{ 30 };
+
+        auto& profiler = DispatchProfiler::Instance();
+        profiler.Reset();
+        profiler.SetSampleInterval(1);
+        profiler.SetFrameBudget(Budget);
+        profiler.Enable();
+
+        PortableEventLoop loop;
+        int runs = 0;
+
+        // 帧 1：三个快速工作项
+        for (int i = 0; i < 3; ++i)
+            EnqueueFast(loop, runs);
+        NG_CHECK(loop.RunPending() == 3);
+        profiler.MarkFrame();
+
+        // 帧 2：一个快速、一个慢速
+        EnqueueFast(loop, runs);
+        EnqueueSlow(loop, SlowItem, runs);
+        NG_CHECK(loop.RunPending() == 2);
+        profiler.MarkFrame();
+
+        // 帧 3：空帧
+        profiler.MarkFrame();
+        NG_CHECK(runs == 5);
+
+        auto report = profiler.Report();
+        NG_CHECK(report.frames == 3);
+        NG_CHECK(report.overBudgetFrames == 1);
+        NG_CHECK(report.budget == Budget);
+        NG_CHECK(report.recentOverBudget.size() == 1);
+
+        auto const& frame = report.recentOverBudget.front();
+        NG_CHECK(frame.frameIndex == 2);
+        NG_CHECK(frame.items == 2);
+        NG_CHECK(frame.slowestSite == "dispatch_profiler_test::Slow");
+        NG_CHECK(frame.slowestItemNs >= static_cast<uint64_t>(std::chrono::nanoseconds{ SlowItem }.count()));
+        NG_CHECK(frame.workNs >= frame.slowestItemNs);
+
+        NG_CHECK(report.sites.size() >= 2);
+        NG_CHECK(report.sites.front().name == "dispatch_profiler_test::Slow");     // 按 P99 执行时间降序
+        auto fast = FindSite(report, "dispatch_profiler_test::Fast");
+        auto slow = FindSite(report, "dispatch_profiler_test::Slow");
+        NG_CHECK(fast && fast->count == 4);
+        NG_CHECK(slow && slow->count == 1);
+        NG_CHECK(slow->execMaxNs >= frame.slowestItemNs * 63 / 64);
+        NG_CHECK(fast->execP99Ns < slow->execP50Ns);
+        // 慢工作项排在同帧的快速工作项之后，等待时间不为零
+        NG_CHECK(slow->waitMaxNs > 0);
+
+        NG_CHECK(profiler.FormatReport().find(L"overBudget=1") != std::wstring::npos);
+
+        // 关闭后照常执行但不记录
+        profiler.Enable(false);
+        EnqueueSlow(loop, SlowItem, runs);
+        NG_CHECK(loop.RunPending() == 1);
+        profiler.MarkFrame();
+        report = profiler.Report();
+        NG_CHECK(runs == 6);
+        NG_CHECK(report.frames == 4);
+        NG_CHECK(report.overBudgetFrames == 1);
+        NG_CHECK(FindSite(report, "dispatch_profiler_test::Slow")->count == 1);
+    }
+
+    // 采样：每 interval 次投递剖析一次（按投递线程计数），帧内耗时按间隔放大
+    void SampledEnqueueScalesFrameWork()
+    {
+        constexpr uint32_t Interval = 4;
+        constexpr auto SlowItem = std::chrono::milliseconds{ 2 };
+
+        auto& profiler = DispatchProfiler::Instance();
+        profiler.Reset();
+        profiler.SetSampleInterval(Interval);
+        profiler.SetFrameBudget(std::chrono::nanoseconds{ 0 });
+        profiler.Enable();
+
+        PortableEventLoop loop;
+        int runs = 0;
+        std::thread poster([&]
+            {
+                for (uint32_t i = 0; i < 2 * Interval; ++i)
+                    EnqueueSlow(loop, SlowItem, runs);
+            });
+        poster.join();
+        NG_CHECK(loop.RunPending() == 2 * Interval);
+        profiler.MarkFrame();
+        NG_CHECK(runs == static_cast<int>(2 * Interval));
+
+        auto report = profiler.Report();
+        auto slow = FindSite(report, "dispatch_profiler_test::Slow");
+        NG_CHECK(slow && slow->count == 2);
+        NG_CHECK(report.recentOverBudget.size() == 1);
+        auto const& frame = report.recentOverBudget.front();
+        NG_CHECK(frame.items == 2);
+        NG_CHECK(frame.workNs >= 2 * Interval * static_cast<uint64_t>(std::chrono::nanoseconds{ SlowItem }.count()));
+
+        profiler.Enable(false);
+        profiler.SetSampleInterval(1);
+        profiler.SetFrameBudget(std::chrono::milliseconds{ 4 });
+    }
+
+    // 队列关闭后 ProfiledEnqueue 与 TryEnqueue 一样返回 false
+    void EnqueueAfterShutdownFails()
+    {
+        auto& profiler = DispatchProfiler::Instance();
+        PortableEventLoop loop;
+        loop.Shutdown();
+        for (bool enabled : { false, true })
+        {
+            profiler.Enable(enabled);
+            NG_CHECK(!ProfiledEnqueue(loop, MVVM_DISPATCH_SITE("dispatch_profiler_test::Closed"), [] {}));
+        }
+        profiler.Enable(false);
+        NG_CHECK(loop.PendingCount() == 0);
+    }
+}
+
+int main()
+{
+    HistogramBucketIndex();
+    HistogramPercentiles();
+    OverBudgetFramesOnPortableLoop();
+    SampledEnqueueScalesFrameWork();
+    EnqueueAfterShutdownFails();
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "lazy_slot.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mvvm;
+
+namespace
+{
+    // 代替 ICommand：空指针即“未构建”
+    struct FakeCommand
+    {
+        int id{ 0 };
+    };
+    using CommandPtr = std::shared_ptr<FakeCommand>;
+    using Slot = LazySlot<CommandPtr>;
+
+    // 首次 Get() 构建一次并回调一次 onBuilt；之后返回同一个对象
+    void BuildsOnceOnFirstGet()
+    {
+        int builds = 0, callbacks = 0;
+        Slot slot{ [&] { ++builds; return std::make_shared<FakeCommand>(FakeCommand{ 1 }); },
+            [&](CommandPtr const& cmd) { ++callbacks; NG_CHECK(cmd && cmd->id == 1); } };
+
+        NG_CHECK(!slot.IsBuilt());
+        NG_CHECK(!slot.Peek());
+        NG_CHECK(builds == 0);
+
+        auto first = slot.Get();
+        auto second = slot.Get();
+        NG_CHECK(first && first == second);
+        NG_CHECK(slot.Peek() == first && slot.IsBuilt());
+        NG_CHECK(builds == 1 && callbacks == 1);
+
+        // 未定义工厂的槽始终为空
+        Slot empty;
+        NG_CHECK(!empty.Get() && !empty.IsBuilt());
+    }
+
+    // Define() 丢弃已构建的值，下次 Get() 用新工厂构建；Set() 直接替换且不触发构建
+    void DefineResetsAndSetReplaces()
+    {
+        int callbacks = 0;
+        Slot slot{ [] { return std::make_shared<FakeCommand>(FakeCommand{ 1 }); } };
+        NG_CHECK(slot.Get()->id == 1);
+
+        slot.Define([] { return std::make_shared<FakeCommand>(FakeCommand{ 2 }); }, [&](CommandPtr const&) { ++callbacks; });
+        NG_CHECK(!slot.IsBuilt());
+        NG_CHECK(slot.Get()->id == 2);
+        NG_CHECK(callbacks == 1);
+
+        auto external = std::make_shared<FakeCommand>(FakeCommand{ 3 });
+        slot.Set(external);
+        NG_CHECK(slot.Get() == external);
+        NG_CHECK(callbacks == 1);
+
+        // 清空后重新构建
+        slot.Set(nullptr);
+        NG_CHECK(slot.Get()->id == 2);
+        NG_CHECK(callbacks == 2);
+    }
+
+    // 工厂返回空值：不发布、不回调，下次 Get() 重试
+    void NullResultIsNotPublished()
+    {
+        int builds = 0, callbacks = 0;
+        Slot slot{ [&]() -> CommandPtr { return ++builds < 2 ? nullptr : std::make_shared<FakeCommand>(); },
+            [&](CommandPtr const&) { ++callbacks; } };
+        NG_CHECK(!slot.Get());
+        NG_CHECK(!slot.IsBuilt() && callbacks == 0);
+        NG_CHECK(slot.Get());
+        NG_CHECK(builds == 2 && callbacks == 1);
+    }
+
+    // 构建在锁外进行：工厂期间的 Set() 保留；工厂期间的 Define() 使旧工厂的产物作废
+    void ReentrantChangesDuringBuild()
+    {
+        auto external = std::make_shared<FakeCommand>(FakeCommand{ 9 });
+        int callbacks = 0;
+        Slot slot;
+        slot.Define([&]
+            {
+                slot.Set(external);
+                return std::make_shared<FakeCommand>(FakeCommand{ 1 });
+            }, [&](CommandPtr const&) { ++callbacks; });
+        NG_CHECK(slot.Get() == external);
+        NG_CHECK(callbacks == 0);
+
+        Slot redefined;
+        redefined.Define([&]
+            {
+                redefined.Define([] { return std::make_shared<FakeCommand>(FakeCommand{ 2 }); });
+                return std::make_shared<FakeCommand>(FakeCommand{ 1 });
+            }, [&](CommandPtr const&) { ++callbacks; });
+        NG_CHECK(!redefined.Get());
+        NG_CHECK(callbacks == 0);
+        NG_CHECK(redefined.Get()->id == 2);
+    }
+
+    // onBuilt 在锁外回调，可以再次访问槽（RegisterForAutoCleanup 之类的回调可能读取命令）
+    void CallbackMayReenter()
+    {
+        CommandPtr seen;
+        Slot slot;
+        slot.Define([] { return std::make_shared<FakeCommand>(); },
+            [&](CommandPtr const& cmd)
+            {
+                NG_CHECK(slot.Peek() == cmd);
+                seen = slot.Get();
+            });
+        auto cmd = slot.Get();
+        NG_CHECK(cmd && seen == cmd);
+    }
+
+    // 多线程同时首次访问：可能各自构建，但只发布一个、只回调一次，所有线程拿到同一个对象
+    void ConcurrentFirstGet()
+    {
+        constexpr int Threads = 8;
+        for (int round = 0; round < 200; ++round)
+        {
+            std::atomic<int> builds{ 0 }, callbacks{ 0 };
+            Slot slot{ [&] { ++builds; return std::make_shared<FakeCommand>(); },
+                [&](CommandPtr const&) { ++callbacks; } };
+
+            std::atomic<bool> go{ false };
+            std::vector<CommandPtr> results(Threads);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < Threads; ++t)
+            {
+                threads.emplace_back([&, t]
+                    {
+                        while (!go.load(std::memory_order_acquire))
+                            std::this_thread::yield();
+                        results[t] = slot.Get();
+                    });
+            }
+            go.store(true, std::memory_order_release);
+            for (auto& thread : threads)
+                thread.join();
+
+            NG_CHECK(callbacks == 1);
+            NG_CHECK(builds >= 1 && builds <= Threads);
+            for (auto const& result : results)
+                NG_CHECK(result && result == slot.Peek());
+        }
+    }
+}
+
+int main()
+{
+    BuildsOnceOnFirstGet();
+    DefineResetsAndSetReplaces();
+    NullResultIsNotPublished();
+    ReentrantChangesDuringBuild();
+    CallbackMayReenter();
+    ConcurrentFirstGet();
+    return 0;
+}
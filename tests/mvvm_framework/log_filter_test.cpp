@@ -0,0 +1,131 @@
+#include "mvvm_log_filter.h"
+#include "test_check.h"
+
+#include <cstring>
+#include <string_view>
+
+// 编译期阈值由 CMakeLists.txt 给定：全局 Info，Commands 关闭，Validation 为 Error
+
+namespace
+{
+    int g_calls = 0;
+    int g_evaluations = 0;
+    mvvm::diagnostics::LogLevel g_lastLevel{};
+    const char* g_lastFile = nullptr;
+
+    int Evaluate(int value)
+    {
+        ++g_evaluations;
+        return value;
+    }
+
+    void Reset()
+    {
+        g_calls = 0;
+        g_evaluations = 0;
+        g_lastFile = nullptr;
+    }
+}
+
+// 代替 mvvm_diagnostics.h 中的后端：只计数，不格式化
+namespace mvvm::diagnostics
+{
+    struct CompiledOut {};
+
+    // 只声明不定义：编译期丢弃的日志点若仍生成了调用，链接失败
+    void LogFormat(LogLevel, const char*, const char*, int, bool, std::wstring_view, int, CompiledOut);
+
+    template <typename... Args>
+    void LogFormat(LogLevel level, const char* file, const char*, int, bool, std::wstring_view, Args&&...)
+    {
+        ++g_calls;
+        g_lastLevel = level;
+        g_lastFile = file;
+    }
+}
+
+using namespace mvvm::diagnostics;
+
+namespace
+{
+    void DefaultsFollowCompiledThresholds()
+    {
+        static_assert(IsLogCompiledIn(LogSubsystem::General, LogLevel::Info));
+        static_assert(!IsLogCompiledIn(LogSubsystem::Commands, LogLevel::Fatal));
+        static_assert(!IsLogCompiledIn(LogSubsystem::Validation, LogLevel::Warning));
+        static_assert(IsLogCompiledIn(LogSubsystem::Validation, LogLevel::Error));
+        static_assert(!IsLogCompiledIn(LogSubsystem::General, LogLevel::Off));
+
+        NG_CHECK(GetLogThreshold(LogSubsystem::General) == LogLevel::Info);
+        NG_CHECK(GetLogThreshold(LogSubsystem::Commands) == LogLevel::Off);
+        NG_CHECK(GetLogThreshold(LogSubsystem::Validation) == LogLevel::Error);
+    }
+
+    // 编译期丢弃：不生成调用（见上面只声明的 LogFormat），参数不求值，运行期阈值也无法重新打开
+    void CompiledOutSitesAreDiscarded()
+    {
+        Reset();
+        SetLogThreshold(LogLevel::Info);
+        MVVM_LOGS(Commands, Fatal, L"{}", Evaluate(1), CompiledOut{});
+        MVVM_LOGS(Validation, Warning, L"{}", Evaluate(2), CompiledOut{});
+        NG_CHECK(g_evaluations == 0);
+        NG_CHECK(g_calls == 0);
+
+        MVVM_LOGS(Validation, Error, L"{}", Evaluate(3));
+        NG_CHECK(g_evaluations == 1);
+        NG_CHECK(g_calls == 1);
+    }
+
+    // 运行期关闭：在参数求值之前跳过
+    void RuntimeThresholdSkipsArguments()
+    {
+        Reset();
+        SetLogThreshold(LogSubsystem::Properties, LogLevel::Error);
+        MVVM_LOGS(Properties, Info, L"{} {}", Evaluate(1), Evaluate(2));
+        MVVM_LOGS(Properties, Warning, L"{}", Evaluate(3));
+        NG_CHECK(g_evaluations == 0);
+        NG_CHECK(g_calls == 0);
+
+        MVVM_LOGS(Properties, Error, L"{} {}", Evaluate(4), Evaluate(5));
+        NG_CHECK(g_evaluations == 2);
+        NG_CHECK(g_calls == 1);
+        NG_CHECK(g_lastLevel == LogLevel::Error);
+
+        // 只影响 Properties
+        MVVM_WARN(L"{}", Evaluate(6));
+        NG_CHECK(g_evaluations == 3);
+        NG_CHECK(g_calls == 2);
+
+        Reset();
+        SetLogThreshold(LogLevel::Off);
+        MVVM_FATAL(L"{}", Evaluate(7));
+        MVVM_LOGS(Properties, Fatal, L"{}", Evaluate(8));
+        NG_CHECK(g_evaluations == 0);
+        NG_CHECK(g_calls == 0);
+        SetLogThreshold(LogLevel::Info);
+    }
+
+    // 启用时参数恰好求值一次，文件名只保留最后一段
+    void EnabledSiteEvaluatesOnce()
+    {
+        Reset();
+        MVVM_INFO(L"{}", Evaluate(1));
+        NG_CHECK(g_evaluations == 1);
+        NG_CHECK(g_calls == 1);
+        NG_CHECK(g_lastLevel == LogLevel::Info);
+        NG_CHECK(g_lastFile && std::strcmp(g_lastFile, "log_filter_test.cpp") == 0);
+
+        MVVM_ERROR(L"complete message");
+        NG_CHECK(g_calls == 2);
+        NG_CHECK(g_lastLevel == LogLevel::Error);
+    }
+}
+
+int main()
+{
+    DefaultsFollowCompiledThresholds();
+    CompiledOutSitesAreDiscarded();
+    RuntimeThresholdSkipsArguments();
+    EnabledSiteEvaluatesOnce();
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "mvvm_log_queue.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mvvm::diagnostics;
+
+namespace
+{
+    // 容量取整为 2 的幂；满时 TryPush 失败且不移走值；空时 TryPop 失败；FIFO
+    void SingleThreadBasics()
+    {
+        NG_CHECK(MpscRingBuffer<int>(0).Capacity() == 2);
+        NG_CHECK(MpscRingBuffer<int>(5).Capacity() == 8);
+        NG_CHECK(MpscRingBuffer<int>(64).Capacity() == 64);
+
+        MpscRingBuffer<std::unique_ptr<int>> queue(4);
+        std::unique_ptr<int> out;
+        NG_CHECK(!queue.TryPop(out));
+
+        for (int round = 0; round < 3; ++round)     // 多轮绕回
+        {
+            for (int i = 0; i < 4; ++i)
+                NG_CHECK(queue.TryPush(std::make_unique<int>(round * 10 + i)));
+            auto rejected = std::make_unique<int>(-1);
+            NG_CHECK(!queue.TryPush(std::move(rejected)));
+            NG_CHECK(rejected && *rejected == -1);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                NG_CHECK(queue.TryPop(out));
+                NG_CHECK(out && *out == round * 10 + i);
+            }
+            NG_CHECK(!queue.TryPop(out));
+        }
+    }
+
+    struct Item
+    {
+        uint32_t producer{ 0 };
+        uint32_t sequence{ 0 };
+    };
+
+    // 多个生产者并发入队、单个消费者出队：不丢、不重，每个生产者内部保持顺序。
+    // 队列容量远小于总量，生产者满时让出重试，覆盖满/空边界的竞争
+    void MultiProducerKeepsPerProducerOrder(uint32_t producers, size_t capacity)
+    {
+        constexpr uint32_t PerProducer = 100000;
+        MpscRingBuffer<Item> queue(capacity);
+        std::atomic<bool> go{ false };
+
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]
+                {
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    for (uint32_t s = 0; s < PerProducer; ++s)
+                    {
+                        while (!queue.TryPush(Item{ p, s }))
+                            std::this_thread::yield();
+                    }
+                });
+        }
+
+        std::vector<uint32_t> next(producers, 0);
+        uint64_t received = 0;
+        uint64_t const total = uint64_t{ producers } * PerProducer;
+        go.store(true, std::memory_order_release);
+        while (received < total)
+        {
+            Item item;
+            if (!queue.TryPop(item))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            NG_CHECK(item.producer < producers);
+            NG_CHECK(item.sequence == next[item.producer]);
+            ++next[item.producer];
+            ++received;
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        Item extra;
+        NG_CHECK(!queue.TryPop(extra));
+        for (uint32_t p = 0; p < producers; ++p)
+            NG_CHECK(next[p] == PerProducer);
+    }
+}
+
+int main()
+{
+    SingleThreadBasics();
+    MultiProducerKeepsPerProducerOrder(1, 8);
+    MultiProducerKeepsPerProducerOrder(4, 8);
+    MultiProducerKeepsPerProducerOrder(8, 1024);
+    return 0;
+}
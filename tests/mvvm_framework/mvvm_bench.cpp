@@ -0,0 +1,445 @@
+#include "lazy_slot.h"
+#include "mvvm_log_queue.h"
+#include "mvvm_observable_vector.h"
+#include "mvvm_slot_columns.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// 微基准（不参与 ctest）：mvvm_bench [规模倍数]，默认 1。
+// 每项打印单次耗时，便于在改动前后对比；数值只在同一台机器上有比较意义。
+
+using namespace mvvm;
+
+namespace
+{
+    volatile double g_sink = 0;
+
+    // repeats > 1 时先预热一次，只计后续的平均值
+    template <typename F>
+    double Measure(int repeats, F&& body)
+    {
+        if (repeats > 1)
+            body();
+        auto const start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; ++i)
+            body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+    }
+
+    void Report(char const* name, double ms, char const* note = "")
+    {
+        std::printf("%-40s %10.3f ms  %s\n", name, ms, note);
+    }
+
+    // user-037：ApplyDiff 的键比较与编辑脚本（键取指针宽度的整数，相当于默认的 ABI 指针键）
+    void Diff(uint32_t n)
+    {
+        std::vector<uintptr_t> before(n);
+        std::iota(before.begin(), before.end(), uintptr_t{ 0x10000 });
+
+        // 删 10、中间插 5、移动 1
+        auto after = before;
+        after.erase(after.begin() + 100, after.begin() + 110);
+        after.insert(after.begin() + n / 2, { 1, 2, 3, 4, 5 });
+        std::rotate(after.begin() + n * 4 / 5, after.begin() + n * 4 / 5 + 1, after.begin() + n * 4 / 5 + 20);
+        std::vector<uintptr_t> reversed(before.rbegin(), before.rend());
+
+        constexpr uint32_t Threshold = 64;   // RangeObservableVector::DefaultResetThreshold
+        size_t sink = 0;
+        Report("diff unchanged", Measure(50, [&] { sink += diff::Compute(before, before, Threshold)->cost; }));
+        Report("diff 17 edits", Measure(50, [&] { sink += diff::Compute(before, after, Threshold)->cost; }));
+        Report("diff 17 edits + apply", Measure(50, [&]
+            {
+                auto values = before;
+                auto script = diff::Compute(before, after, Threshold);
+                size_t notifications = 0;
+                diff::ApplyEditScript(values, *script, after, [&](diff::Change, uint32_t) { ++notifications; });
+                sink += notifications;
+            }), "17 notifications instead of a Reset");
+        Report("diff reversed (gives up at threshold)", Measure(50, [&] { sink += diff::Compute(before, reversed, Threshold).has_value(); }));
+        Report("reset baseline (copy all)", Measure(50, [&] { auto values = after; sink += values.size(); }));
+        g_sink = g_sink + double(sink);
+    }
+
+    // user-028：VM 构造时的命令开销。模拟 DelegateCommand 的可移植部分：
+    // 两个 std::function（execute / canExecute）、若干依赖属性名、向 VM 的 PropertyChanged 挂接的订阅。
+    // WinRT 对象本身（implements<> 分配、弱引用表、事件 token）在 Linux 上无法测量，这里只比较框架侧的簿记。
+    struct FakeViewModel
+    {
+        std::vector<std::function<void(std::wstring const&)>> propertyChanged;
+        std::vector<std::pair<std::shared_ptr<void>, std::wstring>> cleanup;    // RegisterForAutoCleanup
+    };
+
+    struct FakeCommand
+    {
+        std::function<void()>       execute;
+        std::function<bool()>       canExecute;
+        std::vector<std::wstring>   dependsOn;
+        size_t                      canExecuteChanged{ 0 };
+    };
+
+    std::shared_ptr<FakeCommand> BuildCommand(FakeViewModel& vm, int i)
+    {
+        auto cmd = std::make_shared<FakeCommand>();
+        cmd->execute = [&vm, i] { g_sink = g_sink + i + double(vm.cleanup.size()); };
+        cmd->canExecute = [i] { return i % 2 == 0; };
+        cmd->dependsOn = { L"IsBusy", L"Property" + std::to_wstring(i) };
+        std::weak_ptr<FakeCommand> weak = cmd;
+        vm.propertyChanged.emplace_back([weak](std::wstring const& name)
+            {
+                if (auto strong = weak.lock())
+                {
+                    for (auto const& dep : strong->dependsOn)
+                        strong->canExecuteChanged += dep == name;
+                }
+            });
+        return cmd;
+    }
+
+    void LazyCommands(int commands, int bound)
+    {
+        constexpr int Repeats = 2000;
+        size_t sink = 0;
+
+        double const eager = Measure(Repeats, [&]
+            {
+                FakeViewModel vm;
+                std::vector<std::shared_ptr<FakeCommand>> slots;
+                slots.reserve(commands);
+                for (int i = 0; i < commands; ++i)
+                {
+                    slots.push_back(BuildCommand(vm, i));
+                    vm.cleanup.emplace_back(slots.back(), L"Command" + std::to_wstring(i));
+                }
+                sink += vm.propertyChanged.size() + vm.cleanup.size();
+            });
+
+        // 与 ViewModelBase::DefineLazyCommand 相同：工厂捕获 VM，onBuilt 捕获命令名并登记清理
+        using Slot = mvvm::LazySlot<std::shared_ptr<FakeCommand>>;
+        double const lazy = Measure(Repeats, [&]
+            {
+                FakeViewModel vm;
+                std::vector<std::unique_ptr<Slot>> slots;
+                slots.reserve(commands);
+                for (int i = 0; i < commands; ++i)
+                {
+                    slots.push_back(std::make_unique<Slot>());
+                    slots.back()->Define([&vm, i] { return BuildCommand(vm, i); },
+                        [&vm, name = L"Command" + std::to_wstring(i)](std::shared_ptr<FakeCommand> const& cmd)
+                        {
+                            vm.cleanup.emplace_back(cmd, name);
+                        });
+                }
+                for (int i = 0; i < bound; ++i)
+                    sink += slots[i * commands / bound]->Get() != nullptr;
+                sink += vm.propertyChanged.size() + vm.cleanup.size();
+            });
+
+        char note[64];
+        std::snprintf(note, sizeof(note), "%d commands, %d bound", commands, bound);
+        Report("commands eager (construct VM)", eager, note);
+        Report("commands lazy (construct VM + bind)", lazy, note);
+
+        // 构建后的访问路径：Get() 只是加锁读取
+        Slot slot{ [] { return std::make_shared<FakeCommand>(); } };
+        Report("lazy Get() after build (x1000)", Measure(Repeats, [&]
+            {
+                for (int i = 0; i < 1000; ++i)
+                    sink += slot.Get() != nullptr;
+            }));
+        g_sink = g_sink + double(sink);
+    }
+
+    // user-029：日志队列吞吐。producers 个线程各入队 perProducer 条，单个消费者持续出队，测量全部送达的总耗时。
+    // Logger::Enqueue 满时直接丢弃；这里满时让出重试，使每条都经过队列，另计满的次数。
+    // 负载为 64 字节的平凡结构，LogRecord 的格式化与写文件不在测量范围内。
+    // 核数少于生产者 + 1 时线程靠时间片交替，结果主要反映切换开销，与多核上的争用不可比。
+    struct QueueItem
+    {
+        uint64_t words[8]{};
+    };
+
+    template <typename Queue>
+    void QueueThroughput(char const* name, Queue& queue, uint32_t producers, uint32_t perProducer)
+    {
+        std::atomic<bool> go{ false };
+        std::atomic<uint32_t> finished{ 0 };
+        std::atomic<uint64_t> full{ 0 };
+        uint64_t received = 0;
+
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]
+                {
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    uint64_t localFull = 0;
+                    for (uint32_t i = 0; i < perProducer; ++i)
+                    {
+                        QueueItem item;
+                        item.words[0] = p;
+                        item.words[1] = i;
+                        while (!queue.TryPush(std::move(item)))
+                        {
+                            ++localFull;
+                            std::this_thread::yield();
+                        }
+                    }
+                    full += localFull;
+                    ++finished;
+                });
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        QueueItem item;
+        for (;;)
+        {
+            if (queue.TryPop(item))
+            {
+                ++received;
+                continue;
+            }
+            if (finished.load() == producers)
+            {
+                while (queue.TryPop(item))
+                    ++received;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        double const ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (auto& thread : threads)
+            thread.join();
+
+        uint64_t const total = uint64_t{ producers } * perProducer;
+        char note[96];
+        std::snprintf(note, sizeof(note), "%.1f ns/item, full %.2f%% of pushes, %u cores",
+            ms * 1e6 / double(total), 100.0 * double(full.load()) / double(total + full.load()),
+            std::thread::hardware_concurrency());
+        Report(name, ms, note);
+        g_sink = g_sink + double(received);
+    }
+
+    // 对照：std::mutex + std::deque 的无界队列
+    struct LockedQueue
+    {
+        std::mutex m;
+        std::deque<QueueItem> items;
+
+        bool TryPush(QueueItem&& value)
+        {
+            std::scoped_lock lock{ m };
+            items.push_back(std::move(value));
+            return true;
+        }
+
+        bool TryPop(QueueItem& out)
+        {
+            std::scoped_lock lock{ m };
+            if (items.empty())
+                return false;
+            out = items.front();
+            items.pop_front();
+            return true;
+        }
+    };
+
+    void LogQueue(uint32_t perProducer)
+    {
+        // 无争用：同一线程入队一条、出队一条，即 UI 线程写日志的最低开销
+        {
+            diagnostics::MpscRingBuffer<QueueItem> ring(4096);
+            LockedQueue locked;
+            QueueItem item;
+            Report("log ring buffer push+pop (x1000)", Measure(200, [&]
+                {
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        ring.TryPush(QueueItem{});
+                        ring.TryPop(item);
+                    }
+                }));
+            Report("mutex + deque push+pop (x1000)", Measure(200, [&]
+                {
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        locked.TryPush(QueueItem{});
+                        locked.TryPop(item);
+                    }
+                }));
+            g_sink = g_sink + double(item.words[0]);
+        }
+
+        char name[64];
+        for (uint32_t producers : { 1u, 2u, 4u })
+        {
+            diagnostics::MpscRingBuffer<QueueItem> ring(4096);     // MVVM_LOG_QUEUE_CAPACITY 的默认值
+            std::snprintf(name, sizeof(name), "log ring buffer, %u producer(s)", producers);
+            QueueThroughput(name, ring, producers, perProducer);
+
+            LockedQueue locked;
+            std::snprintf(name, sizeof(name), "mutex + deque, %u producer(s)", producers);
+            QueueThroughput(name, locked, producers, perProducer);
+        }
+    }
+
+    // 当前已分配的堆内存（字节）；无法取得时返回 0
+    size_t HeapInUse()
+    {
+#if defined(__GLIBC__)
+        return mallinfo2().uordblks;
+#else
+        return 0;
+#endif
+    }
+
+    // user-035：属性仓库（按类型分列）与每个属性一个对象的对比。
+    // 对照组模拟 ObservableXxx：独立分配、引用计数、虚表、一个事件（订阅者列表）和值本身；
+    // 真实的 COM 对象还有 WinRT 的弱引用表与各接口的虚表指针，只会更大，在 Linux 上无法测量。
+    struct PropertyObject
+    {
+        virtual ~PropertyObject() = default;
+        std::atomic<uint32_t> references{ 1 };
+        std::vector<std::function<void(PropertyObject const&)>> valueChanged;
+    };
+
+    template <typename T>
+    struct TypedPropertyObject : PropertyObject
+    {
+        explicit TypedPropertyObject(T v) : value(std::move(v)) {}
+        T value;
+
+        void Set(T const& v)
+        {
+            if (value == v)
+                return;
+            value = v;
+            for (auto const& handler : valueChanged)
+                handler(*this);
+        }
+    };
+
+    void PropertyStore(uint32_t n)
+    {
+        // 40% Double、30% Int32、20% Boolean、10% String，与按 VM 字段统计的比例相近
+        auto kindOf = [](uint32_t i)
+            {
+                uint32_t const r = i % 10;
+                return r < 4 ? mvvm::SlotKind::Double : r < 7 ? mvvm::SlotKind::Int32 : r < 9 ? mvvm::SlotKind::Boolean : mvvm::SlotKind::String;
+            };
+        char note[96];
+        size_t sink = 0;
+
+        {
+            size_t const before = HeapInUse();
+            std::vector<std::unique_ptr<PropertyObject>> objects;
+            double const fill = Measure(1, [&]
+                {
+                    objects.reserve(n);
+                    for (uint32_t i = 0; i < n; ++i)
+                    {
+                        switch (kindOf(i))
+                        {
+                        case mvvm::SlotKind::Double: objects.push_back(std::make_unique<TypedPropertyObject<double>>(i * 0.5)); break;
+                        case mvvm::SlotKind::Int32: objects.push_back(std::make_unique<TypedPropertyObject<int32_t>>(int32_t(i))); break;
+                        case mvvm::SlotKind::Boolean: objects.push_back(std::make_unique<TypedPropertyObject<bool>>(i % 3 == 0)); break;
+                        default: objects.push_back(std::make_unique<TypedPropertyObject<std::wstring>>(L"value")); break;
+                        }
+                    }
+                });
+            // 指针数组相当于 VM 中持有属性对象的字段，与仓库的句柄数组一样不计入
+            size_t const owners = objects.capacity() * sizeof(objects[0]);
+            std::snprintf(note, sizeof(note), "%.1f bytes/property (heap)", double(HeapInUse() - before - owners) / n);
+            Report("property objects fill", fill, note);
+
+            // 每个属性一个订阅者（绑定），逐个改写 Double 属性
+            for (auto& object : objects)
+                object->valueChanged.emplace_back([&sink](PropertyObject const&) { ++sink; });
+            std::snprintf(note, sizeof(note), "%.1f bytes/property with 1 handler", double(HeapInUse() - before - owners) / n);
+            Report("property objects set (doubles)", Measure(10, [&]
+                {
+                    static double bump = 0;
+                    bump += 1;
+                    for (uint32_t i = 0; i < n; i += 10)
+                        static_cast<TypedPropertyObject<double>*>(objects[i].get())->Set(bump);
+                }), note);
+        }
+
+        {
+            size_t const before = HeapInUse();
+            mvvm::SlotColumns<std::wstring> store;
+            std::vector<uint32_t> slots;
+            double const fill = Measure(1, [&]
+                {
+                    slots.reserve(n);
+                    for (uint32_t i = 0; i < n; ++i)
+                    {
+                        switch (kindOf(i))
+                        {
+                        case mvvm::SlotKind::Double: slots.push_back(store.Add<mvvm::SlotKind::Double>(i * 0.5)); break;
+                        case mvvm::SlotKind::Int32: slots.push_back(store.Add<mvvm::SlotKind::Int32>(int32_t(i))); break;
+                        case mvvm::SlotKind::Boolean: slots.push_back(store.Add<mvvm::SlotKind::Boolean>(i % 3 == 0)); break;
+                        default: slots.push_back(store.Add<mvvm::SlotKind::String>(L"value")); break;
+                        }
+                    }
+                });
+            // 句柄数组属于调用方（VM 字段），不计入仓库
+            size_t const heap = HeapInUse() - before - slots.capacity() * sizeof(uint32_t);
+            std::snprintf(note, sizeof(note), "%.1f bytes/property (heap), %.1f in columns",
+                double(heap) / n, double(store.CapacityBytes()) / n);
+            Report("property store fill", fill, note);
+
+            // 仓库只有一个 SlotChanged 事件，所有槽位共享一个订阅者
+            auto slotChanged = [&sink](uint32_t) { ++sink; };
+            Report("property store set (doubles)", Measure(10, [&]
+                {
+                    static double bump = 0;
+                    bump += 1;
+                    for (uint32_t i = 0; i < n; i += 10)
+                        if (store.Set<mvvm::SlotKind::Double>(slots[i], bump) == mvvm::SlotSetResult::Changed)
+                            slotChanged(slots[i]);
+                }));
+            Report("property store set (batched)", Measure(10, [&]
+                {
+                    static double bump = 0;
+                    bump += 1;
+                    store.BeginUpdate();
+                    for (int pass = 0; pass < 3; ++pass)    // 同一批内重复写入只通知一次
+                        for (uint32_t i = 0; i < n; i += 10)
+                            store.Set<mvvm::SlotKind::Double>(slots[i], bump + pass);
+                    for (auto slot : store.EndUpdate())
+                        slotChanged(slot);
+                }), "3 writes per slot, 1 notification");
+        }
+        g_sink = g_sink + double(sink);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t const scale = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+    Diff(50000 * scale);
+    LazyCommands(50 * scale, 5 * scale);
+    LogQueue(1000000 * scale);
+    PropertyStore(100000 * scale);
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "mvvm_observable_vector.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace mvvm;
+
+namespace
+{
+    // 最小编辑距离（只含插入、删除）= n + m - 2·LCS
+    uint32_t EditDistance(std::vector<int> const& a, std::vector<int> const& b)
+    {
+        std::vector<uint32_t> row(b.size() + 1, 0), prev(b.size() + 1, 0);
+        for (size_t i = 1; i <= a.size(); ++i)
+        {
+            std::swap(row, prev);
+            for (size_t j = 1; j <= b.size(); ++j)
+                row[j] = a[i - 1] == b[j - 1] ? prev[j - 1] + 1 : std::max(prev[j], row[j - 1]);
+        }
+        return static_cast<uint32_t>(a.size() + b.size() - 2 * row[b.size()]);
+    }
+
+    // 脚本首尾相接覆盖 a 与 b，相邻的段已合并，Keep 段两侧的键相等
+    void CheckScript(diff::EditScript const& script, std::vector<int> const& a, std::vector<int> const& b)
+    {
+        uint32_t oi = 0, ni = 0, cost = 0;
+        for (size_t r = 0; r < script.runs.size(); ++r)
+        {
+            auto const& run = script.runs[r];
+            NG_CHECK(run.count > 0);
+            if (r > 0)
+                NG_CHECK(script.runs[r - 1].kind != run.kind);
+            switch (run.kind)
+            {
+            case diff::EditKind::Keep:
+                NG_CHECK(run.oldIndex == oi && run.newIndex == ni);
+                for (uint32_t i = 0; i < run.count; ++i)
+                    NG_CHECK(a[oi + i] == b[ni + i]);
+                oi += run.count;
+                ni += run.count;
+                break;
+            case diff::EditKind::Remove:
+                NG_CHECK(run.oldIndex == oi);
+                oi += run.count;
+                cost += run.count;
+                break;
+            case diff::EditKind::Insert:
+                NG_CHECK(run.newIndex == ni);
+                ni += run.count;
+                cost += run.count;
+                break;
+            }
+        }
+        NG_CHECK(oi == a.size() && ni == b.size());
+        NG_CHECK(cost == script.cost);
+    }
+
+    // 按通知重放到镜像上，必须得到 next
+    template <typename T>
+    std::vector<diff::Change> ApplyAndReplay(std::vector<T> values, diff::EditScript const& script, std::vector<T> const& next)
+    {
+        auto mirror = values;
+        std::vector<diff::Change> changes;
+        diff::ApplyEditScript(values, script, next, [&](diff::Change change, uint32_t index)
+            {
+                changes.push_back(change);
+                switch (change)
+                {
+                case diff::Change::Inserted:
+                    NG_CHECK(index <= mirror.size());
+                    mirror.insert(mirror.begin() + index, values[index]);
+                    break;
+                case diff::Change::Removed:
+                    NG_CHECK(index < mirror.size());
+                    mirror.erase(mirror.begin() + index);
+                    break;
+                case diff::Change::Changed:
+                    NG_CHECK(index < mirror.size());
+                    mirror[index] = values[index];
+                    break;
+                }
+            });
+        NG_CHECK(values == next);
+        NG_CHECK(mirror == next);
+        return changes;
+    }
+
+    std::vector<int> Mutate(std::vector<int> v, std::mt19937& rng, int edits, int alphabet)
+    {
+        std::uniform_int_distribution<int> value(0, alphabet - 1);
+        for (int e = 0; e < edits; ++e)
+        {
+            std::uniform_int_distribution<size_t> at(0, v.size());
+            size_t const i = at(rng);
+            if (rng() % 2 && i < v.size())
+                v.erase(v.begin() + static_cast<std::ptrdiff_t>(i));
+            else
+                v.insert(v.begin() + static_cast<std::ptrdiff_t>(i), value(rng));
+        }
+        return v;
+    }
+
+    void EdgeCases()
+    {
+        std::vector<int> const empty;
+        std::vector<int> const abc{ 1, 2, 3 };
+
+        auto same = diff::Compute(abc, abc, 0);
+        NG_CHECK(same && same->cost == 0);
+        NG_CHECK(same->runs.size() == 1 && same->runs[0].kind == diff::EditKind::Keep && same->runs[0].count == 3);
+
+        auto none = diff::Compute(empty, empty, 0);
+        NG_CHECK(none && none->cost == 0 && none->runs.empty());
+
+        auto fill = diff::Compute(empty, abc, 3);
+        NG_CHECK(fill && fill->cost == 3);
+        CheckScript(*fill, empty, abc);
+        NG_CHECK(!diff::Compute(empty, abc, 2));     // 长度差即下界，直接放弃
+
+        auto drain = diff::Compute(abc, empty, 3);
+        NG_CHECK(drain && drain->cost == 3);
+        CheckScript(*drain, abc, empty);
+
+        // 只在中间插入：前后缀裁掉后只剩一个 Insert
+        std::vector<int> const middle{ 1, 2, 9, 3 };
+        auto insert = diff::Compute(abc, middle, 1);
+        NG_CHECK(insert && insert->cost == 1 && insert->runs.size() == 3);
+        NG_CHECK(insert->runs[1].kind == diff::EditKind::Insert && insert->runs[1].newIndex == 2);
+        CheckScript(*insert, abc, middle);
+
+        // 移动一个元素 = 删除 + 插入
+        std::vector<int> const moved{ 2, 3, 1 };
+        auto move = diff::Compute(abc, moved, 8);
+        NG_CHECK(move && move->cost == 2);
+        CheckScript(*move, abc, moved);
+        ApplyAndReplay(abc, *move, moved);
+    }
+
+    // 随机序列：代价等于最小编辑距离；maxCost 恰好小于距离时放弃
+    void RandomizedAgainstLcs()
+    {
+        std::mt19937 rng(37);
+        for (int round = 0; round < 3000; ++round)
+        {
+            int const alphabet = round % 3 == 0 ? 3 : 50;   // 小字母表制造大量重复键
+            std::uniform_int_distribution<int> len(0, 40);
+            std::uniform_int_distribution<int> value(0, alphabet - 1);
+            std::vector<int> a(static_cast<size_t>(len(rng)));
+            for (auto& x : a)
+                x = value(rng);
+            auto b = round % 2 ? Mutate(a, rng, round % 12, alphabet) : std::vector<int>(static_cast<size_t>(len(rng)));
+            if (round % 2 == 0)
+                for (auto& x : b)
+                    x = value(rng);
+
+            uint32_t const distance = EditDistance(a, b);
+            auto script = diff::Compute(a, b, distance);
+            NG_CHECK(script);
+            NG_CHECK(script->cost == distance);
+            CheckScript(*script, a, b);
+            ApplyAndReplay(a, *script, b);
+
+            auto generous = diff::Compute(a, b, distance + 5);
+            NG_CHECK(generous && generous->cost == distance);
+            if (distance > 0)
+                NG_CHECK(!diff::Compute(a, b, distance - 1));
+        }
+    }
+
+    struct Item
+    {
+        int id{ 0 };
+        int version{ 0 };
+        friend bool operator==(Item const&, Item const&) = default;
+    };
+
+    std::vector<int> IdsOf(std::vector<Item> const& items)
+    {
+        std::vector<int> ids;
+        for (auto const& item : items)
+            ids.push_back(item.id);
+        return ids;
+    }
+
+    // 业务键：键相同而值不同的元素以 Changed 替换；按值比较（相当于默认的 IdentityKey）时只有插入与删除
+    void ChangedOnlyForSameKeyNewValue()
+    {
+        std::vector<Item> const before{ { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 } };
+        std::vector<Item> const after{ { 1, 0 }, { 2, 1 }, { 4, 0 }, { 5, 0 } };
+
+        auto byId = diff::Compute(IdsOf(before), IdsOf(after), 64);
+        NG_CHECK(byId && byId->cost == 2);
+        auto changes = ApplyAndReplay(before, *byId, after);
+        NG_CHECK(std::count(changes.begin(), changes.end(), diff::Change::Changed) == 1);
+        NG_CHECK(changes.size() == 3);
+
+        auto byValue = diff::Compute(before, after, 64);
+        NG_CHECK(byValue && byValue->cost == 4);
+        changes = ApplyAndReplay(before, *byValue, after);
+        NG_CHECK(std::count(changes.begin(), changes.end(), diff::Change::Changed) == 0);
+        NG_CHECK(changes.size() == 4);
+
+        // 无变化：不产生通知
+        std::vector<Item> copy = before;
+        auto unchanged = diff::Compute(IdsOf(before), IdsOf(before), 0);
+        NG_CHECK(!diff::ApplyEditScript(copy, *unchanged, before, [](diff::Change, uint32_t) { NG_CHECK(false); }));
+    }
+
+    // 50k 元素、少量编辑：只在中间部分搜索，结果仍为最小编辑；超出阈值时放弃
+    void LargeListFewEdits()
+    {
+        std::vector<int> a(50000);
+        std::iota(a.begin(), a.end(), 0);
+        auto b = a;
+        b.erase(b.begin() + 100, b.begin() + 110);                  // 删 10
+        b.insert(b.begin() + 25000, { -1, -2, -3, -4, -5 });        // 插 5
+        std::rotate(b.begin() + 40000, b.begin() + 40001, b.begin() + 40020);   // 移动 1 = 删 1 + 插 1
+
+        auto script = diff::Compute(a, b, 64);
+        NG_CHECK(script && script->cost == 17);
+        CheckScript(*script, a, b);
+        ApplyAndReplay(a, *script, b);
+
+        std::vector<int> reversed(a.rbegin(), a.rend());
+        NG_CHECK(!diff::Compute(a, reversed, 64));
+    }
+}
+
+int main()
+{
+    EdgeCases();
+    RandomizedAgainstLcs();
+    ChangedOnlyForSameKeyNewValue();
+    LargeListFewEdits();
+    return 0;
+}
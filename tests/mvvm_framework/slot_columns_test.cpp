@@ -0,0 +1,96 @@
+#include "mvvm_slot_columns.h"
+#include "test_check.h"
+
+#include <string>
+#include <vector>
+
+using namespace mvvm;
+
+namespace
+{
+    using Columns = SlotColumns<std::wstring>;
+
+    // 句柄：高 8 位为类型、低 24 位为列内下标；各列独立编号
+    void HandlesEncodeKindAndIndex()
+    {
+        Columns columns;
+        auto const b0 = columns.Add<SlotKind::Boolean>(true);
+        auto const i0 = columns.Add<SlotKind::Int32>(7);
+        auto const i1 = columns.Add<SlotKind::Int32>(-3);
+        auto const s0 = columns.Add<SlotKind::String>(L"name");
+        NG_CHECK(b0 == 0);
+        NG_CHECK(i0 == (uint32_t(SlotKind::Int32) << Columns::IndexBits));
+        NG_CHECK(i1 == i0 + 1);
+        NG_CHECK((s0 >> Columns::IndexBits) == uint32_t(SlotKind::String));
+        NG_CHECK(columns.Count() == 4);
+
+        NG_CHECK(columns.Get<SlotKind::Boolean>(b0));
+        NG_CHECK(columns.Get<SlotKind::Int32>(i1) == -3);
+        NG_CHECK(columns.Get<SlotKind::String>(s0) == L"name");
+
+        // 类型不符、下标越界、类型越界都无效
+        NG_CHECK(columns.IsValid<SlotKind::Int32>(i1));
+        NG_CHECK(!columns.IsValid<SlotKind::Int64>(i1));
+        NG_CHECK(!columns.IsValid<SlotKind::Int32>(i1 + 1));
+        NG_CHECK(!Columns::IsValidKind(uint32_t(SlotKind::Count) << Columns::IndexBits));
+        NG_CHECK(Columns::IsValidKind(s0));
+
+        uint32_t visited = 0xFF;
+        Columns::VisitKind(s0 >> Columns::IndexBits, [&](auto kind) { visited = uint32_t(decltype(kind)::value); });
+        NG_CHECK(visited == uint32_t(SlotKind::String));
+    }
+
+    // 值不变不通知；批量更新外立即通知，批量中按槽位合并，在最外层 EndUpdate 按首次变化的顺序返回
+    void SetCoalescesInsideUpdate()
+    {
+        Columns columns;
+        auto const a = columns.Add<SlotKind::Double>(1.0);
+        auto const b = columns.Add<SlotKind::String>(L"x");
+        auto const c = columns.Add<SlotKind::Boolean>(false);
+
+        NG_CHECK(columns.Set<SlotKind::Double>(a, 1.0) == SlotSetResult::Unchanged);
+        NG_CHECK(columns.Set<SlotKind::Double>(a, 2.0) == SlotSetResult::Changed);
+
+        columns.BeginUpdate();
+        columns.BeginUpdate();
+        NG_CHECK(columns.Set<SlotKind::String>(b, L"y") == SlotSetResult::Deferred);
+        NG_CHECK(columns.Set<SlotKind::Double>(a, 3.0) == SlotSetResult::Deferred);
+        NG_CHECK(columns.Set<SlotKind::String>(b, L"z") == SlotSetResult::Deferred);
+        NG_CHECK(columns.Set<SlotKind::Boolean>(c, false) == SlotSetResult::Unchanged);
+        NG_CHECK(columns.EndUpdate().empty());       // 内层
+        NG_CHECK(columns.UpdateDepth() == 1);
+        auto const raised = columns.EndUpdate();
+        NG_CHECK(raised == (std::vector<uint32_t>{ b, a }));
+        NG_CHECK(columns.UpdateDepth() == 0);
+        NG_CHECK(columns.Get<SlotKind::String>(b) == L"z");
+
+        // 待通知标记已清除：下一轮批量更新再次记录
+        columns.BeginUpdate();
+        NG_CHECK(columns.Set<SlotKind::String>(b, L"w") == SlotSetResult::Deferred);
+        NG_CHECK(columns.EndUpdate() == (std::vector<uint32_t>{ b }));
+    }
+
+    // bool 列按位存放；容量统计随槽位增长
+    void CapacityGrowsWithSlots()
+    {
+        Columns columns;
+        size_t const empty = columns.CapacityBytes();
+        for (int i = 0; i < 1000; ++i)
+            columns.Add<SlotKind::Boolean>(i % 2 == 0);
+        size_t const bools = columns.CapacityBytes();
+        NG_CHECK(bools > empty);
+        NG_CHECK(bools - empty < 1000 * 2);         // 值按位 + 每槽 1 字节待通知标记
+        for (int i = 0; i < 1000; ++i)
+            columns.Add<SlotKind::Double>(i);
+        NG_CHECK(columns.CapacityBytes() - bools >= 1000 * (sizeof(double) + 1));
+        NG_CHECK(columns.Get<SlotKind::Boolean>(998) && !columns.Get<SlotKind::Boolean>(999));
+    }
+}
+
+int main()
+{
+    HandlesEncodeKindAndIndex();
+    SetCoalescesInsideUpdate();
+    CapacityGrowsWithSlots();
+    return 0;
+}
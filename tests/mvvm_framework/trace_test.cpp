@@ -0,0 +1,195 @@
+#include "mvvm_trace.h"
+#include "mvvm_trace_reader.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mvvm::trace;
+
+namespace
+{
+    std::filesystem::path TempTracePath(char const* stem)
+    {
+        std::random_device rd;
+        return std::filesystem::temp_directory_path()
+            / std::string{ stem }.append("_").append(std::to_string(rd())).append(".mvtrace");
+    }
+
+    std::string NameFor(uint32_t thread, uint32_t index)
+    {
+        return std::string("T").append(std::to_string(thread)).append(".Property").append(std::to_string(index % 700));
+    }
+
+    std::wstring WideNameFor(uint32_t thread, uint32_t index)
+    {
+        auto narrow = NameFor(thread, index);
+        return std::wstring(narrow.begin(), narrow.end());
+    }
+
+    // 多线程写入 -> 读取：事件数、名称、按线程的时间顺序都与写入一致；
+    // 块大小取最小值，使事件块与字符串块都跨越多个块
+    void RoundTripAcrossChunks()
+    {
+        constexpr uint32_t Threads = 4;
+        constexpr uint32_t PerThread = 6000;
+        auto path = TempTracePath("round_trip");
+
+        TraceWriter writer;
+        NG_CHECK(writer.Open(path, 1));
+        std::atomic<uint64_t> clock{ 0 };
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < Threads; ++t)
+        {
+            threads.emplace_back([&, t]
+                {
+                    for (uint32_t i = 0; i < PerThread; ++i)
+                    {
+                        TraceEvent e{};
+                        e.timestampNs = clock.fetch_add(1);
+                        e.threadId = t + 1;
+                        e.arg = t * PerThread + i;
+                        e.kind = i % 2 ? EventKind::PropertySet : EventKind::Execute;
+                        e.phase = Phase::Complete;
+                        e.durationNs = i;
+                        // 窄、宽名称交替，两者驻留到同一张表
+                        if (i % 3 == 0)
+                            writer.Write(e, std::wstring_view{ WideNameFor(t, i) });
+                        else
+                            writer.Write(e, std::string_view{ NameFor(t, i) });
+                    }
+                });
+        }
+        for (auto& th : threads)
+            th.join();
+        writer.Close();
+
+        auto file = ReadTraceFile(path);
+        NG_CHECK(file.header.chunkSize == TraceChunkAlignment);
+        NG_CHECK(file.events.size() == size_t{ Threads } * PerThread);
+        NG_CHECK(std::filesystem::file_size(path) > 4 * TraceChunkAlignment);
+        NG_CHECK(file.strings.size() == size_t{ Threads } * 700);
+
+        std::vector<int64_t> lastIndex(Threads, -1);
+        for (auto const& e : file.events)
+        {
+            uint32_t t = e.arg / PerThread;
+            uint32_t i = e.arg % PerThread;
+            NG_CHECK(t < Threads && e.threadId == t + 1);
+            NG_CHECK(file.NameOf(e.nameId) == NameFor(t, i));
+            NG_CHECK(e.durationNs == i);
+            NG_CHECK(static_cast<int64_t>(i) > lastIndex[t]);   // 读取端按时间戳排序，同一线程保持写入顺序
+            lastIndex[t] = i;
+        }
+        std::filesystem::remove(path);
+    }
+
+    // 不调用 Close（相当于进程在写入中途崩溃）：已写入的事件和它们引用的名称都能读出
+    void ReadableWithoutClose()
+    {
+        auto path = TempTracePath("no_close");
+        TraceWriter writer;
+        NG_CHECK(writer.Open(path));
+
+        TraceEvent e{};
+        e.kind = EventKind::PropertySet;
+        e.timestampNs = 10;
+        writer.Write(e, std::wstring_view{ L"FirstName" });
+        e.timestampNs = 20;
+        writer.Write(e, std::string_view{ "ResetCommand" });
+        e.timestampNs = 30;
+        writer.Write(e, std::wstring_view{ L"年龄" });
+
+        auto file = ReadTraceFile(path);
+        NG_CHECK(file.events.size() == 3);
+        NG_CHECK(file.NameOf(file.events[0].nameId) == "FirstName");
+        NG_CHECK(file.NameOf(file.events[1].nameId) == "ResetCommand");
+        NG_CHECK(file.NameOf(file.events[2].nameId) == "\xE5\xB9\xB4\xE9\xBE\x84");
+
+        writer.Close();
+        std::filesystem::remove(path);
+    }
+
+    // ts / dur 以微秒输出且保留纳秒位：12,345,678,901 ns -> 12345678.901
+    void ChromeJsonKeepsNanoseconds()
+    {
+        TraceFile file;
+        file.strings.emplace(1, "Save\"Command");
+
+        TraceEvent complete{};
+        complete.timestampNs = 12'345'678'901ull;
+        complete.durationNs = 1'500;
+        complete.nameId = 1;
+        complete.kind = EventKind::Execute;
+        complete.phase = Phase::Complete;
+        file.events.push_back(complete);
+
+        TraceEvent instant{};
+        instant.timestampNs = 7;
+        instant.kind = EventKind::Marker;
+        instant.phase = Phase::Instant;
+        file.events.push_back(instant);
+
+        std::ostringstream out;
+        WriteChromeTraceJson(file, out);
+        auto json = out.str();
+        NG_CHECK(json.find("\"ts\":12345678.901,") != std::string::npos);
+        NG_CHECK(json.find("\"dur\":1.500,") != std::string::npos);
+        NG_CHECK(json.find("\"ts\":0.007,") != std::string::npos);
+        NG_CHECK(json.find("\"name\":\"Save\\\"Command\"") != std::string::npos);
+        NG_CHECK(json.find("\"name\":\"Marker\"") != std::string::npos);
+    }
+
+    // 记录线程与 Start/Stop 并发：Start 重设时间起点时其他线程正在 NowNs 中读取（TSan 下检查数据竞争）
+    void TracerRestartWhileEmitting()
+    {
+        auto& tracer = Tracer::Instance();
+        auto path = TempTracePath("tracer");
+        std::atomic<bool> stop{ false };
+        std::vector<std::thread> emitters;
+        for (int t = 0; t < 3; ++t)
+        {
+            emitters.emplace_back([&]
+                {
+                    while (!stop.load())
+                    {
+                        TraceScope scope{ EventKind::Validate, std::string_view{ "Age" } };
+                        scope.Arg(1);
+                        tracer.Instant(EventKind::Marker, std::wstring_view{ L"tick" });
+                    }
+                });
+        }
+        for (int round = 0; round < 20; ++round)
+        {
+            NG_CHECK(tracer.Start(path, TraceChunkAlignment));
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+        }
+        stop.store(true);
+        for (auto& th : emitters)
+            th.join();
+        tracer.Stop();
+
+        auto file = ReadTraceFile(path);
+        NG_CHECK(!file.events.empty());
+        for (auto const& e : file.events)
+        {
+            auto name = file.NameOf(e.nameId);
+            NG_CHECK(name == "Age" || name == "tick");
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+int main()
+{
+    RoundTripAcrossChunks();
+    ReadableWithoutClose();
+    ChromeJsonKeepsNanoseconds();
+    TracerRestartWhileEmitting();
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "ColorKernels.h"
+#include "test_check.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// 同一份源码按三种指令集编译（见 CMakeLists.txt）：每个变体都把批量函数与单色函数（纯标量实现）逐位比较，
+// 标量变体另外覆盖批量函数自身的标量回退。长度取遍 0..40 以覆盖向量宽度之外的尾部。
+
+using namespace nodegraph;
+
+namespace
+{
+    char const* Path()
+    {
+#if NODEGRAPH_COLOR_AVX2
+        return "avx2";
+#elif NODEGRAPH_COLOR_SSE2
+        return "sse2";
+#elif NODEGRAPH_COLOR_NEON
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+    std::vector<Rgba> RandomColors(std::mt19937& rng, size_t n)
+    {
+        std::vector<Rgba> colors(n);
+        for (auto& c : colors)
+            c = std::bit_cast<Rgba>(static_cast<uint32_t>(rng()));
+        return colors;
+    }
+
+    // 双精度的 WCAG 公式，验证查找表本身
+    double ReferenceLuminance(Rgba c)
+    {
+        auto lin = [](double u)
+            {
+                u /= 255.0;
+                return u <= 0.03928 ? u / 12.92 : std::pow((u + 0.055) / 1.055, 2.4);
+            };
+        return 0.2126 * lin(c.r) + 0.7152 * lin(c.g) + 0.0722 * lin(c.b);
+    }
+
+    void CheckBatch(std::mt19937& rng, size_t n)
+    {
+        auto const colors = RandomColors(rng, n);
+        auto const other = RandomColors(rng, n);
+
+        std::vector<float> lum(n);
+        Luminance(colors, lum);
+        for (size_t i = 0; i < n; ++i)
+        {
+            NG_CHECK(lum[i] == RelativeLuminance(colors[i]));
+            NG_CHECK(std::abs(lum[i] - ReferenceLuminance(colors[i])) < 1e-6);
+        }
+
+        Rgba const against = other.empty() ? ContrastDark : other.front();
+        std::vector<float> ratio(n);
+        ContrastRatio(colors, against, ratio);
+        for (size_t i = 0; i < n; ++i)
+            NG_CHECK(ratio[i] == ContrastRatio(colors[i], against));
+
+        for (float threshold : { 1.0f, 3.0f, 4.5f, 7.0f, 21.0f })
+        {
+            auto text = other;
+            AutoContrastText(colors, text, threshold);
+            for (size_t i = 0; i < n; ++i)
+            {
+                Rgba const expected = ContrastRatio(colors[i], other[i]) >= threshold
+                    ? other[i] : ContrastText(RelativeLuminance(colors[i]));
+                NG_CHECK(text[i] == expected);
+            }
+        }
+
+        for (float delta : { 0.0f, 0.2f, -0.2f, 0.35f, -0.35f, 1.0f, -1.0f, 2.0f })
+        {
+            std::vector<Rgba> out(n);
+            Shade(colors, delta, out);
+            for (size_t i = 0; i < n; ++i)
+                NG_CHECK(out[i] == Shade(colors[i], delta));
+
+            // 原地
+            auto inPlace = colors;
+            Shade(inPlace, delta, inPlace);
+            NG_CHECK(inPlace == out);
+        }
+
+        for (float amount : { 0.0f, 0.35f, 1.0f })
+        {
+            std::vector<Rgba> out(n);
+            AutoShade(colors, amount, out);
+            for (size_t i = 0; i < n; ++i)
+                NG_CHECK(out[i] == Shade(colors[i], RelativeLuminance(colors[i]) > 0.5f ? -amount : amount));
+        }
+    }
+
+    void CheckRamp(std::mt19937& rng)
+    {
+        Rgba const stops[] = { { 0, 0, 255, 255 }, { 0, 255, 0, 255 }, { 255, 0, 0, 128 } };
+        ColorRamp ramp(stops);
+        NG_CHECK(ramp.At(0) == stops[0]);
+        NG_CHECK(ramp.At(255) == stops[2]);
+
+        for (size_t n : { size_t{ 0 }, size_t{ 3 }, size_t{ 9 }, size_t{ 1027 } })
+        {
+            std::vector<float> values(n);
+            for (auto& v : values)
+                v = float(int(rng() % 3000) - 1000) / 10.0f;
+            if (n > 8)
+            {
+                values[3] = std::numeric_limits<float>::quiet_NaN();
+                values[4] = std::numeric_limits<float>::infinity();
+                values[5] = -std::numeric_limits<float>::infinity();
+            }
+            std::vector<Rgba> out(n);
+            ramp.Map(values, 0.0f, 100.0f, out);
+            for (size_t i = 0; i < n; ++i)
+            {
+                float x = values[i] * (255.0f / 100.0f);
+                x = x > 0.0f ? std::min(x, 255.0f) : 0.0f;
+                NG_CHECK(out[i] == ramp.At(static_cast<uint8_t>(x + 0.5f)));
+            }
+            if (n > 8)
+                NG_CHECK(out[3] == stops[0] && out[4] == stops[2] && out[5] == stops[0]);
+
+            // 空区间：全部取最低端
+            ramp.Map(values, 5.0f, 5.0f, out);
+            for (auto const& c : out)
+                NG_CHECK(c == stops[0]);
+        }
+    }
+}
+
+int main()
+{
+#if NODEGRAPH_COLOR_AVX2 && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        std::puts("color_kernels_test: avx2 not supported on this CPU, skipped");
+        return NG_SKIP;
+    }
+#endif
+    std::mt19937 rng(50);
+    for (size_t n = 0; n <= 40; ++n)
+        CheckBatch(rng, n);
+    CheckBatch(rng, 10007);
+    CheckRamp(rng);
+    std::printf("color_kernels_test (%s): ok\n", Path());
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include "DisplayList.h"
+#include "test_check.h"
+
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace nodegraph;
+
+namespace
+{
+    bool SameSegment(Segment const& a, Segment const& b)
+    {
+        return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+    }
+
+    // 只靠变更日志维护的镜像（NodeGraphPanel 的 Path 几何同样如此）
+    struct Mirror
+    {
+        std::vector<std::vector<Box>>     nodes;
+        std::vector<std::vector<Segment>> edges;
+        size_t                            resets{ 0 };
+
+        template <typename Instance>
+        static void Apply(std::vector<std::vector<Instance>>& batches, DisplayList::Change const& c, Instance const& value)
+        {
+            switch (c.kind)
+            {
+            case DisplayList::ChangeKind::AddBatch:
+                NG_CHECK(c.batch == batches.size());
+                batches.emplace_back();
+                break;
+            case DisplayList::ChangeKind::Append:
+                NG_CHECK(c.batch < batches.size());
+                NG_CHECK(c.index == batches[c.batch].size());
+                batches[c.batch].push_back(value);
+                break;
+            case DisplayList::ChangeKind::Update:
+                NG_CHECK(c.batch < batches.size() && c.index < batches[c.batch].size());
+                batches[c.batch][c.index] = value;
+                break;
+            case DisplayList::ChangeKind::RemoveSwap:
+                NG_CHECK(c.batch < batches.size() && c.index < batches[c.batch].size());
+                batches[c.batch][c.index] = batches[c.batch].back();
+                batches[c.batch].pop_back();
+                break;
+            case DisplayList::ChangeKind::Reset:
+                break;
+            }
+        }
+
+        void Replay(DisplayList& list)
+        {
+            list.ConsumeChanges([this](DisplayList::Change const& c)
+                {
+                    if (c.kind == DisplayList::ChangeKind::Reset)
+                    {
+                        nodes.clear();
+                        edges.clear();
+                        ++resets;
+                    }
+                    else if (c.layer == DisplayList::Layer::Nodes)
+                        Apply(nodes, c, c.bounds);
+                    else
+                        Apply(edges, c, c.segment);
+                });
+            NG_CHECK(!list.HasChanges());
+        }
+
+        void CheckMatches(DisplayList const& list) const
+        {
+            NG_CHECK(nodes.size() == list.NodeBatches().size());
+            for (size_t b = 0; b < nodes.size(); ++b)
+                NG_CHECK(nodes[b] == list.NodeBatches()[b].instances);
+
+            NG_CHECK(edges.size() == list.EdgeBatches().size());
+            for (size_t b = 0; b < edges.size(); ++b)
+            {
+                auto const& actual = list.EdgeBatches()[b].instances;
+                NG_CHECK(edges[b].size() == actual.size());
+                for (size_t i = 0; i < actual.size(); ++i)
+                    NG_CHECK(SameSegment(edges[b][i], actual[i]));
+            }
+        }
+    };
+
+    NodeStyle NodeStyleOf(int variant)
+    {
+        NodeStyle style;
+        style.shape = variant % 2 ? Primitive::RoundedRect : Primitive::Ellipse;
+        style.fill = Rgba{ static_cast<uint8_t>(40 * variant), 80, 120, 255 };
+        style.cornerRadius = variant % 2 ? 4.0f : 0.0f;
+        return style;
+    }
+
+    EdgeStyle EdgeStyleOf(int variant)
+    {
+        return EdgeStyle{ Rgba{ 0, 0, static_cast<uint8_t>(60 * variant), 255 }, 1.0f + variant };
+    }
+
+    // 批次按样式去重，只有新样式才写入 AddBatch
+    void BatchesAreSharedByStyle()
+    {
+        DisplayList list;
+        auto const a = list.NodeBatchFor(NodeStyleOf(0));
+        auto const b = list.NodeBatchFor(NodeStyleOf(1));
+        NG_CHECK(a != b);
+        NG_CHECK(list.NodeBatchFor(NodeStyleOf(0)) == a);
+        NG_CHECK(list.EdgeBatchFor(EdgeStyleOf(0)) == 0);   // 节点与边的批次各自编号
+
+        size_t adds = 0;
+        list.ConsumeChanges([&](DisplayList::Change const& c)
+            {
+                NG_CHECK(c.kind == DisplayList::ChangeKind::AddBatch);
+                ++adds;
+            });
+        NG_CHECK(adds == 3);
+        NG_CHECK(list.NodeBatchFor(NodeStyleOf(1)) == b);
+        NG_CHECK(!list.HasChanges());
+    }
+
+    // 同批原位更新；换批先删后加；删除把末尾实例换到空位
+    void SetMoveAndRemoveRecordMinimalChanges()
+    {
+        DisplayList list;
+        Mirror mirror;
+        auto const red = list.NodeBatchFor(NodeStyleOf(1));
+        auto const blue = list.NodeBatchFor(NodeStyleOf(2));
+        for (uint32_t key = 0; key < 3; ++key)
+            list.SetNode(key, red, Box::FromRect(10.0f * key, 0, 5, 5));
+        mirror.Replay(list);
+        mirror.CheckMatches(list);
+
+        std::vector<DisplayList::Change> changes;
+        auto collect = [&] { changes.clear(); list.ConsumeChanges([&](DisplayList::Change const& c) { changes.push_back(c); }); };
+
+        list.SetNode(1, red, Box::FromRect(11, 1, 5, 5));
+        collect();
+        NG_CHECK(changes.size() == 1);
+        NG_CHECK(changes[0].kind == DisplayList::ChangeKind::Update && changes[0].index == 1);
+        NG_CHECK(changes[0].bounds == Box::FromRect(11, 1, 5, 5));
+
+        list.SetNode(0, blue, Box::FromRect(0, 0, 5, 5));
+        collect();
+        NG_CHECK(changes.size() == 2);
+        NG_CHECK(changes[0].kind == DisplayList::ChangeKind::RemoveSwap && changes[0].batch == red && changes[0].index == 0);
+        NG_CHECK(changes[1].kind == DisplayList::ChangeKind::Append && changes[1].batch == blue && changes[1].index == 0);
+        NG_CHECK(list.NodeBatches()[red].keys == (std::vector<uint32_t>{ 2, 1 }));
+
+        list.RemoveNode(7);     // 不存在
+        list.RemoveNode(0);
+        list.RemoveNode(0);     // 已删除
+        collect();
+        NG_CHECK(changes.size() == 1);
+        NG_CHECK(!list.ContainsNode(0) && list.ContainsNode(1) && list.ContainsNode(2));
+        NG_CHECK(list.NodeCount() == 2);
+
+        list.Clear();
+        collect();
+        NG_CHECK(changes.size() == 1 && changes[0].kind == DisplayList::ChangeKind::Reset);
+        NG_CHECK(list.NodeCount() == 0 && list.NodeBatches().empty());
+    }
+
+    // 随机增删改（含换批与 Clear），每隔若干步回放一次日志，镜像必须与列表一致，
+    // 且每个键都能在其所在批次、所在下标找到自己的实例
+    void RandomizedJournalReplay()
+    {
+        std::mt19937 rng(41);
+        std::uniform_int_distribution<uint32_t> keyOf(0, 299);
+        std::uniform_int_distribution<int> styleOf(0, 3);
+        std::uniform_int_distribution<int> op(0, 99);
+        std::uniform_real_distribution<float> pos(-1000.0f, 1000.0f);
+
+        DisplayList list;
+        Mirror mirror;
+        std::map<uint32_t, std::pair<NodeStyle, Box>> nodes;
+        std::map<uint32_t, std::pair<EdgeStyle, Segment>> edges;
+
+        for (int step = 0; step < 20000; ++step)
+        {
+            int const r = op(rng);
+            uint32_t const key = keyOf(rng);
+            if (r < 35)
+            {
+                auto const style = NodeStyleOf(styleOf(rng));
+                auto const box = Box::FromRect(pos(rng), pos(rng), 40, 20);
+                list.SetNode(key, list.NodeBatchFor(style), box);
+                nodes[key] = { style, box };
+            }
+            else if (r < 50)
+            {
+                list.RemoveNode(key);
+                nodes.erase(key);
+            }
+            else if (r < 85)
+            {
+                auto const style = EdgeStyleOf(styleOf(rng));
+                Segment const s{ pos(rng), pos(rng), pos(rng), pos(rng) };
+                list.SetEdge(key, list.EdgeBatchFor(style), s);
+                edges[key] = { style, s };
+            }
+            else if (r < 99)
+            {
+                list.RemoveEdge(key);
+                edges.erase(key);
+            }
+            else if (step % 7 == 0)
+            {
+                list.Clear();
+                nodes.clear();
+                edges.clear();
+            }
+
+            if (step % 97 == 0)
+            {
+                mirror.Replay(list);
+                mirror.CheckMatches(list);
+            }
+        }
+        mirror.Replay(list);
+        mirror.CheckMatches(list);
+        NG_CHECK(mirror.resets > 0);
+
+        NG_CHECK(list.NodeCount() == nodes.size());
+        NG_CHECK(list.EdgeCount() == edges.size());
+        for (uint32_t key = 0; key < 300; ++key)
+        {
+            NG_CHECK(list.ContainsNode(key) == nodes.contains(key));
+            NG_CHECK(list.ContainsEdge(key) == edges.contains(key));
+        }
+
+        size_t seen = 0;
+        for (auto const& batch : list.NodeBatches())
+        {
+            NG_CHECK(batch.keys.size() == batch.instances.size());
+            for (size_t i = 0; i < batch.keys.size(); ++i)
+            {
+                auto const& [style, box] = nodes.at(batch.keys[i]);
+                NG_CHECK(batch.style == style);
+                NG_CHECK(batch.instances[i] == box);
+                ++seen;
+            }
+        }
+        for (auto const& batch : list.EdgeBatches())
+        {
+            for (size_t i = 0; i < batch.keys.size(); ++i)
+            {
+                auto const& [style, segment] = edges.at(batch.keys[i]);
+                NG_CHECK(batch.style == style);
+                NG_CHECK(SameSegment(batch.instances[i], segment));
+                ++seen;
+            }
+        }
+        NG_CHECK(seen == nodes.size() + edges.size());
+    }
+}
+
+int main()
+{
+    BatchesAreSharedByStyle();
+    SetMoveAndRemoveRecordMinimalChanges();
+    RandomizedJournalReplay();
+    return 0;
+}
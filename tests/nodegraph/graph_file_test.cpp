@@ -0,0 +1,271 @@
+#include "GraphFile.h"
+#include "test_check.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace nodegraph;
+
+namespace
+{
+    struct NodeRow
+    {
+        int64_t id;
+        float x, y, width, height;
+        uint8_t shape;
+        std::string label;
+        std::optional<int64_t> rank;
+        std::optional<double> weight;
+        std::optional<bool> flag;
+        std::optional<std::string> name;
+    };
+
+    struct EdgeRow
+    {
+        int64_t from, to;
+        float weight;
+        bool directed;
+        std::string label;
+    };
+
+    struct Graph
+    {
+        std::vector<NodeRow> nodes;
+        std::vector<EdgeRow> edges;
+    };
+
+    Graph MakeGraph(uint32_t nodeCount, uint32_t edgeCount)
+    {
+        std::mt19937 rng(47);
+        Graph g;
+        for (uint32_t i = 0; i < nodeCount; ++i)
+        {
+            NodeRow n{ int64_t(i) * 3 - 100, float(i % 97), float(i / 97) * 1.5f, 40, 30, uint8_t(i % 3),
+                       i % 4 ? std::string("node ").append(std::to_string(i)) : std::string{}, {}, {}, {}, {} };
+            if (i % 3 == 0) n.rank = int64_t(i) << 33;
+            if (i % 5 == 0) n.weight = 0.25 * i;
+            if (i % 7 == 0) n.flag = i % 2 == 0;
+            if (i % 11 == 0) n.name = std::string(i % 13, 'x');
+            g.nodes.push_back(std::move(n));
+        }
+        // 字符串用 append 拼接：GCC 12 在 -O2 下对 "e" + std::to_string(i) 误报 -Wrestrict
+        for (uint32_t i = 0; i < edgeCount; ++i)
+        {
+            g.edges.push_back(EdgeRow{ g.nodes[rng() % nodeCount].id, g.nodes[rng() % nodeCount].id,
+                                       float(i % 9) * 0.5f, i % 3 != 0, i % 10 == 0 ? std::string("e").append(std::to_string(i)) : std::string{} });
+        }
+        return g;
+    }
+
+    std::vector<uint8_t> Write(Graph const& g, uint32_t rowsPerChunk)
+    {
+        std::vector<uint8_t> bytes;
+        GraphFileWriter w(bytes, rowsPerChunk);
+        // 节点与边交错写入，写入方按各自的块大小分别落盘
+        size_t e = 0;
+        for (size_t i = 0; i < g.nodes.size(); ++i)
+        {
+            auto const& n = g.nodes[i];
+            w.AddNode(n.id, n.x, n.y, n.width, n.height, n.shape, n.label);
+            if (n.rank) w.SetNodeMeta("rank", *n.rank);
+            if (n.weight) w.SetNodeMeta("weight", *n.weight);
+            if (n.flag) w.SetNodeMeta("flag", *n.flag);
+            if (n.name) w.SetNodeMeta("name", std::string_view{ *n.name });
+            for (size_t k = 0; k < 2 && e < g.edges.size(); ++k, ++e)
+            {
+                auto const& edge = g.edges[e];
+                w.AddEdge(edge.from, edge.to, edge.weight, edge.directed, edge.label);
+            }
+        }
+        for (; e < g.edges.size(); ++e)
+        {
+            auto const& edge = g.edges[e];
+            w.AddEdge(edge.from, edge.to, edge.weight, edge.directed, edge.label);
+        }
+        w.Finish();
+        return bytes;
+    }
+
+    // 完整读出并与原图逐项比较
+    void ReadAndCompare(std::span<uint8_t const> bytes, Graph const& g)
+    {
+        GraphFileReader reader(bytes);
+        GraphChunk chunk;
+        size_t nodes = 0, edges = 0;
+        for (;;)
+        {
+            auto const result = reader.Next(chunk);
+            if (result == GraphFileResult::End)
+                break;
+            NG_CHECK(result == GraphFileResult::Chunk);
+            if (chunk.kind == GraphChunkKind::Nodes)
+            {
+                for (uint32_t i = 0; i < chunk.rows; ++i)
+                {
+                    auto const& n = g.nodes.at(nodes + i);
+                    NG_CHECK(chunk.ids[i] == n.id);
+                    NG_CHECK(chunk.x[i] == n.x && chunk.y[i] == n.y && chunk.width[i] == n.width && chunk.height[i] == n.height);
+                    NG_CHECK(chunk.shape[i] == n.shape);
+                    NG_CHECK(chunk.labels[i] == n.label);
+
+                    size_t present = 0;
+                    for (auto const& column : chunk.meta)
+                    {
+                        if (!column.Has(i))
+                            continue;
+                        ++present;
+                        auto const value = column.Value(i);
+                        if (column.key == "rank") NG_CHECK(n.rank && std::get<int64_t>(value) == *n.rank);
+                        else if (column.key == "weight") NG_CHECK(n.weight && std::get<double>(value) == *n.weight);
+                        else if (column.key == "flag") NG_CHECK(n.flag && std::get<bool>(value) == *n.flag);
+                        else if (column.key == "name") NG_CHECK(n.name && std::get<std::string_view>(value) == *n.name);
+                        else NG_CHECK(!"unexpected meta column");
+                    }
+                    NG_CHECK(present == size_t(n.rank.has_value()) + n.weight.has_value() + n.flag.has_value() + n.name.has_value());
+                }
+                nodes += chunk.rows;
+            }
+            else
+            {
+                NG_CHECK(chunk.kind == GraphChunkKind::Edges);
+                for (uint32_t i = 0; i < chunk.rows; ++i)
+                {
+                    auto const& e = g.edges.at(edges + i);
+                    NG_CHECK(chunk.from[i] == e.from && chunk.to[i] == e.to);
+                    NG_CHECK(chunk.weight[i] == e.weight);
+                    NG_CHECK(((chunk.flags[i] & 1) != 0) == e.directed);
+                    NG_CHECK(chunk.labels[i] == e.label);
+                }
+                edges += chunk.rows;
+            }
+            NG_CHECK(reader.Offset() <= reader.Size());
+        }
+        NG_CHECK(nodes == g.nodes.size());
+        NG_CHECK(edges == g.edges.size());
+        NG_CHECK(reader.Next(chunk) == GraphFileResult::End);
+    }
+
+    // 读到结束为止，返回最后的结果；用于截断 / 损坏输入，要求有限步内结束且不越界
+    GraphFileResult Drain(std::span<uint8_t const> bytes)
+    {
+        GraphFileReader reader(bytes);
+        GraphChunk chunk;
+        for (int guard = 0; guard < 100000; ++guard)
+        {
+            auto const result = reader.Next(chunk);
+            if (result != GraphFileResult::Chunk)
+            {
+                NG_CHECK(reader.Next(chunk) == result);
+                return result;
+            }
+            NG_CHECK(reader.Offset() <= reader.Size());
+            for (uint32_t i = 0; i < chunk.rows; ++i)
+            {
+                (void)chunk.labels[i];
+                if (chunk.kind == GraphChunkKind::Nodes)
+                    for (auto const& column : chunk.meta)
+                        if (column.Has(i))
+                            (void)column.Value(i);
+            }
+        }
+        NG_CHECK(!"reader did not terminate");
+        return GraphFileResult::Invalid;
+    }
+
+    void RoundTrip()
+    {
+        auto const g = MakeGraph(1000, 3000);
+        for (uint32_t rowsPerChunk : { 1u, 7u, 64u, 16384u })
+            ReadAndCompare(Write(g, rowsPerChunk), g);
+
+        // 空图：只有文件头和结束块
+        std::vector<uint8_t> empty;
+        GraphFileWriter(empty).Finish();
+        ReadAndCompare(empty, Graph{});
+    }
+
+    void MappedRoundTrip()
+    {
+        auto const g = MakeGraph(300, 500);
+        auto const bytes = Write(g, 50);
+        auto const path = std::filesystem::temp_directory_path() / ("nodegraph_test_" + std::to_string(std::random_device{}()) + ".ngrf");
+        {
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<char const*>(bytes.data()), std::streamsize(bytes.size()));
+        }
+        {
+            MappedFile file;
+            NG_CHECK(file.Open(path));
+            NG_CHECK(file.Data().size() == bytes.size());
+            ReadAndCompare(file.Data(), g);
+        }
+        std::filesystem::remove(path);
+
+        MappedFile missing;
+        NG_CHECK(!missing.Open(path));
+    }
+
+    void Truncated()
+    {
+        auto const g = MakeGraph(40, 60);
+        auto const bytes = Write(g, 8);
+        NG_CHECK(Drain(bytes) == GraphFileResult::End);
+        // 任何严格前缀（包括恰好停在块边界、缺少结束块的情况）都必须报告格式错误
+        for (size_t size = 0; size < bytes.size(); ++size)
+            NG_CHECK(Drain(std::span{ bytes.data(), size }) == GraphFileResult::Invalid);
+    }
+
+    void Malformed()
+    {
+        auto const g = MakeGraph(40, 60);
+        auto const good = Write(g, 8);
+
+        auto bad = good;
+        bad[0] = 'X';
+        NG_CHECK(Drain(bad) == GraphFileResult::Invalid);
+
+        bad = good;
+        bad[4] = 2;     // 未知版本
+        NG_CHECK(Drain(bad) == GraphFileResult::Invalid);
+
+        // 第一个块的负载长度远超文件
+        bad = good;
+        uint64_t const huge = ~uint64_t{ 0 } - 8;
+        std::memcpy(bad.data() + graphfile::HeaderSize + 8, &huge, sizeof(huge));
+        NG_CHECK(Drain(bad) == GraphFileResult::Invalid);
+
+        // 未知类型的块被跳过
+        bad = good;
+        uint8_t const unknown[graphfile::ChunkHeaderSize + 8] = { 7, 0, 0, 0, 0, 0, 0, 0, 8 };
+        bad.insert(bad.begin() + graphfile::HeaderSize, std::begin(unknown), std::end(unknown));
+        ReadAndCompare(bad, g);
+
+        // 随机翻转字节 / 截断：只要求有限步内结束、不越界
+        std::mt19937 rng(4747);
+        for (int round = 0; round < 3000; ++round)
+        {
+            bad = good;
+            int const flips = 1 + int(rng() % 4);
+            for (int f = 0; f < flips; ++f)
+                bad[graphfile::HeaderSize + rng() % (bad.size() - graphfile::HeaderSize)] ^= uint8_t(1 + rng() % 255);
+            if (rng() % 3 == 0)
+                bad.resize(rng() % bad.size());
+            Drain(bad);
+        }
+    }
+}
+
+int main()
+{
+    RoundTrip();
+    MappedRoundTrip();
+    Truncated();
+    Malformed();
+    std::puts("graph_file_test: ok");
+    return 0;
+}
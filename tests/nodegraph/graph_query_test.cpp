@@ -0,0 +1,231 @@
+#include "GraphQuery.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace nodegraph;
+
+namespace
+{
+    std::vector<uint32_t> Sorted(std::vector<uint32_t> v)
+    {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    bool SameComponent(GraphComponents const& c, std::vector<uint32_t> const& nodes)
+    {
+        for (uint32_t v : nodes)
+            if (c.component[v] != c.component[nodes.front()])
+                return false;
+        return true;
+    }
+
+    // 0 -1-> 1 -1-> 2 -1-> 3，另有更贵的 0 -4-> 2 与 1 -5-> 3
+    void Diamond()
+    {
+        GraphQuery q;
+        q.SetEdge(0, 0, 1, 1, true);
+        q.SetEdge(1, 0, 2, 4, true);
+        q.SetEdge(2, 1, 2, 1, true);
+        q.SetEdge(3, 2, 3, 1, true);
+        q.SetEdge(4, 1, 3, 5, true);
+        auto s = q.Snapshot(4);
+
+        auto p = ShortestPath(*s, 0, 3);
+        NG_CHECK(p.found);
+        NG_CHECK(p.cost == 3.0);
+        NG_CHECK((p.nodes == std::vector<uint32_t>{ 0, 1, 2, 3 }));
+        NG_CHECK((p.edges == std::vector<uint32_t>{ 0, 2, 3 }));
+        NG_CHECK(!ShortestPath(*s, 3, 0).found);
+
+        std::vector<float> xy{ 0, 0, 1, 0, 2, 0, 3, 0 };
+        auto astar = ShortestPath(*s, 0, 3, &xy);
+        NG_CHECK(astar.found && astar.cost == 3.0 && astar.nodes == p.nodes);
+
+        auto order = TopologicalOrder(*s);
+        NG_CHECK(order.acyclic);
+        NG_CHECK((order.order == std::vector<uint32_t>{ 0, 1, 2, 3 }));
+
+        auto scc = StronglyConnectedComponents(*s);
+        NG_CHECK(scc.Count() == 4);
+
+        // 删掉捷径后最短路改走贵的那条
+        q.RemoveEdge(2);
+        auto s2 = q.Snapshot(4);
+        auto p2 = ShortestPath(*s2, 0, 3);
+        NG_CHECK(p2.found && p2.cost == 5.0);
+        NG_CHECK((p2.nodes == std::vector<uint32_t>{ 0, 2, 3 }));
+        // 旧快照不受影响
+        NG_CHECK(ShortestPath(*s, 0, 3).cost == 3.0);
+    }
+
+    // 环 {0,1,2} 流入环 {3,4}，5 孤立
+    void Cycles()
+    {
+        GraphQuery q;
+        q.SetEdge(0, 0, 1, 1, true);
+        q.SetEdge(1, 1, 2, 1, true);
+        q.SetEdge(2, 2, 0, 1, true);
+        q.SetEdge(3, 2, 3, 1, true);
+        q.SetEdge(4, 3, 4, 1, true);
+        q.SetEdge(5, 4, 3, 1, true);
+        auto s = q.Snapshot(6);
+
+        auto scc = StronglyConnectedComponents(*s);
+        NG_CHECK(scc.Count() == 3);
+        NG_CHECK(SameComponent(scc, { 0, 1, 2 }));
+        NG_CHECK(SameComponent(scc, { 3, 4 }));
+        NG_CHECK(scc.component[0] != scc.component[3] && scc.component[5] != scc.component[0] && scc.component[5] != scc.component[3]);
+        // 分量按逆拓扑序编号：下游分量的下标更小
+        NG_CHECK(scc.component[0] > scc.component[3]);
+        for (uint32_t c = 0; c < scc.Count(); ++c)
+            for (uint32_t i = scc.offsets[c]; i < scc.offsets[c + 1]; ++i)
+                NG_CHECK(scc.component[scc.nodes[i]] == c);
+
+        auto order = TopologicalOrder(*s);
+        NG_CHECK(!order.acyclic);
+        NG_CHECK((order.order == std::vector<uint32_t>{ 5 }));
+
+        auto reach = Reachable(*s, { 3 });
+        NG_CHECK((Sorted(reach.nodes) == std::vector<uint32_t>{ 3, 4 }));
+        NG_CHECK((Sorted(reach.edges) == std::vector<uint32_t>{ 4, 5 }));
+
+        // 无向边按双向弧处理，单独一条也构成环
+        GraphQuery u;
+        u.SetEdge(0, 0, 1, 1, false);
+        auto us = u.Snapshot(2);
+        NG_CHECK(!TopologicalOrder(*us).acyclic);
+        NG_CHECK(ShortestPath(*us, 1, 0).found);
+        NG_CHECK(StronglyConnectedComponents(*us).Count() == 1);
+    }
+
+    // 随机增删边后与 Floyd–Warshall 对照
+    void RandomizedAgainstFloyd()
+    {
+        struct Edge { uint32_t from, to; float weight; bool directed, live; };
+        std::mt19937 rng(46);
+        for (int round = 0; round < 60; ++round)
+        {
+            uint32_t const n = 5 + rng() % 40;
+            GraphQuery q;
+            std::vector<Edge> edges;
+            std::vector<float> xy(n * 2);
+            for (auto& v : xy)
+                v = float(rng() % 200);
+
+            for (int op = 0; op < 200; ++op)
+            {
+                int const k = rng() % 10;
+                if (k < 6 || edges.empty())
+                {
+                    uint32_t key = (rng() % 3 == 0 && !edges.empty()) ? uint32_t(rng() % edges.size()) : uint32_t(edges.size());
+                    if (key == edges.size())
+                        edges.push_back({});
+                    Edge e{ uint32_t(rng() % n), uint32_t(rng() % n), float(rng() % 20), rng() % 4 != 0, true };
+                    edges[key] = e;
+                    q.SetEdge(key, e.from, e.to, e.weight, e.directed);
+                    continue;
+                }
+                if (k < 8)
+                {
+                    uint32_t key = uint32_t(rng() % edges.size());
+                    edges[key].live = false;
+                    q.RemoveEdge(key);
+                    continue;
+                }
+
+                auto s = q.Snapshot(n);
+                std::vector<std::vector<std::pair<uint32_t, float>>> adj(n);
+                for (auto const& e : edges)
+                {
+                    if (!e.live)
+                        continue;
+                    adj[e.from].push_back({ e.to, e.weight });
+                    if (!e.directed && e.from != e.to)
+                        adj[e.to].push_back({ e.from, e.weight });
+                }
+                constexpr double Inf = 1e18;
+                std::vector<double> d(size_t(n) * n, Inf);
+                for (uint32_t i = 0; i < n; ++i)
+                    d[i * n + i] = 0;
+                for (uint32_t u = 0; u < n; ++u)
+                    for (auto [v, w] : adj[u])
+                        d[u * n + v] = std::min(d[u * n + v], double(w));
+                for (uint32_t m = 0; m < n; ++m)
+                    for (uint32_t i = 0; i < n; ++i)
+                        for (uint32_t j = 0; j < n; ++j)
+                            d[i * n + j] = std::min(d[i * n + j], d[i * n + m] + d[m * n + j]);
+
+                for (int t = 0; t < 8; ++t)
+                {
+                    uint32_t const a = rng() % n, b = rng() % n;
+                    for (std::vector<float> const* positions : { static_cast<std::vector<float> const*>(nullptr), static_cast<std::vector<float> const*>(&xy) })
+                    {
+                        auto p = ShortestPath(*s, a, b, positions);
+                        if (d[a * n + b] >= Inf)
+                        {
+                            NG_CHECK(!p.found);
+                            continue;
+                        }
+                        NG_CHECK(p.found);
+                        NG_CHECK(std::abs(p.cost - d[a * n + b]) < 1e-6);
+                        NG_CHECK(p.nodes.front() == a && p.nodes.back() == b && p.edges.size() + 1 == p.nodes.size());
+                        double cost = 0;
+                        for (size_t i = 0; i < p.edges.size(); ++i)
+                        {
+                            auto const& e = edges[p.edges[i]];
+                            NG_CHECK(e.live);
+                            NG_CHECK((e.from == p.nodes[i] && e.to == p.nodes[i + 1]) ||
+                                     (!e.directed && e.to == p.nodes[i] && e.from == p.nodes[i + 1]));
+                            cost += e.weight;
+                        }
+                        NG_CHECK(std::abs(cost - p.cost) < 1e-6);
+                    }
+
+                    size_t reachable = 0;
+                    for (uint32_t j = 0; j < n; ++j)
+                        reachable += d[a * n + j] < Inf;
+                    NG_CHECK(Reachable(*s, { a }).nodes.size() == reachable);
+                }
+
+                auto scc = StronglyConnectedComponents(*s);
+                for (uint32_t i = 0; i < n; ++i)
+                    for (uint32_t j = 0; j < n; ++j)
+                        NG_CHECK((d[i * n + j] < Inf && d[j * n + i] < Inf) == (scc.component[i] == scc.component[j]));
+                for (uint32_t u = 0; u < n; ++u)
+                    for (auto [v, w] : adj[u])
+                        NG_CHECK(scc.component[u] >= scc.component[v]);
+
+                bool acyclic = scc.Count() == n;
+                for (uint32_t u = 0; u < n; ++u)
+                    for (auto [v, w] : adj[u])
+                        acyclic = acyclic && u != v;
+                auto order = TopologicalOrder(*s);
+                NG_CHECK(order.acyclic == acyclic);
+                if (acyclic)
+                {
+                    NG_CHECK(order.order.size() == n);
+                    std::vector<uint32_t> position(n);
+                    for (uint32_t i = 0; i < n; ++i)
+                        position[order.order[i]] = i;
+                    for (uint32_t u = 0; u < n; ++u)
+                        for (auto [v, w] : adj[u])
+                            NG_CHECK(position[u] < position[v]);
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    Diamond();
+    Cycles();
+    RandomizedAgainstFloyd();
+    std::puts("graph_query_test: ok");
+    return 0;
+}
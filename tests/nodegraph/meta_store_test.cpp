@@ -0,0 +1,225 @@
+#include "MetaStore.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace nodegraph;
+
+namespace
+{
+    using Store = MetaStore<std::wstring, std::shared_ptr<int>>;
+
+    // 单线程：随机增删改与 std::map 对照
+    void RandomizedAgainstMap()
+    {
+        enum Type { Int, Real, Flag, Str, Obj };
+        Store store;
+        std::mt19937 rng(48);
+        std::vector<uint32_t> rows;
+        std::vector<std::map<std::wstring, std::pair<Type, int64_t>>> ref;
+        std::wstring const keys[] = { L"a", L"b", L"c", L"Name", L"Rank" };
+
+        for (int it = 0; it < 100000; ++it)
+        {
+            int const op = rng() % 12;
+            if (op == 0 || rows.empty())
+            {
+                rows.push_back(store.AllocateRow());
+                ref.emplace_back();
+                NG_CHECK(store.Count(rows.back()) == 0);
+                continue;
+            }
+            size_t const i = rng() % rows.size();
+            uint32_t const row = rows[i];
+            auto& expected = ref[i];
+            auto const& key = keys[rng() % std::size(keys)];
+
+            if (op == 1)
+            {
+                store.FreeRow(row);
+                rows.erase(rows.begin() + i);
+                ref.erase(ref.begin() + i);
+                continue;
+            }
+            if (op == 2)
+            {
+                bool const had = expected.erase(key) != 0;
+                uint32_t const column = store.FindColumn(key);
+                NG_CHECK(had == (column != InvalidMetaColumn && store.Remove(row, column)));
+                continue;
+            }
+            if (op == 3)
+            {
+                store.ClearRow(row);
+                expected.clear();
+                continue;
+            }
+
+            uint32_t const column = store.Column(key);
+            NG_CHECK(store.FindColumn(key) == column && store.Key(column) == key);
+            auto const type = static_cast<Type>(rng() % 5);
+            int64_t const v = int64_t(rng() % 1000) - 500;
+            bool replaced = false;
+            switch (type)
+            {
+            case Int:  replaced = store.SetInt(row, column, v); break;
+            case Real: replaced = store.SetDouble(row, column, v + 0.5); break;
+            case Flag: replaced = store.SetBool(row, column, v > 0); break;
+            case Str:  replaced = store.SetText(row, column, std::to_wstring(v)); break;
+            case Obj:  replaced = store.SetObject(row, column, std::make_shared<int>(int(v))); break;
+            }
+            NG_CHECK(replaced == (expected.count(key) != 0));
+            expected[key] = { type, v };
+
+            NG_CHECK(store.Count(row) == expected.size());
+            size_t visited = 0;
+            store.ForEach(row, [&](uint32_t c)
+                {
+                    ++visited;
+                    auto found = expected.find(store.Key(c));
+                    NG_CHECK(found != expected.end());
+                    auto const [t, value] = found->second;
+                    switch (store.Kind(row, c))
+                    {
+                    case MetaKind::Int64:  NG_CHECK(t == Int && store.Int(row, c) == value); break;
+                    case MetaKind::Double: NG_CHECK(t == Real && store.Double(row, c) == value + 0.5); break;
+                    case MetaKind::Bool:   NG_CHECK(t == Flag && store.Bool(row, c) == (value > 0)); break;
+                    case MetaKind::Text:   NG_CHECK(t == Str && store.TextAt(row, c) == std::to_wstring(value)); break;
+                    case MetaKind::Object: NG_CHECK(t == Obj && *store.ObjectAt(row, c) == value); break;
+                    default:               NG_CHECK(!"empty column visited");
+                    }
+                });
+            NG_CHECK(visited == expected.size());
+        }
+
+        // 释放的行被复用时必须是空的
+        for (uint32_t row : rows)
+            store.FreeRow(row);
+        for (size_t i = 0; i < rows.size(); ++i)
+            NG_CHECK(store.Count(store.AllocateRow()) == 0);
+    }
+
+    // 多线程：与 NodeMetaTable 相同的读写锁协议（读取持共享锁、写入与建列持独占锁）。
+    // 写者在同一把锁内把 "lo" / "hi" / "sum" 三列写成一致的值，读者任何时刻都不能看到撕裂的状态；
+    // 同时不断新建列和分配 / 释放行，覆盖列表与通道扩容时的并发读取。
+    void ConcurrentReadWrite()
+    {
+        Store store;
+        std::shared_mutex mutex;
+        constexpr uint32_t Rows = 64;
+        std::vector<uint32_t> rows;
+        uint32_t lo = 0, hi = 0, sum = 0, tag = 0;
+        {
+            std::unique_lock lock{ mutex };
+            for (uint32_t i = 0; i < Rows; ++i)
+                rows.push_back(store.AllocateRow());
+            lo = store.Column(L"lo");
+            hi = store.Column(L"hi");
+            sum = store.Column(L"sum");
+            tag = store.Column(L"tag");
+        }
+
+        std::atomic<bool> stop{ false };
+        std::atomic<uint64_t> reads{ 0 };
+        std::vector<std::thread> threads;
+
+        for (int w = 0; w < 2; ++w)
+        {
+            threads.emplace_back([&, w]
+                {
+                    std::mt19937 rng(480 + w);
+                    while (reads.load(std::memory_order_relaxed) < 100)
+                        std::this_thread::yield();
+                    for (int it = 0; it < 5000; ++it)
+                    {
+                        uint32_t const row = rows[rng() % Rows];
+                        int64_t const a = rng() % 100000, b = rng() % 100000;
+                        std::unique_lock lock{ mutex };
+                        switch (rng() % 8)
+                        {
+                        case 0:
+                            store.ClearRow(row);
+                            break;
+                        case 1:
+                        {
+                            // 新键：列表扩容
+                            uint32_t const c = store.Column(L"k" + std::to_wstring(rng() % 200));
+                            store.SetText(row, c, L"v");
+                            break;
+                        }
+                        case 2:
+                        {
+                            // 新行：各列的通道在下一次写入时扩容
+                            uint32_t const extra = store.AllocateRow();
+                            store.SetObject(extra, tag, std::make_shared<int>(int(extra)));
+                            store.FreeRow(extra);
+                            break;
+                        }
+                        default:
+                            store.SetInt(row, lo, a);
+                            store.SetInt(row, hi, b);
+                            store.SetDouble(row, sum, double(a + b));
+                            store.SetObject(row, tag, std::make_shared<int>(int(a)));
+                            break;
+                        }
+                    }
+                });
+        }
+
+        for (int r = 0; r < 4; ++r)
+        {
+            threads.emplace_back([&, r]
+                {
+                    std::mt19937 rng(4800 + r);
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        uint32_t const row = rows[rng() % Rows];
+                        std::shared_lock lock{ mutex };
+                        auto const kind = store.Kind(row, lo);
+                        if (kind == MetaKind::Empty)
+                        {
+                            NG_CHECK(store.Kind(row, hi) == MetaKind::Empty && store.Kind(row, sum) == MetaKind::Empty);
+                        }
+                        else
+                        {
+                            NG_CHECK(kind == MetaKind::Int64 && store.Kind(row, hi) == MetaKind::Int64);
+                            NG_CHECK(store.Kind(row, sum) == MetaKind::Double);
+                            NG_CHECK(store.Double(row, sum) == double(store.Int(row, lo) + store.Int(row, hi)));
+                            NG_CHECK(store.Kind(row, tag) == MetaKind::Object && *store.ObjectAt(row, tag) == store.Int(row, lo));
+                        }
+                        uint32_t counted = 0;
+                        store.ForEach(row, [&](uint32_t c) { ++counted; NG_CHECK(store.Kind(row, c) != MetaKind::Empty); });
+                        NG_CHECK(counted == store.Count(row));
+                        NG_CHECK(store.FindColumn(L"lo") == lo);
+                        lock.unlock();
+                        reads.fetch_add(1, std::memory_order_relaxed);
+                        // 读优先的 shared_mutex 下给写者留出机会
+                        std::this_thread::yield();
+                    }
+                });
+        }
+
+        threads[0].join();
+        threads[1].join();
+        stop = true;
+        for (size_t i = 2; i < threads.size(); ++i)
+            threads[i].join();
+        NG_CHECK(reads.load() > 0);
+    }
+}
+
+int main()
+{
+    RandomizedAgainstMap();
+    ConcurrentReadWrite();
+    std::puts("meta_store_test: ok");
+    return 0;
+}
@@ -0,0 +1,546 @@
+#include "ColorKernels.h"
+#include "DisplayList.h"
+#include "ForceLayout.h"
+#include "GraphFile.h"
+#include "GraphIndex.h"
+#include "GraphQuery.h"
+#include "LayeredLayout.h"
+#include "LevelOfDetail.h"
+#include "MetaStore.h"
+#include "QuadTree.h"
+#include "Rasterizer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 微基准（不参与 ctest）：nodegraph_bench [规模倍数]，默认 1。
+// 每项打印单次耗时，便于在改动前后对比；数值只在同一台机器上有比较意义。
+
+using namespace nodegraph;
+
+namespace
+{
+    volatile double g_sink = 0;
+
+    // repeats > 1 时先预热一次（页面调入、查找表初始化），只计后续的平均值
+    template <typename F>
+    double Measure(int repeats, F&& body)
+    {
+        if (repeats > 1)
+            body();
+        auto const start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; ++i)
+            body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+    }
+
+    void Report(char const* name, double ms, char const* note = "")
+    {
+        std::printf("%-34s %10.3f ms  %s\n", name, ms, note);
+    }
+
+    // user-039：视口查询，四叉树 vs 线性扫描
+    void SpatialIndex(uint32_t n)
+    {
+        std::mt19937 rng(39);
+        std::uniform_real_distribution<float> pos(0.0f, 20000.0f);
+        std::vector<Box> boxes(n);
+        for (auto& b : boxes)
+            b = Box::FromRect(pos(rng), pos(rng), 120.0f, 60.0f);
+
+        QuadTree tree;
+        Report("quadtree build", Measure(1, [&] { tree.Clear(); for (uint32_t k = 0; k < n; ++k) tree.Insert(k, boxes[k]); }));
+        Report("quadtree update (move 1%)", Measure(1, [&]
+            {
+                for (uint32_t k = 0; k < n; k += 100)
+                {
+                    auto b = boxes[k];
+                    tree.Update(k, Box{ b.minX + 3, b.minY + 3, b.maxX + 3, b.maxY + 3 });
+                }
+            }));
+
+        Box const viewport = Box::FromRect(8000, 8000, 1920, 1080);
+        Report("quadtree viewport query", Measure(100, [&] { size_t c = 0; tree.Query(viewport, [&](uint32_t, Box const&) { ++c; }); g_sink = g_sink + double(c); }));
+        Report("linear viewport scan", Measure(100, [&] { size_t c = 0; for (auto const& b : boxes) c += b.Intersects(viewport); g_sink = g_sink + double(c); }));
+        Report("quadtree point hit-test", Measure(1000, [&] { size_t c = 0; tree.QueryPoint(9000, 9000, [&](uint32_t, Box const&) { ++c; }); g_sink = g_sink + double(c); }));
+    }
+
+    // user-044：Barnes–Hut 单步
+    void Force(uint32_t n)
+    {
+        std::mt19937 rng(44);
+        std::uniform_real_distribution<float> pos(0.0f, 5000.0f);
+        for (int threads : { 1, 4 })
+        {
+            ForceLayout::Settings settings;
+            settings.threads = threads;
+            ForceLayout layout(settings);
+            for (uint32_t i = 0; i < n; ++i)
+                layout.SetNode(i, pos(rng), pos(rng));
+            for (uint32_t i = 0; i < n * 2; ++i)
+                layout.SetEdge(i, rng() % n, rng() % n);
+            layout.Restart();
+            Report(threads == 1 ? "force layout step (1 thread)" : "force layout step (4 threads)", Measure(20, [&] { layout.Step(); }));
+        }
+    }
+
+    // user-045：分层布局，冷启动与增量
+    void Layered(uint32_t n)
+    {
+        std::mt19937 rng(45);
+        LayeredInput in;
+        for (uint32_t i = 0; i < n; ++i)
+            in.nodes.push_back({ i, float(40 + rng() % 60), float(30 + rng() % 30) });
+        for (uint32_t i = 1; i < n; ++i)
+            for (uint32_t j = 0; j < 1 + rng() % 2; ++j)
+                in.edges.push_back({ i - 1 - uint32_t(rng() % std::min<uint32_t>(i, 50)), i, 1.0f, true });
+
+        LayeredLayout layout;
+        std::shared_ptr<LayeredResult const> first;
+        Report("layered layout (cold)", Measure(1, [&] { first = layout.Run(in, nullptr, {}); }));
+        in.nodes.push_back({ n, 50, 40 });
+        in.edges.push_back({ 0, n, 1.0f, true });
+        Report("layered layout (incremental)", Measure(1, [&] { g_sink = g_sink + double(layout.Run(in, first.get(), {})->layerCount); }));
+    }
+
+    // user-046：最短路、强连通分量与增量快照
+    void Queries(uint32_t n)
+    {
+        std::mt19937 rng(46);
+        GraphQuery q;
+        for (uint32_t k = 0; k < n; ++k)
+            q.SetEdge(k, rng() % n, rng() % n, 1.0 + rng() % 5, true);
+        auto snapshot = q.Snapshot(n);
+        Report("graph snapshot after 1 edit", Measure(10, [&] { q.SetEdge(n, rng() % n, rng() % n, 1.0, true); snapshot = q.Snapshot(n); }));
+        Report("shortest path", Measure(10, [&] { g_sink = g_sink + ShortestPath(*snapshot, rng() % n, rng() % n).cost; }));
+        Report("strongly connected components", Measure(3, [&] { g_sink = g_sink + double(StronglyConnectedComponents(*snapshot).Count()); }));
+        Report("topological order", Measure(3, [&] { g_sink = g_sink + double(TopologicalOrder(*snapshot).order.size()); }));
+    }
+
+    // user-047：二进制图文件写入与逐块解析
+    void File(uint32_t n)
+    {
+        std::vector<uint8_t> bytes;
+        Report("graph file write", Measure(1, [&]
+            {
+                bytes.clear();
+                GraphFileWriter writer(bytes);
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    writer.AddNode(i, float(i % 1000), float(i / 1000), 40, 30, 0, "node " + std::to_string(i));
+                    if (i % 3 == 0)
+                        writer.SetNodeMeta("rank", int64_t(i));
+                }
+                for (uint32_t i = 0; i < n * 3; ++i)
+                    writer.AddEdge(i % n, (i * 7) % n, 1.0f, true, {});
+                writer.Finish();
+            }));
+        Report("graph file parse", Measure(5, [&]
+            {
+                GraphFileReader reader(bytes);
+                GraphChunk chunk;
+                size_t rows = 0;
+                while (reader.Next(chunk) == GraphFileResult::Chunk)
+                    rows += chunk.rows;
+                g_sink = g_sink + double(rows);
+            }));
+    }
+
+    // user-048：列式元数据 vs 每节点一张哈希表
+    void Meta(uint32_t n)
+    {
+        wchar_t const* keys[] = { L"Rank", L"Weight", L"Owner", L"Group" };
+        MetaStore<std::wstring, std::shared_ptr<int>> store;
+        std::vector<uint32_t> rows(n);
+        Report("metastore fill (4 keys/row)", Measure(1, [&]
+            {
+                uint32_t columns[4];
+                for (int c = 0; c < 4; ++c)
+                    columns[c] = store.Column(keys[c]);
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    rows[i] = store.AllocateRow();
+                    store.SetInt(rows[i], columns[0], i);
+                    store.SetDouble(rows[i], columns[1], i * 0.5);
+                    store.SetText(rows[i], columns[2], L"owner");
+                    store.SetBool(rows[i], columns[3], i % 2);
+                }
+            }));
+        Report("metastore read 1 key/row", Measure(10, [&]
+            {
+                uint32_t const column = store.FindColumn(L"Rank");
+                int64_t sum = 0;
+                for (uint32_t row : rows)
+                    sum += store.Int(row, column);
+                g_sink = g_sink + double(sum);
+            }));
+
+        std::vector<std::unordered_map<std::wstring, int64_t>> maps(n);
+        Report("per-node hash map fill", Measure(1, [&] { for (uint32_t i = 0; i < n; ++i) for (auto key : keys) maps[i][key] = i; }));
+        Report("per-node hash map read 1 key/row", Measure(10, [&]
+            {
+                int64_t sum = 0;
+                for (auto const& m : maps)
+                    sum += m.find(L"Rank")->second;
+                g_sink = g_sink + double(sum);
+            }));
+    }
+
+    // user-049 / user-050：批量亮度、自动对比文字色与提亮压暗
+    void Colors(uint32_t n)
+    {
+        std::mt19937 rng(50);
+        std::vector<Rgba> colors(n), out(n);
+        for (auto& c : colors)
+            c = std::bit_cast<Rgba>(static_cast<uint32_t>(rng()));
+        std::vector<float> lum(n);
+        Report("luminance (batch)", Measure(20, [&] { Luminance(colors, lum); }));
+        Report("luminance (per color)", Measure(20, [&] { for (uint32_t i = 0; i < n; ++i) lum[i] = RelativeLuminance(colors[i]); }));
+        Report("auto contrast text (batch)", Measure(20, [&] { out.assign(n, Rgba{ 128, 128, 128, 255 }); AutoContrastText(colors, out, 4.5f); }));
+        Report("shade (batch)", Measure(20, [&] { Shade(colors, 0.2f, out); }));
+        Report("shade (per color)", Measure(20, [&] { for (uint32_t i = 0; i < n; ++i) out[i] = Shade(colors[i], 0.2f); }));
+        g_sink = g_sink + double(lum[n / 2]) + double(out[n / 2].r);
+    }
+
+    // user-041：批量显示列表的构建、日志回放、局部更新与软件光栅化
+    void Display(uint32_t n)
+    {
+        std::mt19937 rng(41);
+        std::uniform_real_distribution<float> pos(0.0f, 20000.0f);
+        std::vector<Box> boxes(n);
+        for (auto& b : boxes)
+            b = Box::FromRect(pos(rng), pos(rng), 120.0f, 60.0f);
+
+        NodeStyle styles[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            styles[i].shape = i % 2 ? Primitive::RoundedRect : Primitive::Ellipse;
+            styles[i].fill = Rgba{ static_cast<uint8_t>(60 * i), 120, 200, 255 };
+            styles[i].cornerRadius = 6.0f;
+        }
+        EdgeStyle const edgeStyle{ Rgba{ 90, 90, 90, 255 }, 1.5f };
+
+        DisplayList list;
+        auto center = [&](uint32_t k, float& x, float& y) { x = (boxes[k].minX + boxes[k].maxX) / 2; y = (boxes[k].minY + boxes[k].maxY) / 2; };
+        auto build = [&]
+            {
+                list.Clear();
+                for (uint32_t k = 0; k < n; ++k)
+                    list.SetNode(k, list.NodeBatchFor(styles[k % 4]), boxes[k]);
+                uint32_t const edges = list.EdgeBatchFor(edgeStyle);
+                for (uint32_t e = 0; e < 2 * n; ++e)
+                {
+                    Segment s;
+                    center(e % n, s.x1, s.y1);
+                    center((e * 7 + 1) % n, s.x2, s.y2);
+                    list.SetEdge(e, edges, s);
+                }
+            };
+        size_t changes = 0;
+        auto replay = [&] { list.ConsumeChanges([&](DisplayList::Change const& c) { changes += c.index; }); };
+
+        Report("display list build (n + 2n edges)", Measure(5, [&] { build(); replay(); }));
+        Report("display list update (move 1%)", Measure(20, [&]
+            {
+                for (uint32_t k = 0; k < n; k += 100)
+                    list.SetNode(k, list.NodeBatchFor(styles[k % 4]), boxes[k]);
+                replay();
+            }));
+        Report("display list restyle (1%)", Measure(20, [&]
+            {
+                for (uint32_t k = 0; k < n; k += 100)
+                    list.SetNode(k, list.NodeBatchFor(styles[(k + 1) % 4]), boxes[k]);
+                for (uint32_t k = 0; k < n; k += 100)
+                    list.SetNode(k, list.NodeBatchFor(styles[k % 4]), boxes[k]);
+                replay();
+            }));
+
+        // 整图缩放到 1920x1080（缩略图导出）与 1:1 的视口（只有落在画布内的像素被写入）
+        Rasterizer raster{ 1920, 1080 };
+        raster.SetTransform(1080.0f / 20060.0f, 0.0f, 0.0f);
+        Report("rasterize whole graph 1920x1080", Measure(3, [&] { raster.Clear(Rgba{ 255, 255, 255, 255 }); raster.Draw(list); }));
+        raster.SetTransform(1.0f, -8000.0f, -8000.0f);
+        Report("rasterize 1:1 viewport 1920x1080", Measure(3, [&] { raster.Clear(Rgba{ 255, 255, 255, 255 }); raster.Draw(list); }));
+        g_sink = g_sink + double(changes) + double(raster.Pixel(960, 540).r);
+    }
+
+    // user-043：细节层次的多级聚类。拖动一个节点的增量维护 vs 整体重建，以及缩小到整图时的聚类与边束遍历
+    void Lod(uint32_t n)
+    {
+        std::mt19937 rng(43);
+        std::uniform_real_distribution<float> pos(0.0f, 20000.0f);
+        std::vector<float> xs(n), ys(n);
+        for (uint32_t k = 0; k < n; ++k)
+        {
+            xs[k] = pos(rng);
+            ys[k] = pos(rng);
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> edges(2 * size_t{ n });
+        for (auto& e : edges)
+            e = { uint32_t(rng() % n), uint32_t(rng() % n) };
+
+        ClusterHierarchy lod;
+        auto build = [&]
+            {
+                lod.Clear();
+                for (uint32_t k = 0; k < n; ++k)
+                    lod.SetNode(k, xs[k], ys[k], 120.0f);
+                for (uint32_t e = 0; e < edges.size(); ++e)
+                    lod.SetEdge(e, edges[e].first, edges[e].second);
+            };
+        Report("lod hierarchy build (n + 2n edges)", Measure(3, build));
+
+        // 拖动：一个节点沿直线移动 100 步，每步跨越最细一级的单元边界
+        uint32_t const dragged = n / 2;
+        Report("lod drag 1 node (x100 moves)", Measure(20, [&]
+            {
+                for (int step = 0; step < 100; ++step)
+                    lod.SetNode(dragged, xs[dragged] + 40.0f * step, ys[dragged], 120.0f);
+                lod.SetNode(dragged, xs[dragged], ys[dragged], 120.0f);
+            }));
+
+        // 缩小到整图放进 1920 宽的视口：选层级并遍历所有聚类与边束（即每帧要生成的符号）
+        float const zoom = 1920.0f / 20000.0f;
+        uint32_t const level = lod.LevelFor(zoom, LodThresholds{}.clusterCellPx);
+        Box const all{ 0.0f, 0.0f, 20000.0f, 20000.0f };
+        size_t visited = 0;
+        char note[64];
+        std::snprintf(note, sizeof(note), "level %u: %zu clusters, %zu bundles", level, lod.ClusterCount(level), lod.BundleCount(level));
+        Report("lod visit clusters + bundles", Measure(20, [&]
+            {
+                lod.ForEachCluster(level, all, [&](ClusterHierarchy::Cluster const& c) { visited += c.count; });
+                lod.ForEachBundle(level, all, [&](auto const&, auto const&, uint32_t count) { visited += count; });
+            }), note);
+        g_sink = g_sink + double(visited);
+    }
+
+    // user-042：视口虚拟化。按 NodeGraphPanel::UpdateRealization 的规则模拟连续平移：
+    // 视口仍在上次实现区域内（留有半个边距）时跳过，否则按视口加边距查询四叉树，并用遍次戳区分进入与离开的节点。
+    // 节点密度固定、图规模增大时，每次重新实现的耗时与元素数量应只随视口变化，而不随 n 增长。
+    void Realize(uint32_t n)
+    {
+        constexpr float Margin = 256.0f;    // RealizationMargin 默认值
+        constexpr int Frames = 600;
+        for (uint32_t count : { n / 10, n, n * 10 })
+        {
+            // 每 200x200 一个节点
+            float const side = 200.0f * std::sqrt(float(count));
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> pos(0.0f, side);
+            QuadTree tree;
+            for (uint32_t k = 0; k < count; ++k)
+                tree.Insert(k, Box::FromRect(pos(rng), pos(rng), 120.0f, 60.0f));
+
+            std::vector<uint32_t> stamp(count, 0);
+            std::vector<uint32_t> realized, kept, entering;
+            uint32_t pass = 0;
+            Box area = Box::Empty();
+            size_t passes = 0, attached = 0, detached = 0, peak = 0;
+
+            double const ms = Measure(1, [&]
+                {
+                    for (int frame = 0; frame < Frames; ++frame)
+                    {
+                        // 从图中央向右下平移，每帧 12 DIP
+                        Box const view = Box::FromRect(side / 2 + 12.0f * frame, side / 2 + 6.0f * frame, 1920, 1080);
+                        if (area.Inflate(-Margin * 0.5f).Encloses(view))
+                            continue;
+                        area = view.Inflate(Margin);
+                        ++pass;
+                        ++passes;
+                        kept.clear();
+                        entering.clear();
+                        tree.Query(area, [&](uint32_t key, Box const&) { stamp[key] = pass; entering.push_back(key); });
+                        for (uint32_t key : realized)
+                        {
+                            if (stamp[key] == pass)
+                                kept.push_back(key);
+                            else
+                                ++detached;
+                        }
+                        attached += entering.size() - kept.size();
+                        realized.swap(entering);
+                        peak = std::max(peak, realized.size());
+                    }
+                });
+
+            char name[48], note[96];
+            std::snprintf(name, sizeof(name), "realize pan %d frames, n=%u", Frames, count);
+            std::snprintf(note, sizeof(note), "%zu passes, peak %zu realized, %zu attach / %zu detach",
+                passes, peak, attached, detached);
+            Report(name, ms, note);
+        }
+    }
+
+    // user-040：拖动节点时的边更新。沿 GraphIndex::IncidentEdges 只重算关联边（NodeGraphPanel::UpdateIncidentEdges），
+    // 对照逐条重算全部边（改动前的 RedrawEdges）。线段写入按边槽位索引的数组，代替 Line 元素的 X1/Y1/X2/Y2。
+    void DragEdges(uint32_t n)
+    {
+        struct NodeInfo { float x{ 0 }, y{ 0 }; };
+        struct EdgeInfo {};
+        GraphIndex<NodeInfo, EdgeInfo> graph;
+        std::mt19937 rng(40);
+        std::uniform_real_distribution<float> pos(0.0f, 20000.0f);
+        for (uint32_t k = 0; k < n; ++k)
+            graph.AddNode(k, NodeInfo{ pos(rng), pos(rng) });
+        // 2n 条边，其中 1% 连到节点 0，使其成为度数较高的枢纽
+        for (uint32_t e = 0; e < 2 * n; ++e)
+            graph.AddEdge(e % 100 == 0 ? 0 : rng() % n, rng() % n, EdgeInfo{});
+
+        std::vector<Segment> lines(graph.EdgeSlotCount());
+        size_t updates = 0;
+        auto updateLine = [&](uint32_t slot)
+            {
+                auto const& e = graph.Edge(slot);
+                auto const& a = graph.Node(graph.FindNode(e.from)).payload;
+                auto const& b = graph.Node(graph.FindNode(e.to)).payload;
+                lines[slot] = Segment{ a.x, a.y, b.x, b.y };
+                ++updates;
+            };
+
+        constexpr int Moves = 60;   // 约 1 秒的拖动
+        char name[48], note[64];
+        for (NodeId dragged : { NodeId{ 1 }, NodeId{ 0 } })
+        {
+            auto& node = graph.Node(graph.FindNode(dragged)).payload;
+            size_t const degree = graph.IncidentEdges(dragged).size();
+
+            updates = 0;
+            double const incremental = Measure(1, [&]
+                {
+                    for (int m = 0; m < Moves; ++m)
+                    {
+                        node.x += 4.0f;
+                        for (uint32_t slot : graph.IncidentEdges(dragged))
+                            updateLine(slot);
+                    }
+                });
+            std::snprintf(name, sizeof(name), "drag degree %zu, incident edges", degree);
+            std::snprintf(note, sizeof(note), "%zu line updates per drag", updates);
+            Report(name, incremental, note);
+
+            updates = 0;
+            double const full = Measure(1, [&]
+                {
+                    for (int m = 0; m < Moves; ++m)
+                    {
+                        node.x += 4.0f;
+                        graph.ForEachEdge([&](uint32_t slot, auto const&) { updateLine(slot); });
+                    }
+                });
+            std::snprintf(name, sizeof(name), "drag degree %zu, redraw all edges", degree);
+            std::snprintf(note, sizeof(note), "%zu line updates per drag", updates);
+            Report(name, full, note);
+        }
+        g_sink = g_sink + double(lines[0].x1);
+    }
+
+    // user-049：整图换色（NodeFill 变化后每个节点重新绑定外观）。
+    // NodeGraphPanel::ComputeAppearance 的可移植部分：新建三把默认画刷（以 shared_ptr 分配代替 SolidColorBrush），
+    // 再做自动对比度（文字色、描边色各一次对比度判断，必要时派生描边色）。
+    // 改动前每个节点算一次且亮度用 std::pow；改动后每次变化只算一次，节点共享同一组画刷。
+    struct BenchAppearance
+    {
+        std::shared_ptr<Rgba> fill, stroke, text;
+    };
+
+    double PowLuminance(Rgba c)
+    {
+        auto toLin = [](double u)
+            {
+                u /= 255.0;
+                return (u <= 0.03928) ? (u / 12.92) : std::pow((u + 0.055) / 1.055, 2.4);
+            };
+        return 0.2126 * toLin(c.r) + 0.7152 * toLin(c.g) + 0.0722 * toLin(c.b);
+    }
+
+    template <typename LuminanceOf>
+    BenchAppearance ComputeBenchAppearance(Rgba fill, LuminanceOf&& luminance)
+    {
+        BenchAppearance a{ std::make_shared<Rgba>(fill), std::make_shared<Rgba>(Rgba{ 70, 130, 180, 255 }),
+            std::make_shared<Rgba>(Rgba{ 0, 0, 0, 255 }) };
+        auto contrast = [&](Rgba x, Rgba y)
+            {
+                double const lx = luminance(x), ly = luminance(y);
+                return (std::max(lx, ly) + 0.05) / (std::min(lx, ly) + 0.05);
+            };
+        if (contrast(fill, *a.text) < 4.5)
+            a.text = std::make_shared<Rgba>(contrast(fill, ContrastDark) >= contrast(fill, ContrastLight) ? ContrastDark : ContrastLight);
+        if (contrast(fill, *a.stroke) < 2.5)
+            a.stroke = std::make_shared<Rgba>(Shade(fill, luminance(fill) > 0.5 ? -0.35f : 0.35f));
+        return a;
+    }
+
+    void Restyle(uint32_t n)
+    {
+        std::vector<BenchAppearance> bound(n);   // 每个节点元素当前使用的画刷
+        Rgba const fills[] = { Rgba{ 40, 80, 160, 255 }, Rgba{ 250, 240, 200, 255 } };
+        int flip = 0;
+
+        Report("restyle, per-node appearance (pow)", Measure(10, [&]
+            {
+                Rgba const fill = fills[flip++ % 2];
+                for (auto& b : bound)
+                    b = ComputeBenchAppearance(fill, PowLuminance);
+            }));
+        Report("restyle, per-node appearance (LUT)", Measure(10, [&]
+            {
+                Rgba const fill = fills[flip++ % 2];
+                for (auto& b : bound)
+                    b = ComputeBenchAppearance(fill, [](Rgba c) { return double(RelativeLuminance(c)); });
+            }));
+        Report("restyle, cached appearance", Measure(10, [&]
+            {
+                auto const shared = ComputeBenchAppearance(fills[flip++ % 2], [](Rgba c) { return double(RelativeLuminance(c)); });
+                for (auto& b : bound)
+                    b = shared;
+            }));
+
+        // 批量绘制模式：换色即换批次，每个节点从旧批次移到新批次
+        DisplayList list;
+        NodeStyle style;
+        std::vector<Box> boxes(n);
+        for (uint32_t k = 0; k < n; ++k)
+        {
+            boxes[k] = Box::FromRect(float(k % 100) * 150, float(k / 100) * 80, 120, 60);
+            list.SetNode(k, list.NodeBatchFor(style), boxes[k]);
+        }
+        list.ConsumeChanges([](DisplayList::Change const&) {});
+        Report("restyle, batched display list", Measure(10, [&]
+            {
+                style.fill = fills[flip++ % 2];
+                uint32_t const batch = list.NodeBatchFor(style);
+                for (uint32_t k = 0; k < n; ++k)
+                    list.SetNode(k, batch, boxes[k]);
+                size_t changes = 0;
+                list.ConsumeChanges([&](DisplayList::Change const&) { ++changes; });
+                g_sink = g_sink + double(changes);
+            }));
+        g_sink = g_sink + double(bound[n / 2].text->r);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t const scale = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+    SpatialIndex(100000 * scale);
+    Force(20000 * scale);
+    Layered(5000 * scale);
+    Queries(100000 * scale);
+    File(200000 * scale);
+    Meta(100000 * scale);
+    Colors(1000000 * scale);
+    Display(10000 * scale);
+    Lod(100000 * scale);
+    Realize(100000 * scale);
+    DragEdges(100000 * scale);
+    Restyle(10000 * scale);
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include "QuadTree.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace nodegraph;
+
+namespace
+{
+    // 与四叉树对照的线性表
+    struct BruteForce
+    {
+        std::vector<std::optional<Box>> boxes;
+
+        void Set(uint32_t key, Box const& box)
+        {
+            if (key >= boxes.size())
+                boxes.resize(key + 1);
+            boxes[key] = box;
+        }
+
+        std::vector<uint32_t> Query(Box const& area) const
+        {
+            std::vector<uint32_t> keys;
+            for (uint32_t k = 0; k < boxes.size(); ++k)
+                if (boxes[k] && boxes[k]->Intersects(area))
+                    keys.push_back(k);
+            return keys;
+        }
+    };
+
+    std::vector<uint32_t> Query(QuadTree const& tree, Box const& area)
+    {
+        std::vector<uint32_t> keys;
+        tree.Query(area, [&](uint32_t key, Box const&) { keys.push_back(key); });
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    Box RandomBox(std::mt19937& rng, float extent, float maxSize)
+    {
+        std::uniform_real_distribution<float> pos(-extent, extent);
+        std::uniform_real_distribution<float> size(0.0f, maxSize);
+        return Box::FromRect(pos(rng), pos(rng), size(rng), size(rng));
+    }
+
+    void RandomizedAgainstBruteForce()
+    {
+        std::mt19937 rng(39);
+        for (int round = 0; round < 20; ++round)
+        {
+            // 小容量 + 大范围，逼出分裂、跨线条目与根单元倍增
+            QuadTree tree(round % 2 ? 2 : 8, 4.0f);
+            BruteForce ref;
+            float const extent = round < 10 ? 500.0f : 50000.0f;
+
+            for (int op = 0; op < 3000; ++op)
+            {
+                uint32_t const key = rng() % 600;
+                switch (rng() % 6)
+                {
+                case 0:
+                case 1:
+                {
+                    auto box = RandomBox(rng, extent, 120.0f);
+                    NG_CHECK(tree.Insert(key, box));
+                    ref.Set(key, box);
+                    break;
+                }
+                case 2:
+                case 3:
+                {
+                    // 小幅移动（多走原地更新）或跳到远处（需要重新插入）
+                    Box box;
+                    if (key < ref.boxes.size() && ref.boxes[key] && rng() % 2)
+                    {
+                        box = *ref.boxes[key];
+                        float const dx = float(int(rng() % 11) - 5), dy = float(int(rng() % 11) - 5);
+                        box = Box{ box.minX + dx, box.minY + dy, box.maxX + dx, box.maxY + dy };
+                    }
+                    else
+                    {
+                        box = RandomBox(rng, extent, 120.0f);
+                    }
+                    NG_CHECK(tree.Update(key, box));
+                    ref.Set(key, box);
+                    break;
+                }
+                case 4:
+                    tree.Remove(key);
+                    if (key < ref.boxes.size())
+                        ref.boxes[key].reset();
+                    break;
+                default:
+                {
+                    auto area = RandomBox(rng, extent, extent * 0.5f);
+                    NG_CHECK(Query(tree, area) == ref.Query(area));
+                    float const x = area.minX, y = area.minY;
+                    NG_CHECK(Query(tree, Box{ x, y, x, y }) == ref.Query(Box{ x, y, x, y }));
+                    break;
+                }
+                }
+
+                size_t live = 0;
+                for (auto const& b : ref.boxes)
+                    live += b.has_value();
+                NG_CHECK(tree.Size() == live);
+            }
+
+            NG_CHECK(Query(tree, Box::Unbounded()) == ref.Query(Box::Unbounded()));
+        }
+    }
+
+    void EarlyExit()
+    {
+        QuadTree tree;
+        for (uint32_t k = 0; k < 100; ++k)
+            tree.Insert(k, Box::FromRect(float(k), 0, 10, 10));
+        int visited = 0;
+        tree.Query(Box::Unbounded(), [&](uint32_t, Box const&) { return ++visited < 5; });
+        NG_CHECK(visited == 5);
+    }
+
+    void NonFiniteBoxes()
+    {
+        float const inf = std::numeric_limits<float>::infinity();
+        float const nan = std::numeric_limits<float>::quiet_NaN();
+
+        QuadTree tree;
+        NG_CHECK(tree.Insert(0, Box{ 0, 0, 10, 10 }));
+
+        // NaN：拒绝，且不留下旧位置
+        NG_CHECK(!tree.Insert(1, Box{ nan, 0, 1, 1 }));
+        NG_CHECK(!tree.Contains(1));
+        NG_CHECK(!tree.Update(0, Box{ 0, nan, 1, 1 }));
+        NG_CHECK(!tree.Contains(0));
+        NG_CHECK(tree.Size() == 0);
+
+        // 无穷大：钳制后入树，必须能在有限步内完成并被查询到
+        NG_CHECK(tree.Insert(2, Box{ -inf, -inf, inf, inf }));
+        NG_CHECK(tree.Insert(3, Box{ inf, inf, inf, inf }));
+        NG_CHECK(tree.Insert(4, Box{ 1e30f, -1e30f, 1e30f, -1e30f }));
+        NG_CHECK(tree.Insert(5, Box{ 5, 5, 6, 6 }));
+        NG_CHECK(tree.Size() == 4);
+        NG_CHECK((Query(tree, Box{ 5, 5, 5, 5 }) == std::vector<uint32_t>{ 2, 5 }));
+        NG_CHECK((Query(tree, Box::Unbounded()) == std::vector<uint32_t>{ 2, 3, 4, 5 }));
+
+        // 最小单元尺寸为 0 时，大量重合的点也不能无限分裂
+        QuadTree degenerate(1, 0.0f);
+        for (uint32_t k = 0; k < 200; ++k)
+            NG_CHECK(degenerate.Insert(k, Box{ 1, 1, 1, 1 }));
+        NG_CHECK(Query(degenerate, Box{ 1, 1, 1, 1 }).size() == 200);
+    }
+}
+
+int main()
+{
+    RandomizedAgainstBruteForce();
+    EarlyExit();
+    NonFiniteBoxes();
+    std::puts("quad_tree_test: ok");
+    return 0;
+}
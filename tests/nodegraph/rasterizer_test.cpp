@@ -0,0 +1,164 @@
+#include "Rasterizer.h"
+#include "test_check.h"
+
+#include <cstdlib>
+
+using namespace nodegraph;
+
+namespace
+{
+    constexpr Rgba White{ 255, 255, 255, 255 };
+    constexpr Rgba Red{ 255, 0, 0, 255 };
+    constexpr Rgba Blue{ 0, 0, 255, 255 };
+    constexpr Rgba Black{ 0, 0, 0, 255 };
+    constexpr Rgba Transparent{ 0, 0, 0, 0 };
+
+    NodeStyle Filled(Primitive shape, Rgba fill)
+    {
+        NodeStyle style;
+        style.shape = shape;
+        style.fill = fill;
+        style.stroke = Transparent;
+        style.strokeWidth = 0.0f;
+        return style;
+    }
+
+    size_t CountPixels(Rasterizer const& r, Rgba color)
+    {
+        size_t n = 0;
+        for (auto const& p : r.Pixels())
+            n += p == color;
+        return n;
+    }
+
+    bool Near(uint8_t a, uint8_t b)
+    {
+        return std::abs(int(a) - int(b)) <= 1;
+    }
+
+    // 与像素网格对齐的矩形：内部全覆盖，外部不受影响，边缘没有半覆盖像素
+    void AlignedRectCoversExactPixels()
+    {
+        DisplayList list;
+        list.SetNode(0, list.NodeBatchFor(Filled(Primitive::RoundedRect, Red)), Box{ 4, 4, 12, 12 });
+
+        Rasterizer r{ 32, 32 };
+        r.Clear(White);
+        r.Draw(list);
+        NG_CHECK(CountPixels(r, Red) == 64);
+        NG_CHECK(CountPixels(r, White) == 32 * 32 - 64);
+        NG_CHECK(r.Pixel(4, 4) == Red && r.Pixel(11, 11) == Red);
+        NG_CHECK(r.Pixel(3, 4) == White && r.Pixel(12, 11) == White);
+
+        // 画布坐标放大 2 倍并平移
+        r.SetTransform(2.0f, -4.0f, 0.0f);
+        r.Clear(White);
+        r.Draw(list);
+        NG_CHECK(CountPixels(r, Red) == 256);
+        NG_CHECK(r.Pixel(4, 8) == Red && r.Pixel(19, 23) == Red);
+        NG_CHECK(r.Pixel(3, 8) == White && r.Pixel(20, 8) == White && r.Pixel(4, 7) == White);
+    }
+
+    // 椭圆：中心全覆盖，外接矩形的角不受影响，左右、上下对称
+    void EllipseIsSymmetric()
+    {
+        DisplayList list;
+        list.SetNode(0, list.NodeBatchFor(Filled(Primitive::Ellipse, Blue)), Box{ 4, 8, 28, 24 });
+
+        Rasterizer r{ 32, 32 };
+        r.Clear(White);
+        r.Draw(list);
+        NG_CHECK(r.Pixel(16, 16) == Blue);
+        NG_CHECK(r.Pixel(4, 8) == White && r.Pixel(27, 23) == White);
+        NG_CHECK(r.Pixel(4, 16) != White);      // 长轴端点附近有覆盖
+
+        for (uint32_t y = 0; y < 32; ++y)
+        {
+            for (uint32_t x = 0; x < 32; ++x)
+            {
+                NG_CHECK(r.Pixel(x, y) == r.Pixel(31 - x, y));
+                NG_CHECK(r.Pixel(x, y) == r.Pixel(x, 31 - y));
+            }
+        }
+        size_t const covered = 32 * 32 - CountPixels(r, White);
+        // 面积 pi * 12 * 8 ≈ 301.6，抗锯齿边缘会多出一圈部分覆盖的像素
+        NG_CHECK(covered >= 290 && covered <= 360);
+    }
+
+    // 线宽 2 的水平线恰好覆盖两行；边先于节点绘制，被节点盖住
+    void EdgesDrawBelowNodes()
+    {
+        DisplayList list;
+        list.SetEdge(0, list.EdgeBatchFor(EdgeStyle{ Black, 2.0f }), Segment{ 2, 16, 30, 16 });
+        list.SetNode(0, list.NodeBatchFor(Filled(Primitive::RoundedRect, Red)), Box{ 12, 12, 20, 20 });
+
+        Rasterizer r{ 32, 32 };
+        r.Clear(White);
+        r.Draw(list);
+        for (uint32_t x = 4; x < 28; ++x)
+        {
+            bool const underNode = x >= 12 && x < 20;
+            NG_CHECK(r.Pixel(x, 15) == (underNode ? Red : Black));
+            NG_CHECK(r.Pixel(x, 16) == (underNode ? Red : Black));
+            if (!underNode)
+            {
+                NG_CHECK(r.Pixel(x, 14) == White);
+                NG_CHECK(r.Pixel(x, 17) == White);
+            }
+        }
+    }
+
+    // 只有描边：边框像素为描边色，内部保持背景
+    void StrokeOnly()
+    {
+        NodeStyle style = Filled(Primitive::RoundedRect, Transparent);
+        style.stroke = Black;
+        style.strokeWidth = 2.0f;
+
+        DisplayList list;
+        list.SetNode(0, list.NodeBatchFor(style), Box{ 8, 8, 24, 24 });
+
+        Rasterizer r{ 32, 32 };
+        r.Clear(White);
+        r.Draw(list);
+        NG_CHECK(r.Pixel(16, 16) == White);
+        NG_CHECK(r.Pixel(7, 16) == Black && r.Pixel(8, 16) == Black);
+        NG_CHECK(r.Pixel(16, 7) == Black && r.Pixel(16, 8) == Black);
+        NG_CHECK(r.Pixel(6, 16) == White && r.Pixel(9, 16) == White);
+        NG_CHECK(r.Pixel(2, 2) == White);
+    }
+
+    // 半透明填充按非预乘 source-over 混合；空盒与画布外的图形不绘制
+    void BlendAndClip()
+    {
+        DisplayList list;
+        list.SetNode(0, list.NodeBatchFor(Filled(Primitive::RoundedRect, Rgba{ 0, 0, 255, 128 })), Box{ 0, 0, 8, 8 });
+        list.SetNode(1, list.NodeBatchFor(Filled(Primitive::RoundedRect, Red)), Box{ 20, 20, 20, 28 });
+        list.SetNode(2, list.NodeBatchFor(Filled(Primitive::Ellipse, Red)), Box{ -50, -50, -10, -10 });
+        list.SetNode(3, list.NodeBatchFor(Filled(Primitive::RoundedRect, Red)), Box{ 28, 28, 60, 60 });
+
+        Rasterizer r{ 32, 32 };
+        r.Clear(White);
+        r.Draw(list);
+        auto const p = r.Pixel(4, 4);
+        NG_CHECK(Near(p.r, 127) && Near(p.g, 127) && p.b == 255 && p.a == 255);
+        NG_CHECK(r.Pixel(20, 24) == White);     // 宽度为 0
+        NG_CHECK(r.Pixel(31, 31) == Red);       // 部分在画布外
+
+        // 透明背景上的半透明颜色保持原色，alpha 为源 alpha
+        r.Clear(Transparent);
+        r.Draw(list);
+        auto const q = r.Pixel(4, 4);
+        NG_CHECK(q.r == 0 && q.g == 0 && q.b == 255 && Near(q.a, 128));
+    }
+}
+
+int main()
+{
+    AlignedRectCoversExactPixels();
+    EllipseIsSymmetric();
+    EdgesDrawBelowNodes();
+    StrokeOnly();
+    BlendAndClip();
+    return 0;
+}
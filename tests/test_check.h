@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// 不依赖 NDEBUG 的断言：失败时打印位置并以非零码退出，由 ctest 判定失败
+#define NG_CHECK(expr)                                                              \
+    do                                                                              \
+    {                                                                               \
+        if (!(expr))                                                                \
+        {                                                                           \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::exit(1);                                                           \
+        }                                                                           \
+    } while (0)
+
+// ctest 的 SKIP_RETURN_CODE
+inline constexpr int NG_SKIP = 77;